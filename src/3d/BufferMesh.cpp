@@ -27,6 +27,8 @@
 #include <QVector3D>
 #include <QVector4D>
 
+#include <utility>
+
 BufferMesh::BufferMesh( Qt3DCore::QNode* parent ) :
   Qt3DRender::QGeometryRenderer( parent ),
   m_bufferMeshGeo( new BufferMeshGeometry( this ) ) {
@@ -40,9 +42,47 @@ BufferMesh::~BufferMesh() {
   m_bufferMeshGeo->deleteLater();
 }
 
-void BufferMesh::bufferUpdate( const QVector<QVector3D>& pos ) {
-  m_bufferMeshGeo->updatePoints( pos );
+bool BufferMesh::bufferUpdate( const QVector<QVector3D>& pos ) {
+  if( m_bufferMeshGeo->updatePoints( pos ) ) {
+    setVertexCount( m_bufferMeshGeo->vertexCount() );
+    setGeometry( m_bufferMeshGeo );
+    return true;
+  }
+
+  return false;
+}
+
+bool BufferMesh::bufferUpdate( QByteArray&& vertexData ) {
+  if( m_bufferMeshGeo->updateData( std::move( vertexData ) ) ) {
+    setVertexCount( m_bufferMeshGeo->vertexCount() );
+    setGeometry( m_bufferMeshGeo );
+    return true;
+  }
+
+  return false;
+}
+
+void BufferMesh::bufferUpdate( QByteArray&& vertexData, QByteArray&& indexData ) {
+  m_bufferMeshGeo->updateIndexedData( std::move( vertexData ), std::move( indexData ) );
 
-  setVertexCount( m_bufferMeshGeo->vertexCount() );
+  // for indexed drawing, the vertex count of the renderer is the number of indices
+  setVertexCount( m_bufferMeshGeo->indexCount() );
   setGeometry( m_bufferMeshGeo );
 }
+
+QVector3D* BufferMesh::beginBufferUpdate( const int maxVertexCount ) {
+  // resize() keeps the capacity, so the staging buffer only allocates if it grows or was uploaded before
+  m_stagingBuffer.resize( maxVertexCount * int( sizeof( QVector3D ) ) );
+  return reinterpret_cast<QVector3D*>( m_stagingBuffer.data() );
+}
+
+bool BufferMesh::commitBufferUpdate( const int vertexCount ) {
+  m_stagingBuffer.resize( vertexCount * int( sizeof( QVector3D ) ) );
+
+  if( m_bufferMeshGeo->isDataUnchanged( m_stagingBuffer.constData(), m_stagingBuffer.size() ) ) {
+    return false;
+  }
+
+  // QByteArray is implicitly shared, so handing a copy to the geometry doesn't copy the data
+  return bufferUpdate( QByteArray( m_stagingBuffer ) );
+}
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <QVector>
+#include <QByteArray>
 #include <QObject>
 #include <QGeometryRenderer>
 
@@ -35,8 +36,19 @@ class BufferMesh : public Qt3DRender::QGeometryRenderer {
   public:
     explicit BufferMesh( Qt3DCore::QNode* parent = nullptr );
     ~BufferMesh();
-    void bufferUpdate( const QVector<QVector3D>& pos );
+    // the updates return whether the data was uploaded; unchanged data (same hash) is skipped
+    bool bufferUpdate( const QVector<QVector3D>& pos );
+    bool bufferUpdate( QByteArray&& vertexData );
+
+    // indexed mesh: positions as floats and 32bit indices; always uploaded
+    void bufferUpdate( QByteArray&& vertexData, QByteArray&& indexData );
+
+    // write the vertices directly into the reusable staging buffer of the mesh: get a pointer to
+    // space for at most maxVertexCount vertices, fill it and commit the number of vertices written
+    QVector3D* beginBufferUpdate( const int maxVertexCount );
+    bool commitBufferUpdate( const int vertexCount );
 
   private:
     BufferMeshGeometry* m_bufferMeshGeo = nullptr;
+    QByteArray m_stagingBuffer;
 };
@@ -26,12 +26,18 @@
 #include <QVector3D>
 #include <Qt3DRender/QAttribute>
 #include <Qt3DRender/QBuffer>
+#include <QHash>
+
+#include <cstring>
+#include <utility>
 
 
 BufferMeshGeometry::BufferMeshGeometry( Qt3DCore::QNode* parent ) :
   Qt3DRender::QGeometry( parent )
   , m_positionAttribute( new Qt3DRender::QAttribute( this ) )
-  , m_vertexBuffer( new Qt3DRender::QBuffer( this ) ) {
+  , m_indexAttribute( new Qt3DRender::QAttribute( this ) )
+  , m_vertexBuffer( new Qt3DRender::QBuffer( this ) )
+  , m_indexBuffer( new Qt3DRender::QBuffer( this ) ) {
   m_positionAttribute->setAttributeType( Qt3DRender::QAttribute::VertexAttribute );
   m_positionAttribute->setBuffer( m_vertexBuffer );
 
@@ -45,21 +51,93 @@ BufferMeshGeometry::BufferMeshGeometry( Qt3DCore::QNode* parent ) :
 
   m_positionAttribute->setName( Qt3DRender::QAttribute::defaultPositionAttributeName() );
 
+  m_indexAttribute->setAttributeType( Qt3DRender::QAttribute::IndexAttribute );
+  m_indexAttribute->setVertexBaseType( Qt3DRender::QAttribute::UnsignedInt );
+  m_indexAttribute->setBuffer( m_indexBuffer );
+  m_indexAttribute->setCount( 0 );
+
   addAttribute( m_positionAttribute );
 }
 
 BufferMeshGeometry::~BufferMeshGeometry() {
   m_positionAttribute->deleteLater();
+  m_indexAttribute->deleteLater();
   m_vertexBuffer->deleteLater();
+  m_indexBuffer->deleteLater();
 }
 
 int BufferMeshGeometry::vertexCount() {
-  return m_vertexBuffer->data().size() / static_cast<int>( sizeof( QVector3D ) );
+  return m_dataSize / static_cast<int>( sizeof( QVector3D ) );
+}
+
+bool BufferMeshGeometry::isDataUnchanged( const char* data, const int size ) const {
+  // the hash rejects most changes cheaply; a match is confirmed against the uploaded bytes, so a collision never
+  // leaves stale geometry
+  return ( size == m_dataSize ) && ( qHashBits( data, size_t( size ) ) == m_dataHash ) &&
+         ( std::memcmp( data, m_lastData.constData(), size_t( size ) ) == 0 );
+}
+
+bool BufferMeshGeometry::updatePoints( const QVector<QVector3D>& vertices ) {
+  const int size = vertices.size() * static_cast<int>( sizeof( QVector3D ) );
+  const auto* data = reinterpret_cast<const char*>( vertices.constData() );
+
+  // hash the vertices in place, so unchanged data costs no allocation
+  if( isDataUnchanged( data, size ) ) {
+    return false;
+  }
+
+  m_dataHash = qHashBits( data, size_t( size ) );
+  m_dataSize = size;
+  m_lastData = QByteArray( data, size );
+
+  // shares the bytes with m_lastData
+  m_vertexBuffer->setData( m_lastData );
+  removeIndices();
+
+  return true;
+}
+
+bool BufferMeshGeometry::updateData( QByteArray&& vertexData ) {
+  if( isDataUnchanged( vertexData.constData(), vertexData.size() ) ) {
+    return false;
+  }
+
+  m_dataHash = qHashBits( vertexData.constData(), size_t( vertexData.size() ) );
+  m_dataSize = vertexData.size();
+  m_lastData = vertexData;
+
+  m_vertexBuffer->setData( std::move( vertexData ) );
+  removeIndices();
+
+  return true;
+}
+
+void BufferMeshGeometry::updateIndexedData( QByteArray&& vertexData, QByteArray&& indexData ) {
+  // the hash only covers non-indexed data, so the next non-indexed update is always uploaded
+  m_dataHash = 0;
+  m_dataSize = -1;
+  m_lastData.clear();
+
+  m_indexAttribute->setCount( uint( indexData.size() / int( sizeof( uint32_t ) ) ) );
+
+  m_vertexBuffer->setData( std::move( vertexData ) );
+  m_indexBuffer->setData( std::move( indexData ) );
+
+  if( !m_indexed ) {
+    addAttribute( m_indexAttribute );
+    m_indexed = true;
+  }
+}
+
+int BufferMeshGeometry::indexCount() const {
+  return int( m_indexAttribute->count() );
 }
 
-void BufferMeshGeometry::updatePoints( const QVector<QVector3D>& vertices ) {
-  QByteArray vertexBufferData;
-  vertexBufferData.resize( vertices.size() * static_cast<int>( sizeof( QVector3D ) ) );
-  memcpy( vertexBufferData.data(), vertices.constData(), static_cast<size_t>( vertexBufferData.size() ) );
-  m_vertexBuffer->setData( vertexBufferData );
+void BufferMeshGeometry::removeIndices() {
+  if( m_indexed ) {
+    removeAttribute( m_indexAttribute );
+    m_indexBuffer->setData( QByteArray() );
+    m_indexAttribute->setCount( 0 );
+    m_indexed = false;
+  }
 }
@@ -26,6 +26,7 @@
 #include "3d/qt3dForwards.h"
 
 #include <QGeometry>
+#include <QByteArray>
 
 class BufferMeshGeometry : public Qt3DRender::QGeometry {
     Q_OBJECT
@@ -35,9 +36,27 @@ class BufferMeshGeometry : public Qt3DRender::QGeometry {
     ~BufferMeshGeometry();
     int vertexCount();
 
-    void updatePoints( const QVector<QVector3D>& vertices );
+    // the update functions return false if the data is the same as the last uploaded one
+    bool updatePoints( const QVector<QVector3D>& vertices );
+    bool updateData( QByteArray&& vertexData );
+
+    bool isDataUnchanged( const char* data, const int size ) const;
+
+    // positions as floats and 32bit indices; the index attribute is only part of the geometry while indexed data is set
+    void updateIndexedData( QByteArray&& vertexData, QByteArray&& indexData );
+    int indexCount() const;
 
   private:
+    uint m_dataHash = 0;
+    int m_dataSize = -1;
+    // the last uploaded non-indexed data; shares the bytes with the vertex buffer
+    QByteArray m_lastData;
+
+    void removeIndices();
+
     Qt3DRender::QAttribute* m_positionAttribute;
+    Qt3DRender::QAttribute* m_indexAttribute;
     Qt3DRender::QBuffer* m_vertexBuffer;
+    Qt3DRender::QBuffer* m_indexBuffer;
+    bool m_indexed = false;
 };
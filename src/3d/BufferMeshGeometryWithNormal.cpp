@@ -27,11 +27,15 @@
 #include <Qt3DRender/QAttribute>
 #include <Qt3DRender/QBuffer>
 
+#include <utility>
+
 BufferMeshGeometryWithNormal::BufferMeshGeometryWithNormal( Qt3DCore::QNode* parent ) :
   Qt3DRender::QGeometry( parent )
   , m_positionAttribute( new Qt3DRender::QAttribute( this ) )
   , m_normalAttribute( new Qt3DRender::QAttribute( this ) )
-  , m_vertexBuffer( new Qt3DRender::QBuffer( this ) ) {
+  , m_indexAttribute( new Qt3DRender::QAttribute( this ) )
+  , m_vertexBuffer( new Qt3DRender::QBuffer( this ) )
+  , m_indexBuffer( new Qt3DRender::QBuffer( this ) ) {
 
   // Populate a buffer with the interleaved per-vertex data with
   // vec3 pos*3, vec3 normal
@@ -55,6 +59,11 @@ BufferMeshGeometryWithNormal::BufferMeshGeometryWithNormal( Qt3DCore::QNode* par
   m_normalAttribute->setByteOffset( 3 * sizeof( float ) );
   m_normalAttribute->setCount( 0 );
 
+  m_indexAttribute->setAttributeType( Qt3DRender::QAttribute::IndexAttribute );
+  m_indexAttribute->setVertexBaseType( Qt3DRender::QAttribute::UnsignedInt );
+  m_indexAttribute->setBuffer( m_indexBuffer );
+  m_indexAttribute->setCount( 0 );
+
   addAttribute( m_positionAttribute );
   addAttribute( m_normalAttribute );
 }
@@ -62,16 +71,50 @@ BufferMeshGeometryWithNormal::BufferMeshGeometryWithNormal( Qt3DCore::QNode* par
 BufferMeshGeometryWithNormal::~BufferMeshGeometryWithNormal() {
   m_positionAttribute->deleteLater();
   m_normalAttribute->deleteLater();
+  m_indexAttribute->deleteLater();
   m_vertexBuffer->deleteLater();
+  m_indexBuffer->deleteLater();
 }
 
 int BufferMeshGeometryWithNormal::vertexCount() {
   return m_vertexBuffer->data().size() / static_cast<int>( sizeof( QVector3D ) );
 }
 
+bool BufferMeshGeometryWithNormal::isIndexed() const {
+  return m_indexed;
+}
+
+int BufferMeshGeometryWithNormal::indexCount() const {
+  return int( m_indexAttribute->count() );
+}
+
 void BufferMeshGeometryWithNormal::updatePoints( const QVector<QVector3D>& vertices ) {
   QByteArray vertexBufferData;
   vertexBufferData.resize( vertices.size() * static_cast<int>( sizeof( QVector3D ) ) );
   memcpy( vertexBufferData.data(), vertices.constData(), static_cast<size_t>( vertexBufferData.size() ) );
   m_vertexBuffer->setData( vertexBufferData );
+
+  if( m_indexed ) {
+    removeAttribute( m_indexAttribute );
+    m_indexBuffer->setData( QByteArray() );
+    m_indexAttribute->setCount( 0 );
+    m_positionAttribute->setCount( 0 );
+    m_normalAttribute->setCount( 0 );
+    m_indexed = false;
+  }
+}
+
+void BufferMeshGeometryWithNormal::updateIndexed( QByteArray&& vertexData, QByteArray&& indexData ) {
+  constexpr int stride = 2 * int( sizeof( QVector3D ) );
+  m_positionAttribute->setCount( uint( vertexData.size() / stride ) );
+  m_normalAttribute->setCount( uint( vertexData.size() / stride ) );
+  m_indexAttribute->setCount( uint( indexData.size() / int( sizeof( uint32_t ) ) ) );
+
+  m_vertexBuffer->setData( std::move( vertexData ) );
+  m_indexBuffer->setData( std::move( indexData ) );
+
+  if( !m_indexed ) {
+    addAttribute( m_indexAttribute );
+    m_indexed = true;
+  }
 }
@@ -37,8 +37,17 @@ class BufferMeshGeometryWithNormal : public Qt3DRender::QGeometry {
 
     void updatePoints( const QVector<QVector3D>& vertices );
 
+    // interleaved position/normal as floats and 32bit indices; the index attribute is only part of
+    // the geometry while indexed data is set
+    void updateIndexed( QByteArray&& vertexData, QByteArray&& indexData );
+    bool isIndexed() const;
+    int indexCount() const;
+
   private:
     Qt3DRender::QAttribute* m_positionAttribute = nullptr;
     Qt3DRender::QAttribute* m_normalAttribute = nullptr;
+    Qt3DRender::QAttribute* m_indexAttribute = nullptr;
     Qt3DRender::QBuffer* m_vertexBuffer = nullptr;
+    Qt3DRender::QBuffer* m_indexBuffer = nullptr;
+    bool m_indexed = false;
 };
@@ -30,6 +30,8 @@
 #include <Qt3DRender/QAttribute>
 #include <Qt3DRender/QBuffer>
 
+#include <utility>
+
 BufferMeshWithNormal::BufferMeshWithNormal( Qt3DCore::QNode* parent ) :
   Qt3DRender::QGeometryRenderer( parent ),
   m_bufferMeshGeo( new BufferMeshGeometryWithNormal( this ) ) {
@@ -49,3 +51,11 @@ void BufferMeshWithNormal::bufferUpdate( const QVector<QVector3D>& pos ) {
   setVertexCount( m_bufferMeshGeo->vertexCount() );
   setGeometry( m_bufferMeshGeo );
 }
+
+void BufferMeshWithNormal::bufferUpdate( QByteArray&& verticesWithNormals, QByteArray&& indices ) {
+  m_bufferMeshGeo->updateIndexed( std::move( verticesWithNormals ), std::move( indices ) );
+
+  // for indexed drawing, the vertex count of the renderer is the number of indices
+  setVertexCount( m_bufferMeshGeo->indexCount() );
+  setGeometry( m_bufferMeshGeo );
+}
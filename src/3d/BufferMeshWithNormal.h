@@ -27,6 +27,7 @@
 
 #include <QObject>
 #include <QVector>
+#include <QByteArray>
 #include <Qt3DRender/QGeometryRenderer>
 
 class QString;
@@ -39,6 +40,9 @@ class BufferMeshWithNormal : public Qt3DRender::QGeometryRenderer {
     ~BufferMeshWithNormal();
     void bufferUpdate( const QVector<QVector3D>& pos );
 
+    // indexed mesh: interleaved position/normal as floats and 32bit indices
+    void bufferUpdate( QByteArray&& verticesWithNormals, QByteArray&& indices );
+
   private:
     BufferMeshGeometryWithNormal* m_bufferMeshGeo = nullptr;
 };
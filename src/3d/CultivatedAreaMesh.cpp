@@ -35,6 +35,7 @@ CultivatedAreaMesh::CultivatedAreaMesh( Qt3DCore::QNode* parent ) :
   setGeometry( m_trackMeshGeometry );
 
   QObject::connect( m_trackMeshGeometry, &CultivatedAreaMeshGeometry::vertexCountChanged, this, &QGeometryRenderer::setVertexCount );
+  QObject::connect( m_trackMeshGeometry, &CultivatedAreaMeshGeometry::optimisationFinished, this, &CultivatedAreaMesh::optimisationFinished );
 }
 
 CultivatedAreaMesh::~CultivatedAreaMesh() {
@@ -60,3 +61,15 @@ void CultivatedAreaMesh::addTrackMesh( CultivatedAreaMesh* trackMesh ) {
 void CultivatedAreaMesh::optimise( CgalThread* thread ) {
   m_trackMeshGeometry->optimise( thread );
 }
+
+void CultivatedAreaMesh::setTriangles( const std::vector<Point_2>& vertices, const std::vector<uint32_t>& indices ) {
+  m_trackMeshGeometry->setTriangles( vertices, indices );
+}
+
+const std::vector<Point_2>& CultivatedAreaMesh::getTrackPointsLeft() const {
+  return m_trackMeshGeometry->getTrackPointsLeft();
+}
+
+const std::vector<Point_2>& CultivatedAreaMesh::getTrackPointsRight() const {
+  return m_trackMeshGeometry->getTrackPointsRight();
+}
@@ -43,6 +43,14 @@ class CultivatedAreaMesh : public Qt3DRender::QGeometryRenderer {
 
     void optimise( CgalThread* thread );
 
+    void setTriangles( const std::vector<Point_2>& vertices, const std::vector<uint32_t>& indices );
+
+    const std::vector<Point_2>& getTrackPointsLeft() const;
+    const std::vector<Point_2>& getTrackPointsRight() const;
+
+  Q_SIGNALS:
+    void optimisationFinished();
+
   private:
     CultivatedAreaMeshGeometry* m_trackMeshGeometry = nullptr;
 };
@@ -232,6 +232,7 @@ void CultivatedAreaMeshGeometry::updateBuffers() {
     m_tangentAttribute->setCount( nVerts );
 
     m_indexBuffer->setData( indexBytes );
+    m_indexAttribute->setVertexBaseType( Qt3DRender::QAttribute::UnsignedShort );
     m_indexAttribute->setCount( indices );
 
     Q_EMIT vertexCountChanged( indices );
@@ -240,6 +241,50 @@ void CultivatedAreaMeshGeometry::updateBuffers() {
   }
 }
 
+void CultivatedAreaMeshGeometry::setTriangles( const std::vector<Point_2>& vertices, const std::vector<uint32_t>& indices ) {
+  QByteArray bufferBytes;
+  QByteArray indexBytes;
+
+  // Populate a buffer with the interleaved per-vertex data with
+  // vec3 pos, vec3 normal, vec4 tangent
+  constexpr int elementSizeVertices = 3 + 3 + 4;
+  constexpr int strideVertices = elementSizeVertices * sizeof( float );
+  bufferBytes.resize( strideVertices * int( vertices.size() ) );
+
+  auto* fptr = reinterpret_cast<float*>( bufferBytes.data() );
+
+  for( const auto& point : vertices ) {
+    // position
+    *fptr++ = float( point.x() );
+    *fptr++ = float( point.y() );
+    *fptr++ = 0.0f;
+    // normal
+    *fptr++ = 0.0f;
+    *fptr++ = 0.0f;
+    *fptr++ = 1.0f;
+    // tangent
+    *fptr++ = 0.0f;
+    *fptr++ = 1.0f;
+    *fptr++ = 0.0f;
+    *fptr++ = 1.0f;
+  }
+
+  // the union of the cultivated area can get big, so use 32bit indices
+  indexBytes.resize( int( indices.size() * sizeof( uint32_t ) ) );
+  memcpy( indexBytes.data(), indices.data(), size_t( indexBytes.size() ) );
+
+  m_vertexBuffer->setData( bufferBytes );
+  m_positionAttribute->setCount( uint( vertices.size() ) );
+  m_normalAttribute->setCount( uint( vertices.size() ) );
+  m_tangentAttribute->setCount( uint( vertices.size() ) );
+
+  m_indexBuffer->setData( indexBytes );
+  m_indexAttribute->setVertexBaseType( Qt3DRender::QAttribute::UnsignedInt );
+  m_indexAttribute->setCount( uint( indices.size() ) );
+
+  Q_EMIT vertexCountChanged( int( indices.size() ) );
+}
+
 void CultivatedAreaMeshGeometry::optimise( CgalThread* thread ) {
   if( trackPointsLeft.size() > 2 ) {
     auto* cgalWorkerLeft = new CgalWorker();
@@ -262,6 +307,11 @@ void CultivatedAreaMeshGeometry::optimise( CgalThread* thread ) {
 
     Q_EMIT simplifyPolylineRight( &trackPointsRight, maxDeviation );
   }
+
+  // nothing to simplify
+  if( !waitForOptimition && trackPointsLeft.size() <= 2 && trackPointsRight.size() <= 2 ) {
+    Q_EMIT optimisationFinished();
+  }
 }
 
 void CultivatedAreaMeshGeometry::simplifyPolylineResultLeft( std::vector<Point_2>* points ) {
@@ -282,6 +332,7 @@ void CultivatedAreaMeshGeometry::simplifyPolylineResultLeft( std::vector<Point_2
 
   if( !waitForOptimition ) {
     updateBuffers();
+    Q_EMIT optimisationFinished();
   }
 }
 
@@ -303,11 +354,12 @@ void CultivatedAreaMeshGeometry::simplifyPolylineResultRight( std::vector<Point_
 
   if( !waitForOptimition ) {
     updateBuffers();
+    Q_EMIT optimisationFinished();
   }
 }
 
 int CultivatedAreaMeshGeometry::vertexCount() {
-  return m_indexBuffer->data().size() / static_cast<int>( sizeof( uint16_t ) );
+  return int( m_indexAttribute->count() );
 }
 
 void CultivatedAreaMeshGeometry::addPoints( const Point_2 pointLeft, const Point_2 pointRight ) {
@@ -42,6 +42,15 @@ class CultivatedAreaMeshGeometry : public Qt3DRender::QGeometry {
 
     void optimise( CgalThread* thread );
 
+    void setTriangles( const std::vector<Point_2>& vertices, const std::vector<uint32_t>& indices );
+
+    const std::vector<Point_2>& getTrackPointsLeft() const {
+      return trackPointsLeft;
+    }
+    const std::vector<Point_2>& getTrackPointsRight() const {
+      return trackPointsRight;
+    }
+
   private:
     void addPointLeftWithoutUpdate( const Point_2 point );
     void addPointRightWithoutUpdate( const Point_2 point );
@@ -51,6 +60,7 @@ class CultivatedAreaMeshGeometry : public Qt3DRender::QGeometry {
     void simplifyPolylineLeft( std::vector<Point_2>* pointsPointer, double maxDeviation );
     void simplifyPolylineRight( std::vector<Point_2>* pointsPointer, double maxDeviation );
     void vertexCountChanged( int );
+    void optimisationFinished();
 
   private Q_SLOTS:
     void simplifyPolylineResultLeft( std::vector<Point_2>* );
@@ -0,0 +1,114 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "InstancedPhongMaterial.h"
+
+#include <Qt3DRender/QEffect>
+#include <Qt3DRender/QFilterKey>
+#include <Qt3DRender/QGraphicsApiFilter>
+#include <Qt3DRender/QParameter>
+#include <Qt3DRender/QRenderPass>
+#include <Qt3DRender/QShaderProgram>
+#include <Qt3DRender/QTechnique>
+
+static const char* const vertexShaderCode = R"(
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+in vec3 instancePosition;
+
+out vec3 worldNormal;
+
+uniform mat4 modelMatrix;
+uniform mat3 modelNormalMatrix;
+uniform mat4 viewProjectionMatrix;
+
+void main() {
+  worldNormal = normalize( modelNormalMatrix * vertexNormal );
+  gl_Position = viewProjectionMatrix * modelMatrix * vec4( vertexPosition + instancePosition, 1.0 );
+}
+)";
+
+static const char* const fragmentShaderCode = R"(
+in vec3 worldNormal;
+
+out vec4 fragColor;
+
+uniform vec4 ka;
+uniform vec4 kd;
+
+void main() {
+  const vec3 lightDirection = vec3( 0.29, 0.29, 0.91 );
+  float diffuse = max( dot( normalize( worldNormal ), lightDirection ), 0.0 );
+  fragColor = vec4( ka.rgb + kd.rgb * diffuse, 1.0 );
+}
+)";
+
+static Qt3DRender::QTechnique* createTechnique( Qt3DRender::QGraphicsApiFilter::Api api,
+    const int majorVersion,
+    const int minorVersion,
+    const QByteArray& versionHeader ) {
+  auto* technique = new Qt3DRender::QTechnique();
+  technique->graphicsApiFilter()->setApi( api );
+  technique->graphicsApiFilter()->setMajorVersion( majorVersion );
+  technique->graphicsApiFilter()->setMinorVersion( minorVersion );
+
+  if( api == Qt3DRender::QGraphicsApiFilter::OpenGL ) {
+    technique->graphicsApiFilter()->setProfile( Qt3DRender::QGraphicsApiFilter::CoreProfile );
+  }
+
+  // the default forward renderer only draws techniques with this key
+  auto* filterKey = new Qt3DRender::QFilterKey( technique );
+  filterKey->setName( QStringLiteral( "renderingStyle" ) );
+  filterKey->setValue( QStringLiteral( "forward" ) );
+  technique->addFilterKey( filterKey );
+
+  auto* shaderProgram = new Qt3DRender::QShaderProgram( technique );
+  shaderProgram->setVertexShaderCode( versionHeader + vertexShaderCode );
+  shaderProgram->setFragmentShaderCode( versionHeader + fragmentShaderCode );
+
+  auto* renderPass = new Qt3DRender::QRenderPass( technique );
+  renderPass->setShaderProgram( shaderProgram );
+  technique->addRenderPass( renderPass );
+
+  return technique;
+}
+
+InstancedPhongMaterial::InstancedPhongMaterial( Qt3DCore::QNode* parent )
+  : Qt3DRender::QMaterial( parent ),
+    m_ambientParameter( new Qt3DRender::QParameter( QStringLiteral( "ka" ), QColor::fromRgbF( 0.05, 0.05, 0.05, 1.0 ) ) ),
+    m_diffuseParameter( new Qt3DRender::QParameter( QStringLiteral( "kd" ), QColor::fromRgbF( 0.7, 0.7, 0.7, 1.0 ) ) ) {
+  auto* effect = new Qt3DRender::QEffect( this );
+
+  effect->addTechnique( createTechnique( Qt3DRender::QGraphicsApiFilter::OpenGL, 3, 2,
+                                         QByteArrayLiteral( "#version 150 core\n" ) ) );
+  effect->addTechnique( createTechnique( Qt3DRender::QGraphicsApiFilter::OpenGLES, 3, 0,
+                                         QByteArrayLiteral( "#version 300 es\nprecision highp float;\n" ) ) );
+
+  effect->addParameter( m_ambientParameter );
+  effect->addParameter( m_diffuseParameter );
+
+  setEffect( effect );
+}
+
+void InstancedPhongMaterial::setAmbient( const QColor& ambient ) {
+  m_ambientParameter->setValue( ambient );
+}
+
+void InstancedPhongMaterial::setDiffuse( const QColor& diffuse ) {
+  m_diffuseParameter->setValue( diffuse );
+}
@@ -0,0 +1,40 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QColor>
+#include <Qt3DRender/QMaterial>
+
+#include "3d/qt3dForwards.h"
+
+// simple ambient/diffuse material, which offsets every vertex by the per-instance attribute "instancePosition"
+class InstancedPhongMaterial : public Qt3DRender::QMaterial {
+    Q_OBJECT
+
+  public:
+    explicit InstancedPhongMaterial( Qt3DCore::QNode* parent = nullptr );
+
+    void setAmbient( const QColor& ambient );
+    void setDiffuse( const QColor& diffuse );
+
+  private:
+    Qt3DRender::QParameter* m_ambientParameter = nullptr;
+    Qt3DRender::QParameter* m_diffuseParameter = nullptr;
+};
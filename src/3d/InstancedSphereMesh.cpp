@@ -0,0 +1,73 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "InstancedSphereMesh.h"
+
+#include <Qt3DCore/QNode>
+#include <Qt3DRender/QGeometryRenderer>
+#include <Qt3DRender/QAttribute>
+#include <Qt3DRender/QBuffer>
+#include <Qt3DExtras/QSphereGeometry>
+
+InstancedSphereMesh::InstancedSphereMesh( Qt3DCore::QNode* parent )
+  : Qt3DRender::QGeometryRenderer( parent ),
+    m_sphereGeometry( new Qt3DExtras::QSphereGeometry( this ) ) {
+  m_instanceBuffer = new Qt3DRender::QBuffer( m_sphereGeometry );
+
+  m_instanceAttribute = new Qt3DRender::QAttribute( m_sphereGeometry );
+  m_instanceAttribute->setName( QStringLiteral( "instancePosition" ) );
+  m_instanceAttribute->setAttributeType( Qt3DRender::QAttribute::VertexAttribute );
+  m_instanceAttribute->setVertexBaseType( Qt3DRender::QAttribute::Float );
+  m_instanceAttribute->setVertexSize( 3 );
+  m_instanceAttribute->setByteOffset( 0 );
+  m_instanceAttribute->setByteStride( sizeof( QVector3D ) );
+  m_instanceAttribute->setDivisor( 1 );
+  m_instanceAttribute->setCount( 0 );
+  m_instanceAttribute->setBuffer( m_instanceBuffer );
+  m_sphereGeometry->addAttribute( m_instanceAttribute );
+
+  setPrimitiveType( Qt3DRender::QGeometryRenderer::Triangles );
+  setInstanceCount( 0 );
+  setGeometry( m_sphereGeometry );
+}
+
+InstancedSphereMesh::~InstancedSphereMesh() {
+  m_instanceAttribute->deleteLater();
+  m_instanceBuffer->deleteLater();
+  m_sphereGeometry->deleteLater();
+}
+
+void InstancedSphereMesh::setRadius( const float radius ) {
+  m_sphereGeometry->setRadius( radius );
+}
+
+void InstancedSphereMesh::setRings( const int rings ) {
+  m_sphereGeometry->setRings( rings );
+}
+
+void InstancedSphereMesh::setSlices( const int slices ) {
+  m_sphereGeometry->setSlices( slices );
+}
+
+void InstancedSphereMesh::setPositions( const QVector<QVector3D>& positions ) {
+  // all the instances are uploaded at once
+  m_instanceBuffer->setData( QByteArray( reinterpret_cast<const char*>( positions.constData() ),
+                                         positions.size() * int( sizeof( QVector3D ) ) ) );
+  m_instanceAttribute->setCount( uint( positions.size() ) );
+  setInstanceCount( positions.size() );
+}
@@ -0,0 +1,47 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QVector3D>
+#include <QGeometryRenderer>
+
+#include "3d/qt3dForwards.h"
+
+// one sphere mesh, drawn once for every position in the per-instance buffer;
+// needs a material, that adds the attribute "instancePosition" to the vertices like InstancedPhongMaterial
+class InstancedSphereMesh : public Qt3DRender::QGeometryRenderer {
+    Q_OBJECT
+
+  public:
+    explicit InstancedSphereMesh( Qt3DCore::QNode* parent = nullptr );
+    ~InstancedSphereMesh();
+
+    void setRadius( const float radius );
+    void setRings( const int rings );
+    void setSlices( const int slices );
+
+    void setPositions( const QVector<QVector3D>& positions );
+
+  private:
+    Qt3DExtras::QSphereGeometry* m_sphereGeometry = nullptr;
+    Qt3DRender::QAttribute* m_instanceAttribute = nullptr;
+    Qt3DRender::QBuffer* m_instanceBuffer = nullptr;
+};
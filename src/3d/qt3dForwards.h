@@ -27,6 +27,7 @@ namespace Qt3DCore {
 namespace Qt3DExtras {
   class QCylinderMesh;
   class QSphereMesh;
+  class QSphereGeometry;
   class QPhongMaterial;
   class QDiffuseSpecularMaterial;
   class QExtrudedTextMesh;
@@ -40,6 +41,7 @@ namespace Qt3DRender {
   class QAttribute;
   class QBuffer;
   class QMaterial;
+  class QParameter;
   class QLineWidth;
   class QRenderTarget;
   class QRenderTargetOutput;
@@ -62,3 +64,5 @@ class BufferMesh;
 class BufferMeshGeometry;
 class BufferMeshGeometryWithNormal;
 class TextureRenderTarget;
+class InstancedSphereMesh;
+class InstancedPhongMaterial;
@@ -24,6 +24,22 @@
 #include <QComboBox>
 #include <QTreeWidget>
 #include <QGraphicsScene>
+#include <QHash>
+
+static QHash<QString, BlockFactory*> factoriesByType;
+
+bool BlockFactory::deferModelResets = false;
+
+BlockFactory::~BlockFactory() {
+  // getNameOfFactory() is pure virtual here, so search by value
+  for( auto it = factoriesByType.begin(); it != factoriesByType.end(); ) {
+    if( it.value() == this ) {
+      it = factoriesByType.erase( it );
+    } else {
+      ++it;
+    }
+  }
+}
 
 void BlockFactory::addToCombobox( QComboBox* combobox ) {
   combobox->addItem( getNameOfFactory(), QVariant::fromValue( this ) );
@@ -51,6 +67,22 @@ void BlockFactory::addToTreeWidget( QTreeWidget* treeWidget ) {
   newItem->setText( 0, getPrettyNameOfFactory() );
   newItem->setText( 1, getNameOfFactory() );
   newItem->setData( 0, Qt::UserRole, QVariant::fromValue( this ) );
+
+  registerFactory();
+}
+
+void BlockFactory::registerFactory() {
+  factoriesByType.insert( getNameOfFactory(), this );
+}
+
+BlockFactory* BlockFactory::factoryForType( const QString& type ) {
+  return factoriesByType.value( type, nullptr );
+}
+
+QStringList BlockFactory::registeredTypes() {
+  auto types = factoriesByType.keys();
+  types.sort();
+  return types;
 }
 
 QNEBlock* BlockFactory::createBaseBlock( QGraphicsScene* scene, BlockBase* obj, int id, bool systemBlock ) {
@@ -71,19 +103,7 @@ QNEBlock* BlockFactory::createBaseBlock( QGraphicsScene* scene, BlockBase* obj,
 }
 
 bool BlockFactory::isIdUnique( QGraphicsScene* scene, int id ) {
-  const auto& constRefOfList = scene->items();
-
-  for( const auto& item : constRefOfList ) {
-    auto* block = qgraphicsitem_cast<QNEBlock*>( item );
-
-    if( block != nullptr ) {
-      if( block->id == id ) {
-        return false;
-      }
-    }
-  }
-
-  return true;
+  return QNEBlock::blockWithId( scene, id ) == nullptr;
 }
 
 const QColor BlockFactory::modelColor = QColor( QStringLiteral( "moccasin" ) );
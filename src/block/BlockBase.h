@@ -20,6 +20,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QLatin1String>
 #include <QStringLiteral>
 
@@ -37,6 +38,16 @@ class BlockBase : public QObject {
   public:
     BlockBase() {}
 
+    // the blocks of the sensor/control path can run on a separate thread, so they aren't delayed by the GUI
+    enum class ExecutionDomain {
+      Gui,
+      Realtime
+    };
+
+    virtual ExecutionDomain executionDomain() const {
+      return ExecutionDomain::Gui;
+    }
+
     virtual void emitConfigSignals() {}
 
     virtual void toJSON( QJsonObject& ) {}
@@ -52,7 +63,7 @@ class BlockFactory : public QObject {
 
   public:
     BlockFactory() {}
-    ~BlockFactory() {}
+    ~BlockFactory();
 
     virtual QString getNameOfFactory() = 0;
 
@@ -74,7 +85,24 @@ class BlockFactory : public QObject {
 
     static bool isIdUnique( QGraphicsScene* scene, int id );
 
+    // adds the factory to the registry of factoryForType(); done by addToTreeWidget() in the GUI
+    void registerFactory();
+
+    // the registered factories, hashed by getNameOfFactory()
+    static BlockFactory* factoryForType( const QString& type );
+    static QStringList registeredTypes();
+
+    // while set, the factories don't reset their models on each created block; used to load whole configs
+    static bool deferModelResets;
+
   protected:
+    template<class Model>
+    static void resetModel( Model* model ) {
+      if( !deferModelResets ) {
+        model->resetModel();
+      }
+    }
+
     static const QColor modelColor;
     static const QColor dockColor;
     static const QColor inputDockColor;
@@ -0,0 +1,458 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "BlockProfiler.h"
+
+#include "qneblock.h"
+#include "qneport.h"
+#include "qneconnection.h"
+
+#include "MeasurementTimestamp.h"
+
+#include <QGraphicsScene>
+#include <QIODevice>
+#include <QTextStream>
+#include <QPointer>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+std::atomic<bool> BlockProfiler::enabledFlag = { false };
+
+namespace {
+  using Clock = std::chrono::steady_clock;
+
+  struct Frame {
+    const QObject* block = nullptr;
+    Clock::time_point start;
+    uint64_t childrenNs = 0;
+    // of the measurement processed by the call, on the same clock; 0 without one
+    qint64 receivedNs = 0;
+  };
+
+  // the slots currently running on this thread
+  thread_local std::vector<Frame> callStack;
+
+  // shared by all the threads; only taken while profiling
+  std::mutex statisticsMutex;
+  std::unordered_map<const QObject*, BlockProfiler::BlockStatistics> profiledBlocks;
+  Clock::time_point statisticsStart = Clock::now();
+
+  std::size_t bucketOf( const uint64_t nanoseconds ) {
+    std::size_t bucket = 0;
+
+    for( uint64_t value = nanoseconds; value > 1 && bucket < BlockProfiler::HistogramBuckets - 1; value >>= 1 ) {
+      ++bucket;
+    }
+
+    return bucket;
+  }
+}
+
+// receives a signal like QSignalSpy and calls the slots of all the connections of it synchronously, as the direct
+// connection would do, but timed. The targets are fixed on construction, so the thread of the sender can iterate
+// over them without locking; removed connections are only deactivated.
+class ProfilingRelay : public QObject {
+  public:
+    struct Target {
+      QNEConnection* connection = nullptr;
+      QPointer<QObject> receiver;
+      int methodIndex = -1;
+    };
+
+    ProfilingRelay( QObject* sender, const int signalIndex, std::vector<Target>&& targets )
+      : sender( sender ), signalIndex( signalIndex ), targets( std::move( targets ) ),
+        activeTargets( new std::atomic<bool>[this->targets.size()] ) {
+      for( std::size_t i = 0; i < this->targets.size(); ++i ) {
+        activeTargets[i] = true;
+      }
+    }
+
+    bool attach() {
+      connection = QMetaObject::connect( sender, signalIndex,
+                                         this, QObject::staticMetaObject.methodCount(),
+                                         Qt::DirectConnection, nullptr );
+      return bool( connection );
+    }
+
+    void detach() {
+      active = false;
+      QObject::disconnect( connection );
+    }
+
+    // returns whether any target is left
+    bool deactivate( QNEConnection* connection ) {
+      bool anyActive = false;
+
+      for( std::size_t i = 0; i < targets.size(); ++i ) {
+        if( targets[i].connection == connection ) {
+          activeTargets[i] = false;
+        }
+
+        anyActive = anyActive || activeTargets[i];
+      }
+
+      return anyActive;
+    }
+
+    const std::vector<Target>& getTargets() const {
+      return targets;
+    }
+
+    int qt_metacall( QMetaObject::Call call, int id, void** arguments ) override {
+      id = QObject::qt_metacall( call, id, arguments );
+
+      if( id < 0 ) {
+        return id;
+      }
+
+      if( call == QMetaObject::InvokeMetaMethod && id == 0 && active ) {
+        BlockProfiler::recordEmit( sender, int( targets.size() ) );
+
+        // the arguments of the signal are passed on as they are; a slot with less parameters ignores the rest
+        for( std::size_t i = 0; i < targets.size(); ++i ) {
+          if( activeTargets[i] && !targets[i].receiver.isNull() ) {
+            BlockProfiler::Scope scope( targets[i].receiver );
+            QMetaObject::metacall( targets[i].receiver, QMetaObject::InvokeMetaMethod, targets[i].methodIndex, arguments );
+          }
+        }
+      }
+
+      return -1;
+    }
+
+  private:
+    QObject* sender = nullptr;
+    int signalIndex = -1;
+    std::vector<Target> targets;
+    std::unique_ptr<std::atomic<bool>[]> activeTargets;
+    std::atomic<bool> active = { true };
+
+    QMetaObject::Connection connection;
+};
+
+uint64_t BlockProfiler::BlockStatistics::quantileNs( const std::array<uint64_t, HistogramBuckets>& histogram, const double quantile ) {
+  uint64_t total = 0;
+
+  for( const auto count : histogram ) {
+    total += count;
+  }
+
+  if( total == 0 ) {
+    return 0;
+  }
+
+  const auto rank = uint64_t( std::ceil( quantile * double( total ) ) );
+  uint64_t sum = 0;
+
+  for( std::size_t bucket = 0; bucket < HistogramBuckets; ++bucket ) {
+    sum += histogram[bucket];
+
+    if( sum >= rank ) {
+      // bucket b holds [2^b, 2^(b+1))
+      return uint64_t( 1 ) << ( bucket + 1 );
+    }
+  }
+
+  return uint64_t( 1 ) << HistogramBuckets;
+}
+
+BlockProfiler::BlockProfiler( QGraphicsScene* scene, QObject* parent )
+  : QObject( parent ), scene( scene ) {}
+
+BlockProfiler::~BlockProfiler() {
+  enabledFlag = false;
+  unrouteConnections();
+}
+
+void BlockProfiler::enter( const QObject* block ) {
+  callStack.push_back( Frame{ block, Clock::now(), 0, MeasurementTimestamp::current().receivedNs } );
+}
+
+void BlockProfiler::leave() {
+  if( callStack.empty() ) {
+    return;
+  }
+
+  const auto frame = callStack.back();
+  callStack.pop_back();
+
+  const auto inclusiveNs = uint64_t( std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - frame.start ).count() );
+  const auto exclusiveNs = inclusiveNs - std::min( inclusiveNs, frame.childrenNs );
+
+  if( !callStack.empty() ) {
+    callStack.back().childrenNs += inclusiveNs;
+  }
+
+  std::lock_guard<std::mutex> lock( statisticsMutex );
+  auto& blockStatistics = profiledBlocks[frame.block];
+  ++blockStatistics.calls;
+  blockStatistics.inclusiveNs += inclusiveNs;
+  blockStatistics.exclusiveNs += exclusiveNs;
+  blockStatistics.maxInclusiveNs = std::max( blockStatistics.maxInclusiveNs, inclusiveNs );
+  ++blockStatistics.inclusiveHistogram[bucketOf( inclusiveNs )];
+  ++blockStatistics.exclusiveHistogram[bucketOf( exclusiveNs )];
+
+  if( frame.receivedNs != 0 ) {
+    const auto startNs = std::chrono::duration_cast<std::chrono::nanoseconds>( frame.start.time_since_epoch() ).count();
+    const auto latencyNs = uint64_t( std::max( startNs - frame.receivedNs, qint64( 0 ) ) );
+
+    ++blockStatistics.latencySamples;
+    blockStatistics.latencyNs += latencyNs;
+    blockStatistics.maxLatencyNs = std::max( blockStatistics.maxLatencyNs, latencyNs );
+    ++blockStatistics.latencyHistogram[bucketOf( latencyNs )];
+  }
+}
+
+void BlockProfiler::recordEmit( const QObject* sender, const int fanOut ) {
+  if( !isEnabled() ) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock( statisticsMutex );
+  auto& blockStatistics = profiledBlocks[sender];
+  ++blockStatistics.emits;
+  blockStatistics.deliveries += uint64_t( fanOut );
+}
+
+bool BlockProfiler::enabled() const {
+  return isEnabled();
+}
+
+std::vector<BlockProfiler::BlockStatistics> BlockProfiler::snapshot() const {
+  std::vector<BlockStatistics> result;
+
+  // the names are looked up in the scene, so blocks deleted since the measurement are left out
+  QHash<const QObject*, QString> names;
+  const auto& constRefOfList = scene->items();
+
+  for( const auto& item : constRefOfList ) {
+    if( auto* block = qgraphicsitem_cast<QNEBlock*>( item ) ) {
+      names.insert( block->object, block->getName() );
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock( statisticsMutex );
+
+    for( const auto& entry : profiledBlocks ) {
+      if( names.contains( entry.first ) ) {
+        result.push_back( entry.second );
+        result.back().name = names.value( entry.first );
+      }
+    }
+  }
+
+  std::sort( result.begin(), result.end(), []( const BlockStatistics & lhs, const BlockStatistics & rhs ) {
+    return lhs.exclusiveNs > rhs.exclusiveNs;
+  } );
+
+  return result;
+}
+
+qint64 BlockProfiler::elapsedNs() const {
+  std::lock_guard<std::mutex> lock( statisticsMutex );
+  return std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - statisticsStart ).count();
+}
+
+bool BlockProfiler::exportCsv( QIODevice& device ) const {
+  if( !device.isWritable() ) {
+    return false;
+  }
+
+  const auto blocks = snapshot();
+  const auto seconds = double( elapsedNs() ) * 1e-9;
+
+  QTextStream stream( &device );
+  stream << "block,calls,calls_per_s,emits,deliveries,mean_fanout,"
+         "inclusive_total_ns,exclusive_total_ns,inclusive_mean_ns,exclusive_mean_ns,inclusive_max_ns,"
+         "exclusive_p50_ns,exclusive_p99_ns,latency_samples,latency_mean_ns,latency_p50_ns,latency_p99_ns,latency_max_ns";
+
+  // bucket b counts the calls in [2^b, 2^(b+1)); the last one all the longer ones too
+  for( std::size_t bucket = 0; bucket < HistogramBuckets - 1; ++bucket ) {
+    stream << ",exclusive_lt_" << ( uint64_t( 1 ) << ( bucket + 1 ) ) << "_ns";
+  }
+
+  stream << ",exclusive_ge_" << ( uint64_t( 1 ) << ( HistogramBuckets - 1 ) ) << "_ns";
+
+  stream << "\n";
+
+  for( const auto& block : blocks ) {
+    QString name = block.name;
+    name.replace( QLatin1Char( '"' ), QStringLiteral( "\"\"" ) );
+
+    stream << '"' << name << "\","
+           << block.calls << ','
+           << ( seconds > 0 ? double( block.calls ) / seconds : 0. ) << ','
+           << block.emits << ','
+           << block.deliveries << ','
+           << ( block.emits > 0 ? double( block.deliveries ) / double( block.emits ) : 0. ) << ','
+           << block.inclusiveNs << ','
+           << block.exclusiveNs << ','
+           << ( block.calls > 0 ? block.inclusiveNs / block.calls : 0 ) << ','
+           << ( block.calls > 0 ? block.exclusiveNs / block.calls : 0 ) << ','
+           << block.maxInclusiveNs << ','
+           << BlockStatistics::quantileNs( block.exclusiveHistogram, 0.5 ) << ','
+           << BlockStatistics::quantileNs( block.exclusiveHistogram, 0.99 ) << ','
+           << block.latencySamples << ','
+           << ( block.latencySamples > 0 ? block.latencyNs / block.latencySamples : 0 ) << ','
+           << BlockStatistics::quantileNs( block.latencyHistogram, 0.5 ) << ','
+           << BlockStatistics::quantileNs( block.latencyHistogram, 0.99 ) << ','
+           << block.maxLatencyNs;
+
+    for( const auto count : block.exclusiveHistogram ) {
+      stream << ',' << count;
+    }
+
+    stream << "\n";
+  }
+
+  stream.flush();
+  return stream.status() == QTextStream::Ok;
+}
+
+void BlockProfiler::setEnabled( const bool enabled ) {
+  if( enabled == isEnabled() ) {
+    return;
+  }
+
+  if( enabled ) {
+    enabledFlag = true;
+    routeConnections();
+  } else {
+    unrouteConnections();
+    enabledFlag = false;
+  }
+
+  Q_EMIT enabledChanged( enabled );
+}
+
+void BlockProfiler::reset() {
+  std::lock_guard<std::mutex> lock( statisticsMutex );
+  profiledBlocks.clear();
+  statisticsStart = Clock::now();
+}
+
+void BlockProfiler::unrouteConnections() {
+  for( auto* relay : ownedRelays ) {
+    removeRelay( relay );
+  }
+
+  for( auto* connection : routedConnections ) {
+    connection->setScheduler( nullptr );
+  }
+
+  ownedRelays.clear();
+  relays.clear();
+  routedConnections.clear();
+}
+
+void BlockProfiler::removeRelay( ProfilingRelay* relay ) {
+  // the relay lives on the thread of the sender, so its deletion can't overlap with an emit running through it
+  relay->detach();
+  relay->deleteLater();
+}
+
+void BlockProfiler::routeConnections() {
+  if( !isEnabled() || scene == nullptr ) {
+    return;
+  }
+
+  // the connections of a signal are grouped into one relay to get the fan-out of it
+  QHash<QPair<QObject*, int>, std::vector<ProfilingRelay::Target>> targetsOfSignal;
+  std::vector<QPair<QObject*, int>> signalOrder;
+
+  const auto& constRefOfList = scene->items();
+
+  for( const auto& item : constRefOfList ) {
+    auto* connection = qgraphicsitem_cast<QNEConnection*>( item );
+
+    // the connections routed by the scheduler or between the threads are timed by their hooks
+    if( connection == nullptr || connection->port2() == nullptr || connection->scheduler() != nullptr ) {
+      continue;
+    }
+
+    QObject* sender = connection->port1()->block()->object;
+    QObject* receiver = connection->port2()->block()->object;
+
+    if( sender->thread() != receiver->thread() ) {
+      continue;
+    }
+
+    // the signatures are the ones of SIGNAL() and SLOT(): the first char is the type of the method
+    const int signalIndex = sender->metaObject()->indexOfMethod(
+                                    QMetaObject::normalizedSignature( connection->port1()->slotSignalSignature.latin1() + 1 ).constData() );
+    const int methodIndex = receiver->metaObject()->indexOfMethod(
+                                    QMetaObject::normalizedSignature( connection->port2()->slotSignalSignature.latin1() + 1 ).constData() );
+
+    if( signalIndex < 0 || methodIndex < 0 ) {
+      continue;
+    }
+
+    const auto key = qMakePair( sender, signalIndex );
+
+    if( !targetsOfSignal.contains( key ) ) {
+      signalOrder.push_back( key );
+    }
+
+    ProfilingRelay::Target target;
+    target.connection = connection;
+    target.receiver = receiver;
+    target.methodIndex = methodIndex;
+    targetsOfSignal[key].push_back( target );
+  }
+
+  for( const auto& key : signalOrder ) {
+    auto* relay = new ProfilingRelay( key.first, key.second, std::move( targetsOfSignal[key] ) );
+    relay->moveToThread( key.first->thread() );
+
+    for( const auto& target : relay->getTargets() ) {
+      target.connection->setScheduler( this );
+    }
+
+    if( relay->attach() ) {
+      for( const auto& target : relay->getTargets() ) {
+        relays.insert( target.connection, relay );
+        routedConnections.push_back( target.connection );
+      }
+
+      ownedRelays.push_back( relay );
+    } else {
+      for( const auto& target : relay->getTargets() ) {
+        target.connection->setScheduler( nullptr );
+      }
+
+      relay->deleteLater();
+    }
+  }
+}
+
+void BlockProfiler::connectionRemoved( void* connection ) {
+  auto* qneConnection = static_cast<QNEConnection*>( connection );
+  auto* relay = relays.take( qneConnection );
+
+  if( relay != nullptr && !relay->deactivate( qneConnection ) ) {
+    removeRelay( relay );
+    ownedRelays.erase( std::remove( ownedRelays.begin(), ownedRelays.end(), relay ), ownedRelays.end() );
+  }
+
+  routedConnections.erase( std::remove( routedConnections.begin(), routedConnections.end(), qneConnection ),
+                           routedConnections.end() );
+}
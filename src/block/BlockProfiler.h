@@ -0,0 +1,137 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class QGraphicsScene;
+class QIODevice;
+class QNEConnection;
+class ProfilingRelay;
+
+// measures the time spent in the slots of the blocks. While disabled, the connections of the graph are the
+// plain ones of Qt and the hooks in the scheduler and the relays are a single relaxed load, so it can stay compiled
+// in. Enabling it routes the direct connections through relays, which time every call of a slot and count the
+// emits of the senders with their fan-out. The time of a slot is inclusive of the slots called by its emits; the
+// exclusive time has them subtracted, tracked by a stack per thread. Calls with a MeasurementTimestamp also record
+// the latency from the receipt of the measurement to the start of the slot, the end-to-end latency up to the block.
+class BlockProfiler : public QObject {
+    Q_OBJECT
+
+  public:
+    // log2 of the nanoseconds
+    static constexpr std::size_t HistogramBuckets = 32;
+
+    struct BlockStatistics {
+      QString name;
+      uint64_t calls = 0;
+      uint64_t emits = 0;
+      uint64_t deliveries = 0;
+      uint64_t inclusiveNs = 0;
+      uint64_t exclusiveNs = 0;
+      uint64_t maxInclusiveNs = 0;
+      std::array<uint64_t, HistogramBuckets> inclusiveHistogram = {};
+      std::array<uint64_t, HistogramBuckets> exclusiveHistogram = {};
+      uint64_t latencySamples = 0;
+      uint64_t latencyNs = 0;
+      uint64_t maxLatencyNs = 0;
+      std::array<uint64_t, HistogramBuckets> latencyHistogram = {};
+
+      // the exclusive upper bound of the bucket containing the given quantile
+      static uint64_t quantileNs( const std::array<uint64_t, HistogramBuckets>& histogram, const double quantile );
+    };
+
+    // times a call of a slot of block; the hooks of the scheduler and the relays use this
+    class Scope {
+      public:
+        explicit Scope( const QObject* block ) {
+          if( BlockProfiler::isEnabled() ) {
+            active = true;
+            BlockProfiler::enter( block );
+          }
+        }
+
+        ~Scope() {
+          if( active ) {
+            BlockProfiler::leave();
+          }
+        }
+
+        Scope( const Scope& ) = delete;
+        Scope& operator=( const Scope& ) = delete;
+
+      private:
+        bool active = false;
+    };
+
+  public:
+    explicit BlockProfiler( QGraphicsScene* scene, QObject* parent = nullptr );
+    ~BlockProfiler();
+
+    static bool isEnabled() {
+      return enabledFlag.load( std::memory_order_relaxed );
+    }
+
+    static void recordEmit( const QObject* sender, const int fanOut );
+
+    bool enabled() const;
+
+    // sorted by the exclusive time, descending
+    std::vector<BlockStatistics> snapshot() const;
+    qint64 elapsedNs() const;
+
+    bool exportCsv( QIODevice& device ) const;
+
+    // the graph changes: restores the direct connections and routes the new ones if enabled
+    void unrouteConnections();
+    void routeConnections();
+
+  public Q_SLOTS:
+    void setEnabled( const bool enabled );
+    void reset();
+
+    // called by QNEConnection on deletion
+    void connectionRemoved( void* connection );
+
+  Q_SIGNALS:
+    void enabledChanged( bool );
+
+  private:
+    static void removeRelay( ProfilingRelay* relay );
+
+    static void enter( const QObject* block );
+    static void leave();
+
+    static std::atomic<bool> enabledFlag;
+
+    QGraphicsScene* scene = nullptr;
+
+    QHash<QNEConnection*, ProfilingRelay*> relays;
+    std::vector<QNEConnection*> routedConnections;
+
+    // one relay per signal, deleted once all of its connections are gone
+    std::vector<ProfilingRelay*> ownedRelays;
+};
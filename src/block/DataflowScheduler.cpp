@@ -0,0 +1,439 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "DataflowScheduler.h"
+#include "BlockProfiler.h"
+
+#include "qneblock.h"
+#include "qneport.h"
+#include "qneconnection.h"
+
+#include <QJsonArray>
+#include <QHash>
+#include <QMetaType>
+
+#include <algorithm>
+#include <array>
+#include <set>
+
+// receives the signals of the compiled graph like QSignalSpy: the method ids after the ones of QObject are the
+// indices of the outputs in the scheduler
+class DataflowSignalCatcher : public QObject {
+  public:
+    explicit DataflowSignalCatcher( DataflowScheduler* scheduler )
+      : scheduler( scheduler ) {}
+
+    int qt_metacall( QMetaObject::Call call, int id, void** arguments ) override {
+      id = QObject::qt_metacall( call, id, arguments );
+
+      if( id < 0 ) {
+        return id;
+      }
+
+      if( call == QMetaObject::InvokeMetaMethod ) {
+        scheduler->capture( std::size_t( id ), arguments );
+      }
+
+      return -1;
+    }
+
+  private:
+    DataflowScheduler* scheduler = nullptr;
+};
+
+// the arguments of a slot are passed as an array of pointers, the first one is the return value
+static constexpr int maxArguments = 10;
+
+DataflowScheduler::DataflowScheduler( QObject* parent )
+  : QObject( parent ), catcher( new DataflowSignalCatcher( this ) ) {}
+
+DataflowScheduler::~DataflowScheduler() {
+  clear();
+  delete catcher;
+}
+
+bool DataflowScheduler::compile( const QJsonObject& json, const std::function<QNEBlock*( int )>& blockForId ) {
+  clear();
+
+  // the nodes are the blocks of the config
+  QHash<int, std::size_t> nodeForId;
+  std::vector<int> idOfNode;
+
+  for( const auto& blockValue : json[QStringLiteral( "blocks" )].toArray() ) {
+    const int id = blockValue.toObject()[QStringLiteral( "id" )].toInt( 0 );
+    QNEBlock* block = blockForId( id );
+
+    if( block != nullptr && !nodeForId.contains( id ) ) {
+      nodeForId.insert( id, nodes.size() );
+      idOfNode.push_back( id );
+      nodes.emplace_back();
+      nodes.back().block = block;
+    }
+  }
+
+  // the edges are the connections; the ones, that can be routed through the scheduler, get an input
+  std::vector<std::vector<std::size_t>> successors( nodes.size() );
+  std::vector<int> inDegree( nodes.size(), 0 );
+  QHash<QPair<QObject*, int>, std::size_t> outputForSignal;
+
+  for( const auto& connectionValue : json[QStringLiteral( "connections" )].toArray() ) {
+    const auto connectionObject = connectionValue.toObject();
+    const int idFrom = connectionObject[QStringLiteral( "idFrom" )].toInt( 0 );
+    const int idTo = connectionObject[QStringLiteral( "idTo" )].toInt( 0 );
+
+    if( !nodeForId.contains( idFrom ) || !nodeForId.contains( idTo ) ) {
+      continue;
+    }
+
+    const auto nodeFrom = nodeForId.value( idFrom );
+    const auto nodeTo = nodeForId.value( idTo );
+
+    QNEPort* portFrom = nodes[nodeFrom].block->getPortWithName( connectionObject[QStringLiteral( "portFrom" )].toString(), true );
+    QNEPort* portTo = nodes[nodeTo].block->getPortWithName( connectionObject[QStringLiteral( "portTo" )].toString(), false );
+
+    if( portFrom == nullptr || portTo == nullptr ) {
+      continue;
+    }
+
+    QNEConnection* connection = nullptr;
+
+    for( auto* portConnection : portFrom->connections() ) {
+      if( portConnection->port2() == portTo && portConnection->scheduler() == nullptr ) {
+        connection = portConnection;
+        break;
+      }
+    }
+
+    if( connection == nullptr ) {
+      continue;
+    }
+
+    if( nodeFrom != nodeTo ) {
+      successors[nodeFrom].push_back( nodeTo );
+      ++inDegree[nodeTo];
+    }
+
+    // the signatures are the ones of SIGNAL() and SLOT(): the first char is the type of the method
+    QObject* sender = portFrom->block()->object;
+    QObject* receiver = portTo->block()->object;
+
+    // the epochs run on the thread of the scheduler; connections to and from other threads keep their routing
+    if( sender->thread() != thread() || receiver->thread() != thread() ) {
+      ++m_statistics.directConnections;
+      continue;
+    }
+    const int signalIndex = sender->metaObject()->indexOfMethod(
+                                    QMetaObject::normalizedSignature( portFrom->slotSignalSignature.latin1() + 1 ).constData() );
+    const int methodIndex = receiver->metaObject()->indexOfMethod(
+                                    QMetaObject::normalizedSignature( portTo->slotSignalSignature.latin1() + 1 ).constData() );
+
+    if( signalIndex < 0 || methodIndex < 0 ) {
+      ++m_statistics.directConnections;
+      continue;
+    }
+
+    const auto signal = sender->metaObject()->method( signalIndex );
+    const auto method = receiver->metaObject()->method( methodIndex );
+
+    // an epoch keeps only the latest value of an output: chunks of a byte stream would get lost that way, so they
+    // stay direct like the unknown types, which can't be copied
+    bool schedulable = signal.parameterCount() <= maxArguments;
+
+    for( int i = 0; i < signal.parameterCount(); ++i ) {
+      if( signal.parameterType( i ) == QMetaType::UnknownType || signal.parameterType( i ) == QMetaType::QByteArray ) {
+        schedulable = false;
+      }
+    }
+
+    if( !schedulable ) {
+      ++m_statistics.directConnections;
+      continue;
+    }
+
+    const auto key = qMakePair( sender, signalIndex );
+
+    if( !outputForSignal.contains( key ) ) {
+      outputForSignal.insert( key, outputs.size() );
+      outputs.emplace_back();
+
+      auto& output = outputs.back();
+      output.sender = sender;
+      output.signal = signal;
+
+      for( int i = 0; i < signal.parameterCount(); ++i ) {
+        output.types.push_back( signal.parameterType( i ) );
+        output.values.push_back( QMetaType::create( signal.parameterType( i ) ) );
+      }
+    }
+
+    const auto outputIndex = outputForSignal.value( key );
+
+    Input input;
+    input.receiver = receiver;
+    input.methodIndex = methodIndex;
+    input.argumentCount = std::min( method.parameterCount(), signal.parameterCount() );
+    input.output = outputIndex;
+    // the node is set after sorting
+    input.node = nodeTo;
+
+    outputs[outputIndex].inputs.push_back( inputs.size() );
+    inputs.push_back( input );
+
+    connection->setScheduler( this );
+    scheduledConnections.push_back( connection );
+  }
+
+  // Kahn's algorithm; the ready nodes are taken in the order of their id, so the order is the same on every load
+  std::vector<std::size_t> order;
+  order.reserve( nodes.size() );
+  {
+    auto compareIds = [&idOfNode]( const std::size_t lhs, const std::size_t rhs ) {
+      return idOfNode[lhs] < idOfNode[rhs];
+    };
+    std::set<std::size_t, decltype( compareIds )> ready( compareIds );
+
+    for( std::size_t node = 0; node < nodes.size(); ++node ) {
+      if( inDegree[node] == 0 ) {
+        ready.insert( node );
+      }
+    }
+
+    while( !ready.empty() ) {
+      const auto node = *ready.begin();
+      ready.erase( ready.begin() );
+      order.push_back( node );
+
+      for( const auto successor : successors[node] ) {
+        if( --inDegree[successor] == 0 ) {
+          ready.insert( successor );
+        }
+      }
+    }
+
+    // the blocks in cycles are executed last, the feedback is delivered in the next epoch
+    std::vector<std::size_t> remaining;
+
+    for( std::size_t node = 0; node < nodes.size(); ++node ) {
+      if( inDegree[node] > 0 ) {
+        remaining.push_back( node );
+      }
+    }
+
+    std::sort( remaining.begin(), remaining.end(), compareIds );
+    m_statistics.blocksInCycles = int( remaining.size() );
+    order.insert( order.end(), remaining.cbegin(), remaining.cend() );
+  }
+
+  // renumber the nodes in execution order
+  {
+    std::vector<std::size_t> positionOfNode( nodes.size() );
+    std::vector<Node> sortedNodes( nodes.size() );
+
+    for( std::size_t position = 0; position < order.size(); ++position ) {
+      positionOfNode[order[position]] = position;
+      sortedNodes[position].block = nodes[order[position]].block;
+    }
+
+    for( std::size_t i = 0; i < inputs.size(); ++i ) {
+      inputs[i].node = positionOfNode[inputs[i].node];
+      sortedNodes[inputs[i].node].inputs.push_back( i );
+    }
+
+    nodes = std::move( sortedNodes );
+  }
+
+  for( std::size_t i = 0; i < outputs.size(); ++i ) {
+    outputs[i].connection = QMetaObject::connect( outputs[i].sender, outputs[i].signal.methodIndex(),
+                            catcher, QObject::staticMetaObject.methodCount() + int( i ),
+                            Qt::DirectConnection, nullptr );
+  }
+
+  m_statistics.blocks = int( nodes.size() );
+  m_statistics.scheduledConnections = int( inputs.size() );
+
+  return !inputs.empty();
+}
+
+bool DataflowScheduler::isCompiled() const {
+  return !inputs.empty();
+}
+
+const DataflowScheduler::Statistics& DataflowScheduler::statistics() const {
+  return m_statistics;
+}
+
+void DataflowScheduler::resetStatistics() {
+  m_statistics.epochs = 0;
+  m_statistics.executions = 0;
+  m_statistics.lastEpochNs = 0;
+  m_statistics.maxEpochNs = 0;
+  m_statistics.meanEpochNs = 0;
+}
+
+QStringList DataflowScheduler::executionOrder() const {
+  QStringList names;
+
+  for( const auto& node : nodes ) {
+    names << node.block->getName();
+  }
+
+  return names;
+}
+
+void DataflowScheduler::clear() {
+  for( auto& output : outputs ) {
+    QObject::disconnect( output.connection );
+
+    for( std::size_t i = 0; i < output.types.size(); ++i ) {
+      QMetaType::destroy( output.types[i], output.values[i] );
+    }
+  }
+
+  for( auto* connection : scheduledConnections ) {
+    connection->setScheduler( nullptr );
+  }
+
+  outputs.clear();
+  inputs.clear();
+  nodes.clear();
+  scheduledConnections.clear();
+
+  dirtyNodes = 0;
+  m_statistics = Statistics();
+}
+
+void DataflowScheduler::connectionRemoved( void* connection ) {
+  scheduledConnections.erase( std::remove( scheduledConnections.begin(), scheduledConnections.end(), connection ),
+                              scheduledConnections.end() );
+
+  // the graph changed, so fall back to the direct connections
+  if( !inputs.empty() ) {
+    clear();
+  }
+}
+
+void DataflowScheduler::capture( const std::size_t outputIndex, void** arguments ) {
+  if( outputIndex >= outputs.size() ) {
+    return;
+  }
+
+  auto& output = outputs[outputIndex];
+
+  // keep only the latest values; as they are constructed in place, no allocation is needed
+  for( std::size_t i = 0; i < output.types.size(); ++i ) {
+    QMetaType::destruct( output.types[i], output.values[i] );
+    QMetaType::construct( output.types[i], output.values[i], arguments[i + 1] );
+  }
+
+  output.timestamp = MeasurementTimestamp::current();
+
+  if( BlockProfiler::isEnabled() ) {
+    BlockProfiler::recordEmit( output.sender, int( output.inputs.size() ) );
+  }
+
+  for( const auto inputIndex : output.inputs ) {
+    markDirty( inputIndex );
+  }
+
+  if( !inEpoch ) {
+    runEpoch();
+  }
+}
+
+void DataflowScheduler::markDirty( const std::size_t inputIndex ) {
+  auto& input = inputs[inputIndex];
+  input.dirty = true;
+
+  auto& node = nodes[input.node];
+
+  if( !node.dirty ) {
+    node.dirty = true;
+    ++dirtyNodes;
+  }
+
+  // the block already ran in this epoch: feedback for the next one
+  if( inEpoch && input.node <= currentNode && !epochQueued ) {
+    epochQueued = true;
+    QMetaObject::invokeMethod( this, [this] {
+      epochQueued = false;
+
+      if( !inEpoch ) {
+        runEpoch();
+      }
+    }, Qt::QueuedConnection );
+  }
+}
+
+void DataflowScheduler::runEpoch() {
+  if( dirtyNodes == 0 ) {
+    return;
+  }
+
+  inEpoch = true;
+  epochTimer.start();
+
+  for( currentNode = 0; currentNode < nodes.size() && dirtyNodes > 0; ++currentNode ) {
+    auto& node = nodes[currentNode];
+
+    if( !node.dirty ) {
+      continue;
+    }
+
+    node.dirty = false;
+    --dirtyNodes;
+    ++m_statistics.executions;
+
+    for( const auto inputIndex : node.inputs ) {
+      auto& input = inputs[inputIndex];
+
+      if( !input.dirty ) {
+        continue;
+      }
+
+      input.dirty = false;
+
+      if( input.receiver.isNull() ) {
+        continue;
+      }
+
+      const auto& output = outputs[input.output];
+
+      std::array<void*, maxArguments + 1> arguments = {};
+
+      for( int i = 0; i < input.argumentCount; ++i ) {
+        arguments[std::size_t( i + 1 )] = output.values[std::size_t( i )];
+      }
+
+      MeasurementTimestamp::Scope timestampScope( output.timestamp );
+      BlockProfiler::Scope scope( input.receiver );
+      QMetaObject::metacall( input.receiver, QMetaObject::InvokeMetaMethod, input.methodIndex, arguments.data() );
+    }
+  }
+
+  // the nodes, that got dirty by feedback, stay dirty for the next epoch
+  currentNode = nodes.size();
+  inEpoch = false;
+
+  const auto nanoseconds = epochTimer.nsecsElapsed();
+  ++m_statistics.epochs;
+  m_statistics.lastEpochNs = nanoseconds;
+  m_statistics.maxEpochNs = std::max( m_statistics.maxEpochNs, nanoseconds );
+  m_statistics.meanEpochNs += ( double( nanoseconds ) - m_statistics.meanEpochNs ) / double( m_statistics.epochs );
+
+  Q_EMIT epochFinished( nanoseconds );
+}
@@ -0,0 +1,132 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QMetaMethod>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QStringList>
+
+#include "MeasurementTimestamp.h"
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+class QNEBlock;
+class QNEConnection;
+class DataflowSignalCatcher;
+
+// optional execution engine for the block graph: the graph of a saved config is sorted topologically and its
+// connections are routed through the scheduler instead of connecting the signals directly to the slots.
+// The scheduler keeps the latest values of each output and executes the blocks in dependency order, each at
+// most once per epoch; an epoch is started by an emit from outside of an epoch (sources, GUI, timers).
+// Connections back to a block that already ran in this epoch (cycles) are delivered in the next epoch.
+class DataflowScheduler : public QObject {
+    Q_OBJECT
+
+  public:
+    struct Statistics {
+      uint64_t epochs = 0;
+      uint64_t executions = 0;
+      qint64 lastEpochNs = 0;
+      qint64 maxEpochNs = 0;
+      double meanEpochNs = 0;
+
+      int blocks = 0;
+      int scheduledConnections = 0;
+      // connections with types unknown to the meta type system stay direct connections
+      int directConnections = 0;
+      int blocksInCycles = 0;
+    };
+
+  public:
+    explicit DataflowScheduler( QObject* parent = nullptr );
+    ~DataflowScheduler();
+
+    // blockForId maps the ids used in the json to the blocks in the scene; returns false if nothing could be scheduled
+    bool compile( const QJsonObject& json, const std::function<QNEBlock*( int )>& blockForId );
+    bool isCompiled() const;
+
+    const Statistics& statistics() const;
+    void resetStatistics();
+
+    // the names of the blocks in execution order
+    QStringList executionOrder() const;
+
+  public Q_SLOTS:
+    // restores the direct connections
+    void clear();
+
+    // called by QNEConnection on deletion; the graph changed, so the schedule is dropped
+    void connectionRemoved( void* connection );
+
+  Q_SIGNALS:
+    void epochFinished( qint64 nanoseconds );
+
+  private:
+    friend class DataflowSignalCatcher;
+
+    void capture( const std::size_t outputIndex, void** arguments );
+    void runEpoch();
+    void markDirty( const std::size_t inputIndex );
+
+    struct Output {
+      QPointer<QObject> sender;
+      QMetaMethod signal;
+      // the latest values, constructed in place on every emit
+      std::vector<int> types;
+      std::vector<void*> values;
+      MeasurementTimestamp timestamp;
+      std::vector<std::size_t> inputs;
+      QMetaObject::Connection connection;
+    };
+
+    struct Input {
+      QPointer<QObject> receiver;
+      int methodIndex = -1;
+      int argumentCount = 0;
+      std::size_t output = 0;
+      std::size_t node = 0;
+      bool dirty = false;
+    };
+
+    struct Node {
+      QNEBlock* block = nullptr;
+      std::vector<std::size_t> inputs;
+      bool dirty = false;
+    };
+
+    std::vector<Output> outputs;
+    std::vector<Input> inputs;
+    std::vector<Node> nodes;
+    std::vector<QNEConnection*> scheduledConnections;
+
+    DataflowSignalCatcher* catcher = nullptr;
+
+    bool inEpoch = false;
+    bool epochQueued = false;
+    std::size_t currentNode = 0;
+    std::size_t dirtyNodes = 0;
+
+    QElapsedTimer epochTimer;
+    Statistics m_statistics;
+};
@@ -0,0 +1,309 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "DeliveryPolicies.h"
+#include "BlockProfiler.h"
+#include "MeasurementTimestamp.h"
+
+#include "qneblock.h"
+#include "qneport.h"
+#include "qneconnection.h"
+
+#include <QGraphicsScene>
+#include <QMetaMethod>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+// receives a signal like QSignalSpy and keeps the latest arguments; the sender might be on another thread, so the
+// values are exchanged under a lock. The relay lives on the thread of the receiver and delivers there.
+class CoalescingRelay : public QObject {
+  public:
+    CoalescingRelay( QObject* sender, const QMetaMethod& signal, QObject* receiver, const int methodIndex, const int argumentCount,
+                     const QNEConnection::DeliveryPolicy policy, const double maxRateHz )
+      : sender( sender ), signal( signal ), receiver( receiver ), methodIndex( methodIndex ), argumentCount( argumentCount ),
+        policy( policy ), periodMs( int( std::ceil( 1000. / std::max( maxRateHz, 0.001 ) ) ) ) {
+      for( int i = 0; i < signal.parameterCount(); ++i ) {
+        types.push_back( signal.parameterType( i ) );
+        pending.push_back( QMetaType::create( signal.parameterType( i ) ) );
+        delivering.push_back( QMetaType::create( signal.parameterType( i ) ) );
+      }
+
+      timer = new QTimer( this );
+      timer->setSingleShot( true );
+      timer->setTimerType( Qt::PreciseTimer );
+      QObject::connect( timer, &QTimer::timeout, [this] {
+        deliver();
+      } );
+    }
+
+    ~CoalescingRelay() {
+      detach();
+
+      for( std::size_t i = 0; i < types.size(); ++i ) {
+        QMetaType::destroy( types[i], pending[i] );
+        QMetaType::destroy( types[i], delivering[i] );
+      }
+    }
+
+    bool attach() {
+      connection = QMetaObject::connect( sender, signal.methodIndex(),
+                                         this, QObject::staticMetaObject.methodCount(),
+                                         Qt::DirectConnection, nullptr );
+      return bool( connection );
+    }
+
+    void detach() {
+      active = false;
+      QObject::disconnect( connection );
+    }
+
+    QNEConnection::DeliveryPolicy deliveryPolicy() const {
+      return policy;
+    }
+
+    int qt_metacall( QMetaObject::Call call, int id, void** arguments ) override {
+      id = QObject::qt_metacall( call, id, arguments );
+
+      if( id < 0 ) {
+        return id;
+      }
+
+      if( call == QMetaObject::InvokeMetaMethod && id == 0 ) {
+        capture( arguments );
+      }
+
+      return -1;
+    }
+
+    // on the thread of the receiver
+    void deliver() {
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+        wakeupPending = false;
+
+        if( !hasPending ) {
+          return;
+        }
+
+        // both hold constructed values, so swapping the pointers is enough
+        std::swap( pending, delivering );
+        deliveringTimestamp = pendingTimestamp;
+        hasPending = false;
+      }
+
+      if( !active || receiver.isNull() ) {
+        return;
+      }
+
+      sinceDelivery.start();
+
+      std::array<void*, 11> slotArguments = {};
+
+      for( int i = 0; i < argumentCount && i < 10; ++i ) {
+        slotArguments[std::size_t( i + 1 )] = delivering[std::size_t( i )];
+      }
+
+      MeasurementTimestamp::Scope timestampScope( deliveringTimestamp );
+      BlockProfiler::Scope scope( receiver );
+      QMetaObject::metacall( receiver, QMetaObject::InvokeMetaMethod, methodIndex, slotArguments.data() );
+    }
+
+  private:
+    // on the thread of the sender
+    void capture( void** arguments ) {
+      if( !active ) {
+        return;
+      }
+
+      bool wakeup = false;
+
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+
+        for( std::size_t i = 0; i < types.size(); ++i ) {
+          QMetaType::destruct( types[i], pending[i] );
+          QMetaType::construct( types[i], pending[i], arguments[i + 1] );
+        }
+
+        pendingTimestamp = MeasurementTimestamp::current();
+        hasPending = true;
+
+        // the values per frame are picked up by DeliveryPolicies::frameSwapped()
+        if( policy == QNEConnection::DeliveryPolicy::RateLimited && !wakeupPending ) {
+          wakeupPending = true;
+          wakeup = true;
+        }
+      }
+
+      if( wakeup ) {
+        if( QThread::currentThread() == thread() ) {
+          schedule();
+        } else {
+          QMetaObject::invokeMethod( this, [this] {
+            schedule();
+          }, Qt::QueuedConnection );
+        }
+      }
+    }
+
+    // on the thread of the receiver: the first value after a pause is delivered at once, the following ones with the
+    // period of the rate
+    void schedule() {
+      const qint64 remainingMs = sinceDelivery.isValid() ? periodMs - sinceDelivery.elapsed() : 0;
+
+      if( remainingMs <= 0 ) {
+        deliver();
+      } else {
+        timer->start( int( remainingMs ) );
+      }
+    }
+
+  private:
+    QObject* sender = nullptr;
+    QMetaMethod signal;
+    QPointer<QObject> receiver;
+    int methodIndex = -1;
+    int argumentCount = 0;
+
+    QNEConnection::DeliveryPolicy policy = QNEConnection::DeliveryPolicy::EveryValue;
+    int periodMs = 0;
+
+    std::vector<int> types;
+
+    std::mutex mutex;
+    std::vector<void*> pending;
+    std::vector<void*> delivering;
+    MeasurementTimestamp pendingTimestamp;
+    MeasurementTimestamp deliveringTimestamp;
+    bool hasPending = false;
+    bool wakeupPending = false;
+
+    QTimer* timer = nullptr;
+    QElapsedTimer sinceDelivery;
+    std::atomic<bool> active = { true };
+
+    QMetaObject::Connection connection;
+};
+
+DeliveryPolicies::DeliveryPolicies( QObject* parent )
+  : QObject( parent ) {}
+
+DeliveryPolicies::~DeliveryPolicies() {
+  for( auto* relay : qAsConst( relays ) ) {
+    removeRelay( relay );
+  }
+}
+
+void DeliveryPolicies::removeRelay( CoalescingRelay* relay ) {
+  // the relay and its timer live on the thread of the receiver, so they are deleted there, after the deliveries
+  // already queued for it
+  relay->detach();
+  relay->deleteLater();
+}
+
+void DeliveryPolicies::routeConnections( QGraphicsScene* scene ) {
+  const auto& constRefOfList = scene->items();
+
+  for( const auto& item : constRefOfList ) {
+    auto* connection = qgraphicsitem_cast<QNEConnection*>( item );
+
+    if( connection == nullptr || connection->port2() == nullptr || connection->scheduler() != nullptr ||
+        connection->deliveryPolicy() == QNEConnection::DeliveryPolicy::EveryValue ) {
+      continue;
+    }
+
+    QObject* sender = connection->port1()->block()->object;
+    QObject* receiver = connection->port2()->block()->object;
+
+    // the signatures are the ones of SIGNAL() and SLOT(): the first char is the type of the method
+    const int signalIndex = sender->metaObject()->indexOfMethod(
+                                    QMetaObject::normalizedSignature( connection->port1()->slotSignalSignature.latin1() + 1 ).constData() );
+    const int methodIndex = receiver->metaObject()->indexOfMethod(
+                                    QMetaObject::normalizedSignature( connection->port2()->slotSignalSignature.latin1() + 1 ).constData() );
+
+    if( signalIndex < 0 || methodIndex < 0 ) {
+      continue;
+    }
+
+    const auto signal = sender->metaObject()->method( signalIndex );
+    const auto method = receiver->metaObject()->method( methodIndex );
+
+    // dropping chunks of a byte stream would corrupt it; unknown types can't be copied
+    bool coalescable = signal.parameterCount() <= 10;
+
+    for( int i = 0; i < signal.parameterCount(); ++i ) {
+      if( signal.parameterType( i ) == QMetaType::UnknownType || signal.parameterType( i ) == QMetaType::QByteArray ) {
+        coalescable = false;
+      }
+    }
+
+    if( !coalescable ) {
+      continue;
+    }
+
+    auto* relay = new CoalescingRelay( sender, signal, receiver, methodIndex,
+                 std::min( method.parameterCount(), signal.parameterCount() ),
+                 connection->deliveryPolicy(), connection->maxRateHz() );
+    relay->moveToThread( receiver->thread() );
+
+    connection->setScheduler( this );
+
+    if( relay->attach() ) {
+      relays.insert( connection, relay );
+    } else {
+      connection->setScheduler( nullptr );
+      relay->deleteLater();
+    }
+  }
+}
+
+int DeliveryPolicies::numRelays() const {
+  return relays.size();
+}
+
+void DeliveryPolicies::frameSwapped() {
+  // a slot might change the graph, so iterate over a copy
+  const auto relaysToDeliver = relays.values();
+
+  for( auto* relay : relaysToDeliver ) {
+    if( relay->deliveryPolicy() == QNEConnection::DeliveryPolicy::LatestPerFrame ) {
+      if( relay->thread() == thread() ) {
+        relay->deliver();
+      } else {
+        QMetaObject::invokeMethod( relay, [relay] {
+          relay->deliver();
+        }, Qt::QueuedConnection );
+      }
+    }
+  }
+}
+
+void DeliveryPolicies::connectionRemoved( void* connection ) {
+  auto* relay = relays.take( static_cast<QNEConnection*>( connection ) );
+
+  if( relay != nullptr ) {
+    removeRelay( relay );
+  }
+}
@@ -0,0 +1,54 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QObject>
+#include <QHash>
+
+class QGraphicsScene;
+class QNEConnection;
+class CoalescingRelay;
+
+// carries out the delivery policies of the connections (QNEConnection::DeliveryPolicy): the connections, that don't
+// deliver every value, are routed through relays which keep only the latest value and pass it on at most with the
+// set rate or once per rendered frame. High-rate producers then don't drive the widgets and the 3D models of the
+// consumers with every sensor value.
+class DeliveryPolicies : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit DeliveryPolicies( QObject* parent = nullptr );
+    ~DeliveryPolicies();
+
+    // claims the connections with a policy, that aren't routed yet; call before the other routings
+    void routeConnections( QGraphicsScene* scene );
+
+    int numRelays() const;
+
+  public Q_SLOTS:
+    // delivers the pending values of the connections with DeliveryPolicy::LatestPerFrame
+    void frameSwapped();
+
+    // called by QNEConnection on deletion
+    void connectionRemoved( void* connection );
+
+  private:
+    static void removeRelay( CoalescingRelay* relay );
+
+    QHash<QNEConnection*, CoalescingRelay*> relays;
+};
@@ -0,0 +1,356 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "ExecutionDomains.h"
+#include "BlockProfiler.h"
+#include "MeasurementTimestamp.h"
+
+#include "block/BlockBase.h"
+#include "kinematic/PoseOptions.h"
+
+#include "qneblock.h"
+#include "qneport.h"
+#include "qneconnection.h"
+
+#include <QGraphicsScene>
+#include <QMetaMethod>
+#include <QPointer>
+#include <QDebug>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+
+#ifdef Q_OS_LINUX
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+// receives a signal like QSignalSpy (the method id after the ones of QObject) and hands the latest arguments to the
+// thread of the receiver through a triple buffer: the writer and the reader each own one buffer and exchange it
+// atomically with the one in the middle, so neither of them ever waits; poses with options are one-shot requests and
+// are delivered individually
+class LatestValueRelay : public QObject {
+  public:
+    LatestValueRelay( QObject* sender, const QMetaMethod& signal, QObject* receiver, const int methodIndex, const int argumentCount )
+      : sender( sender ), signal( signal ), receiver( receiver ), methodIndex( methodIndex ), argumentCount( argumentCount ) {
+      for( int i = 0; i < signal.parameterCount(); ++i ) {
+        types.push_back( signal.parameterType( i ) );
+
+        if( signal.parameterType( i ) == qMetaTypeId<PoseOption::Options>() ) {
+          optionsArgument = i;
+        }
+
+        for( auto& buffer : buffers ) {
+          buffer.push_back( QMetaType::create( signal.parameterType( i ) ) );
+        }
+      }
+    }
+
+    ~LatestValueRelay() {
+      detach();
+
+      for( auto& buffer : buffers ) {
+        for( std::size_t i = 0; i < types.size(); ++i ) {
+          QMetaType::destroy( types[i], buffer[i] );
+        }
+      }
+    }
+
+    bool attach() {
+      connection = QMetaObject::connect( sender, signal.methodIndex(),
+                                         this, QObject::staticMetaObject.methodCount(),
+                                         Qt::DirectConnection, nullptr );
+      return bool( connection );
+    }
+
+    void detach() {
+      active = false;
+      QObject::disconnect( connection );
+    }
+
+    int qt_metacall( QMetaObject::Call call, int id, void** arguments ) override {
+      id = QObject::qt_metacall( call, id, arguments );
+
+      if( id < 0 ) {
+        return id;
+      }
+
+      if( call == QMetaObject::InvokeMetaMethod && id == 0 ) {
+        capture( arguments );
+      }
+
+      return -1;
+    }
+
+  private:
+    // on the thread of the sender
+    void capture( void** arguments ) {
+      if( !active ) {
+        return;
+      }
+
+      // a pose with options is a one-shot request, like the calculation of the local offsets, and must not be
+      // overwritten by the ordinary poses arriving with the rate of the sensors: it is delivered on its own
+      if( optionsArgument >= 0 &&
+          *static_cast<const PoseOption::Options*>( arguments[optionsArgument + 1] ) != PoseOption::NoOptions ) {
+        captureEvent( arguments );
+        return;
+      }
+
+      auto& buffer = buffers[std::size_t( writeIndex )];
+
+      for( std::size_t i = 0; i < types.size(); ++i ) {
+        QMetaType::destruct( types[i], buffer[i] );
+        QMetaType::construct( types[i], buffer[i], arguments[i + 1] );
+      }
+
+      timestamps[std::size_t( writeIndex )] = MeasurementTimestamp::current();
+
+      writeIndex = middle.exchange( writeIndex | NewValue ) & IndexMask;
+
+      // only one wake-up per pending value, so the event queue of a stalled receiver doesn't grow
+      if( !wakeupPending.exchange( true ) ) {
+        QMetaObject::invokeMethod( this, [this] {
+          deliver();
+        }, Qt::QueuedConnection );
+      }
+    }
+
+    // on the thread of the sender; the copy of the arguments is owned by the queued call, so it is also freed if the
+    // relay is deleted before the call runs
+    void captureEvent( void** arguments ) {
+      auto* values = new std::vector<void*>();
+
+      for( std::size_t i = 0; i < types.size(); ++i ) {
+        values->push_back( QMetaType::create( types[i], arguments[i + 1] ) );
+      }
+
+      std::shared_ptr<std::vector<void*>> event( values, [types = types]( std::vector<void*>* values ) {
+        for( std::size_t i = 0; i < types.size(); ++i ) {
+          QMetaType::destroy( types[i], ( *values )[i] );
+        }
+
+        delete values;
+      } );
+      const auto timestamp = MeasurementTimestamp::current();
+
+      QMetaObject::invokeMethod( this, [this, event, timestamp] {
+        if( active && !receiver.isNull() ) {
+          invokeReceiver( *event, timestamp );
+        }
+      }, Qt::QueuedConnection );
+    }
+
+    // on the thread of the receiver
+    void invokeReceiver( const std::vector<void*>& values, const MeasurementTimestamp& timestamp ) {
+      std::array<void*, 11> slotArguments = {};
+
+      for( int i = 0; i < argumentCount && i < 10; ++i ) {
+        slotArguments[std::size_t( i + 1 )] = values[std::size_t( i )];
+      }
+
+      MeasurementTimestamp::Scope timestampScope( timestamp );
+      BlockProfiler::Scope scope( receiver );
+      QMetaObject::metacall( receiver, QMetaObject::InvokeMetaMethod, methodIndex, slotArguments.data() );
+    }
+
+    // on the thread of the receiver, as the relay lives there
+    void deliver() {
+      wakeupPending = false;
+
+      if( !active || !( middle.load() & NewValue ) ) {
+        return;
+      }
+
+      readIndex = middle.exchange( readIndex ) & IndexMask;
+
+      if( receiver.isNull() ) {
+        return;
+      }
+
+      invokeReceiver( buffers[std::size_t( readIndex )], timestamps[std::size_t( readIndex )] );
+    }
+
+  private:
+    static constexpr int IndexMask = 0x3;
+    static constexpr int NewValue = 0x4;
+
+    QObject* sender = nullptr;
+    QMetaMethod signal;
+    QPointer<QObject> receiver;
+    int methodIndex = -1;
+    int argumentCount = 0;
+    // the argument of the type PoseOption::Options or -1
+    int optionsArgument = -1;
+
+    std::vector<int> types;
+    std::array<std::vector<void*>, 3> buffers;
+    std::array<MeasurementTimestamp, 3> timestamps;
+
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<int> middle = { 2 };
+    std::atomic<bool> wakeupPending = { false };
+    std::atomic<bool> active = { true };
+
+    QMetaObject::Connection connection;
+};
+
+ExecutionDomains::ExecutionDomains( QObject* parent )
+  : QObject( parent ) {}
+
+ExecutionDomains::~ExecutionDomains() {
+  // the deferred deletions of the relays on the realtime thread are carried out when it finishes
+  for( auto* relay : qAsConst( relays ) ) {
+    removeRelay( relay );
+  }
+
+  if( realtimeThread != nullptr ) {
+    realtimeThread->quit();
+    realtimeThread->wait();
+    delete realtimeThread;
+  }
+}
+
+void ExecutionDomains::removeRelay( LatestValueRelay* relay ) {
+  // deleted on the thread of the receiver, where the relay lives and its queued deliveries run
+  relay->detach();
+  relay->deleteLater();
+}
+
+void ExecutionDomains::setRealtimeEnabled( const bool enabled ) {
+  if( enabled && realtimeThread == nullptr ) {
+    realtimeThread = new QThread();
+    realtimeThread->setObjectName( QStringLiteral( "Realtime" ) );
+
+    // runs on the new thread
+    QObject::connect( realtimeThread, &QThread::started, [] {
+#ifdef Q_OS_LINUX
+      // the priorities of QThread have no effect with the default scheduler of linux; SCHED_FIFO needs CAP_SYS_NICE
+      // or an rtprio limit, so this is a best effort
+      sched_param parameter = {};
+      parameter.sched_priority = sched_get_priority_min( SCHED_FIFO ) + 10;
+
+      if( pthread_setschedparam( pthread_self(), SCHED_FIFO, &parameter ) != 0 ) {
+        qDebug() << "ExecutionDomains: SCHED_FIFO not permitted, the realtime thread runs with the default scheduler";
+      }
+
+#endif
+    } );
+
+    realtimeThread->start( QThread::TimeCriticalPriority );
+  }
+}
+
+bool ExecutionDomains::isRealtimeEnabled() const {
+  return realtimeThread != nullptr;
+}
+
+void ExecutionDomains::assign( QNEBlock* block ) {
+  if( realtimeThread == nullptr || block == nullptr ) {
+    return;
+  }
+
+  auto* object = qobject_cast<BlockBase*>( block->object );
+
+  if( object != nullptr &&
+      object->executionDomain() == BlockBase::ExecutionDomain::Realtime &&
+      object->thread() != realtimeThread ) {
+    object->moveToThread( realtimeThread );
+  }
+}
+
+void ExecutionDomains::assignAll( QGraphicsScene* scene ) {
+  const auto& constRefOfList = scene->items();
+
+  for( const auto& item : constRefOfList ) {
+    assign( qgraphicsitem_cast<QNEBlock*>( item ) );
+  }
+}
+
+void ExecutionDomains::routeConnections( QGraphicsScene* scene ) {
+  const auto& constRefOfList = scene->items();
+
+  for( const auto& item : constRefOfList ) {
+    auto* connection = qgraphicsitem_cast<QNEConnection*>( item );
+
+    if( connection == nullptr || connection->port2() == nullptr || connection->scheduler() != nullptr ) {
+      continue;
+    }
+
+    QObject* sender = connection->port1()->block()->object;
+    QObject* receiver = connection->port2()->block()->object;
+
+    if( sender->thread() == receiver->thread() ) {
+      continue;
+    }
+
+    // the signatures are the ones of SIGNAL() and SLOT(): the first char is the type of the method
+    const int signalIndex = sender->metaObject()->indexOfMethod(
+                                    QMetaObject::normalizedSignature( connection->port1()->slotSignalSignature.latin1() + 1 ).constData() );
+    const int methodIndex = receiver->metaObject()->indexOfMethod(
+                                    QMetaObject::normalizedSignature( connection->port2()->slotSignalSignature.latin1() + 1 ).constData() );
+
+    if( signalIndex < 0 || methodIndex < 0 ) {
+      continue;
+    }
+
+    const auto signal = sender->metaObject()->method( signalIndex );
+    const auto method = receiver->metaObject()->method( methodIndex );
+
+    // byte streams and unknown types keep the queued connection of Qt
+    bool latestValueOnly = signal.parameterCount() <= 10;
+
+    for( int i = 0; i < signal.parameterCount(); ++i ) {
+      if( signal.parameterType( i ) == QMetaType::UnknownType || signal.parameterType( i ) == QMetaType::QByteArray ) {
+        latestValueOnly = false;
+      }
+    }
+
+    if( !latestValueOnly ) {
+      continue;
+    }
+
+    auto* relay = new LatestValueRelay( sender, signal, receiver, methodIndex,
+                 std::min( method.parameterCount(), signal.parameterCount() ) );
+    relay->moveToThread( receiver->thread() );
+
+    connection->setScheduler( this );
+
+    if( relay->attach() ) {
+      relays.insert( connection, relay );
+    } else {
+      connection->setScheduler( nullptr );
+      relay->deleteLater();
+    }
+  }
+}
+
+int ExecutionDomains::numRelays() const {
+  return relays.size();
+}
+
+void ExecutionDomains::connectionRemoved( void* connection ) {
+  auto* relay = relays.take( static_cast<QNEConnection*>( connection ) );
+
+  if( relay != nullptr ) {
+    removeRelay( relay );
+  }
+}
@@ -0,0 +1,65 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+
+class QGraphicsScene;
+class QNEBlock;
+class QNEConnection;
+class LatestValueRelay;
+
+// runs the blocks of the sensor/control path (BlockBase::ExecutionDomain::Realtime) on a dedicated thread with elevated
+// priority, so the steering isn't delayed by rendering, plots or dialogs. The connections between the domains are
+// routed through relays which keep only the latest value in a lock-free triple buffer; the receiving thread is woken
+// up at most once per pending value, so a stalled GUI can't pile up events. Byte streams are passed with Qt's queued
+// connections instead, as no chunk may be lost, and so are poses with options like PoseOption::CalculateLocalOffsets.
+class ExecutionDomains : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit ExecutionDomains( QObject* parent = nullptr );
+    ~ExecutionDomains();
+
+    // without the realtime thread, all the blocks stay on the GUI thread
+    void setRealtimeEnabled( const bool enabled );
+    bool isRealtimeEnabled() const;
+
+    // moves the object of the block to the thread of its domain; call before the config signals are emitted
+    void assign( QNEBlock* block );
+    void assignAll( QGraphicsScene* scene );
+
+    // routes the connections between the domains through latest-value relays
+    void routeConnections( QGraphicsScene* scene );
+
+    int numRelays() const;
+
+  public Q_SLOTS:
+    // called by QNEConnection on deletion
+    void connectionRemoved( void* connection );
+
+  private:
+    static void removeRelay( LatestValueRelay* relay );
+
+    QThread* realtimeThread = nullptr;
+
+    QHash<QNEConnection*, LatestValueRelay*> relays;
+};
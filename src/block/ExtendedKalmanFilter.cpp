@@ -31,6 +31,8 @@
 
 #include "kalman/ExtendedKalmanFilter.hpp"
 
+#include <algorithm>
+
 ExtendedKalmanFilter::ExtendedKalmanFilter() {
   x.setZero();
   ekf.init( x );
@@ -81,6 +83,18 @@ void ExtendedKalmanFilter::predict() {
   constexpr double msPerS = 1000;
   double elapsedTime = double ( elapsedTimer.restart() ) / msPerS;
 
+  const auto& timestamp = MeasurementTimestamp::current();
+  double secondsSinceLastPrediction = 0;
+
+  if( timestamp.secondsSince( lastPredictionTimestamp, secondsSinceLastPrediction ) ) {
+    // a measurement older than the state can't be predicted back to; it is applied to the current state
+    elapsedTime = std::max( secondsSinceLastPrediction, 0. );
+  }
+
+  if( secondsSinceLastPrediction >= 0 ) {
+    lastPredictionTimestamp = timestamp;
+  }
+
   ekf.predict( systemModel, elapsedTime );
 }
 
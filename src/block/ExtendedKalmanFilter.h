@@ -22,6 +22,7 @@
 #include <QElapsedTimer>
 
 #include "BlockBase.h"
+#include "MeasurementTimestamp.h"
 
 #include "helpers/eigenHelper.h"
 #include "kinematic/PoseOptions.h"
@@ -41,6 +42,10 @@ class ExtendedKalmanFilter : public BlockBase {
   public:
     explicit ExtendedKalmanFilter();
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setPosition( const Eigen::Vector3d& position );
 
@@ -78,6 +83,10 @@ class ExtendedKalmanFilter : public BlockBase {
     KinematicModel::ImuMeasurement<double, State, KinematicModel::ImuMeasurementVector> imuMeasumentModel;
 
     QElapsedTimer elapsedTimer;
+
+    // the timestamp of the last prediction; if the measurements carry one, the filter predicts to their time of
+    // validity instead of their time of arrival
+    MeasurementTimestamp lastPredictionTimestamp;
 };
 
 class ExtendedKalmanFilterFactory : public BlockFactory {
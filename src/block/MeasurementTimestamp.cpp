@@ -0,0 +1,149 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "MeasurementTimestamp.h"
+
+#include <QDateTime>
+
+#include "helpers/charconvHelper.h"
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+
+namespace {
+  thread_local MeasurementTimestamp currentTimestamp;
+
+  // seconds until the time base wraps around
+  double periodOfTimeBase( const MeasurementTimestamp::TimeBase timeBase ) {
+    switch( timeBase ) {
+      case MeasurementTimestamp::TimeBase::GpsTimeOfWeek:
+        return 7 * 24 * 3600;
+
+      case MeasurementTimestamp::TimeBase::UtcTimeOfDay:
+        return 24 * 3600;
+
+      default:
+        return 0;
+    }
+  }
+}
+
+bool MeasurementTimestamp::secondsSince( const MeasurementTimestamp& earlier, double& seconds ) const {
+  if( hasValidity() && timeBase == earlier.timeBase ) {
+    seconds = validitySeconds - earlier.validitySeconds;
+
+    // the wrap-around of the week or the day between the two
+    const double period = periodOfTimeBase( timeBase );
+
+    if( period > 0 ) {
+      if( seconds < -period / 2 ) {
+        seconds += period;
+      } else if( seconds > period / 2 ) {
+        seconds -= period;
+      }
+    }
+
+    return true;
+  }
+
+  if( isValid() && earlier.isValid() ) {
+    seconds = double( receivedNs - earlier.receivedNs ) * 1e-9;
+    return true;
+  }
+
+  return false;
+}
+
+qint64 MeasurementTimestamp::ageNs() const {
+  return isValid() ? nowNs() - receivedNs : 0;
+}
+
+qint64 MeasurementTimestamp::receivedMSecsSinceEpoch() const {
+  // the offset between the two clocks, taken once
+  static const qint64 offsetMs = QDateTime::currentMSecsSinceEpoch() - nowNs() / 1000000;
+
+  return receivedNs / 1000000 + offsetMs;
+}
+
+qint64 MeasurementTimestamp::nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+MeasurementTimestamp MeasurementTimestamp::received() {
+  MeasurementTimestamp timestamp;
+  timestamp.receivedNs = nowNs();
+  return timestamp;
+}
+
+MeasurementTimestamp MeasurementTimestamp::withValidity( const TimeBase timeBase, const double validitySeconds ) {
+  MeasurementTimestamp timestamp = currentTimestamp;
+
+  if( !timestamp.isValid() ) {
+    timestamp.receivedNs = nowNs();
+  }
+
+  // the time bases of the sensors differ, so the filters would fall back to the times of receipt between them, which
+  // don't match the capture if it isn't replayed in real-time
+  if( timestamp.timeBase == TimeBase::Capture ) {
+    return timestamp;
+  }
+
+  timestamp.timeBase = timeBase;
+  timestamp.validitySeconds = validitySeconds;
+  return timestamp;
+}
+
+const MeasurementTimestamp& MeasurementTimestamp::current() {
+  return currentTimestamp;
+}
+
+double MeasurementTimestamp::currentSecsSinceEpoch() {
+  if( currentTimestamp.isValid() ) {
+    return double( currentTimestamp.receivedMSecsSinceEpoch() ) / 1000;
+  }
+
+  return double( QDateTime::currentMSecsSinceEpoch() ) / 1000;
+}
+
+bool MeasurementTimestamp::secondsOfDayFromNmea( const std::string_view field, double& seconds ) {
+  if( field.size() < 6 ) {
+    return false;
+  }
+
+  int hours = 0;
+  int minutes = 0;
+  double secondsOfMinute = 0;
+
+  if( std::from_chars( field.data(), field.data() + 2, hours ).ptr != field.data() + 2 ||
+      std::from_chars( field.data() + 2, field.data() + 4, minutes ).ptr != field.data() + 4 ||
+      !doubleFromChars( field.substr( 4 ), secondsOfMinute ) ) {
+    return false;
+  }
+
+  seconds = hours * 3600 + minutes * 60 + secondsOfMinute;
+  return true;
+}
+
+MeasurementTimestamp::Scope::Scope( const MeasurementTimestamp& timestamp )
+  : previous( currentTimestamp ) {
+  currentTimestamp = timestamp;
+}
+
+MeasurementTimestamp::Scope::~Scope() {
+  currentTimestamp = previous;
+}
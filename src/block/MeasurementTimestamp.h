@@ -0,0 +1,100 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QtGlobal>
+
+#include <cstdint>
+#include <string_view>
+
+// the time of a measurement, carried alongside its values through the block graph. The signals of the blocks only
+// carry values, so the timestamp isn't a parameter: the sources (streams, parsers, simulator) set it for the duration
+// of their emits with a Scope and the slots called by them read it with current(). The relays between the threads and
+// the dataflow scheduler store it with the values and restore it on delivery. Outside of a measurement, current() is
+// invalid and the blocks use their time of arrival as before.
+class MeasurementTimestamp {
+  public:
+    enum class TimeBase : uint8_t {
+      None = 0,
+      // UBX iTOW, wraps every week
+      GpsTimeOfWeek,
+      // NMEA hhmmss.ss, wraps every day
+      UtcTimeOfDay,
+      // the time of the simulation
+      Simulation,
+      // the timeline of a replayed capture; the measurements of all the sources share it, so the intervals between them
+      // are the original ones regardless of the speed of the replay
+      Capture
+    };
+
+    // when the data was received, monotonic in ns of std::chrono::steady_clock; 0 if unknown
+    qint64 receivedNs = 0;
+
+    // the time of validity of the sensor, in seconds of the time base
+    double validitySeconds = 0;
+    TimeBase timeBase = TimeBase::None;
+
+  public:
+    bool isValid() const {
+      return receivedNs != 0;
+    }
+
+    bool hasValidity() const {
+      return timeBase != TimeBase::None;
+    }
+
+    // the seconds from earlier to this; uses the times of validity if both have the same base, else the times of
+    // receipt. Returns false if neither is available for both.
+    bool secondsSince( const MeasurementTimestamp& earlier, double& seconds ) const;
+
+    qint64 ageNs() const;
+
+    // the time of receipt in ms since the epoch, like QDateTime::currentMSecsSinceEpoch()
+    qint64 receivedMSecsSinceEpoch() const;
+
+    static qint64 nowNs();
+
+    // a chunk of data just received, without a time of validity yet
+    static MeasurementTimestamp received();
+
+    // the current timestamp with the time of validity of the sensor added; the time of receipt is kept, or set to now
+    // if the data didn't come through a stream. The timeline of a replayed capture is kept as the time of validity
+    static MeasurementTimestamp withValidity( const TimeBase timeBase, const double validitySeconds );
+
+    // the timestamp of the measurement being processed on this thread
+    static const MeasurementTimestamp& current();
+
+    // the time of receipt of the current measurement in s since the epoch, or the time now without one; for the plots
+    static double currentSecsSinceEpoch();
+
+    // hhmmss.ss of NMEA to seconds of the day
+    static bool secondsOfDayFromNmea( const std::string_view field, double& seconds );
+
+    // sets the current timestamp for the lifetime of the scope; they can be nested
+    class Scope {
+      public:
+        explicit Scope( const MeasurementTimestamp& timestamp );
+        ~Scope();
+
+        Scope( const Scope& ) = delete;
+        Scope& operator=( const Scope& ) = delete;
+
+      private:
+        MeasurementTimestamp previous;
+    };
+};
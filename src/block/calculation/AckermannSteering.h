@@ -28,6 +28,10 @@ class AckermannSteering : public BlockBase {
   public:
     explicit AckermannSteering() = default;
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setWheelbase( double wheelbase );
 
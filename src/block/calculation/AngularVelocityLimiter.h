@@ -29,6 +29,10 @@ class AngularVelocityLimiter : public BlockBase {
   public:
     explicit AngularVelocityLimiter() = default;
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setMaxAngularVelocity( double maxAngularVelocity );
 
@@ -38,6 +38,10 @@ class TransverseMercatorConverter : public BlockBase {
       : BlockBase(),
         tmw( tmw ) {}
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setWGS84Position( const Eigen::Vector3d& position );
 
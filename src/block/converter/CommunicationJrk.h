@@ -30,6 +30,10 @@ class CommunicationJrk : public BlockBase {
       : BlockBase() {
     }
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   Q_SIGNALS:
     void dataReceived( const QByteArray& );
 
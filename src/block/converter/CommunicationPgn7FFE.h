@@ -29,6 +29,10 @@ class CommunicationPgn7ffe : public BlockBase {
     explicit CommunicationPgn7ffe()
       : BlockBase() {}
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   Q_SIGNALS:
     void  dataReceived( const QByteArray& );
 
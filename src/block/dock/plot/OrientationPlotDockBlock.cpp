@@ -21,6 +21,8 @@
 #include "qneblock.h"
 #include "qneport.h"
 
+#include "block/MeasurementTimestamp.h"
+
 #include "gui/dock/PlotDock.h"
 #include "gui/MyMainWindow.h"
 
@@ -71,7 +73,7 @@ OrientationPlotDockBlock::OrientationPlotDockBlock( const QString& uniqueName, M
 
 void OrientationPlotDockBlock::setOrientation( const Eigen::Quaterniond& orientation ) {
   const auto taitBryanDegrees = radiansToDegrees( quaternionToTaitBryan( orientation ) );
-  double currentSecsSinceEpoch = double( QDateTime::currentMSecsSinceEpoch() ) / 1000;
+  double currentSecsSinceEpoch = MeasurementTimestamp::currentSecsSinceEpoch();
 
   widget->getQCustomPlotWidget()->graph( 0 )->addData( currentSecsSinceEpoch, getRoll( taitBryanDegrees ) );
   widget->getQCustomPlotWidget()->graph( 1 )->addData( currentSecsSinceEpoch, getPitch( taitBryanDegrees ) );
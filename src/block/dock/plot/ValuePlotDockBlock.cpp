@@ -21,6 +21,8 @@
 #include "qneblock.h"
 #include "qneport.h"
 
+#include "block/MeasurementTimestamp.h"
+
 #include "gui/dock/PlotDock.h"
 #include "gui/MyMainWindow.h"
 
@@ -59,7 +61,7 @@ ValuePlotDockBlock::ValuePlotDockBlock( const QString& uniqueName, MyMainWindow*
 }
 
 void ValuePlotDockBlock::addValue0( const double value ) {
-  auto currentSecsSinceEpoch = double( QDateTime::currentMSecsSinceEpoch() ) / 1000;
+  auto currentSecsSinceEpoch = MeasurementTimestamp::currentSecsSinceEpoch();
 
   widget->getQCustomPlotWidget()->graph( 0 )->addData( currentSecsSinceEpoch, value );
 
@@ -67,7 +69,7 @@ void ValuePlotDockBlock::addValue0( const double value ) {
 }
 
 void ValuePlotDockBlock::addValue1( const double value ) {
-  auto currentSecsSinceEpoch = double( QDateTime::currentMSecsSinceEpoch() ) / 1000;
+  auto currentSecsSinceEpoch = MeasurementTimestamp::currentSecsSinceEpoch();
 
   widget->getQCustomPlotWidget()->graph( 1 )->addData( currentSecsSinceEpoch, value );
 
@@ -75,7 +77,7 @@ void ValuePlotDockBlock::addValue1( const double value ) {
 }
 
 void ValuePlotDockBlock::addValue2( const double value ) {
-  auto currentSecsSinceEpoch = double( QDateTime::currentMSecsSinceEpoch() ) / 1000;
+  auto currentSecsSinceEpoch = MeasurementTimestamp::currentSecsSinceEpoch();
 
   widget->getQCustomPlotWidget()->graph( 2 )->addData( currentSecsSinceEpoch, value );
 
@@ -83,7 +85,7 @@ void ValuePlotDockBlock::addValue2( const double value ) {
 }
 
 void ValuePlotDockBlock::addValue3( const double value ) {
-  auto currentSecsSinceEpoch = double( QDateTime::currentMSecsSinceEpoch() ) / 1000;
+  auto currentSecsSinceEpoch = MeasurementTimestamp::currentSecsSinceEpoch();
 
   widget->getQCustomPlotWidget()->graph( 3 )->addData( currentSecsSinceEpoch, value );
 
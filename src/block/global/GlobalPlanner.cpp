@@ -34,6 +34,8 @@
 #include "gui/GlobalPlannerToolbar.h"
 
 #include "3d/BufferMesh.h"
+#include "3d/InstancedSphereMesh.h"
+#include "3d/InstancedPhongMaterial.h"
 
 #include <QFileDialog>
 
@@ -59,14 +61,48 @@ GlobalPlanner::GlobalPlanner( const QString& uniqueName, MyMainWindow* mainWindo
   : tmw( tmw ),
     mainWindow( mainWindow ),
     rootEntity( rootEntity ) {
-  widget = new GlobalPlannerToolbar( mainWindow );
-  dock = new KDDockWidgets::DockWidget( uniqueName );
+  // without a main window (headless), the AB-lines are loaded from files
+  if( mainWindow != nullptr ) {
+    widget = new GlobalPlannerToolbar( mainWindow );
+    dock = new KDDockWidgets::DockWidget( uniqueName );
+
+    QObject::connect( widget, &GlobalPlannerToolbar::setAPoint, this, &GlobalPlanner::setAPoint );
+    QObject::connect( widget, &GlobalPlannerToolbar::setBPoint, this, &GlobalPlanner::setBPoint );
+    QObject::connect( widget, &GlobalPlannerToolbar::setAdditionalPoint, this, &GlobalPlanner::setAdditionalPoint );
+    QObject::connect( widget, &GlobalPlannerToolbar::setAdditionalPointsContinous, this, &GlobalPlanner::setAdditionalPointsContinous );
+    QObject::connect( widget, &GlobalPlannerToolbar::snap, this, &GlobalPlanner::snap );
+  }
+
+  {
+    threadForCgalWorker = new CgalThread( this );
+    cgalWorker = new CgalWorker();
+    cgalWorker->moveToThread( threadForCgalWorker );
+    threadForCgalWorker->start();
+    QObject::connect( this, &GlobalPlanner::requestPolylineSimplification, cgalWorker, &CgalWorker::simplifyPolyline );
+
+    QObject::connect( cgalWorker, &CgalWorker::simplifyPolylineResult, this, &GlobalPlanner::createPlanPolyline );
+  }
+}
+
+GlobalPlanner::~GlobalPlanner() {
+  if( dock != nullptr ) {
+    dock->deleteLater();
+  }
+
+  if( widget != nullptr ) {
+    widget->deleteLater();
+  }
+}
 
-  QObject::connect( widget, &GlobalPlannerToolbar::setAPoint, this, &GlobalPlanner::setAPoint );
-  QObject::connect( widget, &GlobalPlannerToolbar::setBPoint, this, &GlobalPlanner::setBPoint );
-  QObject::connect( widget, &GlobalPlannerToolbar::setAdditionalPoint, this, &GlobalPlanner::setAdditionalPoint );
-  QObject::connect( widget, &GlobalPlannerToolbar::setAdditionalPointsContinous, this, &GlobalPlanner::setAdditionalPointsContinous );
-  QObject::connect( widget, &GlobalPlannerToolbar::snap, this, &GlobalPlanner::snap );
+bool GlobalPlanner::createMarkerEntities() {
+  // without a root entity (headless), nothing is rendered
+  if( rootEntity == nullptr ) {
+    return false;
+  }
+
+  if( aPointEntity != nullptr ) {
+    return true;
+  }
 
   // a point marker -> orange
   {
@@ -138,29 +174,25 @@ GlobalPlanner::GlobalPlanner( const QString& uniqueName, MyMainWindow* mainWindo
   {
     pointsEntity = new Qt3DCore::QEntity( rootEntity );
 
-    pointsMesh = new Qt3DExtras::QSphereMesh( bPointEntity );
+    // all the points of the polyline are drawn with one instanced mesh
+    pointsMesh = new InstancedSphereMesh( pointsEntity );
     pointsMesh->setRadius( .2f );
     pointsMesh->setSlices( 20 );
     pointsMesh->setRings( 20 );
 
-    pointsMaterial = new Qt3DExtras::QPhongMaterial( bPointEntity );
+    pointsMaterial = new InstancedPhongMaterial( pointsEntity );
     pointsMaterial->setDiffuse( QColor( "purple" ) );
-  }
 
-  {
-    threadForCgalWorker = new CgalThread( this );
-    cgalWorker = new CgalWorker();
-    cgalWorker->moveToThread( threadForCgalWorker );
-    threadForCgalWorker->start();
-    QObject::connect( this, &GlobalPlanner::requestPolylineSimplification, cgalWorker, &CgalWorker::simplifyPolyline );
-
-    QObject::connect( cgalWorker, &CgalWorker::simplifyPolylineResult, this, &GlobalPlanner::createPlanPolyline );
+    pointsEntity->addComponent( pointsMesh );
+    pointsEntity->addComponent( pointsMaterial );
+    pointsEntity->setEnabled( false );
   }
-}
 
-GlobalPlanner::~GlobalPlanner() {
-  dock->deleteLater();
-  widget->deleteLater();
+  const auto quat = toQQuaternion( orientation );
+  aPointTransform->setRotation( quat );
+  bPointTransform->setRotation( quat );
+
+  return true;
 }
 
 void GlobalPlanner::setPose( const Eigen::Vector3d& position, const Eigen::Quaterniond& orientation, const PoseOption::Options& options ) {
@@ -168,9 +200,11 @@ void GlobalPlanner::setPose( const Eigen::Vector3d& position, const Eigen::Quate
     this->position = toPoint3( position );
     this->orientation = orientation;
 
-    auto quat = toQQuaternion( orientation );
-    aPointTransform->setRotation( quat );
-    bPointTransform->setRotation( quat );
+    if( aPointEntity != nullptr ) {
+      auto quat = toQQuaternion( orientation );
+      aPointTransform->setRotation( quat );
+      bPointTransform->setRotation( quat );
+    }
 
     auto position2D = to2D( position );
 
@@ -180,8 +214,13 @@ void GlobalPlanner::setPose( const Eigen::Vector3d& position, const Eigen::Quate
 
     //        QElapsedTimer timer;
     //        timer.start();
+    auto version = plan.getVersion();
     plan.expand( position2D );
     //        qDebug() << "Cycle Time plan.expandPlan:" << timer.nsecsElapsed() << "ns";
+
+    if( plan.getVersion() != version ) {
+      Q_EMIT planChanged( plan );
+    }
   }
 }
 
@@ -218,11 +257,13 @@ void GlobalPlanner::setField( std::shared_ptr<Polygon_with_holes_2> field ) {
 }
 
 void GlobalPlanner::setAPoint() {
-  aPointTransform->setTranslation( toQVector3D( position ) );
+  if( createMarkerEntities() ) {
+    aPointTransform->setTranslation( toQVector3D( position ) );
 
-  aPointEntity->setEnabled( true );
-  bPointEntity->setEnabled( false );
-  pointsEntity->setEnabled( false );
+    aPointEntity->setEnabled( true );
+    bPointEntity->setEnabled( false );
+    pointsEntity->setEnabled( false );
+  }
 
   aPoint = position;
   abPolyline.clear();
@@ -230,8 +271,10 @@ void GlobalPlanner::setAPoint() {
 }
 
 void GlobalPlanner::setBPoint() {
-  bPointTransform->setTranslation( toQVector3D( position ) );
-  bPointEntity->setEnabled( true );
+  if( createMarkerEntities() ) {
+    bPointTransform->setTranslation( toQVector3D( position ) );
+    bPointEntity->setEnabled( true );
+  }
 
   bPoint = position;
   abPolyline.push_back( to2D( position ) );
@@ -260,41 +303,36 @@ void GlobalPlanner::snap() {
 
 void GlobalPlanner::createPlanPolyline( std::vector<Point_2>* polylinePtr ) {
   std::unique_ptr<std::vector<Point_2>> polyline( polylinePtr );
+  const bool hasMarkers = createMarkerEntities();
   Point_2 position2D = to2D( position );
 
   if( polyline->size() > 2 ) {
-    aPointEntity->setEnabled( false );
-    bPointEntity->setEnabled( false );
-    widget->setToolbarToAdditionalPoint();
-
-    for( const auto& child : qAsConst( pointsEntity->children() ) ) {
-      if( auto* childPtr = qobject_cast<Qt3DCore::QEntity*>( child ) ) {
-        childPtr->setEnabled( false );
-        childPtr->deleteLater();
-      }
-    }
+    if( hasMarkers ) {
+      aPointEntity->setEnabled( false );
+      bPointEntity->setEnabled( false );
 
-    for( const auto& point : *polyline ) {
-      auto* entity = new Qt3DCore::QEntity( pointsEntity );
+      QVector<QVector3D> positions;
+      positions.reserve( int( polyline->size() ) );
 
-      auto* transform = new Qt3DCore::QTransform( entity );
-      transform->setTranslation( toQVector3D( point ) );
+      for( const auto& point : *polyline ) {
+        positions << toQVector3D( point );
+      }
 
-      entity->addComponent( pointsMaterial );
-      entity->addComponent( pointsMesh );
-      entity->addComponent( transform );
+      pointsMesh->setPositions( positions );
 
-      entity->setEnabled( true );
+      pointsEntity->setEnabled( true );
     }
 
-    pointsEntity->setEnabled( true );
+    if( widget != nullptr ) {
+      widget->setToolbarToAdditionalPoint();
+    }
 
     plan.resetPlanWith( make_shared<PathPrimitiveSequence>(
                                 *polyline,
                                 std::sqrt( implementSegment.squared_length() ),
                                 true,
                                 0 ) );
-
+    plan.expand( position2D );
 
     Q_EMIT planChanged( plan );
   }
@@ -304,24 +342,26 @@ void GlobalPlanner::createPlanPolyline( std::vector<Point_2>* polylinePtr ) {
     bPoint = to3D( polyline->back() );
     abSegment = Segment_3( aPoint, bPoint );
 
-    aPointTransform->setTranslation( toQVector3D( aPoint ) );
-    bPointTransform->setTranslation( toQVector3D( bPoint ) );
-    aPointEntity->setEnabled( true );
-    bPointEntity->setEnabled( true );
+    if( hasMarkers ) {
+      aPointTransform->setTranslation( toQVector3D( aPoint ) );
+      bPointTransform->setTranslation( toQVector3D( bPoint ) );
+      aPointEntity->setEnabled( true );
+      bPointEntity->setEnabled( true );
+    }
 
-    widget->setToolbarToAdditionalPoint();
+    if( widget != nullptr ) {
+      widget->setToolbarToAdditionalPoint();
+    }
 
     plan.resetPlanWith( make_shared<PathPrimitiveLine>(
                                 to2D( abSegment ).supporting_line(),
                                 std::sqrt( implementSegment.squared_length() ),
                                 true,
                                 0 ) );
+    plan.expand( position2D );
 
     Q_EMIT planChanged( plan );
   }
-
-  plan.expand( position2D );
-
 }
 
 void GlobalPlanner::createPlanAB() {
@@ -367,13 +407,17 @@ void GlobalPlanner::snapPlanAB() {
     bPoint = bPoint.transform( transformation3D );
     abSegment = Segment_3( aPoint, bPoint );
 
-    aPointTransform->setTranslation( toQVector3D( aPoint ) );
-    bPointTransform->setTranslation( toQVector3D( bPoint ) );
+    if( createMarkerEntities() ) {
+      aPointTransform->setTranslation( toQVector3D( aPoint ) );
+      bPointTransform->setTranslation( toQVector3D( bPoint ) );
+    }
 
 //    QElapsedTimer timer;
 //    timer.start();
     plan.transform( transformation2D );
 //    qDebug() << "Cycle Time Snap:" << timer.nsecsElapsed() << "ns";
+
+    Q_EMIT planChanged( plan );
   }
 }
 
@@ -443,6 +487,8 @@ void GlobalPlanner::openAbLineFromFile( QFile& file ) {
   auto geoJsonHelper = GeoJsonHelper( file );
   geoJsonHelper.print();
 
+  const bool hasMarkers = createMarkerEntities();
+
   for( const auto& member : geoJsonHelper.members ) {
     switch( member.first ) {
       case GeoJsonHelper::GeometryType::LineString: {
@@ -454,14 +500,21 @@ void GlobalPlanner::openAbLineFromFile( QFile& file ) {
 
           if( index == 0 ) {
             aPoint = tmwPoint;
-            aPointTransform->setTranslation( toQVector3D( tmwPoint ) );
+
+            if( hasMarkers ) {
+              aPointTransform->setTranslation( toQVector3D( tmwPoint ) );
+            }
           }
 
           if( index == 1 ) {
             bPoint = tmwPoint;
-            bPointTransform->setTranslation( toQVector3D( tmwPoint ) );
-            aPointEntity->setEnabled( true );
-            bPointEntity->setEnabled( true );
+
+            if( hasMarkers ) {
+              bPointTransform->setTranslation( toQVector3D( tmwPoint ) );
+              aPointEntity->setEnabled( true );
+              bPointEntity->setEnabled( true );
+            }
+
             abSegment = Segment_3( aPoint, tmwPoint );
           }
 
@@ -483,7 +536,9 @@ void GlobalPlanner::openAbLineFromFile( QFile& file ) {
 }
 
 void GlobalPlanner::newField() {
-  widget->resetToolbar();
+  if( widget != nullptr ) {
+    widget->resetToolbar();
+  }
   abPolyline.clear();
 }
 
@@ -564,12 +619,14 @@ QNEBlock* GlobalPlannerFactory::createBlock( QGraphicsScene* scene, int id ) {
                                     rootEntity );
   auto* b = createBaseBlock( scene, object, id, true );
 
-  object->dock->setTitle( QStringLiteral( "Global Planner" ) );
-  object->dock->setWidget( object->widget );
+  if( object->dock != nullptr ) {
+    object->dock->setTitle( QStringLiteral( "Global Planner" ) );
+    object->dock->setWidget( object->widget );
 
-  menu->addAction( object->dock->toggleAction() );
+    menu->addAction( object->dock->toggleAction() );
 
-  mainWindow->addDockWidget( object->dock, location );
+    mainWindow->addDockWidget( object->dock, location );
+  }
 
   b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ) );
   b->addInputPort( QStringLiteral( "Pose Left Edge" ), QLatin1String( SLOT( setPoseLeftEdge( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ) );
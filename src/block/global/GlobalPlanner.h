@@ -36,6 +36,8 @@ class MyMainWindow;
 class FieldsOptimitionToolbar;
 class GlobalPlannerToolbar;
 class BufferMesh;
+class InstancedSphereMesh;
+class InstancedPhongMaterial;
 class GeographicConvertionWrapper;
 class Plan;
 class PlanGlobal;
@@ -149,6 +151,9 @@ class GlobalPlanner : public BlockBase {
     uint32_t runNumber = 0;
 
   private:
+    // the markers are created when they are first shown; returns false without a root entity
+    bool createMarkerEntities();
+
     QWidget* mainWindow = nullptr;
     Qt3DCore::QEntity* rootEntity = nullptr;
 
@@ -166,8 +171,8 @@ class GlobalPlanner : public BlockBase {
     Qt3DCore::QTransform* bTextTransform = nullptr;
 
     Qt3DCore::QEntity* pointsEntity = nullptr;
-    Qt3DExtras::QSphereMesh* pointsMesh = nullptr;
-    Qt3DExtras::QPhongMaterial* pointsMaterial = nullptr;
+    InstancedSphereMesh* pointsMesh = nullptr;
+    InstancedPhongMaterial* pointsMaterial = nullptr;
 
   private:
     Qt3DCore::QEntity* m_baseEntity = nullptr;
@@ -27,7 +27,9 @@
 
 #include <QFile>
 #include <QFileDialog>
+#include <QTextStream>
 #include <QJsonObject>
+#include <QJsonArray>
 
 #include <QEvent>
 #include <QBasicTimer>
@@ -49,291 +51,329 @@
 #include "helpers/cgalHelper.h"
 #include "helpers/eigenHelper.h"
 
-// http://correll.cs.colorado.edu/?p=1869
-// https://github.com/correll/Introduction-to-Autonomous-Robots/releases
-
-//#include <CGAL/Constrained_triangulation_plus_2.h>
+#include "block/MeasurementTimestamp.h"
 
-//#include <CGAL/Triangulation_vertex_base_with_info_2.h>
-//#include <CGAL/Triangulation_face_base_with_info_2.h>
+#include <algorithm>
 
-#include <CGAL/boost/graph/graph_traits_Delaunay_triangulation_2.h>
-//#include <CGAL/boost/graph/graph_traits_Triangulation_data_structure_2.h>
-//#include <CGAL/boost/graph/graph_traits_Constrained_triangulation_plus_2.h>
-//#include <CGAL/boost/graph/graph_traits_Constrained_Delaunay_triangulation_2.h>
-#include <CGAL/boost/graph/copy_face_graph.h>
-#include <CGAL/boost/graph/graph_traits_Surface_mesh.h>
-
-//#include <CGAL/Polygon_mesh_processing/locate.h>
-#include <CGAL/Polygon_mesh_processing/compute_normal.h>
-namespace PMP = CGAL::Polygon_mesh_processing;
-using vertex_descriptor = boost::graph_traits<SurfaceMesh_3>::vertex_descriptor;
-using face_descriptor = boost::graph_traits<SurfaceMesh_3>::face_descriptor;
+// http://correll.cs.colorado.edu/?p=1869
+// https://github.com/correll/Introduction-to-Autonomous-Robots/releases
 
 PoseSimulation::PoseSimulation( QWidget* mainWindow, Qt3DCore::QEntity* rootEntity, GeographicConvertionWrapper* tmw )
-  : mainWindow( mainWindow ), tmw( tmw ) {
+  : mainWindow( mainWindow ), rootEntity( rootEntity ), tmw( tmw ) {
 
   state.setZero();
 
   setSimulation( false );
 
   noiseGenerator.seed( std::chrono::system_clock::now().time_since_epoch().count() );
+}
 
-  // test for recording
-  {
-    m_baseEntity = new Qt3DCore::QEntity( rootEntity );
-    m_baseTransform = new Qt3DCore::QTransform( m_baseEntity );
-    m_baseEntity->addComponent( m_baseTransform );
-
-    m_pointsEntity = new Qt3DCore::QEntity( m_baseEntity );
-    m_terrainEntity = new Qt3DCore::QEntity( m_baseEntity );
-    m_linesEntity = new Qt3DCore::QEntity( m_baseEntity );
-    m_segmentsEntity3 = new Qt3DCore::QEntity( m_baseEntity );
-    m_segmentsEntity4 = new Qt3DCore::QEntity( m_baseEntity );
-    m_terrainEntity->setEnabled( false );
-    m_linesEntity->setEnabled( false );
-    m_segmentsEntity3->setEnabled( false );
-
-    m_pointsMesh = new BufferMesh( m_pointsEntity );
-    m_pointsMesh->setPrimitiveType( Qt3DRender::QGeometryRenderer::Points );
-    m_pointsEntity->addComponent( m_pointsMesh );
-
-    m_terrainMesh = new BufferMeshWithNormal( m_terrainEntity );
-    m_terrainMesh->setPrimitiveType( Qt3DRender::QGeometryRenderer::Triangles );
-    m_terrainEntity->addComponent( m_terrainMesh );
-
-    m_linesMesh = new BufferMesh( m_linesEntity );
-    m_linesMesh->setPrimitiveType( Qt3DRender::QGeometryRenderer::Lines );
-    m_linesEntity->addComponent( m_linesMesh );
-
-    m_segmentsMesh3 = new BufferMesh( m_segmentsEntity3 );
-    m_segmentsMesh3->setPrimitiveType( Qt3DRender::QGeometryRenderer::Points );
-    m_segmentsEntity3->addComponent( m_segmentsMesh3 );
-
-    m_segmentsMesh4 = new BufferMesh( m_segmentsEntity4 );
-    m_segmentsMesh4->setPrimitiveType( Qt3DRender::QGeometryRenderer::Lines );
-    m_segmentsEntity4->addComponent( m_segmentsMesh4 );
-
-    m_pointsMaterial = new Qt3DExtras::QPhongMaterial( m_pointsEntity );
-    m_segmentsMaterial = new Qt3DExtras::QPhongMaterial( m_terrainEntity );
-    m_segmentsMaterial2 = new Qt3DExtras::QPhongMaterial( m_linesEntity );
-    m_segmentsMaterial3 = new Qt3DExtras::QPhongMaterial( m_segmentsEntity3 );
-    m_segmentsMaterial4 = new Qt3DExtras::QPhongMaterial( m_segmentsEntity4 );
-
-    m_pointsMaterial->setAmbient( Qt::yellow );
-    m_segmentsMaterial->setAmbient( Qt::darkGreen );
-    m_segmentsMaterial->setShininess( 0.1f );
-    m_segmentsMaterial2->setAmbient( Qt::green );
-    m_segmentsMaterial3->setAmbient( Qt::blue );
-    m_segmentsMaterial4->setAmbient( Qt::red );
-
-    m_pointsEntity->addComponent( m_pointsMaterial );
-    m_terrainEntity->addComponent( m_segmentsMaterial );
-    m_linesEntity->addComponent( m_segmentsMaterial2 );
-    m_segmentsEntity3->addComponent( m_segmentsMaterial3 );
-    m_segmentsEntity4->addComponent( m_segmentsMaterial4 );
+void PoseSimulation::createTerrainEntities() {
+  if( m_baseEntity != nullptr ) {
+    return;
   }
+
+  m_baseEntity = new Qt3DCore::QEntity( rootEntity );
+  m_baseTransform = new Qt3DCore::QTransform( m_baseEntity );
+  m_baseEntity->addComponent( m_baseTransform );
+
+  m_pointsEntity = new Qt3DCore::QEntity( m_baseEntity );
+  m_terrainEntity = new Qt3DCore::QEntity( m_baseEntity );
+  m_linesEntity = new Qt3DCore::QEntity( m_baseEntity );
+  m_segmentsEntity3 = new Qt3DCore::QEntity( m_baseEntity );
+  m_segmentsEntity4 = new Qt3DCore::QEntity( m_baseEntity );
+  m_terrainEntity->setEnabled( false );
+  m_linesEntity->setEnabled( false );
+  m_segmentsEntity3->setEnabled( false );
+
+  m_pointsMesh = new BufferMesh( m_pointsEntity );
+  m_pointsMesh->setPrimitiveType( Qt3DRender::QGeometryRenderer::Points );
+  m_pointsEntity->addComponent( m_pointsMesh );
+
+  m_terrainMesh = new BufferMeshWithNormal( m_terrainEntity );
+  m_terrainMesh->setPrimitiveType( Qt3DRender::QGeometryRenderer::Triangles );
+  m_terrainEntity->addComponent( m_terrainMesh );
+
+  m_linesMesh = new BufferMesh( m_linesEntity );
+  m_linesMesh->setPrimitiveType( Qt3DRender::QGeometryRenderer::Lines );
+  m_linesEntity->addComponent( m_linesMesh );
+
+  m_segmentsMesh3 = new BufferMesh( m_segmentsEntity3 );
+  m_segmentsMesh3->setPrimitiveType( Qt3DRender::QGeometryRenderer::Points );
+  m_segmentsEntity3->addComponent( m_segmentsMesh3 );
+
+  m_segmentsMesh4 = new BufferMesh( m_segmentsEntity4 );
+  m_segmentsMesh4->setPrimitiveType( Qt3DRender::QGeometryRenderer::Lines );
+  m_segmentsEntity4->addComponent( m_segmentsMesh4 );
+
+  m_pointsMaterial = new Qt3DExtras::QPhongMaterial( m_pointsEntity );
+  m_segmentsMaterial = new Qt3DExtras::QPhongMaterial( m_terrainEntity );
+  m_segmentsMaterial2 = new Qt3DExtras::QPhongMaterial( m_linesEntity );
+  m_segmentsMaterial3 = new Qt3DExtras::QPhongMaterial( m_segmentsEntity3 );
+  m_segmentsMaterial4 = new Qt3DExtras::QPhongMaterial( m_segmentsEntity4 );
+
+  m_pointsMaterial->setAmbient( Qt::yellow );
+  m_segmentsMaterial->setAmbient( Qt::darkGreen );
+  m_segmentsMaterial->setShininess( 0.1f );
+  m_segmentsMaterial2->setAmbient( Qt::green );
+  m_segmentsMaterial3->setAmbient( Qt::blue );
+  m_segmentsMaterial4->setAmbient( Qt::red );
+
+  m_pointsEntity->addComponent( m_pointsMaterial );
+  m_terrainEntity->addComponent( m_segmentsMaterial );
+  m_linesEntity->addComponent( m_segmentsMaterial2 );
+  m_segmentsEntity3->addComponent( m_segmentsMaterial3 );
+  m_segmentsEntity4->addComponent( m_segmentsMaterial4 );
 }
 
 void PoseSimulation::timerEvent( QTimerEvent* event ) {
   if( event->timerId() == m_timer.timerId() ) {
-    constexpr double msPerS = 1000;
-    double deltaT = double ( m_time.restart() ) / msPerS;
-    double steerAngle = 0;
+    SimulationCore::Sample sample;
 
-    if( m_autosteerEnabled ) {
-      steerAngle = m_steerAngleFromAutosteer;
-    } else {
-      steerAngle = m_steerAngle;
+    while( simulationCore.popSample( sample ) ) {
+      publishSample( sample );
     }
+  }
+}
 
-    Q_EMIT steeringAngleChanged( steerAngle );
-    Q_EMIT velocityChanged( m_velocity );
-
-    auto rollPitchYaw = ( lastFoundFaceOrientation
-                          * taitBryanToQuaternion( 0, 0, state( int( ThreeWheeledFRHRL::StateNames::Yaw ) ) )
-                        ).conjugate()
-                        * taitBryanToQuaternion( 0, 0, state( int( ThreeWheeledFRHRL::StateNames::Yaw ) ) );
+void PoseSimulation::publishSample( const SimulationCore::Sample& sample ) {
+  state = sample.state;
 
-    auto taitBryanAngles = quaternionToTaitBryan( rollPitchYaw );
+  {
+    if( !terrain.isEmpty() ) {
+      double terrainHeight = 0;
 
-//    state( int( ThreeWheeledFRHRL::StateNames::Roll ) ) = taitBryanAngles.y();
-//    state( int( ThreeWheeledFRHRL::StateNames::Pitch ) ) = taitBryanAngles.x();
-    {
-      Eigen::IOFormat CommaInitFmt( Eigen::StreamPrecision, Eigen::DontAlignCols, ", ", ", ", "", "", "(", ")" );
-      std::cout << "taitBryanAngles: " << ( taitBryanAngles * 180 / M_PI ).format( CommaInitFmt ) << std::endl;
+      if( terrain.lookup( state( int( ThreeWheeledFRHRL::StateNames::X ) ),
+                          state( int( ThreeWheeledFRHRL::StateNames::Y ) ),
+                          terrainHeight, lastFoundFaceOrientation ) ) {
+        state( int( ThreeWheeledFRHRL::StateNames::Z ) ) = terrainHeight + 2;
+      } else {
+        lastFoundFaceOrientation = taitBryanToQuaternion( 0, 0, 0 );
+      }
     }
+  }
 
-    {
-      auto& V = m_velocity;
-      auto deltaF = degreesToRadians( steerAngle );
-
-      {
-        constexpr double MinDeltaT = 0.001;
-        double factor = std::floor( deltaT / MinDeltaT );
-        double deltaT2 = deltaT / factor;
+  // every sensor samples the state on its own schedule; the measurements are delivered after their latency
+  for( std::size_t i = 0; i < sensorSchedules.size(); ++i ) {
+    if( isMeasurementDue( sensorSchedules[i], sample.time ) ) {
+      Measurement measurement = measure( Sensor( i ), sample );
 
-//        std::cout << "factor, deltaT, deltaT2" << factor << deltaT << deltaT2 << std::endl;
+      if( !( sensorSchedules[i].dropout > 0 && dropoutDistribution( noiseGenerator ) < sensorSchedules[i].dropout ) ) {
+        double delay = sensorSchedules[i].latency;
 
-        for( int i = 0; i < factor; ++i ) {
-          StateType<double> prediction;
-//          qDebug() << "PoseSimulation::timerEvent" << Caf << Car << Cah;
-          simulatorModel.predict( state, deltaT2,
-                                  V, deltaF,
-                                  a, b, c,
-                                  Caf, Car, Cah,
-                                  m, Iz,
-                                  sigmaF, sigmaR, sigmaH,
-                                  Cx, slipX,
-                                  prediction );
-          state = prediction;
+        if( sensorSchedules[i].jitter > 0 ) {
+          delay += std::abs( std::normal_distribution<double>( 0, sensorSchedules[i].jitter )( noiseGenerator ) );
         }
+
+        // a transport doesn't reorder the messages of one sensor
+        measurement.deliveryTime = std::max( sample.time + delay, sensorSchedules[i].lastDeliveryTime );
+        sensorSchedules[i].lastDeliveryTime = measurement.deliveryTime;
+        pendingMeasurements[i].push_back( measurement );
       }
     }
+  }
 
-    {
-      if( tin && surfaceMesh ) {
-        auto point = Point_3( state( int( ThreeWheeledFRHRL::StateNames::X ) ),
-                              state( int( ThreeWheeledFRHRL::StateNames::Y ) ),
-                              state( int( ThreeWheeledFRHRL::StateNames::Z ) ) );
-        auto foundFace = tin->locate( point, lastFoundFace );
-        /*if(lastFoundFace != foundFace) */{
+  for( std::size_t i = 0; i < pendingMeasurements.size(); ++i ) {
+    while( !pendingMeasurements[i].empty() && pendingMeasurements[i].front().deliveryTime <= sample.time ) {
+      deliver( Sensor( i ), pendingMeasurements[i].front() );
+      pendingMeasurements[i].pop_front();
+    }
+  }
+}
 
-          if( !tin->is_infinite( foundFace ) ) {
-            Eigen::Vector3d points[] = {
-              toEigenVector( foundFace->vertex( 0 )->point() ),
-              toEigenVector( foundFace->vertex( 1 )->point() ),
-              toEigenVector( foundFace->vertex( 2 )->point() )
-            };
+bool PoseSimulation::isMeasurementDue( SensorSchedule& schedule, const double time ) {
+  const double period = schedule.rate > 0 ? ( 1. / schedule.rate ) : ( double( m_interval ) / 1000 );
 
-            auto plane = Plane_3( foundFace->vertex( 0 )->point(),
-                                  foundFace->vertex( 1 )->point(),
-                                  foundFace->vertex( 2 )->point() );
-            auto line = Line_3( point, Vector_3( 0, 0, 1 ) );
+  // small tolerance, so a period that is a multiple of the step size isn't missed by rounding
+  if( time + 1e-9 < schedule.nextMeasurementTime ) {
+    return false;
+  }
 
-            auto result = CGAL::intersection( plane, line );
+  schedule.nextMeasurementTime += period;
 
-            if( result ) {
-              if( auto* const projectedPoint = boost::get<Point_3>( &*result ) ) {
-                state( int( ThreeWheeledFRHRL::StateNames::Z ) ) = projectedPoint->z() + 2;
-              }
-            }
+  // after a pause or a change of the rate: continue from now instead of catching up
+  if( schedule.nextMeasurementTime < time ) {
+    schedule.nextMeasurementTime = time + period;
+  }
 
-            // https://www.scratchapixel.com/lessons/3d-basic-rendering/ray-tracing-rendering-a-triangle/geometry-of-a-triangle
-            auto normalVector = ( points[1] - points[0] ).cross( points[2] - points[0] );
-            lastFoundFaceOrientation = Eigen::Quaterniond::FromTwoVectors( Eigen::Vector3d::UnitZ(), normalVector );
+  return true;
+}
 
-            Eigen::IOFormat CommaInitFmt( Eigen::StreamPrecision, Eigen::DontAlignCols, ", ", ", ", "", "", "(", ")" );
+PoseSimulation::Measurement PoseSimulation::measure( const Sensor sensor, const SimulationCore::Sample& sample ) {
+  Measurement measurement;
+  measurement.sampleTime = sample.time;
+
+  switch( sensor ) {
+    case Sensor::Gnss: {
+      if( noisePositionXYActivated || noisePositionZActivated ) {
+        antennaKinematic.setPose( Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::X ) ) + noisePositionXY( noiseGenerator ),
+                                  state( int( ThreeWheeledFRHRL::StateNames::Y ) ) + noisePositionXY( noiseGenerator ),
+                                  state( int( ThreeWheeledFRHRL::StateNames::Z ) ) + noisePositionZ( noiseGenerator ) ),
+                                  trueOrientation(),
+                                  PoseOption::Options() );
+      } else {
+        antennaKinematic.setPose( Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::X ) ),
+                                  state( int( ThreeWheeledFRHRL::StateNames::Y ) ),
+                                  state( int( ThreeWheeledFRHRL::StateNames::Z ) ) ),
+                                  trueOrientation(),
+                                  PoseOption::Options() );
+      }
 
-            std::cout << "lastFoundFaceOrientation: " << ( quaternionToTaitBryan( lastFoundFaceOrientation ) * 180 / M_PI ).format( CommaInitFmt ) << ", normalVector: " << normalVector.format( CommaInitFmt ) << std::endl;
-          } else {
-            std::cout << "tin->is_infinite( foundFace )" << std::endl;
-            lastFoundFaceOrientation = taitBryanToQuaternion( 0, 0, 0 );
-          }
+      measurement.position = antennaKinematic.positionCalculated;
 
-          lastFoundFace = foundFace;
+      // in global coordinates: WGS84
+      double latitude, longitude, height;
+      tmw->Reverse( measurement.position.x(), measurement.position.y(), measurement.position.z(), latitude, longitude, height );
+      measurement.globalPosition = Eigen::Vector3d( latitude, longitude, height );
 
-        }
-      }
+      measurement.velocity = Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::Vx ) ),
+                                              state( int( ThreeWheeledFRHRL::StateNames::Vy ) ),
+                                              state( int( ThreeWheeledFRHRL::StateNames::Vz ) ) );
     }
+    break;
 
-
-    // orientation
-    {
+    case Sensor::Orientation:
+    case Sensor::Imu: {
       if( noiseOrientationActivated ) {
-        m_orientation = taitBryanToQuaternion( state( int( ThreeWheeledFRHRL::StateNames::Yaw ) ) + noiseOrientation( noiseGenerator ),
-                                               state( int( ThreeWheeledFRHRL::StateNames::Pitch ) ) + noiseOrientation( noiseGenerator ),
-                                               state( int( ThreeWheeledFRHRL::StateNames::Roll ) ) + noiseOrientation( noiseGenerator ) );
+        measurement.orientation = lastFoundFaceOrientation *
+                                  taitBryanToQuaternion( state( int( ThreeWheeledFRHRL::StateNames::Yaw ) ) + noiseOrientation( noiseGenerator ),
+                                                         state( int( ThreeWheeledFRHRL::StateNames::Pitch ) ) + noiseOrientation( noiseGenerator ),
+                                                         state( int( ThreeWheeledFRHRL::StateNames::Roll ) ) + noiseOrientation( noiseGenerator ) );
       } else {
-        m_orientation = taitBryanToQuaternion( state( int( ThreeWheeledFRHRL::StateNames::Yaw ) ),
-                                               state( int( ThreeWheeledFRHRL::StateNames::Pitch ) ),
-                                               state( int( ThreeWheeledFRHRL::StateNames::Roll ) ) );
+        measurement.orientation = trueOrientation();
       }
 
-      Eigen::IOFormat CommaInitFmt( Eigen::StreamPrecision, Eigen::DontAlignCols, ", ", ", ", "", "", "(", ")" );
-
-      auto orientation = lastFoundFaceOrientation * m_orientation;
-      std::cout << "lastFoundFaceOrientation: " << radiansToDegrees( quaternionToTaitBryan( lastFoundFaceOrientation ) ).format( CommaInitFmt ) << ", "
-                << "m_orientation: " << radiansToDegrees( quaternionToTaitBryan( m_orientation ) ).format( CommaInitFmt ) << std::endl;
+      if( sensor == Sensor::Imu ) {
+        if( noiseAccelerometerActivated ) {
+          measurement.accelerometer = Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::Ax ) ) + noiseAccelerometer( noiseGenerator ),
+                                      state( int( ThreeWheeledFRHRL::StateNames::Ay ) ) + noiseAccelerometer( noiseGenerator ),
+                                      state( int( ThreeWheeledFRHRL::StateNames::Az ) ) + noiseAccelerometer( noiseGenerator ) );
+        } else {
+          measurement.accelerometer = Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::Ax ) ),
+                                      state( int( ThreeWheeledFRHRL::StateNames::Ay ) ),
+                                      state( int( ThreeWheeledFRHRL::StateNames::Az ) ) );
+        }
 
-      Q_EMIT orientationChanged( orientation );
-      m_orientation = orientation;
+        if( noiseGyroActivated ) {
+          measurement.gyro = Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::Vroll ) ) + noiseGyro( noiseGenerator ),
+                                              state( int( ThreeWheeledFRHRL::StateNames::Vpitch ) ) + noiseGyro( noiseGenerator ),
+                                              state( int( ThreeWheeledFRHRL::StateNames::Vyaw ) ) + noiseGyro( noiseGenerator ) );
+        } else {
+          measurement.gyro = Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::Vroll ) ),
+                                              state( int( ThreeWheeledFRHRL::StateNames::Vpitch ) ),
+                                              state( int( ThreeWheeledFRHRL::StateNames::Vyaw ) ) );
+        }
+      }
+    }
+    break;
 
+    case Sensor::Odometry: {
+      measurement.steerAngle = radiansToDegrees( sample.inputs.steerAngle );
+      measurement.speed = sample.inputs.velocity;
     }
+    break;
 
-    {
-      /*static uint8_t counter = 0;
+    default:
+      break;
+  }
 
-      if( ++counter >= 10 )*/ {
-//        counter = 0;
+  return measurement;
+}
 
-        if( noisePositionXYActivated || noisePositionZActivated ) {
-          antennaKinematic.setPose( Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::X ) ) + noisePositionXY( noiseGenerator ),
-                                    state( int( ThreeWheeledFRHRL::StateNames::Y ) ) + noisePositionXY( noiseGenerator ),
-                                    state( int( ThreeWheeledFRHRL::StateNames::Z ) ) + noisePositionZ( noiseGenerator ) ),
-                                    m_orientation,
-                                    PoseOption::Options() );
-        } else {
-          antennaKinematic.setPose( Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::X ) ),
-                                    state( int( ThreeWheeledFRHRL::StateNames::Y ) ),
-                                    state( int( ThreeWheeledFRHRL::StateNames::Z ) ) ),
-                                    m_orientation,
-                                    PoseOption::Options() );
-        }
+void PoseSimulation::deliver( const Sensor sensor, const Measurement& measurement ) {
+  MeasurementTimestamp::Scope timestampScope( MeasurementTimestamp::withValidity( MeasurementTimestamp::TimeBase::Simulation, measurement.sampleTime ) );
 
-        Q_EMIT velocity3DChanged( Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::Vx ) ),
-                                  state( int( ThreeWheeledFRHRL::StateNames::Vy ) ),
-                                  state( int( ThreeWheeledFRHRL::StateNames::Vz ) ) ) );
+  switch( sensor ) {
+    case Sensor::Gnss:
+      Q_EMIT velocity3DChanged( measurement.velocity );
+      // position with antenna offset
+      Q_EMIT positionChanged( measurement.position );
+      Q_EMIT globalPositionChanged( measurement.globalPosition );
+      break;
 
-        // emit signal with antenna offset
-        Q_EMIT positionChanged( antennaKinematic.positionCalculated );
+    case Sensor::Orientation:
+      m_orientation = measurement.orientation;
+      Q_EMIT orientationChanged( measurement.orientation );
+      break;
 
+    case Sensor::Imu:
+      Q_EMIT imuDataChanged( measurement.orientation, measurement.accelerometer, measurement.gyro );
+      break;
 
-        // in global coordinates: WGS84
-        {
-          double latitude, longitude, height;
-          tmw->Reverse( antennaKinematic.positionCalculated.x(),
-                        antennaKinematic.positionCalculated.y(),
-                        antennaKinematic.positionCalculated.z(), latitude, longitude, height );
+    case Sensor::Odometry:
+      Q_EMIT steeringAngleChanged( measurement.steerAngle );
+      Q_EMIT velocityChanged( measurement.speed );
+      break;
 
-//      QElapsedTimer timer;
-//      timer.start();
-          Q_EMIT globalPositionChanged( Eigen::Vector3d( latitude, longitude, height ) );
+    default:
+      break;
+  }
+}
 
-        }
-      }
-    }
+Eigen::Quaterniond PoseSimulation::trueOrientation() const {
+  return lastFoundFaceOrientation * taitBryanToQuaternion( state( int( ThreeWheeledFRHRL::StateNames::Yaw ) ),
+         state( int( ThreeWheeledFRHRL::StateNames::Pitch ) ),
+         state( int( ThreeWheeledFRHRL::StateNames::Roll ) ) );
+}
+
+void PoseSimulation::resetSensorSchedules() {
+  for( auto& schedule : sensorSchedules ) {
+    schedule.nextMeasurementTime = 0;
+    schedule.lastDeliveryTime = 0;
+  }
 
+  for( auto& pending : pendingMeasurements ) {
+    pending.clear();
+  }
+}
 
-    Eigen::Vector3d accelerometerData;
+void PoseSimulation::updatePublishInterval() {
+  // an own rate or latency of a sensor needs every step of the simulation to keep the timing
+  bool needsEveryStep = false;
 
-    if( noiseAccelerometerActivated ) {
-      accelerometerData = Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::Ax ) ) + noiseAccelerometer( noiseGenerator ),
-                                           state( int( ThreeWheeledFRHRL::StateNames::Ay ) ) + noiseAccelerometer( noiseGenerator ),
-                                           state( int( ThreeWheeledFRHRL::StateNames::Az ) ) + noiseAccelerometer( noiseGenerator ) );
-    } else {
-      accelerometerData = Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::Ax ) ),
-                                           state( int( ThreeWheeledFRHRL::StateNames::Ay ) ),
-                                           state( int( ThreeWheeledFRHRL::StateNames::Az ) ) );
+  for( const auto& schedule : sensorSchedules ) {
+    if( schedule.rate > 0 || schedule.latency > 0 || schedule.jitter > 0 ) {
+      needsEveryStep = true;
     }
+  }
 
-    Eigen::Vector3d gyroData;
+  simulationCore.setPublishInterval( needsEveryStep ? simulationCore.stepSize() : ( double( m_interval ) / 1000 ) );
+}
 
-    if( noiseGyroActivated ) {
-      gyroData = Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::Vroll ) ) + noiseGyro( noiseGenerator ),
-                                  state( int( ThreeWheeledFRHRL::StateNames::Vpitch ) ) + noiseGyro( noiseGenerator ),
-                                  state( int( ThreeWheeledFRHRL::StateNames::Vyaw ) ) + noiseGyro( noiseGenerator ) );
-    } else {
-      gyroData = Eigen::Vector3d( state( int( ThreeWheeledFRHRL::StateNames::Vroll ) ),
-                                  state( int( ThreeWheeledFRHRL::StateNames::Vpitch ) ),
-                                  state( int( ThreeWheeledFRHRL::StateNames::Vyaw ) ) );
-    }
+void PoseSimulation::setSensorSchedule( const int sensor, const double rate, const double latency, const double jitter, const double dropout ) {
+  if( sensor >= 0 && sensor < int( Sensor::Count ) ) {
+    auto& schedule = sensorSchedules[std::size_t( sensor )];
+    schedule.rate = std::max( rate, 0. );
+    schedule.latency = std::max( latency, 0. );
+    schedule.jitter = std::max( jitter, 0. );
+    schedule.dropout = std::clamp( dropout, 0., 1. );
 
-    Q_EMIT imuDataChanged( m_orientation, accelerometerData, gyroData );
-//      qDebug() << "Cycle Time PoseSimulation:    " << timer.nsecsElapsed() << "ns";
+    updatePublishInterval();
   }
 }
 
+SimulationCore::Inputs PoseSimulation::simulationInputs() const {
+  SimulationCore::Inputs inputs;
+
+  inputs.velocity = m_velocity;
+  inputs.steerAngle = degreesToRadians( m_autosteerEnabled ? m_steerAngleFromAutosteer : m_steerAngle );
+  inputs.a = a;
+  inputs.b = b;
+  inputs.c = c;
+  inputs.Caf = Caf;
+  inputs.Car = Car;
+  inputs.Cah = Cah;
+  inputs.m = m;
+  inputs.Iz = Iz;
+  inputs.sigmaF = sigmaF;
+  inputs.sigmaR = sigmaR;
+  inputs.sigmaH = sigmaH;
+  inputs.Cx = Cx;
+  inputs.slipX = slipX;
+
+  return inputs;
+}
+
 void PoseSimulation::toJSON( QJsonObject& json ) {
   QJsonObject valuesObject;
 
@@ -350,6 +390,24 @@ void PoseSimulation::toJSON( QJsonObject& json ) {
   valuesObject[QStringLiteral( "sigmaH" )] = this->sigmaH;
   valuesObject[QStringLiteral( "Cx" )] = this->Cx;
   valuesObject[QStringLiteral( "slip" )] = this->slipX;
+  valuesObject[QStringLiteral( "integrator" )] = int( simulationCore.integrator() );
+  valuesObject[QStringLiteral( "simulationMode" )] = int( simulationCore.mode() );
+  valuesObject[QStringLiteral( "timeFactor" )] = simulationCore.timeFactor();
+  valuesObject[QStringLiteral( "stepSize" )] = simulationCore.stepSize();
+  valuesObject[QStringLiteral( "vehicleModel" )] = int( simulationCore.vehicleModel() );
+
+  QJsonArray sensorsArray;
+
+  for( const auto& schedule : sensorSchedules ) {
+    QJsonObject sensorObject;
+    sensorObject[QStringLiteral( "rate" )] = schedule.rate;
+    sensorObject[QStringLiteral( "latency" )] = schedule.latency;
+    sensorObject[QStringLiteral( "jitter" )] = schedule.jitter;
+    sensorObject[QStringLiteral( "dropout" )] = schedule.dropout;
+    sensorsArray.append( sensorObject );
+  }
+
+  valuesObject[QStringLiteral( "sensors" )] = sensorsArray;
 
   json[QStringLiteral( "values" )] = valuesObject;
 }
@@ -409,13 +467,49 @@ void PoseSimulation::fromJSON( QJsonObject& json ) {
     if( valuesObject[QStringLiteral( "slip" )].isDouble() ) {
       this->slipX = valuesObject[QStringLiteral( "slip" )].toDouble();
     }
+
+    if( valuesObject[QStringLiteral( "integrator" )].isDouble() ) {
+      setIntegrator( valuesObject[QStringLiteral( "integrator" )].toInt() );
+    }
+
+    if( valuesObject[QStringLiteral( "simulationMode" )].isDouble() ) {
+      setSimulationMode( valuesObject[QStringLiteral( "simulationMode" )].toInt(),
+                         valuesObject[QStringLiteral( "timeFactor" )].toDouble( 1 ) );
+    }
+
+    if( valuesObject[QStringLiteral( "stepSize" )].isDouble() ) {
+      setStepSize( valuesObject[QStringLiteral( "stepSize" )].toDouble() );
+    }
+
+    if( valuesObject[QStringLiteral( "vehicleModel" )].isDouble() ) {
+      setVehicleModel( valuesObject[QStringLiteral( "vehicleModel" )].toInt() );
+    }
+
+    if( valuesObject[QStringLiteral( "sensors" )].isArray() ) {
+      const auto sensorsArray = valuesObject[QStringLiteral( "sensors" )].toArray();
+
+      for( int i = 0; i < sensorsArray.size(); ++i ) {
+        const auto sensorObject = sensorsArray.at( i ).toObject();
+        setSensorSchedule( i,
+                           sensorObject[QStringLiteral( "rate" )].toDouble( 0 ),
+                           sensorObject[QStringLiteral( "latency" )].toDouble( 0 ),
+                           sensorObject[QStringLiteral( "jitter" )].toDouble( 0 ),
+                           sensorObject[QStringLiteral( "dropout" )].toDouble( 0 ) );
+      }
+    }
+
+    simulationCore.setInputs( simulationInputs() );
   }
 }
 
 void PoseSimulation::setInterval( int interval ) {
   m_interval = interval;
 
-  setSimulation( m_enabled );
+  updatePublishInterval();
+
+  if( m_enabled ) {
+    m_timer.start( m_interval, Qt::PreciseTimer, this );
+  }
 
   Q_EMIT intervalChanged( m_interval );
 }
@@ -424,9 +518,15 @@ void PoseSimulation::setSimulation( bool enabled ) {
   m_enabled = enabled;
 
   if( enabled ) {
+    if( !simulationCore.isRunning() ) {
+      resetSensorSchedules();
+      updatePublishInterval();
+      simulationCore.start( state, simulationInputs() );
+    }
+
     m_timer.start( m_interval, Qt::PreciseTimer, this );
-    m_time.start();
   } else {
+    simulationCore.stop();
     m_timer.stop();
   }
 
@@ -439,10 +539,14 @@ void PoseSimulation::setFrequency( double frequency ) {
 
 void PoseSimulation::setSteerAngle( double steerAngle ) {
   m_steerAngle = steerAngle + m_steerAngleOffset;
+
+  simulationCore.setInputs( simulationInputs() );
 }
 
 void PoseSimulation::setVelocity( double velocity ) {
   m_velocity = velocity;
+
+  simulationCore.setInputs( simulationInputs() );
 }
 
 void PoseSimulation::setRollOffset( double offset ) {
@@ -463,6 +567,65 @@ void PoseSimulation::setSteerAngleOffset( double offset ) {
 
 void PoseSimulation::setSteerAngleFromAutosteer( double steerAngle ) {
   m_steerAngleFromAutosteer = steerAngle + m_steerAngleOffset;
+
+  simulationCore.setInputs( simulationInputs() );
+}
+
+void PoseSimulation::setIntegrator( const int integrator ) {
+  simulationCore.setIntegrator( integrator == 0 ? SimulationCore::Integrator::Euler : SimulationCore::Integrator::RungeKutta4 );
+}
+
+void PoseSimulation::setSimulationMode( const int mode, const double timeFactor ) {
+  switch( mode ) {
+    case 1:
+      simulationCore.setMode( SimulationCore::Mode::Accelerated, timeFactor );
+      break;
+
+    case 2:
+      simulationCore.setMode( SimulationCore::Mode::AsFastAsPossible, timeFactor );
+      break;
+
+    default:
+      simulationCore.setMode( SimulationCore::Mode::RealTime, timeFactor );
+      break;
+  }
+}
+
+void PoseSimulation::setStepSize( const double stepSize ) {
+  simulationCore.setStepSize( stepSize );
+
+  // a new step size needs a new run
+  if( simulationCore.isRunning() ) {
+    simulationCore.stop();
+    resetSensorSchedules();
+    updatePublishInterval();
+    simulationCore.start( state, simulationInputs() );
+  }
+}
+
+void PoseSimulation::setVehicleModel( const int vehicleModel ) {
+  const bool wasRunning = simulationCore.isRunning();
+  simulationCore.stop();
+
+  switch( vehicleModel ) {
+    case 1:
+      simulationCore.setVehicleModel( SimulationCore::VehicleModel::NonLinear3DOF );
+      break;
+
+    case 2:
+      simulationCore.setVehicleModel( SimulationCore::VehicleModel::NonLinear4DOF );
+      break;
+
+    default:
+      simulationCore.setVehicleModel( SimulationCore::VehicleModel::ThreeWheeled );
+      break;
+  }
+
+  if( wasRunning ) {
+    resetSensorSchedules();
+    updatePublishInterval();
+    simulationCore.start( state, simulationInputs() );
+  }
 }
 
 void PoseSimulation::setInitialWGS84Position( const Eigen::Vector3d& position ) {
@@ -471,6 +634,8 @@ void PoseSimulation::setInitialWGS84Position( const Eigen::Vector3d& position )
 
 void PoseSimulation::autosteerEnabled( bool enabled ) {
   m_autosteerEnabled = enabled;
+
+  simulationCore.setInputs( simulationInputs() );
 }
 
 void PoseSimulation::setSimulatorValues( const double a, const double b, const double c, const double Caf, const double Car, const double Cah, const double m, const double Iz, const double sigmaF, const double sigmaR, const double sigmaH, const double Cx, const double slipX ) {
@@ -488,6 +653,8 @@ void PoseSimulation::setSimulatorValues( const double a, const double b, const d
   this->sigmaH = sigmaH;
   this->Cx = Cx;
   this->slipX = slipX;
+
+  simulationCore.setInputs( simulationInputs() );
 }
 
 void PoseSimulation::setNoiseStandartDeviations( double noisePositionXY, double noisePositionZ, double noiseOrientation, double noiseAccelerometer, double noiseGyro ) {
@@ -536,7 +703,7 @@ void PoseSimulation::openTIN() {
                                       dir,
                                       selectedFilter );
   fileDialog->setFileMode( QFileDialog::ExistingFile );
-  fileDialog->setNameFilter( tr( "All Files (*);;GeoJSON Files (*.geojson)" ) );
+  fileDialog->setNameFilter( tr( "All Files (*);;GeoJSON Files (*.geojson);;ESRI ASCII Grid (*.asc)" ) );
 
   // connect the signal QFileDialog::urlSelected to a lambda, which opens the file.
   // this is needed, as the file dialog on android is asynchonous, so you have to connect to
@@ -572,7 +739,11 @@ void PoseSimulation::openTIN() {
         qWarning() << "Couldn't open save file.";
       } else {
 
-        openTINFromFile( loadFile );
+        if( fileName.endsWith( QStringLiteral( ".asc" ), Qt::CaseInsensitive ) ) {
+          openDEMFromFile( loadFile );
+        } else {
+          openTINFromFile( loadFile );
+        }
       }
     }
 
@@ -590,18 +761,32 @@ void PoseSimulation::openTIN() {
 }
 
 void PoseSimulation::openTINFromFile( QFile& file ) {
+  // prints the GeoJSON and the statistics of the loading; off by default, as it is slow for big surveys
+  constexpr bool enableDebug = false;
+
+  QElapsedTimer timer;
+  timer.start();
+
   auto geoJsonHelper = GeoJsonHelper( file );
-  geoJsonHelper.print();
+
+  if( enableDebug ) {
+    geoJsonHelper.print();
+  }
 
   std::vector<Point_3> points;
-  QVector<QVector3D> pointsForMesh;
+  QByteArray pointsForMesh;
 
   for( const auto& member : geoJsonHelper.members ) {
     switch( member.first ) {
       case GeoJsonHelper::GeometryType::MultiPoint: {
-        for( const auto& point : std::get<GeoJsonHelper::MultiPointType>( member.second ) ) {
+        const auto& multiPoint = std::get<GeoJsonHelper::MultiPointType>( member.second );
+        points.reserve( points.size() + multiPoint.size() );
+        pointsForMesh.reserve( pointsForMesh.size() + int( multiPoint.size() * sizeof( QVector3D ) ) );
+
+        for( const auto& point : multiPoint ) {
           auto tmwPoint = tmw->Forward( point );
-          pointsForMesh << toQVector3D( tmwPoint );
+          const auto vertex = toQVector3D( tmwPoint );
+          pointsForMesh.append( reinterpret_cast<const char*>( &vertex ), int( sizeof( QVector3D ) ) );
           points.emplace_back( toPoint3( tmwPoint ) );
         }
       }
@@ -612,67 +797,174 @@ void PoseSimulation::openTINFromFile( QFile& file ) {
     }
   }
 
-  m_pointsMesh->bufferUpdate( pointsForMesh );
+  createTerrainEntities();
+  m_pointsMesh->bufferUpdate( std::move( pointsForMesh ) );
   m_pointsEntity->setEnabled( true );
 
+  const auto timeParsed = timer.elapsed();
+
   tin = make_unique<DelaunayTriangulationProjectedXY>( points.cbegin(), points.cend() );
-  surfaceMesh = make_unique<SurfaceMesh_3>();
-  CGAL::copy_face_graph( *tin, *surfaceMesh );
 
-  auto vnormals = surfaceMesh->add_property_map<vertex_descriptor, Vector_3>( "v:normals", CGAL::NULL_VECTOR ).first;
-  auto fnormals = surfaceMesh->add_property_map<face_descriptor, Vector_3>( "f:normals", CGAL::NULL_VECTOR ).first;
+  const auto timeTriangulated = timer.elapsed();
 
-  PMP::compute_normals( *surfaceMesh, vnormals, fnormals );
-  std::cout << "Vertex normals :" << std::endl;
+  // compile the triangulation into one indexed mesh with shared vertices; the rendering and the lookups
+  // in the simulation both use it
+  TerrainMesh mesh;
+  {
+    mesh.vertices.reserve( tin->number_of_vertices() );
+    mesh.indices.reserve( tin->number_of_faces() * 3 );
 
-  for( vertex_descriptor vd : vertices( *surfaceMesh ) ) {
-    std::cout << vnormals[vd] << std::endl;
-  }
+    for( auto it = tin->finite_vertices_begin(), end = tin->finite_vertices_end(); it != end; ++it ) {
+      it->info() = uint32_t( mesh.vertices.size() );
+      mesh.vertices.push_back( toEigenVector( it->point() ) );
+    }
 
-  Eigen::IOFormat CommaInitFmt( Eigen::StreamPrecision, Eigen::DontAlignCols, ", ", ", ", "", "", "(", ")" );
+    for( auto it = tin->finite_faces_begin(), end = tin->finite_faces_end(); it != end; ++it ) {
+      mesh.indices.push_back( it->vertex( 0 )->info() );
+      mesh.indices.push_back( it->vertex( 1 )->info() );
+      mesh.indices.push_back( it->vertex( 2 )->info() );
+    }
 
-  auto ppm = get( CGAL::vertex_point, *surfaceMesh );
+    // the triangulation knows every edge exactly once
+    mesh.edges.reserve( ( mesh.vertices.size() * 3 ) * 2 );
 
-  QVector<QVector3D> trianglesWithNormals;
+    for( auto it = tin->finite_edges_begin(), end = tin->finite_edges_end(); it != end; ++it ) {
+      mesh.edges.push_back( it->first->vertex( tin->cw( it->second ) )->info() );
+      mesh.edges.push_back( it->first->vertex( tin->ccw( it->second ) )->info() );
+    }
+  }
 
-  std::cout << "Face normals :" << std::endl;
+  mesh.computeNormals();
 
-  for( face_descriptor fd : faces( *surfaceMesh ) ) {
-    auto normal = fnormals[fd];
-    const auto normalVector = toQVector3D( normal );
+  const auto timeCompiled = timer.elapsed();
 
-//    std::vector<QVector3D> points;
-    for( vertex_descriptor vd : CGAL::vertices_around_face( surfaceMesh->halfedge( fd ), *surfaceMesh ) ) {
-//       points.emplace_back(convertPoint3ToQVector3D( get( ppm, vd ) ));
-      trianglesWithNormals << toQVector3D( get( ppm, vd ) );
-//      trianglesWithNormals << convertVector3ToQVector3D(vnormals[vd]);
-      trianglesWithNormals << normalVector;
+  terrain.setTriangles( mesh );
+
+  // interleaved position/normal for the terrain, only the positions for the edges
+  {
+    QByteArray verticesWithNormals;
+    verticesWithNormals.resize( int( mesh.vertices.size() * 6 * sizeof( float ) ) );
+    QByteArray vertices;
+    vertices.resize( int( mesh.vertices.size() * 3 * sizeof( float ) ) );
+
+    auto* verticesWithNormalsData = reinterpret_cast<float*>( verticesWithNormals.data() );
+    auto* verticesData = reinterpret_cast<float*>( vertices.data() );
+
+    for( std::size_t i = 0; i < mesh.vertices.size(); ++i ) {
+      const auto& vertex = mesh.vertices[i];
+      const auto& normal = mesh.normals[i];
+
+      *verticesWithNormalsData++ = float( vertex.x() );
+      *verticesWithNormalsData++ = float( vertex.y() );
+      *verticesWithNormalsData++ = float( vertex.z() );
+      *verticesWithNormalsData++ = normal.x();
+      *verticesWithNormalsData++ = normal.y();
+      *verticesWithNormalsData++ = normal.z();
+
+      *verticesData++ = float( vertex.x() );
+      *verticesData++ = float( vertex.y() );
+      *verticesData++ = float( vertex.z() );
     }
 
-    auto quaternion = Eigen::Quaterniond::FromTwoVectors( Eigen::Vector3d( 0, 0, 1 ), toEigenVector( normal ) );
+    QByteArray indices( reinterpret_cast<const char*>( mesh.indices.data() ), int( mesh.indices.size() * sizeof( uint32_t ) ) );
+    QByteArray edges( reinterpret_cast<const char*>( mesh.edges.data() ), int( mesh.edges.size() * sizeof( uint32_t ) ) );
 
-    std::cout << "vector: " << normal << " Euler: " << ( quaternionToTaitBryan( quaternion ) * 180 / M_PI ).format( CommaInitFmt ) << std::endl;
+    createTerrainEntities();
+    m_terrainMesh->bufferUpdate( std::move( verticesWithNormals ), std::move( indices ) );
+    m_terrainEntity->setEnabled( true );
+
+    m_linesMesh->bufferUpdate( std::move( vertices ), std::move( edges ) );
+    m_linesEntity->setEnabled( true );
   }
 
-  m_terrainMesh->bufferUpdate( trianglesWithNormals );
-  m_terrainEntity->setEnabled( true );
+  if( enableDebug ) {
+    qDebug() << "PoseSimulation: TIN with" << mesh.vertices.size() << "vertices," << mesh.indices.size() / 3 << "faces,"
+             << mesh.edges.size() / 2 << "edges; parsed:" << timeParsed << "ms, triangulated:" << timeTriangulated
+             << "ms, compiled:" << timeCompiled << "ms, uploaded:" << timer.elapsed() << "ms";
+  }
+}
+
+// ESRI ASCII grid; as the local coordinates are only known to the application, the lower left corner
+// (xllcorner/yllcorner or xllcenter/yllcenter) is read as longitude/latitude in WGS84 and the cellsize in meters
+void PoseSimulation::openDEMFromFile( QFile& file ) {
+  QTextStream stream( &file );
+
+  int columns = 0;
+  int rows = 0;
+  double longitude = 0;
+  double latitude = 0;
+  double cellSize = 0;
+  bool cellCenter = false;
+  double noDataValue = -9999;
+
+  QString key;
+
+  // the header is key/value pairs; the first numeric "key" is the start of the data
+  while( !stream.atEnd() ) {
+    const qint64 position = stream.pos();
+    stream >> key;
+
+    bool isNumber = false;
+    key.toDouble( &isNumber );
+
+    if( isNumber ) {
+      stream.seek( position );
+      break;
+    }
 
+    key = key.toLower();
+
+    if( key == QLatin1String( "ncols" ) ) {
+      stream >> columns;
+    } else if( key == QLatin1String( "nrows" ) ) {
+      stream >> rows;
+    } else if( key == QLatin1String( "xllcorner" ) || key == QLatin1String( "xllcenter" ) ) {
+      stream >> longitude;
+      cellCenter = key == QLatin1String( "xllcenter" );
+    } else if( key == QLatin1String( "yllcorner" ) || key == QLatin1String( "yllcenter" ) ) {
+      stream >> latitude;
+    } else if( key == QLatin1String( "cellsize" ) ) {
+      stream >> cellSize;
+    } else if( key == QLatin1String( "nodata_value" ) ) {
+      stream >> noDataValue;
+    } else {
+      QString value;
+      stream >> value;
+    }
+  }
+
+  if( columns < 2 || rows < 2 || cellSize <= 0 ) {
+    qWarning() << "PoseSimulation::openDEMFromFile: invalid header";
+    return;
+  }
 
-  QVector<QVector3D> lines;
+  // the rows in the file are north to south, the raster of the terrain is south to north
+  std::vector<double> heights( std::size_t( columns ) * rows, 0 );
 
-  for( const auto& edge : surfaceMesh->edges() ) {
+  for( int row = rows - 1; row >= 0; --row ) {
+    for( int column = 0; column < columns; ++column ) {
+      double height = 0;
+      stream >> height;
 
-    auto point1 = surfaceMesh->point( surfaceMesh->vertex( edge, 0 ) );
-    auto point2 = surfaceMesh->point( surfaceMesh->vertex( edge, 1 ) );
+      if( qFuzzyCompare( height, noDataValue ) ) {
+        height = 0;
+      }
+
+      heights[std::size_t( row ) * columns + column] = height;
+    }
+  }
 
-    std::cout << "line: " << point1 << ", " << point2 << std::endl;
+  double x = 0;
+  double y = 0;
+  double z = 0;
+  tmw->Forward( latitude, longitude, x, y, z );
 
-    lines << toQVector3D( point1 );
-    lines <<  toQVector3D( point2 );
+  if( !cellCenter ) {
+    x += cellSize / 2;
+    y += cellSize / 2;
   }
 
-  m_linesMesh->bufferUpdate( lines );
-  m_linesEntity->setEnabled( true );
+  terrain.setRaster( x, y, cellSize, uint32_t( columns ), uint32_t( rows ), std::move( heights ) );
 }
 
 void PoseSimulation::setWheelbase( double wheelbase ) {
@@ -20,6 +20,8 @@
 
 #include <random>
 #include <memory>
+#include <array>
+#include <deque>
 
 #include <QObject>
 #include <QBasicTimer>
@@ -36,6 +38,9 @@
 #include "block/kinematic/FixedKinematicPrimitive.h"
 
 #include "kinematic/VehicleDynamics/Vehicle.h"
+#include "kinematic/Terrain.h"
+#include "kinematic/TerrainMesh.h"
+#include "kinematic/SimulationCore.h"
 
 #include "filter/3wFRHRL/SystemModel.h"
 
@@ -47,12 +52,12 @@ using PointSet_3 = CGAL::Point_set_3<Point_3>;
 
 #include <CGAL/Projection_traits_xy_3.h>
 #include <CGAL/Delaunay_triangulation_2.h>
+#include <CGAL/Triangulation_vertex_base_with_info_2.h>
 using ProjectionTraitsXY = CGAL::Projection_traits_xy_3<Epick>;
-using DelaunayTriangulationProjectedXY = CGAL::Delaunay_triangulation_2<ProjectionTraitsXY>;
-
-#include <CGAL/Surface_mesh.h>
-#include <CGAL/Polygon_mesh_processing/locate.h>
-using SurfaceMesh_3 = CGAL::Surface_mesh<Point_3>;
+// the info of the vertices is their index in the compiled TerrainMesh
+using VertexBaseWithIndex = CGAL::Triangulation_vertex_base_with_info_2<uint32_t, ProjectionTraitsXY>;
+using TriangulationDataStructureWithIndex = CGAL::Triangulation_data_structure_2<VertexBaseWithIndex>;
+using DelaunayTriangulationProjectedXY = CGAL::Delaunay_triangulation_2<ProjectionTraitsXY, TriangulationDataStructureWithIndex>;
 
 class QFile;
 class BufferMeshWithNormal;
@@ -63,6 +68,15 @@ class PoseSimulation : public BlockBase {
   public:
     explicit PoseSimulation( QWidget* mainWindow, Qt3DCore::QEntity* rootEntity, GeographicConvertionWrapper* tmw );
 
+    // the emulated sensors; each one has its own schedule
+    enum class Sensor : uint8_t {
+      Gnss = 0,
+      Orientation,
+      Imu,
+      Odometry,
+      Count
+    };
+
   public Q_SLOTS:
     void setInterval( const int interval );
     void setSimulation( const bool enabled );
@@ -80,6 +94,18 @@ class PoseSimulation : public BlockBase {
     void setInitialWGS84Position( const Eigen::Vector3d& position );
     void autosteerEnabled( const bool enabled );
 
+    // 0: Euler, 1: Runge-Kutta 4
+    void setIntegrator( const int integrator );
+    // 0: real time, 1: accelerated by timeFactor, 2: as fast as possible
+    void setSimulationMode( const int mode, const double timeFactor );
+    void setStepSize( const double stepSize );
+    // 0: ThreeWheeledFRHRL, 1: VehicleNonLinear3DOF, 2: VehicleNonLinear4DOF
+    void setVehicleModel( const int vehicleModel );
+
+    // rate in Hz (0: with the frequency of the simulator), latency and jitter (standard deviation) in s,
+    // dropout as probability 0…1
+    void setSensorSchedule( const int sensor, const double rate, const double latency, const double jitter, const double dropout );
+
     void setSimulatorValues( const double a, const double b, const double c,
                              const double Caf, const double Car, const double Cah,
                              const double m, const double Iz,
@@ -94,10 +120,49 @@ class PoseSimulation : public BlockBase {
 
     void openTIN();
     void openTINFromFile( QFile& file );
+    void openDEMFromFile( QFile& file );
 
   protected:
     void timerEvent( QTimerEvent* event ) override;
 
+  private:
+    struct SensorSchedule {
+      double rate = 0;
+      double latency = 0;
+      double jitter = 0;
+      double dropout = 0;
+
+      double nextMeasurementTime = 0;
+      double lastDeliveryTime = 0;
+    };
+
+    struct Measurement {
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+      double deliveryTime = 0;
+      // the time of validity; the emits of the measurement carry it as their MeasurementTimestamp
+      double sampleTime = 0;
+
+      Eigen::Vector3d position = Eigen::Vector3d::Zero();
+      Eigen::Vector3d globalPosition = Eigen::Vector3d::Zero();
+      Eigen::Vector3d velocity = Eigen::Vector3d::Zero();
+      Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();
+      Eigen::Vector3d accelerometer = Eigen::Vector3d::Zero();
+      Eigen::Vector3d gyro = Eigen::Vector3d::Zero();
+      double steerAngle = 0;
+      double speed = 0;
+    };
+
+    SimulationCore::Inputs simulationInputs() const;
+    void publishSample( const SimulationCore::Sample& sample );
+
+    bool isMeasurementDue( SensorSchedule& schedule, const double time );
+    Measurement measure( const Sensor sensor, const SimulationCore::Sample& sample );
+    void deliver( const Sensor sensor, const Measurement& measurement );
+    Eigen::Quaterniond trueOrientation() const;
+    void resetSensorSchedules();
+    void updatePublishInterval();
+
   Q_SIGNALS:
     void simulatorValuesChanged( const double a, const double b, const double c,
                                  const double Caf, const double Car, const double Cah,
@@ -144,15 +209,19 @@ class PoseSimulation : public BlockBase {
     virtual void fromJSON( QJsonObject& json ) override;
 
   private:
+    // the entities of the terrain are only needed once one is loaded, so they are created then
+    void createTerrainEntities();
+
     QWidget* mainWindow = nullptr;
+    Qt3DCore::QEntity* rootEntity = nullptr;
 
     bool m_enabled = false;
     bool m_autosteerEnabled = false;
     int m_interval = 50;
 
+    // only polls the samples of the simulation core
     QBasicTimer m_timer;
     int m_timerId{};
-    QElapsedTimer m_time;
 
     double m_steerAngle = 0;
     double m_steerAngleFromAutosteer = 0;
@@ -189,7 +258,7 @@ class PoseSimulation : public BlockBase {
 
     template <typename T_> using StateType = ThreeWheeledFRHRL::State<T_>;
     StateType<double> state;
-    ThreeWheeledFRHRL::TractorImuGpsFusionModel<StateType> simulatorModel;
+    SimulationCore simulationCore;
 
     std::default_random_engine noiseGenerator;
     bool noisePositionXYActivated = false;
@@ -202,10 +271,13 @@ class PoseSimulation : public BlockBase {
     std::normal_distribution<double> noiseAccelerometer = std::normal_distribution<double>( 0, 0.01 );
     bool noiseGyroActivated = false;
     std::normal_distribution<double> noiseGyro = std::normal_distribution<double>( 0, 0.01 );
+    std::uniform_real_distribution<double> dropoutDistribution = std::uniform_real_distribution<double>( 0, 1 );
+
+    std::array<SensorSchedule, std::size_t( Sensor::Count )> sensorSchedules;
+    std::array<std::deque<Measurement>, std::size_t( Sensor::Count )> pendingMeasurements;
 
     std::unique_ptr<DelaunayTriangulationProjectedXY> tin;
-    std::unique_ptr<SurfaceMesh_3> surfaceMesh;
-    DelaunayTriangulationProjectedXY::Face_handle lastFoundFace;
+    Terrain terrain;
     Eigen::Quaterniond lastFoundFaceOrientation = taitBryanToQuaternion( 0, 0, 0 );
 
     Qt3DCore::QEntity* m_baseEntity = nullptr;
@@ -29,6 +29,9 @@
 #include <Qt3DExtras/QDiffuseSpecularMaterial>
 #include <Qt3DExtras/QMetalRoughMaterial>
 
+#include <Qt3DRender/QCamera>
+#include <Qt3DRender/QLevelOfDetail>
+
 #include "block/sectionControl/Implement.h"
 #include "block/sectionControl/ImplementSection.h"
 
@@ -37,11 +40,22 @@
 
 #include "helpers/cgalHelper.h"
 #include "helpers/eigenHelper.h"
+#include "helpers/GeographicConvertionWrapper.h"
+#include "helpers/GeoJsonHelper.h"
 
 #include <QPointer>
-
-CultivatedAreaModel::CultivatedAreaModel( Qt3DCore::QEntity* rootEntity, CgalThread* threadForCgalWorker )
-  : threadForCgalWorker( threadForCgalWorker ) {
+#include <QAction>
+#include <QMenu>
+#include <QFile>
+#include <QFileDialog>
+
+CultivatedAreaModel::CultivatedAreaModel( QWidget* mainWindow,
+    QMenu* saveMenu,
+    Qt3DCore::QEntity* rootEntity,
+    Qt3DRender::QCamera* cameraEntity,
+    CgalThread* threadForCgalWorker,
+    GeographicConvertionWrapper* tmw )
+  : mainWindow( mainWindow ), tmw( tmw ), threadForCgalWorker( threadForCgalWorker ) {
   const QColor colorCultivatedArea = QColor( 0xa2, 0xb8, 0xff, 128 );
 
   // base
@@ -59,12 +73,56 @@ CultivatedAreaModel::CultivatedAreaModel( Qt3DCore::QEntity* rootEntity, CgalThr
   m_layer = new Qt3DRender::QLayer( m_baseEntity );
   m_layer->setRecursive( true );
   m_baseEntity->addComponent( m_layer );
+
+  unionMesh = createNewMesh();
+  unionMeshCoarse = createNewMesh();
+  qobject_cast<Qt3DCore::QEntity*>( unionMeshCoarse->parent() )->setEnabled( false );
+
+  // switch between the fine and the coarse union depending on the distance of the camera to the vehicle
+  {
+    m_distanceMeasurementEntity = new Qt3DCore::QEntity( rootEntity );
+    m_distanceMeasurementTransform = new Qt3DCore::QTransform( m_distanceMeasurementEntity );
+    m_distanceMeasurementEntity->addComponent( m_distanceMeasurementTransform );
+    m_lod = new Qt3DRender::QLevelOfDetail( m_distanceMeasurementEntity );
+    m_lod->setCamera( cameraEntity );
+    m_lod->setThresholds( {250, 10000} );
+    m_distanceMeasurementEntity->addComponent( m_lod );
+
+    QObject::connect( m_lod, &Qt3DRender::QLevelOfDetail::currentIndexChanged, this, &CultivatedAreaModel::currentIndexChanged );
+  }
+
+  // the worker for the union of the strips lives as long as the block
+  {
+    qRegisterMetaType<std::shared_ptr<CultivatedAreaUnion>>();
+    qRegisterMetaType<std::vector<CultivatedAreaStrip>*>();
+
+    cgalWorker = new CgalWorker();
+    cgalWorker->moveToThread( threadForCgalWorker );
+
+    QObject::connect( this, &CultivatedAreaModel::requestUnionCultivatedArea, cgalWorker, &CgalWorker::unionCultivatedArea );
+    QObject::connect( cgalWorker, &CgalWorker::unionCultivatedAreaResult, this, &CultivatedAreaModel::unionCultivatedAreaResult );
+  }
+
+  if( saveMenu != nullptr ) {
+    saveAction = saveMenu->addAction( QStringLiteral( "Save Cultivated Area" ) );
+    QObject::connect( saveAction, &QAction::triggered, this, &CultivatedAreaModel::saveCultivatedArea );
+  }
 }
 
 // order is important! Crashes if a parent entity is removed first!
 CultivatedAreaModel::~CultivatedAreaModel() {
+  if( saveAction != nullptr ) {
+    saveAction->deleteLater();
+  }
+
+  cgalWorker->deleteLater();
+
+  m_lod->setEnabled( false );
+  m_distanceMeasurementEntity->setEnabled( false );
   m_baseEntity->setEnabled( false );
 
+  m_lod->deleteLater();
+  m_distanceMeasurementEntity->deleteLater();
   m_baseEntity->deleteLater();
 }
 
@@ -74,6 +132,8 @@ void CultivatedAreaModel::emitConfigSignals() {
 
 void CultivatedAreaModel::setPose( const Eigen::Vector3d& position, const Eigen::Quaterniond& orientation, const PoseOption::Options& options ) {
   if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+    m_distanceMeasurementTransform->setTranslation( toQVector3D( position ) );
+
     if( implement != nullptr ) {
       m_baseTransform->setTranslation( QVector3D( 0, 0, position.z() ) );
 
@@ -95,7 +155,7 @@ void CultivatedAreaModel::setPose( const Eigen::Vector3d& position, const Eigen:
 
           if( mesh->vertexCount() > 1000 ) {
             qDebug() << "activeSectionsMeshes.at( i )->vertexCount() > 1000";
-            mesh->optimise( threadForCgalWorker );
+            optimiseMesh( mesh );
             sectionMeshes.at( i ) = createNewMesh();
             sectionMeshes.at( i )->addPoints( pointLeft, pointRight );
           }
@@ -113,7 +173,7 @@ void CultivatedAreaModel::setImplement( const QPointer<Implement>& implement ) {
     for( auto* mesh : sectionMeshes ) {
       if( mesh != nullptr ) {
         if( mesh->vertexCount() > 3 ) {
-          mesh->optimise( threadForCgalWorker );
+          optimiseMesh( mesh );
         } else {
           mesh->deleteLater();
         }
@@ -158,6 +218,116 @@ CultivatedAreaMesh* CultivatedAreaModel::createNewMesh() {
   return mesh;
 }
 
+void CultivatedAreaModel::optimiseMesh( CultivatedAreaMesh* mesh ) {
+  // when the strip is simplified, it gets merged into the union of the cultivated area
+  QObject::connect( mesh, &CultivatedAreaMesh::optimisationFinished, this, [this, mesh]() {
+    meshesWaitingForUnion.push_back( mesh );
+    unionCultivatedArea();
+  } );
+
+  mesh->optimise( threadForCgalWorker );
+}
+
+void CultivatedAreaModel::unionCultivatedArea() {
+  if( !unionRunning && !meshesWaitingForUnion.empty() ) {
+    auto* strips = new std::vector<CultivatedAreaStrip>();
+    strips->reserve( meshesWaitingForUnion.size() );
+
+    for( const auto* mesh : meshesWaitingForUnion ) {
+      strips->push_back( CultivatedAreaStrip{ mesh->getTrackPointsLeft(), mesh->getTrackPointsRight() } );
+    }
+
+    meshesInUnion.swap( meshesWaitingForUnion );
+    meshesWaitingForUnion.clear();
+
+    unionRunning = true;
+    Q_EMIT requestUnionCultivatedArea( cultivatedAreaUnion, strips );
+  }
+}
+
+void CultivatedAreaModel::unionCultivatedAreaResult( const std::shared_ptr<CultivatedAreaUnion>& result ) {
+  cultivatedAreaUnion = result;
+
+  unionMesh->setTriangles( result->vertices, result->indices );
+  unionMeshCoarse->setTriangles( result->verticesCoarse, result->indicesCoarse );
+
+  // the strips are now part of the union, so remove them
+  for( auto* mesh : meshesInUnion ) {
+    mesh->parent()->deleteLater();
+  }
+
+  meshesInUnion.clear();
+  unionRunning = false;
+
+  Q_EMIT areaChanged( result->area );
+
+  unionCultivatedArea();
+}
+
+void CultivatedAreaModel::currentIndexChanged( const int currentIndex ) {
+  // only the union is switched; the strips that are still recorded are always shown in full detail
+  const bool coarse = currentIndex != 0;
+  qobject_cast<Qt3DCore::QEntity*>( unionMesh->parent() )->setEnabled( !coarse );
+  qobject_cast<Qt3DCore::QEntity*>( unionMeshCoarse->parent() )->setEnabled( coarse );
+}
+
+void CultivatedAreaModel::saveCultivatedArea() {
+  if( cultivatedAreaUnion != nullptr ) {
+    QString selectedFilter = QStringLiteral( "GeoJSON Files (*.geojson)" );
+    QString dir;
+    QString fileName = QFileDialog::getSaveFileName( mainWindow,
+                       tr( "Save Cultivated Area" ),
+                       dir,
+                       tr( "All Files (*);;GeoJSON Files (*.geojson)" ),
+                       &selectedFilter );
+
+    if( !fileName.isEmpty() ) {
+
+      QFile saveFile( fileName );
+
+      if( !saveFile.open( QIODevice::WriteOnly ) ) {
+        qWarning() << "Couldn't open save file.";
+        return;
+      }
+
+      saveCultivatedAreaToFile( saveFile );
+    }
+  }
+}
+
+void CultivatedAreaModel::saveCultivatedAreaToFile( QFile& file ) {
+  auto geoJsonHelper = GeoJsonHelper();
+
+  auto addRing = [this]( GeoJsonHelper::PolygonType & polygon, const Polygon_2 & ring ) {
+    auto points = GeoJsonHelper::MultiPointType();
+
+    for( const auto& vi : ring ) {
+      points.emplace_back( tmw->Reverse( toEigenVector( vi ) ) );
+    }
+
+    // add the first point again to close the ring
+    points.push_back( points.front() );
+
+    polygon.emplace_back( points );
+  };
+
+  if( cultivatedAreaUnion != nullptr ) {
+    for( const auto& polygonWithHoles : cultivatedAreaUnion->polygons ) {
+      auto polygon = GeoJsonHelper::PolygonType();
+
+      addRing( polygon, polygonWithHoles.outer_boundary() );
+
+      for( auto hole = polygonWithHoles.holes_begin(), end = polygonWithHoles.holes_end(); hole != end; ++hole ) {
+        addRing( polygon, *hole );
+      }
+
+      geoJsonHelper.addFeature( GeoJsonHelper::GeometryType::Polygon, polygon );
+    }
+  }
+
+  geoJsonHelper.save( file );
+}
+
 void CultivatedAreaModel::setSections() {
   if( implement != nullptr ) {
     size_t numSections = implement->sections.size();
@@ -181,7 +351,7 @@ void CultivatedAreaModel::setSections() {
       } else {
         if( sectionMeshes.at( sectionIndex ) != nullptr ) {
           if( sectionMeshes.at( sectionIndex )->vertexCount() > 3 ) {
-            sectionMeshes.at( sectionIndex )->optimise( threadForCgalWorker );
+            optimiseMesh( sectionMeshes.at( sectionIndex ) );
           } else {
             sectionMeshes.at( sectionIndex )->deleteLater();
           }
@@ -193,15 +363,24 @@ void CultivatedAreaModel::setSections() {
   }
 }
 
-CultivatedAreaModelFactory::CultivatedAreaModelFactory( Qt3DCore::QEntity* rootEntity, bool usePBR )
-  : rootEntity( rootEntity ),
+CultivatedAreaModelFactory::CultivatedAreaModelFactory( QWidget* mainWindow,
+    QMenu* saveMenu,
+    Qt3DCore::QEntity* rootEntity,
+    Qt3DRender::QCamera* cameraEntity,
+    bool usePBR,
+    GeographicConvertionWrapper* tmw )
+  : mainWindow( mainWindow ),
+    saveMenu( saveMenu ),
+    rootEntity( rootEntity ),
+    cameraEntity( cameraEntity ),
     usePBR( usePBR ),
+    tmw( tmw ),
     threadForCgalWorker( new CgalThread( this ) ) {
   threadForCgalWorker->start();
 }
 
 QNEBlock* CultivatedAreaModelFactory::createBlock( QGraphicsScene* scene, int id ) {
-  auto* obj = new CultivatedAreaModel( rootEntity, threadForCgalWorker );
+  auto* obj = new CultivatedAreaModel( mainWindow, saveMenu, rootEntity, cameraEntity, threadForCgalWorker, tmw );
   auto* b = createBaseBlock( scene, obj, id );
 
   b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ) );
@@ -209,6 +388,7 @@ QNEBlock* CultivatedAreaModelFactory::createBlock( QGraphicsScene* scene, int id
   b->addInputPort( QStringLiteral( "Section Control Data" ), QLatin1String( SLOT( setSections() ) ) );
 
   b->addOutputPort( QStringLiteral( "Cultivated Area" ), QLatin1String( SIGNAL( layerChanged( Qt3DRender::QLayer* ) ) ) );
+  b->addOutputPort( QStringLiteral( "Area" ), QLatin1String( SIGNAL( areaChanged( const double ) ) ) );
 
   b->setBrush( modelColor );
 
@@ -21,12 +21,15 @@
 #include <QObject>
 #include <QPointer>
 
+#include <memory>
+
 #include <Qt3DCore/QEntity>
 #include <Qt3DCore/QTransform>
 
 #include <Qt3DRender/QGeometry>
 #include <Qt3DRender/QGeometryRenderer>
 #include <Qt3DRender/QLayer>
+#include <Qt3DRender/QLevelOfDetail>
 
 #include <Qt3DExtras/QMetalRoughMaterial>
 #include <Qt3DExtras/QDiffuseSpecularMaterial>
@@ -38,15 +41,29 @@
 
 #include "../sectionControl/Implement.h"
 
+class QWidget;
+class QFile;
+class QMenu;
+class QAction;
+
 class CgalThread;
+class CgalWorker;
 class CultivatedAreaMesh;
 class Implement;
+class GeographicConvertionWrapper;
+struct CultivatedAreaStrip;
+struct CultivatedAreaUnion;
 
 class CultivatedAreaModel : public BlockBase {
     Q_OBJECT
 
   public:
-    explicit CultivatedAreaModel( Qt3DCore::QEntity* rootEntity, CgalThread* threadForCgalWorker );
+    explicit CultivatedAreaModel( QWidget* mainWindow,
+                                  QMenu* saveMenu,
+                                  Qt3DCore::QEntity* rootEntity,
+                                  Qt3DRender::QCamera* cameraEntity,
+                                  CgalThread* threadForCgalWorker,
+                                  GeographicConvertionWrapper* tmw );
     ~CultivatedAreaModel();
 
     virtual void emitConfigSignals() override;
@@ -56,14 +73,31 @@ class CultivatedAreaModel : public BlockBase {
     void setImplement( const QPointer<Implement>& );
     void setSections();
 
+    void saveCultivatedArea();
+    void saveCultivatedAreaToFile( QFile& file );
+
+  private Q_SLOTS:
+    void unionCultivatedAreaResult( const std::shared_ptr<CultivatedAreaUnion>& result );
+    void currentIndexChanged( const int currentIndex );
+
   Q_SIGNALS:
     void layerChanged( Qt3DRender::QLayer* );
+    void areaChanged( const double );
+
+    void requestUnionCultivatedArea( std::shared_ptr<CultivatedAreaUnion>, std::vector<CultivatedAreaStrip>* );
 
   private:
     CultivatedAreaMesh* createNewMesh();
+    void optimiseMesh( CultivatedAreaMesh* mesh );
+    void unionCultivatedArea();
 
   private:
+    QWidget* mainWindow = nullptr;
+    QAction* saveAction = nullptr;
+    GeographicConvertionWrapper* tmw = nullptr;
+
     CgalThread* threadForCgalWorker = nullptr;
+    CgalWorker* cgalWorker = nullptr;
 
     Qt3DCore::QEntity* m_baseEntity = nullptr;
     Qt3DCore::QTransform* m_baseTransform = nullptr;
@@ -73,17 +107,36 @@ class CultivatedAreaModel : public BlockBase {
 
     Qt3DRender::QLayer* m_layer;
 
+    Qt3DCore::QEntity* m_distanceMeasurementEntity = nullptr;
+    Qt3DCore::QTransform* m_distanceMeasurementTransform = nullptr;
+    Qt3DRender::QLevelOfDetail* m_lod = nullptr;
+
     QPointer<Implement> implement;
 
     std::vector<double> sectionOffsets;
     std::vector<CultivatedAreaMesh*> sectionMeshes;
+
+    // finished strips get merged in batches into one polygon set on the worker thread:
+    // the strips finished while a union runs are collected and merged with the next run
+    std::vector<CultivatedAreaMesh*> meshesWaitingForUnion;
+    std::vector<CultivatedAreaMesh*> meshesInUnion;
+    bool unionRunning = false;
+
+    std::shared_ptr<CultivatedAreaUnion> cultivatedAreaUnion;
+    CultivatedAreaMesh* unionMesh = nullptr;
+    CultivatedAreaMesh* unionMeshCoarse = nullptr;
 };
 
 class CultivatedAreaModelFactory : public BlockFactory {
     Q_OBJECT
 
   public:
-    CultivatedAreaModelFactory( Qt3DCore::QEntity* rootEntity, bool usePBR );
+    CultivatedAreaModelFactory( QWidget* mainWindow,
+                                QMenu* saveMenu,
+                                Qt3DCore::QEntity* rootEntity,
+                                Qt3DRender::QCamera* cameraEntity,
+                                bool usePBR,
+                                GeographicConvertionWrapper* tmw );
 
     QString getNameOfFactory() override {
       return QStringLiteral( "Cultivated Area Model" );
@@ -96,7 +149,11 @@ class CultivatedAreaModelFactory : public BlockFactory {
     virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override;
 
   private:
+    QWidget* mainWindow = nullptr;
+    QMenu* saveMenu = nullptr;
     Qt3DCore::QEntity* rootEntity = nullptr;
+    Qt3DRender::QCamera* cameraEntity = nullptr;
     bool usePBR = true;
+    GeographicConvertionWrapper* tmw = nullptr;
     CgalThread* threadForCgalWorker = nullptr;
 };
@@ -28,6 +28,8 @@
 #include <Qt3DCore/QTransform>
 #include <Qt3DRender/QAttribute>
 #include <Qt3DRender/QBuffer>
+#include <Qt3DRender/QCamera>
+#include <Qt3DRender/QLevelOfDetail>
 #include <Qt3DRender/QTexture>
 #include <Qt3DRender/QTextureWrapMode>
 
@@ -63,10 +65,19 @@
 #include <QJsonObject>
 #include <QBrush>
 #include <utility>
+#include <algorithm>
+#include <cmath>
 
 
-PathPlannerModel::PathPlannerModel( Qt3DCore::QEntity* rootEntity )
+PathPlannerModel::PathPlannerModel( Qt3DCore::QEntity* rootEntity, Qt3DRender::QCamera* cameraEntity )
   : rootEntity( rootEntity ) {
+  m_distanceMeasurementEntity = new Qt3DCore::QEntity( rootEntity );
+  m_distanceMeasurementTransform = new Qt3DCore::QTransform( m_distanceMeasurementEntity );
+  m_distanceMeasurementEntity->addComponent( m_distanceMeasurementTransform );
+  m_lod = new Qt3DRender::QLevelOfDetail( m_distanceMeasurementEntity );
+  m_lod->setCamera( cameraEntity );
+  m_lod->setThresholds( {150, 600, 2400} );
+  m_distanceMeasurementEntity->addComponent( m_lod );
 
   baseEntity = new Qt3DCore::QEntity( rootEntity );
 
@@ -107,6 +118,8 @@ PathPlannerModel::PathPlannerModel( Qt3DCore::QEntity* rootEntity )
   bisectorsEntity->addComponent( bisectorsMaterial );
 
   refreshColors();
+
+  QObject::connect( m_lod, &Qt3DRender::QLevelOfDetail::currentIndexChanged, this, &PathPlannerModel::currentIndexChanged );
 }
 
 void PathPlannerModel::toJSON( QJsonObject& json ) {
@@ -156,6 +169,10 @@ void PathPlannerModel::refreshColors() {
   }
 
   bisectorsMaterial->setAmbient( bisectorsColor );
+
+  // the settings are set directly, so take this as the signal to rebuild everything
+  meshesDirty = true;
+  indexDirty = true;
 }
 
 void PathPlannerModel::setVisible( const bool visible ) {
@@ -164,6 +181,9 @@ void PathPlannerModel::setVisible( const bool visible ) {
 
 void PathPlannerModel::setPlan( const Plan& plan ) {
   this->plan = plan;
+
+  meshesDirty = true;
+  indexDirty = true;
 }
 
 void PathPlannerModel::setPose( const Eigen::Vector3d& position, const Eigen::Quaterniond& orientation, const PoseOption::Options& options ) {
@@ -171,59 +191,208 @@ void PathPlannerModel::setPose( const Eigen::Vector3d& position, const Eigen::Qu
     this->position = position;
     this->orientation = orientation;
 
-    if( visible ) {
+    m_distanceMeasurementTransform->setTranslation( toQVector3D( position ) );
+
+    if( meshesNeedUpdate() ) {
+      updateMeshes();
+    }
+  }
+}
+
+void PathPlannerModel::currentIndexChanged( const int currentIndex ) {
+  // the last threshold is the maximum distance, anything further away uses the coarsest level
+  lodLevel = std::clamp( currentIndex, 0, 2 );
 
-      if( !plan.plan->empty() ) {
-        const Point_2 position2D = to2D( position );
+  meshesDirty = true;
+  updateMeshes();
+}
 
-        Iso_rectangle_2 viewBoxRect( Bbox_2( position2D.x() - viewBox, position2D.y() - viewBox, position2D.x() + viewBox, position2D.y() + viewBox ) );
+bool PathPlannerModel::meshesNeedUpdate() const {
+  if( !visible || meshesDirty || plan.getVersion() != lastPlanVersion ) {
+    return true;
+  }
 
-        QVector<QVector3D> positionsLines;
-        QVector<QVector3D> positionsRays;
-        QVector<QVector3D> positionsSegments;
-        QVector<QVector3D> positionsBisectors;
+  const double viewBoxStep = viewBox * ( 1 << ( 2 * lodLevel ) ) / 4;
 
-        for( const auto& step : * ( plan.plan ) ) {
-          if( const auto* pathLine = step->castToLine() ) {
-            const auto& line = pathLine->line;
+  return std::abs( position.x() - lastUpdatePosition.x() ) > viewBoxStep ||
+         std::abs( position.y() - lastUpdatePosition.y() ) > viewBoxStep;
+}
 
-            auto result = intersection( viewBoxRect, line );
+void PathPlannerModel::rebuildIndex() {
+  // more cells than this and the primitive is always a candidate
+  constexpr double maxCellsPerPrimitive = 1024;
 
-            if( result ) {
-              if( const Segment_2* segment = boost::get<Segment_2>( &*result ) ) {
-                positionsLines << QVector3D( segment->source().x(), segment->source().y(), zOffset );
-                positionsLines << QVector3D( segment->target().x(), segment->target().y(), zOffset );
-              }
+  indexCells.clear();
+  indexUnbounded.clear();
+  indexQueryStamps.assign( plan.plan->size(), 0 );
+  indexQueryStamp = 0;
+  indexCellSize = std::max( viewBox, 1. );
+
+  for( uint32_t i = 0, end = uint32_t( plan.plan->size() ); i < end; ++i ) {
+    const auto& primitive = ( *plan.plan )[i];
+
+    bool bounded = false;
+    Bbox_2 bbox;
+
+    if( const auto* pathSegment = primitive->castToSegment() ) {
+      bounded = true;
+      bbox = pathSegment->segment.bbox();
+    }
+
+    if( const auto* pathSequence = primitive->castToSequence() ) {
+      bounded = !pathSequence->sequence.empty();
+
+      for( const auto& step : pathSequence->sequence ) {
+        if( const auto* pathSegment = step->castToSegment() ) {
+          bbox += pathSegment->segment.bbox();
+        } else {
+          bounded = false;
+          break;
+        }
+      }
+    }
+
+    if( bounded ) {
+      const auto xMin = int32_t( std::floor( bbox.xmin() / indexCellSize ) );
+      const auto xMax = int32_t( std::floor( bbox.xmax() / indexCellSize ) );
+      const auto yMin = int32_t( std::floor( bbox.ymin() / indexCellSize ) );
+      const auto yMax = int32_t( std::floor( bbox.ymax() / indexCellSize ) );
+
+      if( ( double( xMax - xMin + 1 ) * double( yMax - yMin + 1 ) ) <= maxCellsPerPrimitive ) {
+        for( int32_t x = xMin; x <= xMax; ++x ) {
+          for( int32_t y = yMin; y <= yMax; ++y ) {
+            indexCells[( uint64_t( uint32_t( x ) ) << 32 ) | uint32_t( y )].push_back( i );
+          }
+        }
+
+        continue;
+      }
+    }
+
+    indexUnbounded.push_back( i );
+  }
+
+  indexPlanVersion = plan.getVersion();
+  indexDirty = false;
+}
+
+void PathPlannerModel::queryIndex( const Iso_rectangle_2& rect ) {
+  ++indexQueryStamp;
+  candidates.clear();
+
+  auto addCandidate = [this]( const uint32_t index ) {
+    if( indexQueryStamps[index] != indexQueryStamp ) {
+      indexQueryStamps[index] = indexQueryStamp;
+      candidates.push_back( index );
+    }
+  };
+
+  for( const auto index : indexUnbounded ) {
+    addCandidate( index );
+  }
+
+  const auto xMin = int32_t( std::floor( rect.xmin() / indexCellSize ) );
+  const auto xMax = int32_t( std::floor( rect.xmax() / indexCellSize ) );
+  const auto yMin = int32_t( std::floor( rect.ymin() / indexCellSize ) );
+  const auto yMax = int32_t( std::floor( rect.ymax() / indexCellSize ) );
+
+  for( int32_t x = xMin; x <= xMax; ++x ) {
+    for( int32_t y = yMin; y <= yMax; ++y ) {
+      const auto cell = indexCells.find( ( uint64_t( uint32_t( x ) ) << 32 ) | uint32_t( y ) );
+
+      if( cell != indexCells.cend() ) {
+        for( const auto index : cell->second ) {
+          addCandidate( index );
+        }
+      }
+    }
+  }
+
+  // keep the order of the plan, so the same view results in the same vertex data
+  std::sort( candidates.begin(), candidates.end() );
+}
+
+void PathPlannerModel::updateMeshes() {
+  if( visible ) {
+
+    if( !plan.plan->empty() ) {
+      const Point_2 position2D = to2D( position );
+
+      // every level of detail shows only every n-th pass, but in a bigger view box
+      const int32_t decimation = 1 << ( 2 * lodLevel );
+      const double viewBoxScaled = viewBox * decimation;
+
+      // the view box is extended by the distance the vehicle can move before the meshes get rebuilt
+      const double viewBoxStep = viewBoxScaled / 4;
+      const double viewBoxExtent = viewBoxScaled + viewBoxStep;
+
+      Iso_rectangle_2 viewBoxRect( Bbox_2( position2D.x() - viewBoxExtent, position2D.y() - viewBoxExtent,
+                                           position2D.x() + viewBoxExtent, position2D.y() + viewBoxExtent ) );
+
+      meshesDirty = false;
+      lastPlanVersion = plan.getVersion();
+      lastUpdatePosition = position2D;
+
+      if( indexDirty || indexPlanVersion != plan.getVersion() ) {
+        rebuildIndex();
+      }
+
+      queryIndex( viewBoxRect );
+
+      // resize() keeps the capacity of the vectors, so they are reused from update to update
+      positionsLines.resize( 0 );
+      positionsRays.resize( 0 );
+      positionsSegments.resize( 0 );
+      positionsBisectors.resize( 0 );
+
+      for( const auto index : candidates ) {
+        const auto& step = ( *plan.plan )[index];
+
+        if( ( step->passNumber % decimation ) != 0 ) {
+          continue;
+        }
+
+        if( const auto* pathLine = step->castToLine() ) {
+          const auto& line = pathLine->line;
+
+          auto result = intersection( viewBoxRect, line );
+
+          if( result ) {
+            if( const Segment_2* segment = boost::get<Segment_2>( &*result ) ) {
+              positionsLines << QVector3D( segment->source().x(), segment->source().y(), zOffset );
+              positionsLines << QVector3D( segment->target().x(), segment->target().y(), zOffset );
             }
           }
+        }
 
-          if( const auto* pathSegment = step->castToSegment() ) {
-            const auto& segment = pathSegment->segment;
+        if( const auto* pathSegment = step->castToSegment() ) {
+          const auto& segment = pathSegment->segment;
 
-            auto result = intersection( viewBoxRect, segment );
+          auto result = intersection( viewBoxRect, segment );
 
-            if( result ) {
-              if( const Segment_2* segment = boost::get<Segment_2>( &*result ) ) {
-                positionsSegments << QVector3D( segment->source().x(), segment->source().y(), zOffset );
-                positionsSegments << QVector3D( segment->target().x(), segment->target().y(), zOffset );
-              }
+          if( result ) {
+            if( const Segment_2* segment = boost::get<Segment_2>( &*result ) ) {
+              positionsSegments << QVector3D( segment->source().x(), segment->source().y(), zOffset );
+              positionsSegments << QVector3D( segment->target().x(), segment->target().y(), zOffset );
             }
           }
+        }
 
-          if( const auto* pathRay = step->castToRay() ) {
-            const auto& ray = pathRay->ray;
+        if( const auto* pathRay = step->castToRay() ) {
+          const auto& ray = pathRay->ray;
 
-            auto result = intersection( viewBoxRect, ray );
+          auto result = intersection( viewBoxRect, ray );
 
-            if( result ) {
-              if( const Segment_2* segment = boost::get<Segment_2>( &*result ) ) {
-                positionsRays << QVector3D( segment->source().x(), segment->source().y(), zOffset );
-                positionsRays << QVector3D( segment->target().x(), segment->target().y(), zOffset );
-              }
+          if( result ) {
+            if( const Segment_2* segment = boost::get<Segment_2>( &*result ) ) {
+              positionsRays << QVector3D( segment->source().x(), segment->source().y(), zOffset );
+              positionsRays << QVector3D( segment->target().x(), segment->target().y(), zOffset );
             }
           }
+        }
 
-          if( const auto* pathSequence = step->castToSequence() ) {
+        if( const auto* pathSequence = step->castToSequence() ) {
+          if( lodLevel == 0 ) {
             for( const auto& step : pathSequence->sequence ) {
               if( const auto* pathLine = step->castToLine() ) {
                 const auto& line = pathLine->line;
@@ -264,60 +433,114 @@ void PathPlannerModel::setPose( const Eigen::Vector3d& position, const Eigen::Qu
                 }
               }
             }
+          } else {
+            // merge consecutive segments of the sequence into longer ones; the rest is shown as is
+            const auto& sequence = pathSequence->sequence;
+            const Point_2* mergedSource = nullptr;
+            int32_t mergedCount = 0;
+
+            for( std::size_t i = 0; i < sequence.size(); ++i ) {
+              if( const auto* pathSegment = sequence[i]->castToSegment() ) {
+                if( mergedSource == nullptr ) {
+                  mergedSource = &pathSegment->segment.source();
+                  mergedCount = 0;
+                }
 
-            if( bisectorsVisible ) {
-              for( const auto& line : pathSequence->bisectors ) {
-                auto result = intersection( viewBoxRect, line );
+                ++mergedCount;
+
+                const bool lastOfRun = ( i + 1 ) == sequence.size() || sequence[i + 1]->castToSegment() == nullptr;
+
+                if( mergedCount >= decimation || lastOfRun ) {
+                  auto result = intersection( viewBoxRect, Segment_2( *mergedSource, pathSegment->segment.target() ) );
+
+                  if( result ) {
+                    if( const Segment_2* segment = boost::get<Segment_2>( &*result ) ) {
+                      positionsSegments << QVector3D( segment->source().x(), segment->source().y(), zOffset );
+                      positionsSegments << QVector3D( segment->target().x(), segment->target().y(), zOffset );
+                    }
+                  }
+
+                  mergedSource = &pathSegment->segment.target();
+                  mergedCount = 0;
+                }
+
+                if( lastOfRun ) {
+                  mergedSource = nullptr;
+                }
+              } else if( const auto* pathLine = sequence[i]->castToLine() ) {
+                auto result = intersection( viewBoxRect, pathLine->line );
 
                 if( result ) {
                   if( const Segment_2* segment = boost::get<Segment_2>( &*result ) ) {
-                    positionsBisectors << QVector3D( segment->source().x(), segment->source().y(), zOffset );
-                    positionsBisectors << QVector3D( segment->target().x(), segment->target().y(), zOffset );
+                    positionsLines << QVector3D( segment->source().x(), segment->source().y(), zOffset );
+                    positionsLines << QVector3D( segment->target().x(), segment->target().y(), zOffset );
+                  }
+                }
+              } else if( const auto* pathRay = sequence[i]->castToRay() ) {
+                auto result = intersection( viewBoxRect, pathRay->ray );
+
+                if( result ) {
+                  if( const Segment_2* segment = boost::get<Segment_2>( &*result ) ) {
+                    positionsRays << QVector3D( segment->source().x(), segment->source().y(), zOffset );
+                    positionsRays << QVector3D( segment->target().x(), segment->target().y(), zOffset );
                   }
                 }
               }
             }
           }
-        }
 
-        if( !positionsLines.isEmpty() ) {
-          linesMesh->bufferUpdate( positionsLines );
-          linesEntity->setEnabled( true );
-        } else {
-          linesEntity->setEnabled( false );
-        }
+          if( bisectorsVisible && lodLevel == 0 ) {
+            for( const auto& line : pathSequence->bisectors ) {
+              auto result = intersection( viewBoxRect, line );
 
-        if( !positionsRays.isEmpty() ) {
-          raysMesh->bufferUpdate( positionsRays );
-          raysEntity->setEnabled( true );
-        } else {
-          raysEntity->setEnabled( false );
+              if( result ) {
+                if( const Segment_2* segment = boost::get<Segment_2>( &*result ) ) {
+                  positionsBisectors << QVector3D( segment->source().x(), segment->source().y(), zOffset );
+                  positionsBisectors << QVector3D( segment->target().x(), segment->target().y(), zOffset );
+                }
+              }
+            }
+          }
         }
+      }
 
-        if( !positionsSegments.isEmpty() ) {
-          segmentsMesh->bufferUpdate( positionsSegments );
-          segmentsEntity->setEnabled( true );
-        } else {
-          segmentsEntity->setEnabled( false );
-        }
+      if( !positionsLines.isEmpty() ) {
+        linesMesh->bufferUpdate( positionsLines );
+        linesEntity->setEnabled( true );
+      } else {
+        linesEntity->setEnabled( false );
+      }
 
-        if( bisectorsVisible && !positionsBisectors.isEmpty() ) {
-          bisectorsMesh->bufferUpdate( positionsBisectors );
-          bisectorsEntity->setEnabled( true );
-        } else {
-          bisectorsEntity->setEnabled( false );
-        }
+      if( !positionsRays.isEmpty() ) {
+        raysMesh->bufferUpdate( positionsRays );
+        raysEntity->setEnabled( true );
+      } else {
+        raysEntity->setEnabled( false );
+      }
+
+      if( !positionsSegments.isEmpty() ) {
+        segmentsMesh->bufferUpdate( positionsSegments );
+        segmentsEntity->setEnabled( true );
+      } else {
+        segmentsEntity->setEnabled( false );
+      }
 
-        baseEntity->setEnabled( true );
+      if( bisectorsVisible && lodLevel == 0 && !positionsBisectors.isEmpty() ) {
+        bisectorsMesh->bufferUpdate( positionsBisectors );
+        bisectorsEntity->setEnabled( true );
+      } else {
+        bisectorsEntity->setEnabled( false );
       }
-    } else {
-      baseEntity->setEnabled( false );
+
+      baseEntity->setEnabled( true );
     }
+  } else {
+    baseEntity->setEnabled( false );
   }
 }
 
 QNEBlock* PathPlannerModelFactory::createBlock( QGraphicsScene* scene, int id ) {
-  auto* obj = new PathPlannerModel( rootEntity );
+  auto* obj = new PathPlannerModel( rootEntity, m_cameraEntity );
   auto* b = createBaseBlock( scene, obj, id );
 
   b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ) );
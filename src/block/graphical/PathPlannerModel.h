@@ -22,6 +22,7 @@
 
 #include <QVector2D>
 #include <QVector3D>
+#include <QVector>
 
 #include <Qt3DCore/QEntity>
 #include <Qt3DCore/QTransform>
@@ -29,6 +30,7 @@
 #include <Qt3DRender/QTexture>
 #include <Qt3DRender/QTextureWrapMode>
 #include <Qt3DRender/QAttribute>
+#include <Qt3DRender/QLevelOfDetail>
 
 #include <Qt3DExtras/QSphereMesh>
 #include <Qt3DExtras/QPhongMaterial>
@@ -51,12 +53,14 @@
 class BufferMesh;
 
 #include <utility>
+#include <vector>
+#include <unordered_map>
 
 class PathPlannerModel : public BlockBase {
     Q_OBJECT
 
   public:
-    explicit PathPlannerModel( Qt3DCore::QEntity* rootEntity );
+    explicit PathPlannerModel( Qt3DCore::QEntity* rootEntity, Qt3DRender::QCamera* cameraEntity );
 
     void toJSON( QJsonObject& json ) override;
     void fromJSON( QJsonObject& json ) override;
@@ -70,6 +74,16 @@ class PathPlannerModel : public BlockBase {
 
     void setPose( const Eigen::Vector3d& position, const Eigen::Quaterniond& orientation, const PoseOption::Options& options );
 
+  private Q_SLOTS:
+    void currentIndexChanged( const int currentIndex );
+
+  private:
+    bool meshesNeedUpdate() const;
+    void updateMeshes();
+
+    void rebuildIndex();
+    void queryIndex( const Iso_rectangle_2& rect );
+
   public:
     Eigen::Vector3d position = Eigen::Vector3d( 0, 0, 0 );
     Eigen::Quaterniond orientation = Eigen::Quaterniond();
@@ -89,6 +103,13 @@ class PathPlannerModel : public BlockBase {
   private:
     Qt3DCore::QEntity* rootEntity = nullptr;
 
+    Qt3DCore::QEntity* m_distanceMeasurementEntity = nullptr;
+    Qt3DCore::QTransform* m_distanceMeasurementTransform = nullptr;
+    Qt3DRender::QLevelOfDetail* m_lod = nullptr;
+
+    // level of detail: 0 is full resolution, every level shows only every 4th pass in a 4 times bigger view box
+    int lodLevel = 0;
+
     Qt3DCore::QEntity* baseEntity = nullptr;
 
     Qt3DCore::QEntity* linesEntity = nullptr;
@@ -106,15 +127,36 @@ class PathPlannerModel : public BlockBase {
 
   private:
     Plan plan;
+
+    QVector<QVector3D> positionsLines;
+    QVector<QVector3D> positionsRays;
+    QVector<QVector3D> positionsSegments;
+    QVector<QVector3D> positionsBisectors;
+
+    // the meshes are only rebuilt if the plan or the settings changed or the vehicle moved a fraction of the view box
+    bool meshesDirty = true;
+    uint32_t lastPlanVersion = 0;
+    Point_2 lastUpdatePosition = Point_2( 0, 0 );
+
+    // uniform grid over the bounding boxes of the bounded primitives of the plan; the unbounded ones
+    // (lines, rays and primitives covering too many cells) are always candidates
+    bool indexDirty = true;
+    uint32_t indexPlanVersion = 0;
+    double indexCellSize = 1;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> indexCells;
+    std::vector<uint32_t> indexUnbounded;
+    std::vector<uint32_t> indexQueryStamps;
+    uint32_t indexQueryStamp = 0;
+    std::vector<uint32_t> candidates;
 };
 
 class PathPlannerModelFactory : public BlockFactory {
     Q_OBJECT
 
   public:
-    PathPlannerModelFactory( Qt3DCore::QEntity* rootEntity )
+    PathPlannerModelFactory( Qt3DCore::QEntity* rootEntity, Qt3DRender::QCamera* cameraEntity )
       : BlockFactory(),
-        rootEntity( rootEntity ) {}
+        rootEntity( rootEntity ), m_cameraEntity( cameraEntity ) {}
 
     QString getNameOfFactory() override {
       return QStringLiteral( "Path Planner Model" );
@@ -128,4 +170,5 @@ class PathPlannerModelFactory : public BlockFactory {
 
   private:
     Qt3DCore::QEntity* rootEntity = nullptr;
+    Qt3DRender::QCamera* m_cameraEntity = nullptr;
 };
@@ -56,23 +56,33 @@ namespace PS = CGAL::Polyline_simplification_2;
 
 LocalPlanner::LocalPlanner( const QString& uniqueName, MyMainWindow* mainWindow )
   : BlockBase() {
-  widget = new GuidanceTurning( mainWindow );
-  dock = new KDDockWidgets::DockWidget( uniqueName );
-
-  QObject::connect( widget, &GuidanceTurning::turnLeftToggled, this, &LocalPlanner::turnLeftToggled );
-  QObject::connect( widget, &GuidanceTurning::turnRightToggled, this, &LocalPlanner::turnRightToggled );
-  QObject::connect( widget, &GuidanceTurning::numSkipChanged, this, &LocalPlanner::numSkipChanged );
-  QObject::connect( this, &LocalPlanner::resetTurningStateOfDock, widget, &GuidanceTurning::resetTurningState );
+  // without a main window (headless), the turns can't be triggered
+  if( mainWindow != nullptr ) {
+    widget = new GuidanceTurning( mainWindow );
+    dock = new KDDockWidgets::DockWidget( uniqueName );
+
+    QObject::connect( widget, &GuidanceTurning::turnLeftToggled, this, &LocalPlanner::turnLeftToggled );
+    QObject::connect( widget, &GuidanceTurning::turnRightToggled, this, &LocalPlanner::turnRightToggled );
+    QObject::connect( widget, &GuidanceTurning::numSkipChanged, this, &LocalPlanner::numSkipChanged );
+    QObject::connect( this, &LocalPlanner::resetTurningStateOfDock, widget, &GuidanceTurning::resetTurningState );
+  }
 }
 
 LocalPlanner::~LocalPlanner() {
-  dock->deleteLater();
-  widget->deleteLater();
+  if( dock != nullptr ) {
+    dock->deleteLater();
+  }
+
+  if( widget != nullptr ) {
+    widget->deleteLater();
+  }
 }
 
 void LocalPlanner::setName( const QString& name ) {
-  dock->setTitle( name );
-  dock->toggleAction()->setText( QStringLiteral( "Turning Dock: " ) + name );
+  if( dock != nullptr ) {
+    dock->setTitle( name );
+    dock->toggleAction()->setText( QStringLiteral( "Turning Dock: " ) + name );
+  }
 }
 
 void LocalPlanner::setPose( const Eigen::Vector3d& position, const Eigen::Quaterniond& orientation, const PoseOption::Options& options ) {
@@ -88,11 +98,12 @@ void LocalPlanner::setPose( const Eigen::Vector3d& position, const Eigen::Quater
         double distanceSquared = qInf();
         auto nearestPrimitive = globalPlan.getNearestPrimitive( position2D, distanceSquared );
         double distanceNearestPrimitive = std::sqrt( distanceSquared );
+        bool replacePlan = plan.plan->empty();
 
         if( !lastPrimitive || ( !forceCurrentPath && distanceNearestPrimitive < ( std::sqrt( lastPrimitive->distanceToPointSquared( position2D ) ) - pathHysteresis ) ) ) {
           lastPrimitive = *nearestPrimitive;
           plan.type = globalPlan.type;
-          plan.plan->clear();
+          replacePlan = true;
         }
 
         if( lastPrimitive->anyDirection ) {
@@ -104,12 +115,12 @@ void LocalPlanner::setPose( const Eigen::Vector3d& position, const Eigen::Quater
             reverse->anyDirection = false;
             lastPrimitive = reverse;
             plan.type = globalPlan.type;
-            plan.plan->clear();
+            replacePlan = true;
           }
         }
 
-        if( plan.plan->empty() ) {
-          plan.plan->push_back( lastPrimitive );
+        if( replacePlan ) {
+          plan.setPrimitives( std::make_shared<Plan::Primitives>( 1, lastPrimitive ) );
           Q_EMIT planChanged( plan );
         }
       }
@@ -260,10 +271,10 @@ void LocalPlanner::calculateTurning( bool changeExistingTurn ) {
         PS::simplify( polyline.cbegin(), polyline.cend(), cost, PS::Stop_above_cost_threshold( 0.008 ), std::back_inserter( optimizedPolyline ) );
 
         if( !optimizedPolyline.empty() ) {
-          plan.plan->clear();
+          auto primitives = std::make_shared<Plan::Primitives>();
 
           for( size_t i = 0, end = optimizedPolyline.size() - 1; i < end; ++i ) {
-            plan.plan->push_back( std::make_shared<PathPrimitiveSegment>(
+            primitives->push_back( std::make_shared<PathPrimitiveSegment>(
                                           Segment_2( optimizedPolyline.at( i ), optimizedPolyline.at( i + 1 ) ),
                                           0, false, 0 ) );
           }
@@ -274,12 +285,13 @@ void LocalPlanner::calculateTurning( bool changeExistingTurn ) {
             direction = direction.opposite();
           }
 
-          plan.plan->push_back( std::make_shared<PathPrimitiveRay>(
+          primitives->push_back( std::make_shared<PathPrimitiveRay>(
                                         Ray_2( optimizedPolyline.back(), direction ),
                                         false,
                                         0, false, 0 ) );
 
           plan.type = Plan::Type::Mixed;
+          plan.setPrimitives( std::move( primitives ) );
           Q_EMIT planChanged( plan );
         }
       }
@@ -292,12 +304,14 @@ QNEBlock* LocalPlannerFactory::createBlock( QGraphicsScene* scene, int id ) {
                                    mainWindow );
   auto* b = createBaseBlock( scene, object, id );
 
-  object->dock->setTitle( getNameOfFactory() );
-  object->dock->setWidget( object->widget );
+  if( object->dock != nullptr ) {
+    object->dock->setTitle( getNameOfFactory() );
+    object->dock->setWidget( object->widget );
 
-  menu->addAction( object->dock->toggleAction() );
+    menu->addAction( object->dock->toggleAction() );
 
-  mainWindow->addDockWidget( object->dock, location );
+    mainWindow->addDockWidget( object->dock, location );
+  }
 
   b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ) );
   b->addInputPort( QStringLiteral( "Plan" ), QLatin1String( SLOT( setPlan( const Plan& ) ) ) );
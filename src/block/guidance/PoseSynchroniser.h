@@ -32,6 +32,10 @@ class PoseSynchroniser : public BlockBase {
     explicit PoseSynchroniser()
       : BlockBase() {}
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setPosition( const Eigen::Vector3d& position );
 
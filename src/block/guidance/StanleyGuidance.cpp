@@ -21,8 +21,7 @@
 #include "qneblock.h"
 #include "qneport.h"
 
-#include "kinematic/cgal.h"
-#include "kinematic/CgalWorker.h"
+#include <QtMath>
 
 void StanleyGuidance::setSteeringAngle( const double steeringAngle ) {
   steeringAngle2Ago = steeringAngle1Ago;
@@ -39,6 +39,10 @@ class StanleyGuidance : public BlockBase {
     explicit StanleyGuidance()
       : BlockBase() {}
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setSteeringAngle( const double steeringAngle );
 
@@ -38,6 +38,10 @@ class XteGuidance : public BlockBase {
     explicit XteGuidance()
       : BlockBase() {}
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setPose( const Eigen::Vector3d& position, const Eigen::Quaterniond&, const PoseOption::Options& options );
 
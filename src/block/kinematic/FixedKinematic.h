@@ -33,6 +33,10 @@ class FixedKinematic : public BlockBase {
     explicit FixedKinematic()
       : BlockBase() {}
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setOffsetHookToPivot( const Eigen::Vector3d& offset );
     void setOffsetPivotToTow( const Eigen::Vector3d& offset );
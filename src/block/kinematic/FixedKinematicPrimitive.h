@@ -32,6 +32,10 @@ class FixedKinematicPrimitive : public BlockBase {
     explicit FixedKinematicPrimitive()
       : BlockBase() {}
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setOffset( const Eigen::Vector3d& offset );
 
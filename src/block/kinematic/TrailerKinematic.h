@@ -35,6 +35,10 @@ class TrailerKinematic : public BlockBase {
     explicit TrailerKinematic()
       : BlockBase() {}
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setOffsetHookToPivot( const Eigen::Vector3d& offset );
     void setOffsetPivotToTow( const Eigen::Vector3d& offset );
@@ -36,6 +36,10 @@ class TrailerKinematicPrimitive : public BlockBase {
     explicit TrailerKinematicPrimitive()
       : BlockBase() {}
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   public Q_SLOTS:
     void setOffset( const Eigen::Vector3d& offset );
     void setMaxJackknifeAngle( const double maxJackknifeAngle );
@@ -54,7 +54,7 @@ QNEBlock* NumberFactory::createBlock( QGraphicsScene* scene, int id ) {
 
   b->setBrush( valueColor );
 
-  model->resetModel();
+  resetModel( model );
 
   return b;
 }
@@ -133,7 +133,7 @@ QNEBlock* OrientationBlockFactory::createBlock( QGraphicsScene* scene, int id )
 
   b->setBrush( valueColor );
 
-  model->resetModel();
+  resetModel( model );
 
   return b;
 }
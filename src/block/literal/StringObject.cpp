@@ -54,7 +54,7 @@ QNEBlock* StringFactory::createBlock( QGraphicsScene* scene, int id ) {
 
   b->setBrush( valueColor );
 
-  model->resetModel();
+  resetModel( model );
 
   return b;
 }
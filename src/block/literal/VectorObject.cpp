@@ -64,7 +64,7 @@ QNEBlock* VectorFactory::createBlock( QGraphicsScene* scene, int id ) {
 
   b->setBrush( valueColor );
 
-  model->resetModel();
+  resetModel( model );
 
   return b;
 }
@@ -0,0 +1,370 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "NmeaParser.h"
+
+#include "qneblock.h"
+#include "qneport.h"
+
+#include "block/MeasurementTimestamp.h"
+
+#include "helpers/anglesHelper.h"
+
+#include <QBrush>
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+namespace {
+  // the UTC time of a sentence is the time of validity of its values; the emits carry it
+  MeasurementTimestamp timestampOfNmeaTime( const std::string_view field ) {
+    double secondsOfDay = 0;
+
+    if( MeasurementTimestamp::secondsOfDayFromNmea( field, secondsOfDay ) ) {
+      return MeasurementTimestamp::withValidity( MeasurementTimestamp::TimeBase::UtcTimeOfDay, secondsOfDay );
+    }
+
+    return MeasurementTimestamp::current();
+  }
+
+  // 1kn = 463m/900s
+  constexpr double MetersPerSecondPerKnot = 463. / 900.;
+}
+
+NmeaParser::NmeaParser() {
+  // resize( 0 ) keeps a reserved capacity, so the pending sentence never allocates
+  pending.reserve( MaxPendingSize );
+}
+
+void NmeaParser::setData( const QByteArray& data ) {
+  const auto parse = [this]( const NmeaSentence & sentence ) {
+    parseSentence( sentence );
+  };
+
+  // the usual case: the last chunk ended with a complete sentence, so the new one is parsed in place
+  if( pending.isEmpty() ) {
+    const auto consumed = tokenizer.tokenize( std::string_view( data.constData(), std::size_t( data.size() ) ), parse );
+    pending.append( data.constData() + consumed, data.size() - int( consumed ) );
+  } else {
+    pending.append( data );
+    const auto consumed = tokenizer.tokenize( std::string_view( pending.constData(), std::size_t( pending.size() ) ), parse );
+    pending.remove( 0, int( consumed ) );
+  }
+
+  if( pending.size() > MaxPendingSize ) {
+    pending.resize( 0 );
+  }
+
+  if( tokenizer.checksumErrors != reportedChecksumErrors ) {
+    reportedChecksumErrors = tokenizer.checksumErrors;
+    Q_EMIT checksumErrorsChanged( double( reportedChecksumErrors ) );
+  }
+}
+
+void NmeaParser::parseSentence( const NmeaSentence& sentence ) {
+  // as most users will have either a M8T or F9P, the interface documentation of ublox
+  // is used for the format of the NMEA sentences
+  // https://www.u-blox.com/de/product/zed-f9p-module -> interface manual
+  if( sentence.type == "GGA" ) {
+    parseGGA( sentence );
+  } else if( sentence.type == "RMC" ) {
+    parseRMC( sentence );
+  } else if( sentence.type == "HDT" ) {
+    parseHDT( sentence );
+  } else if( sentence.type == "VTG" ) {
+    parseVTG( sentence );
+  } else if( sentence.type == "GST" ) {
+    parseGST( sentence );
+  } else if( sentence.type == "GNS" ) {
+    parseGNS( sentence );
+  }
+}
+
+// time, lat, N/S, lon, E/W, quality, numSV, HDOP, alt, M, sep, M, diffAge, diffStation
+void NmeaParser::parseGGA( const NmeaSentence& sentence ) {
+  MeasurementTimestamp::Scope timestampScope( timestampOfNmeaTime( sentence.field( 0 ) ) );
+
+  double value = 0;
+
+  if( NmeaTokenizer::toDouble( sentence.field( 5 ), value ) ) {
+    Q_EMIT fixQualityChanged( value );
+  }
+
+  if( NmeaTokenizer::toDouble( sentence.field( 6 ), value ) ) {
+    Q_EMIT numSatelitesChanged( value );
+  }
+
+  if( NmeaTokenizer::toDouble( sentence.field( 7 ), value ) ) {
+    Q_EMIT hdopChanged( value );
+  }
+
+  if( NmeaTokenizer::toDouble( sentence.field( 12 ), value ) ) {
+    Q_EMIT ageOfDifferentialDataChanged( value );
+  }
+
+  double latitude = 0;
+  double longitude = 0;
+  double height = 0;
+
+  if( NmeaTokenizer::toDegrees( sentence.field( 1 ), sentence.field( 2 ), latitude ) &&
+      NmeaTokenizer::toDegrees( sentence.field( 3 ), sentence.field( 4 ), longitude ) ) {
+    NmeaTokenizer::toDouble( sentence.field( 8 ), height );
+    Q_EMIT globalPositionChanged( Eigen::Vector3d( latitude, longitude, height ) );
+  }
+}
+
+// like GGA, but for more than 12 satelites and with the modes of the constellations instead of the quality:
+// time, lat, N/S, lon, E/W, posMode, numSV, HDOP, alt, sep, diffAge, diffStation, navStatus
+void NmeaParser::parseGNS( const NmeaSentence& sentence ) {
+  MeasurementTimestamp::Scope timestampScope( timestampOfNmeaTime( sentence.field( 0 ) ) );
+
+  const auto posMode = sentence.field( 5 );
+
+  if( !posMode.empty() ) {
+    // the mode of the first constellation to the quality of GGA
+    double fixQuality = 0;
+
+    switch( posMode.front() ) {
+      case 'A':
+        fixQuality = 1;
+        break;
+
+      case 'D':
+        fixQuality = 2;
+        break;
+
+      case 'P':
+        fixQuality = 3;
+        break;
+
+      case 'R':
+        fixQuality = 4;
+        break;
+
+      case 'F':
+        fixQuality = 5;
+        break;
+
+      case 'E':
+        fixQuality = 6;
+        break;
+
+      case 'M':
+        fixQuality = 7;
+        break;
+
+      case 'S':
+        fixQuality = 8;
+        break;
+
+      default:
+        break;
+    }
+
+    Q_EMIT fixQualityChanged( fixQuality );
+  }
+
+  double value = 0;
+
+  if( NmeaTokenizer::toDouble( sentence.field( 6 ), value ) ) {
+    Q_EMIT numSatelitesChanged( value );
+  }
+
+  if( NmeaTokenizer::toDouble( sentence.field( 7 ), value ) ) {
+    Q_EMIT hdopChanged( value );
+  }
+
+  if( NmeaTokenizer::toDouble( sentence.field( 10 ), value ) ) {
+    Q_EMIT ageOfDifferentialDataChanged( value );
+  }
+
+  double latitude = 0;
+  double longitude = 0;
+  double height = 0;
+
+  if( NmeaTokenizer::toDegrees( sentence.field( 1 ), sentence.field( 2 ), latitude ) &&
+      NmeaTokenizer::toDegrees( sentence.field( 3 ), sentence.field( 4 ), longitude ) ) {
+    NmeaTokenizer::toDouble( sentence.field( 8 ), height );
+    Q_EMIT globalPositionChanged( Eigen::Vector3d( latitude, longitude, height ) );
+  }
+}
+
+// time, status, lat, N/S, lon, E/W, spd, cog, date, mv, mvEW, posMode, navStatus
+void NmeaParser::parseRMC( const NmeaSentence& sentence ) {
+  // V: the receiver has no valid position
+  if( sentence.field( 1 ) != "A" ) {
+    return;
+  }
+
+  MeasurementTimestamp::Scope timestampScope( timestampOfNmeaTime( sentence.field( 0 ) ) );
+
+  double value = 0;
+
+  if( NmeaTokenizer::toDouble( sentence.field( 6 ), value ) ) {
+    Q_EMIT velocityChanged( value * MetersPerSecondPerKnot );
+  }
+
+  if( NmeaTokenizer::toDouble( sentence.field( 7 ), value ) ) {
+    Q_EMIT courseOverGroundChanged( value );
+  }
+
+  double latitude = 0;
+  double longitude = 0;
+
+  if( NmeaTokenizer::toDegrees( sentence.field( 2 ), sentence.field( 3 ), latitude ) &&
+      NmeaTokenizer::toDegrees( sentence.field( 4 ), sentence.field( 5 ), longitude ) ) {
+    Q_EMIT globalPositionRmcChanged( Eigen::Vector3d( latitude, longitude, 0 ) );
+  }
+}
+
+// cogt, T, cogm, M, sogn, N, sogk, K, posMode
+void NmeaParser::parseVTG( const NmeaSentence& sentence ) {
+  double value = 0;
+
+  if( NmeaTokenizer::toDouble( sentence.field( 6 ), value ) ) {
+    Q_EMIT velocityChanged( value / 3.6 );
+  } else if( NmeaTokenizer::toDouble( sentence.field( 4 ), value ) ) {
+    Q_EMIT velocityChanged( value * MetersPerSecondPerKnot );
+  }
+
+  if( NmeaTokenizer::toDouble( sentence.field( 0 ), value ) ) {
+    Q_EMIT courseOverGroundChanged( value );
+  }
+}
+
+// https://www.trimble.com/OEM_ReceiverHelp/V4.44/en/NMEA-0183messages_HDT.html
+// heading, T
+void NmeaParser::parseHDT( const NmeaSentence& sentence ) {
+  double heading = 0;
+
+  if( NmeaTokenizer::toDouble( sentence.field( 0 ), heading ) ) {
+    Q_EMIT orientationChanged( Eigen::Quaterniond( Eigen::AngleAxisd( degreesToRadians( heading ), Eigen::Vector3d::UnitZ() ) ) );
+  }
+}
+
+// time, rangeRms, stdMajor, stdMinor, orient, stdLat, stdLong, stdAlt
+void NmeaParser::parseGST( const NmeaSentence& sentence ) {
+  MeasurementTimestamp::Scope timestampScope( timestampOfNmeaTime( sentence.field( 0 ) ) );
+
+  double value = 0;
+
+  if( NmeaTokenizer::toDouble( sentence.field( 1 ), value ) ) {
+    Q_EMIT rmsOfPseudorangeResidualsChanged( value );
+  }
+
+  double latitude = 0;
+  double longitude = 0;
+  double height = 0;
+
+  if( NmeaTokenizer::toDouble( sentence.field( 5 ), latitude ) &&
+      NmeaTokenizer::toDouble( sentence.field( 6 ), longitude ) &&
+      NmeaTokenizer::toDouble( sentence.field( 7 ), height ) ) {
+    Q_EMIT positionStandardDeviationChanged( Eigen::Vector3d( latitude, longitude, height ) );
+  }
+}
+
+NmeaParser::BenchmarkResult NmeaParser::benchmark( const QByteArray& data, const int chunkSize, const double seconds ) {
+  BenchmarkResult result;
+
+  if( data.isEmpty() || chunkSize <= 0 ) {
+    return result;
+  }
+
+  NmeaParser parser;
+  QElapsedTimer timer;
+  timer.start();
+
+  do {
+    for( int offset = 0; offset < data.size(); offset += chunkSize ) {
+      parser.setData( QByteArray::fromRawData( data.constData() + offset, std::min( chunkSize, data.size() - offset ) ) );
+    }
+  } while( double( timer.nsecsElapsed() ) < seconds * 1e9 );
+
+  const double elapsedSeconds = double( timer.nsecsElapsed() ) / 1e9;
+
+  result.megabytesPerSecond = double( parser.tokenizer.bytes ) / elapsedSeconds / 1e6;
+  result.sentencesPerSecond = double( parser.tokenizer.sentences ) / elapsedSeconds;
+  result.checksumErrors = parser.tokenizer.checksumErrors;
+
+  return result;
+}
+
+QNEBlock* NmeaParserFactory::createBlock( QGraphicsScene* scene, int id ) {
+  auto* obj = new NmeaParser();
+  auto* b = createBaseBlock( scene, obj, id );
+
+  b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( setData( const QByteArray& ) ) ) );
+
+  b->addOutputPort( QStringLiteral( "WGS84 Position" ), QLatin1String( SIGNAL( globalPositionChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Fix Quality" ), QLatin1String( SIGNAL( fixQualityChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "HDOP" ), QLatin1String( SIGNAL( hdopChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Num Satelites" ), QLatin1String( SIGNAL( numSatelitesChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Age of Differential Data" ), QLatin1String( SIGNAL( ageOfDifferentialDataChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "WGS84 Position RMC" ), QLatin1String( SIGNAL( globalPositionRmcChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Velocity" ), QLatin1String( SIGNAL( velocityChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Course over Ground" ), QLatin1String( SIGNAL( courseOverGroundChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Orientation" ), QLatin1String( SIGNAL( orientationChanged( const Eigen::Quaterniond& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Position Std Dev" ), QLatin1String( SIGNAL( positionStandardDeviationChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "RMS Residuals" ), QLatin1String( SIGNAL( rmsOfPseudorangeResidualsChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Checksum Errors" ), QLatin1String( SIGNAL( checksumErrorsChanged( const double ) ) ) );
+
+  b->setBrush( parserColor );
+
+  return b;
+}
+
+QNEBlock* NmeaParserGGAFactory::createBlock( QGraphicsScene* scene, int id ) {
+  auto* obj = new NmeaParser();
+  auto* b = createBaseBlock( scene, obj, id );
+
+  b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( setData( const QByteArray& ) ) ) );
+
+  b->addOutputPort( QStringLiteral( "WGS84 Position" ), QLatin1String( SIGNAL( globalPositionChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Fix Quality" ), QLatin1String( SIGNAL( fixQualityChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "HDOP" ), QLatin1String( SIGNAL( hdopChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Num Satelites" ), QLatin1String( SIGNAL( numSatelitesChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Age of Differential Data" ), QLatin1String( SIGNAL( ageOfDifferentialDataChanged( const double ) ) ) );
+
+  b->setBrush( parserColor );
+
+  return b;
+}
+
+QNEBlock* NmeaParserHDTFactory::createBlock( QGraphicsScene* scene, int id ) {
+  auto* obj = new NmeaParser();
+  auto* b = createBaseBlock( scene, obj, id );
+
+  b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( setData( const QByteArray& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Orientation" ), QLatin1String( SIGNAL( orientationChanged( const Eigen::Quaterniond& ) ) ) );
+
+  b->setBrush( parserColor );
+
+  return b;
+}
+
+QNEBlock* NmeaParserRMCFactory::createBlock( QGraphicsScene* scene, int id ) {
+  auto* obj = new NmeaParser();
+  auto* b = createBaseBlock( scene, obj, id );
+
+  b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( setData( const QByteArray& ) ) ) );
+  b->addOutputPort( QStringLiteral( "WGS84 Position" ), QLatin1String( SIGNAL( globalPositionRmcChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Velocity" ), QLatin1String( SIGNAL( velocityChanged( const double ) ) ) );
+
+  b->setBrush( parserColor );
+
+  return b;
+}
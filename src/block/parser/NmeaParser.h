@@ -0,0 +1,184 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+
+#include "block/BlockBase.h"
+
+#include "helpers/eigenHelper.h"
+
+#include "NmeaTokenizer.h"
+
+// the front-end for NMEA streams: parses all complete sentences of every chunk in one pass over the bytes and
+// dispatches GGA, GNS, HDT, RMC, VTG and GST to their outputs. Only an incomplete sentence at the end of a chunk is
+// kept for the next one.
+class NmeaParser : public BlockBase {
+    Q_OBJECT
+
+  public:
+    explicit NmeaParser();
+
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
+    struct BenchmarkResult {
+      double megabytesPerSecond = 0;
+      double sentencesPerSecond = 0;
+      uint64_t checksumErrors = 0;
+    };
+
+    // feeds data in chunks of chunkSize bytes (like the reads of a serial port) for at least seconds
+    static BenchmarkResult benchmark( const QByteArray& data, const int chunkSize, const double seconds );
+
+  Q_SIGNALS:
+    // GGA and GNS
+    void globalPositionChanged( const Eigen::Vector3d& );
+    void fixQualityChanged( const double );
+    void hdopChanged( const double );
+    void numSatelitesChanged( const double );
+    void ageOfDifferentialDataChanged( const double );
+
+    // RMC has no height
+    void globalPositionRmcChanged( const Eigen::Vector3d& );
+
+    // RMC and VTG; m/s and degrees
+    void velocityChanged( const double );
+    void courseOverGroundChanged( const double );
+
+    // HDT
+    void orientationChanged( const Eigen::Quaterniond& );
+
+    // GST; the standard deviations of latitude, longitude and height in m
+    void positionStandardDeviationChanged( const Eigen::Vector3d& );
+    void rmsOfPseudorangeResidualsChanged( const double );
+
+    void checksumErrorsChanged( const double );
+
+  public Q_SLOTS:
+    void setData( const QByteArray& data );
+
+  private:
+    void parseSentence( const NmeaSentence& sentence );
+
+    void parseGGA( const NmeaSentence& sentence );
+    void parseGNS( const NmeaSentence& sentence );
+    void parseRMC( const NmeaSentence& sentence );
+    void parseVTG( const NmeaSentence& sentence );
+    void parseHDT( const NmeaSentence& sentence );
+    void parseGST( const NmeaSentence& sentence );
+
+  private:
+    // NMEA limits a sentence to 82 chars; anything longer without a newline is garbage
+    static constexpr int MaxPendingSize = 4096;
+
+    NmeaTokenizer tokenizer;
+    QByteArray pending;
+    uint64_t reportedChecksumErrors = 0;
+};
+
+class NmeaParserFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    NmeaParserFactory()
+      : BlockFactory() {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "NMEA Parser" );
+    }
+
+    QString getCategoryOfFactory() override {
+      return QStringLiteral( "Parsers" );
+    }
+
+    QString getPrettyNameOfFactory() override {
+      return QStringLiteral( "NMEA Parser for GGA/GNS/RMC/VTG/HDT/GST sentences" );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override;
+};
+
+// the parsers of single sentences of older configs; they are a NmeaParser with the ports of the old blocks
+class NmeaParserGGAFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    NmeaParserGGAFactory()
+      : BlockFactory() {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "NMEA Parser GGA/GNS" );
+    }
+
+    QString getCategoryOfFactory() override {
+      return QStringLiteral( "Parsers" );
+    }
+
+    QString getPrettyNameOfFactory() override {
+      return QStringLiteral( "NMEA Parser for GGA/GNS sentences" );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override;
+};
+
+class NmeaParserHDTFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    NmeaParserHDTFactory()
+      : BlockFactory() {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "NMEA Parser HDT" );
+    }
+
+    QString getCategoryOfFactory() override {
+      return QStringLiteral( "Parsers" );
+    }
+
+    QString getPrettyNameOfFactory() override {
+      return QStringLiteral( "NMEA Parser for HDT sentences" );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override;
+};
+
+class NmeaParserRMCFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    NmeaParserRMCFactory()
+      : BlockFactory() {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "NMEA Parser RMC" );
+    }
+
+    QString getCategoryOfFactory() override {
+      return QStringLiteral( "Parsers" );
+    }
+
+    QString getPrettyNameOfFactory() override {
+      return QStringLiteral( "NMEA Parser for RMC sentences" );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override;
+};
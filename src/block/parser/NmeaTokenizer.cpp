@@ -0,0 +1,135 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "NmeaTokenizer.h"
+
+#include "helpers/charconvHelper.h"
+
+#include <charconv>
+
+namespace {
+  int hexDigit( const char c ) {
+    if( c >= '0' && c <= '9' ) {
+      return c - '0';
+    }
+
+    if( c >= 'A' && c <= 'F' ) {
+      return c - 'A' + 10;
+    }
+
+    if( c >= 'a' && c <= 'f' ) {
+      return c - 'a' + 10;
+    }
+
+    return -1;
+  }
+}
+
+bool NmeaTokenizer::split( std::string_view line, NmeaSentence& sentence ) {
+  if( !line.empty() && line.back() == '\r' ) {
+    line.remove_suffix( 1 );
+  }
+
+  // everything before the start of the sentence is garbage, like a partial sentence after a reconnect
+  const auto start = line.find_last_of( "$!" );
+
+  if( start == std::string_view::npos ) {
+    return false;
+  }
+
+  line.remove_prefix( start + 1 );
+
+  // the checksum is a XOR of all chars between the '$' and the '*'
+  const auto star = line.find( '*' );
+
+  if( star == std::string_view::npos || star + 3 > line.size() ) {
+    return false;
+  }
+
+  uint8_t checksum = 0;
+
+  for( std::size_t i = 0; i < star; ++i ) {
+    checksum ^= uint8_t( line[i] );
+  }
+
+  const int high = hexDigit( line[star + 1] );
+  const int low = hexDigit( line[star + 2] );
+
+  if( high < 0 || low < 0 || checksum != uint8_t( ( high << 4 ) | low ) ) {
+    ++checksumErrors;
+    return false;
+  }
+
+  const auto body = line.substr( 0, star );
+  auto comma = body.find( ',' );
+  const auto address = body.substr( 0, comma );
+
+  if( address.size() < 3 ) {
+    return false;
+  }
+
+  // proprietary sentences ('P' and the id of the manufacturer) have no talker
+  if( address.front() == 'P' ) {
+    sentence.talker = std::string_view();
+    sentence.type = address;
+  } else {
+    sentence.talker = address.substr( 0, 2 );
+    sentence.type = address.substr( 2 );
+  }
+
+  sentence.numFields = 0;
+
+  while( comma != std::string_view::npos ) {
+    if( sentence.numFields == NmeaSentence::MaxFields ) {
+      return false;
+    }
+
+    const auto next = body.find( ',', comma + 1 );
+    sentence.fields[std::size_t( sentence.numFields++ )] = body.substr( comma + 1, next == std::string_view::npos ? std::string_view::npos : next - comma - 1 );
+    comma = next;
+  }
+
+  return true;
+}
+
+bool NmeaTokenizer::toDouble( const std::string_view field, double& value ) {
+  return doubleFromChars( field, value );
+}
+
+bool NmeaTokenizer::toInt( const std::string_view field, int& value ) {
+  const auto* end = field.data() + field.size();
+  const auto result = std::from_chars( field.data(), end, value );
+  return !field.empty() && result.ec == std::errc() && result.ptr == end;
+}
+
+bool NmeaTokenizer::toDegrees( const std::string_view field, const std::string_view hemisphere, double& degrees ) {
+  double value = 0;
+
+  if( !toDouble( field, value ) ) {
+    return false;
+  }
+
+  // DDDMM.MMMMM as a number: the minutes are the last two digits before the point
+  const double wholeDegrees = double( int( value / 100 ) );
+  degrees = wholeDegrees + ( value - wholeDegrees * 100 ) / 60;
+
+  if( hemisphere == "S" || hemisphere == "W" ) {
+    degrees = -degrees;
+  }
+
+  return true;
+}
@@ -0,0 +1,92 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// an NMEA 0183 sentence as slices into the buffer it was found in; valid as long as the buffer
+struct NmeaSentence {
+  static constexpr int MaxFields = 32;
+
+  // "GP", "GN", ...
+  std::string_view talker;
+  // "GGA", "RMC", ...
+  std::string_view type;
+
+  // the fields after the address; empty fields are empty slices
+  std::array<std::string_view, MaxFields> fields;
+  int numFields = 0;
+
+  // an empty slice for a field past the end, so optional trailing fields need no checks
+  std::string_view field( const int index ) const {
+    return index < numFields ? fields[std::size_t( index )] : std::string_view();
+  }
+};
+
+// splits a stream of bytes into NMEA sentences without copying or allocating anything; every complete line is scanned
+// once, its checksum validated and its fields sliced
+class NmeaTokenizer {
+  public:
+    // calls handler( const NmeaSentence& ) for every complete sentence with a valid checksum in data; returns the
+    // bytes up to and including the last newline, the rest is an incomplete sentence to be passed again with more data
+    template<typename Handler>
+    std::size_t tokenize( const std::string_view data, Handler&& handler ) {
+      std::size_t consumed = 0;
+
+      while( consumed < data.size() ) {
+        const auto* begin = data.data() + consumed;
+        const auto* newline = static_cast<const char*>( std::memchr( begin, '\n', data.size() - consumed ) );
+
+        if( newline == nullptr ) {
+          break;
+        }
+
+        consumed = std::size_t( newline - data.data() ) + 1;
+
+        if( split( std::string_view( begin, std::size_t( newline - begin ) ), sentence ) ) {
+          ++sentences;
+          handler( static_cast<const NmeaSentence&>( sentence ) );
+        }
+      }
+
+      bytes += consumed;
+      return consumed;
+    }
+
+    // validates the checksum and slices the fields of one line; the line may have leading garbage and a trailing '\r'
+    bool split( std::string_view line, NmeaSentence& sentence );
+
+    // the parsers of the fields; false for an empty or malformed field
+    static bool toDouble( const std::string_view field, double& value );
+    static bool toInt( const std::string_view field, int& value );
+
+    // DDMM.MMMMM or DDDMM.MMMMM and the hemisphere to degrees, negative for S or W
+    static bool toDegrees( const std::string_view field, const std::string_view hemisphere, double& degrees );
+
+  public:
+    uint64_t bytes = 0;
+    uint64_t sentences = 0;
+    uint64_t checksumErrors = 0;
+
+  private:
+    NmeaSentence sentence;
+};
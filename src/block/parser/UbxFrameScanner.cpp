@@ -0,0 +1,30 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "UbxFrameScanner.h"
+
+bool UbxFrameScanner::checksumValid( const uint8_t* data, const std::size_t size ) {
+  uint8_t a = 0;
+  uint8_t b = 0;
+
+  for( std::size_t i = 0; i < size; ++i ) {
+    a += data[i];
+    b += a;
+  }
+
+  return data[size] == a && data[size + 1] == b;
+}
@@ -0,0 +1,132 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// a frame of UBX, found in place in a buffer; valid as long as the buffer
+struct UbxFrame {
+  uint8_t messageClass = 0;
+  uint8_t messageId = 0;
+  uint16_t length = 0;
+  const uint8_t* payload = nullptr;
+
+  uint16_t key() const {
+    return uint16_t( ( messageClass << 8 ) | messageId );
+  }
+
+  // the payload as one of the packed structs of UbxMessages.h, or nullptr if the frame is too short for it
+  template<typename Payload>
+  const Payload* as() const {
+    return length >= sizeof( Payload ) ? reinterpret_cast<const Payload*>( payload ) : nullptr;
+  }
+};
+
+// finds the frames of UBX in a stream of bytes a frame at a time: the sync chars are searched with memchr and the
+// checksum is calculated over the contiguous frame, so nothing is copied. Other protocols on the same port, like
+// NMEA, are skipped.
+class UbxFrameScanner {
+  public:
+    static constexpr std::size_t HeaderSize = 6;
+    static constexpr std::size_t ChecksumSize = 2;
+    // the largest messages of the receivers (NAV-SAT, RXM-RAWX, MON-SPAN...) stay well below it; a longer length after
+    // a false sync would hold back all the frames behind it until that many bytes arrived
+    static constexpr std::size_t MaxPayloadSize = 8192;
+    static constexpr std::size_t MaxFrameSize = HeaderSize + MaxPayloadSize + ChecksumSize;
+
+    // calls handler( const UbxFrame& ) for every complete frame with a valid checksum in data; returns the bytes
+    // consumed, the rest is the start of a frame to be passed again with more data
+    template<typename Handler>
+    std::size_t scan( const uint8_t* data, const std::size_t size, Handler&& handler ) {
+      std::size_t consumed = 0;
+
+      while( consumed < size ) {
+        const auto* sync = static_cast<const uint8_t*>( std::memchr( data + consumed, 0xb5, size - consumed ) );
+
+        if( sync == nullptr ) {
+          consumed = size;
+          break;
+        }
+
+        const auto position = std::size_t( sync - data );
+        const auto available = size - position;
+
+        if( available < 2 ) {
+          consumed = position;
+          break;
+        }
+
+        if( sync[1] != 0x62 ) {
+          consumed = position + 1;
+          continue;
+        }
+
+        if( available < HeaderSize ) {
+          consumed = position;
+          break;
+        }
+
+        const auto length = uint16_t( sync[4] | ( sync[5] << 8 ) );
+        const auto frameSize = HeaderSize + length + ChecksumSize;
+
+        if( length > MaxPayloadSize ) {
+          // not a frame: search from the next byte
+          ++checksumErrors;
+          consumed = position + 1;
+          continue;
+        }
+
+        if( available < frameSize ) {
+          consumed = position;
+          break;
+        }
+
+        if( checksumValid( sync + 2, length + 4u ) ) {
+          frame.messageClass = sync[2];
+          frame.messageId = sync[3];
+          frame.length = length;
+          frame.payload = sync + HeaderSize;
+
+          ++frames;
+          consumed = position + frameSize;
+
+          handler( static_cast<const UbxFrame&>( frame ) );
+        } else {
+          // a false sync or a corrupted frame: search from the next byte
+          ++checksumErrors;
+          consumed = position + 1;
+        }
+      }
+
+      bytes += consumed;
+      return consumed;
+    }
+
+    // the 8-bit Fletcher checksum over class, id, length and payload; it follows them directly
+    static bool checksumValid( const uint8_t* data, const std::size_t size );
+
+  public:
+    uint64_t bytes = 0;
+    uint64_t frames = 0;
+    uint64_t checksumErrors = 0;
+
+  private:
+    UbxFrame frame;
+};
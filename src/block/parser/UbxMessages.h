@@ -0,0 +1,224 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QtGlobal>
+
+#include <cstdint>
+
+// the payloads of the decoded UBX messages, as laid out in the interface description of the F9P/F9R; they are read in
+// place from the frame, so they are packed and only valid on a little endian host like the receiver
+static_assert( Q_BYTE_ORDER == Q_LITTLE_ENDIAN, "the UBX payloads are read in place" );
+
+namespace Ubx {
+  constexpr uint16_t messageKey( const uint8_t messageClass, const uint8_t messageId ) {
+    return uint16_t( ( messageClass << 8 ) | messageId );
+  }
+
+  constexpr uint16_t NavPvt = messageKey( 0x01, 0x07 );
+  constexpr uint16_t NavHpPosLlh = messageKey( 0x01, 0x14 );
+  constexpr uint16_t NavTimeUtc = messageKey( 0x01, 0x21 );
+  constexpr uint16_t NavCov = messageKey( 0x01, 0x36 );
+  constexpr uint16_t NavRelPosNed = messageKey( 0x01, 0x3c );
+  constexpr uint16_t EsfRaw = messageKey( 0x10, 0x03 );
+  constexpr uint16_t EsfIns = messageKey( 0x10, 0x15 );
+
+#pragma pack(push, 1)
+
+  struct NavPvtPayload {
+    uint32_t iTOW;
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    uint8_t valid;
+    uint32_t tAcc;
+    int32_t nano;
+    uint8_t fixType;
+    // bit 0: gnssFixOK, bit 1: diffSoln, bits 6..7: carrSoln (1: float, 2: fixed)
+    uint8_t flags;
+    uint8_t flags2;
+    uint8_t numSV;
+    // 1e-7 deg
+    int32_t lon;
+    int32_t lat;
+    // mm
+    int32_t height;
+    int32_t hMSL;
+    uint32_t hAcc;
+    uint32_t vAcc;
+    // mm/s
+    int32_t velN;
+    int32_t velE;
+    int32_t velD;
+    int32_t gSpeed;
+    // 1e-5 deg
+    int32_t headMot;
+    uint32_t sAcc;
+    uint32_t headAcc;
+    // 0.01
+    uint16_t pDOP;
+    uint16_t flags3;
+    uint8_t reserved1[4];
+    // 1e-5 deg
+    int32_t headVeh;
+    int16_t magDec;
+    uint16_t magAcc;
+  };
+  static_assert( sizeof( NavPvtPayload ) == 92, "NAV-PVT" );
+
+  struct NavHpPosLlhPayload {
+    uint8_t version;
+    uint8_t reserved1[2];
+    // bit 0: invalidLlh
+    uint8_t flags;
+    uint32_t iTOW;
+    // 1e-7 deg, plus the high precision part in 1e-9 deg
+    int32_t lon;
+    int32_t lat;
+    // mm, plus the high precision part in 0.1 mm
+    int32_t height;
+    int32_t hMSL;
+    int8_t lonHp;
+    int8_t latHp;
+    int8_t heightHp;
+    int8_t hMSLHp;
+    // 0.1 mm
+    uint32_t hAcc;
+    uint32_t vAcc;
+  };
+  static_assert( sizeof( NavHpPosLlhPayload ) == 36, "NAV-HPPOSLLH" );
+
+  struct NavTimeUtcPayload {
+    uint32_t iTOW;
+    uint32_t tAcc;
+    int32_t nano;
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    // bit 2: validUTC
+    uint8_t valid;
+  };
+  static_assert( sizeof( NavTimeUtcPayload ) == 20, "NAV-TIMEUTC" );
+
+  struct NavCovPayload {
+    uint32_t iTOW;
+    uint8_t version;
+    uint8_t posCovValid;
+    uint8_t velCovValid;
+    uint8_t reserved0[9];
+    // m^2 and m^2/s^2 in NED
+    float posCovNN;
+    float posCovNE;
+    float posCovND;
+    float posCovEE;
+    float posCovED;
+    float posCovDD;
+    float velCovNN;
+    float velCovNE;
+    float velCovND;
+    float velCovEE;
+    float velCovED;
+    float velCovDD;
+  };
+  static_assert( sizeof( NavCovPayload ) == 64, "NAV-COV" );
+
+  // version 1, as sent by the F9P; version 0 of the M8P has no heading
+  struct NavRelPosNedPayload {
+    uint8_t version;
+    uint8_t reserved1;
+    uint16_t refStationId;
+    uint32_t iTOW;
+    // cm, plus the high precision part in 0.1 mm
+    int32_t relPosN;
+    int32_t relPosE;
+    int32_t relPosD;
+    int32_t relPosLength;
+    // 1e-5 deg
+    int32_t relPosHeading;
+    uint8_t reserved2[4];
+    int8_t relPosHPN;
+    int8_t relPosHPE;
+    int8_t relPosHPD;
+    int8_t relPosHPLength;
+    uint32_t accN;
+    uint32_t accE;
+    uint32_t accD;
+    uint32_t accLength;
+    uint32_t accHeading;
+    uint8_t reserved3[4];
+    // bit 0: gnssFixOK, bit 2: relPosValid, bit 8: relPosHeadingValid
+    uint32_t flags;
+  };
+  static_assert( sizeof( NavRelPosNedPayload ) == 64, "NAV-RELPOSNED" );
+
+  // the compensated angular rates and accelerations of the fusion of the F9R
+  struct EsfInsPayload {
+    // bits 8..10: the angular rates valid, bits 11..13: the accelerations valid
+    uint32_t bitfield0;
+    uint8_t reserved1[4];
+    uint32_t iTOW;
+    // 1e-3 deg/s
+    int32_t xAngRate;
+    int32_t yAngRate;
+    int32_t zAngRate;
+    // 1e-2 m/s^2
+    int32_t xAccel;
+    int32_t yAccel;
+    int32_t zAccel;
+  };
+  static_assert( sizeof( EsfInsPayload ) == 36, "ESF-INS" );
+
+  // followed by a variable number of EsfRawSample
+  struct EsfRawPayload {
+    uint8_t reserved1[4];
+  };
+
+  struct EsfRawSample {
+    // bits 0..23: the value as a signed 24 bit integer, bits 24..29: the type
+    uint32_t data;
+    uint32_t sTag;
+
+    int32_t value() const {
+      return int32_t( data << 8 ) >> 8;
+    }
+
+    uint8_t type() const {
+      return uint8_t( ( data >> 24 ) & 0x3f );
+    }
+  };
+  static_assert( sizeof( EsfRawSample ) == 8, "ESF-RAW" );
+
+  // the types of the samples of ESF-RAW
+  enum EsfRawType : uint8_t {
+    GyroZ = 5,
+    GyroTemperature = 12,
+    GyroY = 13,
+    GyroX = 14,
+    AccelerationX = 16,
+    AccelerationY = 17,
+    AccelerationZ = 18
+  };
+
+#pragma pack(pop)
+}
@@ -23,59 +23,305 @@
 
 #include "helpers/anglesHelper.h"
 
-#include <QBrush>
+#include "block/MeasurementTimestamp.h"
 
+#include "UbxMessages.h"
 
-void UBX_Parser_Helper::handle_NAV_HPPOSLLH( uint32_t iTOW, double lon, double lat, double height, double hMSL, double hAcc, double vAcc ) {
-  Q_EMIT ubxNavHpPosLlhChanged( iTOW, lon, lat, height, hMSL, hAcc, vAcc );
-}
+#include <QBrush>
+#include <QDate>
 
-void UBX_Parser_Helper::handle_NAV_RELPOSNED( uint32_t iTOW, double relPosN, double relPosE, double relPosD, double relPosLenght, double relPosHeading ) {
-  Q_EMIT ubxNavRelPosNedChanged( iTOW, relPosN, relPosE, relPosD, relPosLenght, relPosHeading );
-}
+#include <cmath>
+
+namespace {
+  // iTOW is the time of validity of the solution in ms of the GPS week; the emits of the messages carry it
+  MeasurementTimestamp timestampOfITow( const uint32_t iTOW ) {
+    return MeasurementTimestamp::withValidity( MeasurementTimestamp::TimeBase::GpsTimeOfWeek, double( iTOW ) / 1000 );
+  }
 
-void UBX_Parser_Helper::handle_NAV_PVT( uint32_t iTOW, bool rtkFix, bool rtkFloat, uint8_t numSatelites, double speed, double headingOfMotion, double headingOfVehicle, double pDOP ) {
-  Q_EMIT UbxNavPvtChanged( iTOW, rtkFix, rtkFloat, numSatelites, speed, headingOfMotion, headingOfVehicle, pDOP );
+  // the scanner rejects longer frames, so more without a complete frame is garbage
+  constexpr int MaxPendingSize = int( UbxFrameScanner::MaxFrameSize );
 }
 
 UbxParser::UbxParser()
   : BlockBase() {
-  connect( &ubxParser, &UBX_Parser_Helper::ubxNavHpPosLlhChanged, this, &UbxParser::ubxNavHpPosLLH );
-  connect( &ubxParser, &UBX_Parser_Helper::ubxNavRelPosNedChanged, this, &UbxParser::ubxNavRelPosNed );
-  connect( &ubxParser, &UBX_Parser_Helper::UbxNavPvtChanged, this, &UbxParser::UbxNavPvt );
+  // resize( 0 ) keeps a reserved capacity, so the pending frame never allocates
+  pending.reserve( MaxPendingSize );
 }
 
 void UbxParser::setData( const QByteArray& data ) {
-  for( const uint8_t c : data ) {
-    ubxParser.parse( c );
+  const auto parse = [this]( const UbxFrame & frame ) {
+    parseFrame( frame );
+  };
+
+  // the usual case: the last chunk ended with a complete frame, so the new one is parsed in place
+  if( pending.isEmpty() ) {
+    const auto consumed = scanner.scan( reinterpret_cast<const uint8_t*>( data.constData() ), std::size_t( data.size() ), parse );
+    pending.append( data.constData() + consumed, data.size() - int( consumed ) );
+  } else {
+    pending.append( data );
+    const auto consumed = scanner.scan( reinterpret_cast<const uint8_t*>( pending.constData() ), std::size_t( pending.size() ), parse );
+    pending.remove( 0, int( consumed ) );
+  }
+
+  if( pending.size() > MaxPendingSize ) {
+    pending.resize( 0 );
+  }
+
+  if( scanner.checksumErrors != reportedChecksumErrors ) {
+    reportedChecksumErrors = scanner.checksumErrors;
+    Q_EMIT checksumErrorsChanged( double( reportedChecksumErrors ) );
   }
 }
 
-void UbxParser::ubxNavHpPosLLH( uint32_t, double lon, double lat, double height, double, double hAcc, double vAcc ) {
-  Q_EMIT globalPositionChanged( Eigen::Vector3d( lon, lat, height ) );
-  Q_EMIT horizontalAccuracyChanged( hAcc );
-  Q_EMIT verticalAccuracyChanged( vAcc );
+void UbxParser::parseFrame( const UbxFrame& frame ) {
+  switch( frame.key() ) {
+    case Ubx::NavPvt:
+      parseNavPvt( frame );
+      break;
+
+    case Ubx::NavHpPosLlh:
+      parseNavHpPosLlh( frame );
+      break;
+
+    case Ubx::NavRelPosNed:
+      parseNavRelPosNed( frame );
+      break;
+
+    case Ubx::NavCov:
+      parseNavCov( frame );
+      break;
+
+    case Ubx::NavTimeUtc:
+      parseNavTimeUtc( frame );
+      break;
+
+    case Ubx::EsfIns:
+      parseEsfIns( frame );
+      break;
+
+    case Ubx::EsfRaw:
+      parseEsfRaw( frame );
+      break;
+
+    default:
+      break;
+  }
 }
 
-void UbxParser::ubxNavRelPosNed( uint32_t, double, double, double relPosD, double relPosLenght, double relPosHeading ) {
+void UbxParser::parseNavPvt( const UbxFrame& frame ) {
+  const auto* pvt = frame.as<Ubx::NavPvtPayload>();
+
+  if( pvt == nullptr ) {
+    return;
+  }
+
+  MeasurementTimestamp::Scope timestampScope( timestampOfITow( pvt->iTOW ) );
+
+  // the quality of NMEA GGA: 4 is RTK fixed, 5 RTK float
+  const bool gnssFixOk = pvt->flags & 0x01;
+  const bool differential = pvt->flags & 0x02;
+  const int carrierSolution = ( pvt->flags >> 6 ) & 0x03;
+  const bool headingOfVehicleValid = pvt->flags & 0x20;
+
+  Q_EMIT fixQualityChanged( !gnssFixOk ? 0 : carrierSolution == 2 ? 4 : carrierSolution == 1 ? 5 : differential ? 2 : 1 );
+
+  Q_EMIT velocityChanged( double( pvt->gSpeed ) / 1000 );
+  Q_EMIT numSatelitesChanged( pvt->numSV );
+  Q_EMIT hdopChanged( double( pvt->pDOP ) / 100 );
+
+  Q_EMIT orientationMotionChanged( Eigen::Quaterniond( Eigen::AngleAxisd( ( degreesToRadians( double( pvt->headMot ) * 1e-5 ) - headingOffsetRad )*headingFactor, Eigen::Vector3d::UnitZ() ) ) );
+
+  if( headingOfVehicleValid ) {
+    Q_EMIT orientationVehicleChanged( Eigen::Quaterniond( Eigen::AngleAxisd( ( degreesToRadians( double( pvt->headVeh ) * 1e-5 ) - headingOffsetRad )*headingFactor, Eigen::Vector3d::UnitZ() ) ) );
+  }
+}
+
+void UbxParser::parseNavHpPosLlh( const UbxFrame& frame ) {
+  const auto* hpPosLlh = frame.as<Ubx::NavHpPosLlhPayload>();
+
+  // bit 0 of flags: invalidLlh
+  if( hpPosLlh == nullptr || ( hpPosLlh->flags & 0x01 ) ) {
+    return;
+  }
+
+  MeasurementTimestamp::Scope timestampScope( timestampOfITow( hpPosLlh->iTOW ) );
+
+  const double latitude = double( hpPosLlh->lat ) * 1e-7 + double( hpPosLlh->latHp ) * 1e-9;
+  const double longitude = double( hpPosLlh->lon ) * 1e-7 + double( hpPosLlh->lonHp ) * 1e-9;
+  const double height = double( hpPosLlh->height ) * 1e-3 + double( hpPosLlh->heightHp ) * 1e-4;
+
+  Q_EMIT globalPositionChanged( Eigen::Vector3d( latitude, longitude, height ) );
+  Q_EMIT horizontalAccuracyChanged( double( hpPosLlh->hAcc ) * 1e-4 );
+  Q_EMIT verticalAccuracyChanged( double( hpPosLlh->vAcc ) * 1e-4 );
+}
+
+void UbxParser::parseNavRelPosNed( const UbxFrame& frame ) {
+  const auto* relPosNed = frame.as<Ubx::NavRelPosNedPayload>();
+
+  // bit 2 of flags: relPosValid, bit 8: relPosHeadingValid
+  if( relPosNed == nullptr || relPosNed->version != 1 || ( relPosNed->flags & 0x104 ) != 0x104 ) {
+    return;
+  }
+
+  MeasurementTimestamp::Scope timestampScope( timestampOfITow( relPosNed->iTOW ) );
+
+  const double relPosD = double( relPosNed->relPosD ) * 1e-2 + double( relPosNed->relPosHPD ) * 1e-4;
+  const double relPosLength = double( relPosNed->relPosLength ) * 1e-2 + double( relPosNed->relPosHPLength ) * 1e-4;
+  const double relPosHeading = double( relPosNed->relPosHeading ) * 1e-5;
+
+  if( relPosLength <= 0 ) {
+    return;
+  }
+
   Q_EMIT orientationDualAntennaChanged(
           // roll
-          Eigen::AngleAxisd( ( std::asin( relPosD / relPosLenght ) - rollOffsetRad )*rollFactor, Eigen::Vector3d::UnitX() )
+          Eigen::AngleAxisd( ( std::asin( relPosD / relPosLength ) - rollOffsetRad )*rollFactor, Eigen::Vector3d::UnitX() )
           *
           // heading
           Eigen::AngleAxisd( ( degreesToRadians( relPosHeading ) - headingOffsetRad )*headingFactor, Eigen::Vector3d::UnitZ() )
   );
-  Q_EMIT distanceBetweenAntennasChanged( relPosLenght );
+  Q_EMIT distanceBetweenAntennasChanged( relPosLength );
+}
+
+void UbxParser::parseNavCov( const UbxFrame& frame ) {
+  const auto* cov = frame.as<Ubx::NavCovPayload>();
+
+  if( cov == nullptr ) {
+    return;
+  }
+
+  MeasurementTimestamp::Scope timestampScope( timestampOfITow( cov->iTOW ) );
+
+  if( cov->posCovValid ) {
+    Q_EMIT positionStandardDeviationChanged( Eigen::Vector3d( std::sqrt( double( cov->posCovNN ) ),
+                                            std::sqrt( double( cov->posCovEE ) ),
+                                            std::sqrt( double( cov->posCovDD ) ) ) );
+  }
+
+  if( cov->velCovValid ) {
+    Q_EMIT velocityStandardDeviationChanged( Eigen::Vector3d( std::sqrt( double( cov->velCovNN ) ),
+                                            std::sqrt( double( cov->velCovEE ) ),
+                                            std::sqrt( double( cov->velCovDD ) ) ) );
+  }
+}
+
+void UbxParser::parseNavTimeUtc( const UbxFrame& frame ) {
+  const auto* timeUtc = frame.as<Ubx::NavTimeUtcPayload>();
+
+  // bit 2 of valid: validUTC
+  if( timeUtc == nullptr || !( timeUtc->valid & 0x04 ) ) {
+    return;
+  }
+
+  MeasurementTimestamp::Scope timestampScope( timestampOfITow( timeUtc->iTOW ) );
+
+  // 2440588 is the julian day of the epoch
+  const auto days = QDate( timeUtc->year, timeUtc->month, timeUtc->day ).toJulianDay() - 2440588;
+
+  Q_EMIT utcTimeChanged( double( days ) * 86400 +
+                         timeUtc->hour * 3600 + timeUtc->min * 60 + timeUtc->sec +
+                         double( timeUtc->nano ) * 1e-9 );
+}
+
+void UbxParser::parseEsfIns( const UbxFrame& frame ) {
+  const auto* ins = frame.as<Ubx::EsfInsPayload>();
+
+  if( ins == nullptr ) {
+    return;
+  }
+
+  MeasurementTimestamp::Scope timestampScope( timestampOfITow( ins->iTOW ) );
+
+  // bits 8..10: the angular rates valid, bits 11..13: the accelerations valid
+  if( ( ins->bitfield0 & 0x0700 ) == 0x0700 ) {
+    Q_EMIT angularRateChanged( Eigen::Vector3d( double( ins->xAngRate ) * 1e-3,
+                               double( ins->yAngRate ) * 1e-3,
+                               double( ins->zAngRate ) * 1e-3 ) );
+  }
+
+  if( ( ins->bitfield0 & 0x3800 ) == 0x3800 ) {
+    Q_EMIT accelerationChanged( Eigen::Vector3d( double( ins->xAccel ) * 1e-2,
+                                double( ins->yAccel ) * 1e-2,
+                                double( ins->zAccel ) * 1e-2 ) );
+  }
 }
 
-void UbxParser::UbxNavPvt( uint32_t, bool, bool, uint8_t numSatelites, double speed, double headingOfMotion, double headingOfVehicle, double pDOP ) {
-  Q_EMIT velocityChanged( speed );
-  Q_EMIT numSatelitesChanged( numSatelites );
-  Q_EMIT hdopChanged( pDOP );
+void UbxParser::parseEsfRaw( const UbxFrame& frame ) {
+  if( frame.length < sizeof( Ubx::EsfRawPayload ) ) {
+    return;
+  }
+
+  // the samples of the axes with the same sensor time tag are combined; a message can hold several of them. They have
+  // no iTOW, so the time of receipt is kept.
+  const auto* samples = reinterpret_cast<const Ubx::EsfRawSample*>( frame.payload + sizeof( Ubx::EsfRawPayload ) );
+  const auto numSamples = ( frame.length - sizeof( Ubx::EsfRawPayload ) ) / sizeof( Ubx::EsfRawSample );
+
+  Eigen::Vector3d angularRate;
+  Eigen::Vector3d acceleration;
+  int angularRateAxes = 0;
+  int accelerationAxes = 0;
+
+  const auto emitComplete = [&]() {
+    if( angularRateAxes == 0x07 ) {
+      Q_EMIT rawAngularRateChanged( angularRate );
+    }
+
+    if( accelerationAxes == 0x07 ) {
+      Q_EMIT rawAccelerationChanged( acceleration );
+    }
+
+    angularRateAxes = 0;
+    accelerationAxes = 0;
+  };
 
-  Q_EMIT orientationMotionChanged( Eigen::Quaterniond( Eigen::AngleAxisd( ( degreesToRadians( headingOfMotion ) - headingOffsetRad )*headingFactor, Eigen::Vector3d::UnitZ() ) ) );
+  for( std::size_t i = 0; i < numSamples; ++i ) {
+    const auto& sample = samples[i];
+
+    if( i != 0 && sample.sTag != samples[i - 1].sTag ) {
+      emitComplete();
+    }
+
+    // 2^-12 deg/s and 2^-10 m/s^2
+    const double gyro = double( sample.value() ) / 4096;
+    const double accelerometer = double( sample.value() ) / 1024;
+
+    switch( sample.type() ) {
+      case Ubx::GyroX:
+        angularRate.x() = gyro;
+        angularRateAxes |= 0x01;
+        break;
+
+      case Ubx::GyroY:
+        angularRate.y() = gyro;
+        angularRateAxes |= 0x02;
+        break;
+
+      case Ubx::GyroZ:
+        angularRate.z() = gyro;
+        angularRateAxes |= 0x04;
+        break;
+
+      case Ubx::AccelerationX:
+        acceleration.x() = accelerometer;
+        accelerationAxes |= 0x01;
+        break;
+
+      case Ubx::AccelerationY:
+        acceleration.y() = accelerometer;
+        accelerationAxes |= 0x02;
+        break;
+
+      case Ubx::AccelerationZ:
+        acceleration.z() = accelerometer;
+        accelerationAxes |= 0x04;
+        break;
+
+      default:
+        break;
+    }
+  }
 
-  Q_EMIT orientationMotionChanged( Eigen::Quaterniond( Eigen::AngleAxisd( ( degreesToRadians( headingOfVehicle ) - headingOffsetRad )*headingFactor, Eigen::Vector3d::UnitZ() ) ) );
+  emitComplete();
 }
 
 void UbxParser::setHeadingOffset( const double headingOffset ) {
@@ -115,6 +361,15 @@ QNEBlock* UbxParserFactory::createBlock( QGraphicsScene* scene, int id ) {
   b->addOutputPort( QStringLiteral( "HDOP" ), QLatin1String( SIGNAL( hdopChanged( const double ) ) ) );
   b->addOutputPort( QStringLiteral( "Horizontal Accuracy" ), QLatin1String( SIGNAL( horizontalAccuracyChanged( const double ) ) ) );
   b->addOutputPort( QStringLiteral( "Vertical Accuracy" ), QLatin1String( SIGNAL( verticalAccuracyChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Fix Quality" ), QLatin1String( SIGNAL( fixQualityChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Position Std Dev NED" ), QLatin1String( SIGNAL( positionStandardDeviationChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Velocity Std Dev NED" ), QLatin1String( SIGNAL( velocityStandardDeviationChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Angular Rate" ), QLatin1String( SIGNAL( angularRateChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Acceleration" ), QLatin1String( SIGNAL( accelerationChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Raw Angular Rate" ), QLatin1String( SIGNAL( rawAngularRateChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Raw Acceleration" ), QLatin1String( SIGNAL( rawAccelerationChanged( const Eigen::Vector3d& ) ) ) );
+  b->addOutputPort( QStringLiteral( "UTC Time" ), QLatin1String( SIGNAL( utcTimeChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Checksum Errors" ), QLatin1String( SIGNAL( checksumErrorsChanged( const double ) ) ) );
 
   b->setBrush( parserColor );
 
@@ -22,80 +22,23 @@
 
 #include "block/BlockBase.h"
 
-#include "UBX_Parser.h"
-
 #include "helpers/eigenHelper.h"
 
-class UBX_Parser_Helper : public QObject, public UBX_Parser {
-    Q_OBJECT
-
-  public:
-    UBX_Parser_Helper() {}
-    ~UBX_Parser_Helper() {}
-
-  protected:
-    void handle_NAV_HPPOSLLH(
-            uint32_t iTOW,
-            double lon,
-            double lat,
-            double height,
-            double hMSL,
-            double hAcc,
-            double vAcc ) override;
-
-    void handle_NAV_RELPOSNED(
-            uint32_t iTOW,
-            double relPosN,
-            double relPosE,
-            double relPosD,
-            double relPosLenght,
-            double relPosHeading ) override;
-
-    void handle_NAV_PVT(
-            uint32_t iTOW,
-            bool rtkFix,
-            bool rtkFloat,
-            uint8_t numSatelites,
-            double speed,
-            double headingOfMotion,
-            double headingOfVehicle,
-            double pDOP ) override;
-
-  Q_SIGNALS:
-    void ubxNavHpPosLlhChanged(
-            uint32_t iTOW,
-            double lon,
-            double lat,
-            double height,
-            double hMSL,
-            double hAcc,
-            double vAcc );
-
-    void ubxNavRelPosNedChanged(
-            uint32_t iTOW,
-            double relPosN,
-            double relPosE,
-            double relPosD,
-            double relPosLenght,
-            double relPosHeading );
-
-    void UbxNavPvtChanged(
-            uint32_t iTOW,
-            bool rtkFix,
-            bool rtkFloat,
-            uint8_t numSatelites,
-            double speed,
-            double headingOfMotion,
-            double headingOfVehicle,
-            double pDOP );
-};
+#include "UbxFrameScanner.h"
 
+// decodes the UBX messages of u-blox receivers a frame at a time: NAV-PVT, NAV-HPPOSLLH, NAV-RELPOSNED, NAV-COV,
+// NAV-TIMEUTC and the IMU data of ESF-INS and ESF-RAW. Only the start of an incomplete frame at the end of a chunk is
+// kept for the next one.
 class UbxParser : public BlockBase {
     Q_OBJECT
 
   public:
     explicit UbxParser();
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   Q_SIGNALS:
     void globalPositionChanged( const Eigen::Vector3d& );
     void velocityChanged( const double );
@@ -110,37 +53,29 @@ class UbxParser : public BlockBase {
     void horizontalAccuracyChanged( const double );
     void verticalAccuracyChanged( const double );
 
+    // like the quality of NMEA GGA
+    void fixQualityChanged( const double );
+
+    // NAV-COV: the standard deviations of position and velocity in NED; m and m/s
+    void positionStandardDeviationChanged( const Eigen::Vector3d& );
+    void velocityStandardDeviationChanged( const Eigen::Vector3d& );
+
+    // ESF-INS: compensated for bias and gravity in the vehicle frame; deg/s and m/s^2
+    void angularRateChanged( const Eigen::Vector3d& );
+    void accelerationChanged( const Eigen::Vector3d& );
+
+    // ESF-RAW: the measurements of the IMU in its frame; deg/s and m/s^2
+    void rawAngularRateChanged( const Eigen::Vector3d& );
+    void rawAccelerationChanged( const Eigen::Vector3d& );
+
+    // NAV-TIMEUTC: s since the epoch
+    void utcTimeChanged( const double );
+
+    void checksumErrorsChanged( const double );
+
   public Q_SLOTS:
     void setData( const QByteArray& data );
 
-  protected Q_SLOTS:
-    void ubxNavHpPosLLH(
-            uint32_t /*iTOW*/,
-            double lon,
-            double lat,
-            double height,
-            double /*hMSL*/,
-            double hAcc,
-            double vAcc );
-
-    void ubxNavRelPosNed(
-            uint32_t /*iTOW*/,
-            double /*relPosN*/,
-            double /*relPosE*/,
-            double relPosD,
-            double relPosLenght,
-            double relPosHeading );
-
-    void UbxNavPvt(
-            uint32_t /*iTOW*/,
-            bool /*rtkFix*/,
-            bool /*rtkFloat*/,
-            uint8_t numSatelites,
-            double speed,
-            double headingOfMotion,
-            double headingOfVehicle,
-            double pDOP );
-
     void setHeadingOffset( const double headingOffset );
     void setHeadingFactor( const double headingFactor );
 
@@ -148,7 +83,21 @@ class UbxParser : public BlockBase {
     void setRollFactor( const double rollFactor );
 
   private:
-    UBX_Parser_Helper ubxParser;
+    void parseFrame( const UbxFrame& frame );
+
+    void parseNavPvt( const UbxFrame& frame );
+    void parseNavHpPosLlh( const UbxFrame& frame );
+    void parseNavRelPosNed( const UbxFrame& frame );
+    void parseNavCov( const UbxFrame& frame );
+    void parseNavTimeUtc( const UbxFrame& frame );
+    void parseEsfIns( const UbxFrame& frame );
+    void parseEsfRaw( const UbxFrame& frame );
+
+  private:
+    UbxFrameScanner scanner;
+    QByteArray pending;
+    uint64_t reportedChecksumErrors = 0;
+
     double headingOffsetRad = 0;
     double rollOffsetRad = 0;
     double headingFactor = 1;
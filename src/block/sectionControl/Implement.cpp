@@ -37,20 +37,28 @@
 Implement::Implement( const QString& uniqueName, MyMainWindow* mainWindow, KDDockWidgets::DockWidget** firstDock )
   : BlockBase(),
     firstDock( firstDock ) {
-  widget = new SectionControlToolbar( this, mainWindow );
-  dock = new KDDockWidgets::DockWidget( uniqueName );
+  // without a main window (headless), the sections can't be switched by hand
+  if( mainWindow != nullptr ) {
+    widget = new SectionControlToolbar( this, mainWindow );
+    dock = new KDDockWidgets::DockWidget( uniqueName );
+  }
 
   // add section 0: the section to control them all
   sections.push_back( new ImplementSection( 0, 0, 0 ) );
 }
 
 Implement::~Implement() {
-  if( *firstDock == dock ) {
-    *firstDock = nullptr;
+  if( dock != nullptr ) {
+    if( *firstDock == dock ) {
+      *firstDock = nullptr;
+    }
+
+    dock->deleteLater();
   }
 
-  widget->deleteLater();
-  dock->deleteLater();
+  if( widget != nullptr ) {
+    widget->deleteLater();
+  }
 }
 
 void Implement::emitConfigSignals() {
@@ -115,8 +123,10 @@ void Implement::emitSectionsChanged() {
 }
 
 void Implement::setName( const QString& name ) {
-  dock->setTitle( name );
-  dock->toggleAction()->setText( QStringLiteral( "SC: " ) + name );
+  if( dock != nullptr ) {
+    dock->setTitle( name );
+    dock->toggleAction()->setText( QStringLiteral( "SC: " ) + name );
+  }
 }
 
 QNEBlock* ImplementFactory::createBlock( QGraphicsScene* scene, int id ) {
@@ -129,16 +139,18 @@ QNEBlock* ImplementFactory::createBlock( QGraphicsScene* scene, int id ) {
                                 &firstDock );
   auto* b = createBaseBlock( scene, object, id );
 
-  object->dock->setTitle( getNameOfFactory() );
-  object->dock->setWidget( object->widget );
+  if( object->dock != nullptr ) {
+    object->dock->setTitle( getNameOfFactory() );
+    object->dock->setWidget( object->widget );
 
-  menu->addAction( object->dock->toggleAction() );
+    menu->addAction( object->dock->toggleAction() );
 
-  if( firstDock == nullptr ) {
-    mainWindow->addDockWidget( object->dock, location );
-    firstDock = object->dock;
-  } else {
-    mainWindow->addDockWidget( object->dock, KDDockWidgets::Location_OnBottom, firstDock );
+    if( firstDock == nullptr ) {
+      mainWindow->addDockWidget( object->dock, location );
+      firstDock = object->dock;
+    } else {
+      mainWindow->addDockWidget( object->dock, KDDockWidgets::Location_OnBottom, firstDock );
+    }
   }
 
   b->addOutputPort( QStringLiteral( "Trigger Calculation of Local Pose" ), QLatin1String( SIGNAL( triggerLocalPose( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ) );
@@ -147,7 +159,9 @@ QNEBlock* ImplementFactory::createBlock( QGraphicsScene* scene, int id ) {
   b->addOutputPort( QStringLiteral( "Position Left Edge" ), QLatin1String( SIGNAL( leftEdgeChanged( const Eigen::Vector3d& ) ) ) );
   b->addOutputPort( QStringLiteral( "Position Right Edge" ), QLatin1String( SIGNAL( rightEdgeChanged( const Eigen::Vector3d& ) ) ) );
 
-  model->resetModel();
+  if( model != nullptr ) {
+    resetModel( model );
+  }
 
   return b;
 }
@@ -0,0 +1,298 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "CaptureFile.h"
+
+#include <QtEndian>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+  void encodeRecordHeader( uchar* header, const qint64 timestampNs, const uint16_t source, const uint16_t flags, const uint32_t length ) {
+    qToLittleEndian<quint64>( quint64( timestampNs ), header );
+    qToLittleEndian<quint16>( source, header + 8 );
+    qToLittleEndian<quint16>( flags, header + 10 );
+    qToLittleEndian<quint32>( length, header + 12 );
+  }
+
+  // the size of the record at data, or 0 if it is truncated
+  qint64 decodeRecord( const uchar* data, const qint64 available, CaptureFile::Reader::Record& record ) {
+    if( available < CaptureFile::RecordHeaderSize ) {
+      return 0;
+    }
+
+    const auto length = qFromLittleEndian<quint32>( data + 12 );
+
+    if( CaptureFile::RecordHeaderSize + qint64( length ) > available ) {
+      return 0;
+    }
+
+    record.timestampNs = qint64( qFromLittleEndian<quint64>( data ) );
+    record.source = qFromLittleEndian<quint16>( data + 8 );
+    record.flags = qFromLittleEndian<quint16>( data + 10 );
+    record.length = length;
+    record.data = reinterpret_cast<const char*>( data + CaptureFile::RecordHeaderSize );
+
+    return CaptureFile::RecordHeaderSize + qint64( length );
+  }
+}
+
+CaptureFile::Writer::~Writer() {
+  close();
+}
+
+bool CaptureFile::Writer::open( const QString& filename, const int compressionLevel ) {
+  close();
+
+  file.setFileName( filename );
+
+  // the writes are large anyway, the buffer of QFile would only copy them once more
+  if( !file.open( QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered ) ) {
+    return false;
+  }
+
+  this->compressionLevel = qBound( 0, compressionLevel, 9 );
+
+  uchar header[HeaderSize];
+  std::memcpy( header, Magic, sizeof( Magic ) );
+  qToLittleEndian<quint32>( Version, header + 8 );
+  qToLittleEndian<quint32>( this->compressionLevel != 0 ? FlagCompressed : 0, header + 12 );
+
+  if( file.write( reinterpret_cast<const char*>( header ), HeaderSize ) != HeaderSize ) {
+    file.close();
+    return false;
+  }
+
+  // allocated once and kept for the next captures
+  if( !ring ) {
+    ring = std::make_unique<SpscByteRing>( RingSize );
+  }
+
+  written = HeaderSize;
+  dropped = 0;
+  stopping = false;
+  running = true;
+  thread = std::thread( &Writer::run, this );
+
+  return true;
+}
+
+void CaptureFile::Writer::close() {
+  if( !running ) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    stopping = true;
+  }
+
+  wakeUp.notify_one();
+  thread.join();
+
+  file.close();
+  block = QByteArray();
+  running = false;
+}
+
+bool CaptureFile::Writer::write( const qint64 timestampNs, const uint16_t source, const char* data, const uint32_t length, const uint16_t flags ) {
+  if( !running ) {
+    return false;
+  }
+
+  if( !ring->reserve( std::size_t( RecordHeaderSize ) + length ) ) {
+    ++dropped;
+    return false;
+  }
+
+  uchar header[RecordHeaderSize];
+  encodeRecordHeader( header, timestampNs, source, flags, length );
+
+  ring->append( reinterpret_cast<const char*>( header ), std::size_t( RecordHeaderSize ) );
+  ring->append( data, length );
+  ring->commit();
+
+  // without holding the mutex: a missed wake up is caught by the timeout of the thread
+  if( ring->size() >= WakeUpSize ) {
+    wakeUp.notify_one();
+  }
+
+  return true;
+}
+
+void CaptureFile::Writer::run() {
+  for( ;; ) {
+    {
+      std::unique_lock<std::mutex> lock( mutex );
+      wakeUp.wait_for( lock, std::chrono::milliseconds( WakeUpIntervalMs ), [this] {
+        return stopping.load() || ring->size() >= WakeUpSize;
+      } );
+    }
+
+    const bool stop = stopping;
+
+    drain();
+
+    if( stop ) {
+      break;
+    }
+  }
+}
+
+void CaptureFile::Writer::drain() {
+  const char* first = nullptr;
+  const char* second = nullptr;
+  std::size_t firstSize = 0;
+  std::size_t secondSize = 0;
+
+  const auto size = ring->peek( first, firstSize, second, secondSize );
+
+  if( size == 0 ) {
+    return;
+  }
+
+  if( compressionLevel != 0 ) {
+    writeCompressed( first, firstSize, second, secondSize );
+  } else {
+    qint64 bytes = file.write( first, qint64( firstSize ) );
+
+    if( secondSize != 0 ) {
+      bytes += file.write( second, qint64( secondSize ) );
+    }
+
+    written += std::max( bytes, qint64( 0 ) );
+  }
+
+  ring->consume( size );
+}
+
+bool CaptureFile::Writer::writeCompressed( const char* first, const std::size_t firstSize, const char* second, const std::size_t secondSize ) {
+  // the ring only holds whole records, so every block starts with a record header
+  block.resize( int( firstSize + secondSize ) );
+  std::memcpy( block.data(), first, firstSize );
+  std::memcpy( block.data() + firstSize, second, secondSize );
+
+  const auto compressed = qCompress( block, compressionLevel );
+
+  uchar header[RecordHeaderSize];
+  encodeRecordHeader( header,
+                      qint64( qFromLittleEndian<quint64>( block.constData() ) ),
+                      BlockSource, RecordFlagCompressedBlock, uint32_t( compressed.size() ) );
+
+  const bool ok = file.write( reinterpret_cast<const char*>( header ), RecordHeaderSize ) == RecordHeaderSize &&
+                  file.write( compressed ) == compressed.size();
+
+  written += RecordHeaderSize + compressed.size();
+
+  // keeps the capacity
+  block.resize( 0 );
+
+  return ok;
+}
+
+CaptureFile::Reader::~Reader() {
+  close();
+}
+
+bool CaptureFile::Reader::open( const QString& filename ) {
+  close();
+
+  file.setFileName( filename );
+
+  if( !file.open( QIODevice::ReadOnly ) || file.size() < HeaderSize ) {
+    file.close();
+    return false;
+  }
+
+  size = file.size();
+  map = file.map( 0, size );
+
+  if( map == nullptr ||
+      std::memcmp( map, Magic, sizeof( Magic ) ) != 0 ||
+      qFromLittleEndian<quint32>( map + 8 ) != Version ) {
+    close();
+    return false;
+  }
+
+  offset = HeaderSize;
+  return true;
+}
+
+void CaptureFile::Reader::close() {
+  if( map != nullptr ) {
+    file.unmap( const_cast<uchar*>( map ) );
+    map = nullptr;
+  }
+
+  file.close();
+  size = 0;
+  offset = 0;
+  block = QByteArray();
+  blockOffset = 0;
+}
+
+bool CaptureFile::Reader::next( Record& record ) {
+  if( map == nullptr ) {
+    return false;
+  }
+
+  for( ;; ) {
+    if( blockOffset < block.size() ) {
+      const auto recordSize = decodeRecord( reinterpret_cast<const uchar*>( block.constData() ) + blockOffset,
+                                            block.size() - blockOffset, record );
+
+      if( recordSize != 0 ) {
+        blockOffset += int( recordSize );
+        return true;
+      }
+
+      // a truncated block: go on with the next one
+      block.resize( 0 );
+      blockOffset = 0;
+    }
+
+    const auto recordSize = decodeRecord( map + offset, size - offset, record );
+
+    if( recordSize == 0 ) {
+      return false;
+    }
+
+    offset += recordSize;
+
+    if( record.source != BlockSource || !( record.flags & RecordFlagCompressedBlock ) ) {
+      return true;
+    }
+
+    block = qUncompress( reinterpret_cast<const uchar*>( record.data ), int( record.length ) );
+    blockOffset = 0;
+  }
+}
+
+void CaptureFile::Reader::rewind() {
+  if( map != nullptr ) {
+    offset = HeaderSize;
+  }
+
+  block.resize( 0 );
+  blockOffset = 0;
+}
+
+double CaptureFile::Reader::progress() const {
+  return size > HeaderSize ? double( offset - HeaderSize ) / double( size - HeaderSize ) : 1.;
+}
@@ -0,0 +1,154 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "helpers/SpscByteRing.h"
+
+// the format of the captures of the streams: a header, followed by records of a raw chunk of bytes each, as it was
+// received, with the time of receipt and the source. All numbers are little endian.
+//
+//   header:  char magic[8] = "QOGCAP\r\n", uint32 version, uint32 flags
+//   record:  uint64 timestamp (ns, monotonic), uint16 source, uint16 flags, uint32 length, uint8 data[length]
+namespace CaptureFile {
+  constexpr char Magic[8] = { 'Q', 'O', 'G', 'C', 'A', 'P', '\r', '\n' };
+  constexpr uint32_t Version = 1;
+  constexpr qint64 HeaderSize = 16;
+  constexpr qint64 RecordHeaderSize = 16;
+
+  // the records of the recorder can be compressed in blocks: a record of the source BlockSource with the flag
+  // CompressedBlock holds the following records, compressed with qCompress(); its timestamp is the one of the first
+  // record in the block. The header has the flag Compressed set in this case.
+  constexpr uint32_t FlagCompressed = 1;
+  constexpr uint16_t RecordFlagCompressedBlock = 1;
+  constexpr uint16_t BlockSource = 0xffff;
+
+  // appends the records to a preallocated ring, which a thread of its own writes to the file in large sequential
+  // writes; write() never waits on the disk. If the ring is full, the record is dropped and counted.
+  class Writer {
+    public:
+      Writer() = default;
+      ~Writer();
+
+      Writer( const Writer& ) = delete;
+      Writer& operator=( const Writer& ) = delete;
+
+      // truncates the file and writes the header; compressionLevel is the level of zlib, 0 doesn't compress
+      bool open( const QString& filename, const int compressionLevel = 0 );
+
+      // writes the rest of the ring and waits for the thread
+      void close();
+
+      bool isOpen() const {
+        return running;
+      }
+
+      // the thread calling open(); false if the record was dropped
+      bool write( const qint64 timestampNs, const uint16_t source, const char* data, const uint32_t length, const uint16_t flags = 0 );
+
+      qint64 bytesWritten() const {
+        return written.load( std::memory_order_relaxed );
+      }
+
+      qint64 droppedRecords() const {
+        return dropped;
+      }
+
+    private:
+      void run();
+      void drain();
+      bool writeCompressed( const char* first, const std::size_t firstSize, const char* second, const std::size_t secondSize );
+
+    private:
+      static constexpr std::size_t RingSize = 8 << 20;
+
+      // the thread is woken up early, if the ring fills up faster than it is drained by the timeout
+      static constexpr std::size_t WakeUpSize = RingSize / 4;
+      static constexpr int WakeUpIntervalMs = 100;
+
+      std::unique_ptr<SpscByteRing> ring;
+      std::thread thread;
+      std::mutex mutex;
+      std::condition_variable wakeUp;
+      std::atomic<bool> stopping = { false };
+      bool running = false;
+
+      // used by the thread only while it runs
+      QFile file;
+      int compressionLevel = 0;
+      QByteArray block;
+
+      std::atomic<qint64> written = { 0 };
+      qint64 dropped = 0;
+  };
+
+  // reads the records from a memory mapped file; the data of a record points into the mapping and is valid until the
+  // reader is closed. Compressed blocks are unpacked transparently; the data of their records is valid until the next
+  // block is unpacked, so only until the next call of next().
+  class Reader {
+    public:
+      struct Record {
+        qint64 timestampNs = 0;
+        uint16_t source = 0;
+        uint16_t flags = 0;
+        const char* data = nullptr;
+        uint32_t length = 0;
+      };
+
+    public:
+      Reader() = default;
+      ~Reader();
+
+      Reader( const Reader& ) = delete;
+      Reader& operator=( const Reader& ) = delete;
+
+      bool open( const QString& filename );
+      void close();
+
+      bool isOpen() const {
+        return map != nullptr;
+      }
+
+      // false at the end of the file or on a truncated record
+      bool next( Record& record );
+      void rewind();
+
+      // 0...1
+      double progress() const;
+
+    private:
+      QFile file;
+      const uchar* map = nullptr;
+      qint64 size = 0;
+      qint64 offset = 0;
+
+      // the unpacked compressed block and the offset of the next record in it
+      QByteArray block;
+      int blockOffset = 0;
+  };
+}
@@ -0,0 +1,93 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "CaptureRecorder.h"
+
+#include "qneblock.h"
+#include "qneport.h"
+
+#include "block/MeasurementTimestamp.h"
+
+#include <QBrush>
+#include <QDebug>
+
+CaptureRecorder::CaptureRecorder() {}
+
+void CaptureRecorder::setFilename( const QString& filename ) {
+  if( writer.droppedRecords() != 0 ) {
+    qWarning() << "CaptureRecorder:" << writer.droppedRecords() << "records dropped";
+    Q_EMIT droppedChanged( 0 );
+  }
+
+  writer.close();
+
+  if( !filename.isEmpty() && !writer.open( filename, compressionLevel ) ) {
+    qWarning() << "CaptureRecorder: couldn't open" << filename;
+  }
+}
+
+void CaptureRecorder::setCompression( const double level ) {
+  compressionLevel = int( level );
+}
+
+void CaptureRecorder::setData0( const QByteArray& data ) {
+  record( 0, data );
+}
+
+void CaptureRecorder::setData1( const QByteArray& data ) {
+  record( 1, data );
+}
+
+void CaptureRecorder::setData2( const QByteArray& data ) {
+  record( 2, data );
+}
+
+void CaptureRecorder::setData3( const QByteArray& data ) {
+  record( 3, data );
+}
+
+void CaptureRecorder::record( const uint16_t source, const QByteArray& data ) {
+  if( !writer.isOpen() || data.isEmpty() ) {
+    return;
+  }
+
+  const auto& timestamp = MeasurementTimestamp::current();
+  const auto receivedNs = timestamp.isValid() ? timestamp.receivedNs : MeasurementTimestamp::nowNs();
+
+  if( !writer.write( receivedNs, source, data.constData(), uint32_t( data.size() ) ) && receivedNs - lastDroppedNs >= 1000000000 ) {
+    lastDroppedNs = receivedNs;
+    Q_EMIT droppedChanged( double( writer.droppedRecords() ) );
+  }
+}
+
+QNEBlock* CaptureRecorderFactory::createBlock( QGraphicsScene* scene, int id ) {
+  auto* obj = new CaptureRecorder();
+  auto* b = createBaseBlock( scene, obj, id );
+
+  b->addInputPort( QStringLiteral( "File" ), QLatin1String( SLOT( setFilename( const QString& ) ) ) );
+  b->addInputPort( QStringLiteral( "Compression" ), QLatin1String( SLOT( setCompression( const double ) ) ) );
+  b->addInputPort( QStringLiteral( "Data 0" ), QLatin1String( SLOT( setData0( const QByteArray& ) ) ) );
+  b->addInputPort( QStringLiteral( "Data 1" ), QLatin1String( SLOT( setData1( const QByteArray& ) ) ) );
+  b->addInputPort( QStringLiteral( "Data 2" ), QLatin1String( SLOT( setData2( const QByteArray& ) ) ) );
+  b->addInputPort( QStringLiteral( "Data 3" ), QLatin1String( SLOT( setData3( const QByteArray& ) ) ) );
+
+  b->addOutputPort( QStringLiteral( "Dropped" ), QLatin1String( SIGNAL( droppedChanged( const double ) ) ) );
+
+  b->setBrush( valueColor );
+
+  return b;
+}
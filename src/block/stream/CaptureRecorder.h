@@ -0,0 +1,82 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QObject>
+
+#include "block/BlockBase.h"
+
+#include "CaptureFile.h"
+
+// records the data of up to four streams into a capture for CaptureReplay; each input is a source. The time of
+// receipt is taken from the MeasurementTimestamp of the stream, so the capture has the timing of the receipt and not
+// of the recorder. Connect it as a tee to the outputs of the streams: the data is only copied into a ring, a
+// thread of its own writes it to the disk, optionally compressed.
+class CaptureRecorder : public BlockBase {
+    Q_OBJECT
+
+  public:
+    explicit CaptureRecorder();
+
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
+  Q_SIGNALS:
+    // the records dropped because the disk couldn't keep up; at most once a second
+    void droppedChanged( const double );
+
+  public Q_SLOTS:
+    // starts a new capture; an empty filename stops the recording
+    void setFilename( const QString& filename );
+
+    // the level of zlib for the next capture; 0 doesn't compress
+    void setCompression( const double level );
+
+    void setData0( const QByteArray& data );
+    void setData1( const QByteArray& data );
+    void setData2( const QByteArray& data );
+    void setData3( const QByteArray& data );
+
+  private:
+    void record( const uint16_t source, const QByteArray& data );
+
+  private:
+    CaptureFile::Writer writer;
+    int compressionLevel = 0;
+
+    qint64 lastDroppedNs = 0;
+};
+
+class CaptureRecorderFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    CaptureRecorderFactory()
+      : BlockFactory() {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "Capture Recorder" );
+    }
+
+    QString getCategoryOfFactory() override {
+      return QStringLiteral( "Streams" );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override;
+};
@@ -0,0 +1,178 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "CaptureReplay.h"
+
+#include "qneblock.h"
+#include "qneport.h"
+
+#include "block/MeasurementTimestamp.h"
+
+#include <QBrush>
+#include <QTimerEvent>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+CaptureReplay::CaptureReplay() {}
+
+void CaptureReplay::setFilename( const QString& filename ) {
+  timer.stop();
+  hasNextRecord = false;
+
+  if( filename.isEmpty() ) {
+    reader.close();
+    return;
+  }
+
+  if( !reader.open( filename ) ) {
+    qWarning() << "CaptureReplay: couldn't open" << filename;
+    return;
+  }
+
+  restart();
+}
+
+void CaptureReplay::setSpeed( const double speed ) {
+  rebase();
+  this->speed = std::max( speed, 0. );
+
+  if( hasNextRecord ) {
+    timer.start( 0, Qt::PreciseTimer, this );
+  }
+}
+
+void CaptureReplay::restart() {
+  reader.rewind();
+  hasNextRecord = reader.next( nextRecord );
+  lastProgressPercent = -1;
+
+  if( hasNextRecord ) {
+    baseTimestampNs = nextRecord.timestampNs;
+    baseNs = MeasurementTimestamp::nowNs();
+
+    firstTimestampNs = nextRecord.timestampNs;
+    timelineOffsetNs = timelineNs;
+
+    timer.start( 0, Qt::PreciseTimer, this );
+  }
+}
+
+void CaptureReplay::rebase() {
+  if( hasNextRecord ) {
+    baseTimestampNs = nextRecord.timestampNs;
+    baseNs = MeasurementTimestamp::nowNs();
+  }
+}
+
+void CaptureReplay::timerEvent( QTimerEvent* event ) {
+  if( event->timerId() != timer.timerId() ) {
+    return;
+  }
+
+  if( speed <= 0 ) {
+    for( int i = 0; i < RecordsPerBatch && hasNextRecord; ++i ) {
+      emitRecord( nextRecord );
+      hasNextRecord = reader.next( nextRecord );
+    }
+  } else {
+    const auto elapsedNs = double( MeasurementTimestamp::nowNs() - baseNs );
+
+    while( hasNextRecord && double( nextRecord.timestampNs - baseTimestampNs ) / speed <= elapsedNs ) {
+      emitRecord( nextRecord );
+      hasNextRecord = reader.next( nextRecord );
+    }
+  }
+
+  emitProgress();
+
+  if( !hasNextRecord ) {
+    timer.stop();
+    return;
+  }
+
+  if( speed <= 0 ) {
+    timer.start( 0, Qt::PreciseTimer, this );
+  } else {
+    const auto dueNs = double( nextRecord.timestampNs - baseTimestampNs ) / speed - double( MeasurementTimestamp::nowNs() - baseNs );
+    timer.start( std::max( int( std::ceil( dueNs / 1e6 ) ), 0 ), Qt::PreciseTimer, this );
+  }
+}
+
+void CaptureReplay::emitRecord( const CaptureFile::Reader::Record& record ) {
+  // the receipt stays on the monotonic clock, so the ages downstream are the real ones; the intervals of the capture are
+  // carried by the time of validity
+  timelineNs = std::max( timelineNs, timelineOffsetNs + record.timestampNs - firstTimestampNs );
+
+  MeasurementTimestamp timestamp;
+  timestamp.receivedNs = MeasurementTimestamp::nowNs();
+  timestamp.timeBase = MeasurementTimestamp::TimeBase::Capture;
+  timestamp.validitySeconds = double( timelineNs ) * 1e-9;
+  MeasurementTimestamp::Scope timestampScope( timestamp );
+
+  // a copy, as the receivers can keep the data longer than the file is mapped
+  const QByteArray data( record.data, int( record.length ) );
+
+  switch( record.source ) {
+    case 0:
+      Q_EMIT dataReceived0( data );
+      break;
+
+    case 1:
+      Q_EMIT dataReceived1( data );
+      break;
+
+    case 2:
+      Q_EMIT dataReceived2( data );
+      break;
+
+    case 3:
+      Q_EMIT dataReceived3( data );
+      break;
+
+    default:
+      break;
+  }
+}
+
+void CaptureReplay::emitProgress() {
+  const int percent = int( reader.progress() * 100 );
+
+  if( percent != lastProgressPercent ) {
+    lastProgressPercent = percent;
+    Q_EMIT progressChanged( percent );
+  }
+}
+
+QNEBlock* CaptureReplayFactory::createBlock( QGraphicsScene* scene, int id ) {
+  auto* obj = new CaptureReplay();
+  auto* b = createBaseBlock( scene, obj, id );
+
+  b->addInputPort( QStringLiteral( "File" ), QLatin1String( SLOT( setFilename( const QString& ) ) ) );
+  b->addInputPort( QStringLiteral( "Speed" ), QLatin1String( SLOT( setSpeed( const double ) ) ) );
+
+  b->addOutputPort( QStringLiteral( "Data 0" ), QLatin1String( SIGNAL( dataReceived0( const QByteArray& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Data 1" ), QLatin1String( SIGNAL( dataReceived1( const QByteArray& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Data 2" ), QLatin1String( SIGNAL( dataReceived2( const QByteArray& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Data 3" ), QLatin1String( SIGNAL( dataReceived3( const QByteArray& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Progress" ), QLatin1String( SIGNAL( progressChanged( const double ) ) ) );
+
+  b->setBrush( valueColor );
+
+  return b;
+}
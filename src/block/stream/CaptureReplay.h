@@ -0,0 +1,106 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QObject>
+#include <QBasicTimer>
+
+#include "block/BlockBase.h"
+
+#include "CaptureFile.h"
+
+// replays a capture of the streams with the original timing, scaled by the speed, or as fast as possible with a speed
+// of 0. The data of each source is emitted on its own output; the MeasurementTimestamp is received now and carries the
+// timeline of the capture as the time of validity (TimeBase::Capture), so the filters see the original intervals in
+// every mode.
+class CaptureReplay : public BlockBase {
+    Q_OBJECT
+
+  public:
+    static constexpr int NumSources = 4;
+
+    explicit CaptureReplay();
+
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
+  Q_SIGNALS:
+    void dataReceived0( const QByteArray& );
+    void dataReceived1( const QByteArray& );
+    void dataReceived2( const QByteArray& );
+    void dataReceived3( const QByteArray& );
+
+    void progressChanged( const double );
+
+  public Q_SLOTS:
+    void setFilename( const QString& filename );
+
+    // 1 is real-time, 0 as fast as possible
+    void setSpeed( const double speed );
+
+  protected:
+    void timerEvent( QTimerEvent* event ) override;
+
+  private:
+    void restart();
+    void rebase();
+    void emitRecord( const CaptureFile::Reader::Record& record );
+    void emitProgress();
+
+  private:
+    // the records replayed in one go, if as fast as possible; the event loop runs in between
+    static constexpr int RecordsPerBatch = 1024;
+
+    CaptureFile::Reader reader;
+    CaptureFile::Reader::Record nextRecord;
+    bool hasNextRecord = false;
+
+    double speed = 1;
+    QBasicTimer timer;
+
+    // the timeline of the capture is mapped to the monotonic clock relative to this record, so changing the speed
+    // doesn't jump
+    qint64 baseTimestampNs = 0;
+    qint64 baseNs = 0;
+
+    // the timeline of the capture relative to its first record; a restart continues it, so it never runs backwards
+    qint64 firstTimestampNs = 0;
+    qint64 timelineOffsetNs = 0;
+    qint64 timelineNs = 0;
+
+    int lastProgressPercent = -1;
+};
+
+class CaptureReplayFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    CaptureReplayFactory()
+      : BlockFactory() {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "Capture Replay" );
+    }
+
+    QString getCategoryOfFactory() override {
+      return QStringLiteral( "Streams" );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override;
+};
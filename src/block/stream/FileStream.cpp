@@ -21,6 +21,8 @@
 #include "qneblock.h"
 #include "qneport.h"
 
+#include "block/MeasurementTimestamp.h"
+
 #include <QBrush>
 #include <QFile>
 #include <QByteArray>
@@ -80,6 +82,7 @@ void FileStream::timerEvent( QTimerEvent* event ) {
       if( fileStream->atEnd() ) {
         timer.stop();
       } else {
+        MeasurementTimestamp::Scope timestampScope( MeasurementTimestamp::received() );
         Q_EMIT dataReceived( fileStream->readLine().toLatin1() );
       }
     }
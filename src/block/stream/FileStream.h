@@ -34,6 +34,10 @@ class FileStream : public BlockBase {
   public:
     explicit FileStream();
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
     ~FileStream() override;
 
   Q_SIGNALS:
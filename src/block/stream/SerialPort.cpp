@@ -21,47 +21,125 @@
 #include "qneblock.h"
 #include "qneport.h"
 
+#include "block/MeasurementTimestamp.h"
+
 #include <QObject>
 #include <QBrush>
 #include <QByteArray>
 #include <QSerialPort>
 
-SerialPort::SerialPort() {
+#include <algorithm>
+
+SerialPortWorker::SerialPortWorker( QObject* parent )
+  : StreamWorker( InitialCapacity, parent ) {
   serialPort = new QSerialPort( this );
+  serialPort->setReadBufferSize( ReadBufferSize );
   connect( serialPort, &QIODevice::readyRead,
-           this, &SerialPort::processPendingData );
+           this, &SerialPortWorker::readPending );
+}
+
+void SerialPortWorker::open( const QString& port, const qint32 baudrate ) {
+  serialPort->close();
+  serialPort->setPortName( port );
+  serialPort->setBaudRate( baudrate );
+  serialPort->open( QIODevice::ReadWrite );
+}
+
+void SerialPortWorker::setBaudrate( const qint32 baudrate ) {
+  serialPort->setBaudRate( baudrate );
+}
+
+void SerialPortWorker::send( const QByteArray& data ) {
+  serialPort->write( data );
+}
+
+bool SerialPortWorker::hasPending() {
+  return serialPort->bytesAvailable() > 0;
+}
+
+bool SerialPortWorker::readChunk( QByteArray& buffer ) {
+  buffer.resize( int( serialPort->bytesAvailable() ) );
+  const auto bytesRead = serialPort->read( buffer.data(), buffer.size() );
+  buffer.resize( int( std::max( bytesRead, qint64( 0 ) ) ) );
+  return bytesRead > 0;
+}
+
+qint64 SerialPortWorker::dropBacklog() {
+  return serialPort->skip( serialPort->bytesAvailable() );
+}
+
+SerialPort::SerialPort() {
+  createWorker();
 }
 
 SerialPort::~SerialPort() {
-  if( serialPort ) {
-    serialPort->deleteLater();
+  // on the I/O thread, the worker has no parent
+  if( onIoThread && worker ) {
+    worker->deleteLater();
+  }
+}
+
+void SerialPort::createWorker() {
+  if( worker ) {
+    StreamWorker::destroy( worker );
+  }
+
+  worker = new SerialPortWorker( onIoThread ? nullptr : this );
+
+  if( onIoThread ) {
+    worker->moveToThread( StreamWorker::ioThread() );
+  }
+
+  connect( worker, &StreamWorker::chunkReceived, this, &SerialPort::deliver );
+  connect( worker, &StreamWorker::droppedChanged, this, &SerialPort::droppedChanged );
+  connect( worker, &StreamWorker::stallsChanged, this, &SerialPort::stallsChanged );
+
+  if( !port.isEmpty() ) {
+    setPort( port );
   }
 }
 
 void SerialPort::setPort( const QString& port ) {
   this->port = port;
-  serialPort->close();
-  serialPort->setPortName( port );
-  serialPort->open( QIODevice::ReadWrite );
+
+  auto* worker = this->worker;
+  const auto baudrate = qint32( this->baudrate );
+  QMetaObject::invokeMethod( worker, [worker, port, baudrate] {
+    worker->open( port, baudrate );
+  } );
 }
 
 void SerialPort::setBaudrate( double baudrate ) {
   this->baudrate = baudrate;
-  serialPort->setBaudRate( qint32( baudrate ) );
+
+  auto* worker = this->worker;
+  QMetaObject::invokeMethod( worker, [worker, baudrate] {
+    worker->setBaudrate( qint32( baudrate ) );
+  } );
+}
+
+void SerialPort::setIoThread( double ioThread ) {
+  if( ( ioThread != 0 ) != onIoThread ) {
+    // the old worker closes the device, the new one opens it again on its thread
+    onIoThread = ioThread != 0;
+    createWorker();
+  }
 }
 
 void SerialPort::sendData( const QByteArray& data ) {
-  serialPort->write( data );
+  auto* worker = this->worker;
+  QMetaObject::invokeMethod( worker, [worker, data] {
+    worker->send( data );
+  } );
 }
 
-void SerialPort::processPendingData() {
-  QByteArray datagram;
+void SerialPort::deliver( const QByteArray& data, const qint64 receivedNs ) {
+  // the time of receipt is the one of the read, not of this delivery
+  MeasurementTimestamp timestamp;
+  timestamp.receivedNs = receivedNs;
 
-  while( serialPort->bytesAvailable() ) {
-    datagram.resize( int( serialPort->bytesAvailable() ) );
-    serialPort->read( datagram.data(), datagram.size() );
-    Q_EMIT dataReceived( datagram );
-  }
+  MeasurementTimestamp::Scope timestampScope( timestamp );
+  Q_EMIT dataReceived( data );
 }
 
 QNEBlock* SerialPortFactory::createBlock( QGraphicsScene* scene, int id ) {
@@ -70,9 +148,12 @@ QNEBlock* SerialPortFactory::createBlock( QGraphicsScene* scene, int id ) {
 
   b->addInputPort( QStringLiteral( "Port" ), QLatin1String( SLOT( setPort( QString ) ) ) );
   b->addInputPort( QStringLiteral( "Baudrate" ), QLatin1String( SLOT( setBaudrate( double ) ) ) );
+  b->addInputPort( QStringLiteral( "I/O Thread" ), QLatin1String( SLOT( setIoThread( double ) ) ) );
   b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( sendData( const QByteArray& ) ) ) );
 
   b->addOutputPort( QStringLiteral( "Data" ), QLatin1String( SIGNAL( dataReceived( const QByteArray& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Dropped" ), QLatin1String( SIGNAL( droppedChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Stalls" ), QLatin1String( SIGNAL( stallsChanged( const double ) ) ) );
 
   b->setBrush( inputOutputColor );
 
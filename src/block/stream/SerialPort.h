@@ -22,8 +22,36 @@
 
 #include "block/BlockBase.h"
 
+#include "StreamWorker.h"
+
 class QSerialPort;
 
+class SerialPortWorker : public StreamWorker {
+    Q_OBJECT
+
+  public:
+    explicit SerialPortWorker( QObject* parent = nullptr );
+
+  public Q_SLOTS:
+    void open( const QString& port, const qint32 baudrate );
+    void setBaudrate( const qint32 baudrate );
+
+    void send( const QByteArray& data ) override;
+
+  protected:
+    bool hasPending() override;
+    bool readChunk( QByteArray& buffer ) override;
+    qint64 dropBacklog() override;
+
+  private:
+    // bounds the buffer of QSerialPort, so a stall leaves the rest in the driver
+    static constexpr qint64 ReadBufferSize = 64 * 1024;
+    static constexpr int InitialCapacity = 4096;
+
+    QSerialPort* serialPort = nullptr;
+};
+
+// the device is read by a SerialPortWorker, on the thread of the block or on the I/O thread
 class SerialPort : public BlockBase {
     Q_OBJECT
 
@@ -31,25 +59,39 @@ class SerialPort : public BlockBase {
     explicit SerialPort();
     ~SerialPort();
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
   signals:
     void  dataReceived( const QByteArray& );
 
+    void droppedChanged( const double );
+    void stallsChanged( const double );
+
   public slots:
     void setPort( const QString& port );
 
     void setBaudrate( double baudrate );
 
+    // 0: read the device on the thread of the block, else on the I/O thread
+    void setIoThread( double ioThread );
+
     void sendData( const QByteArray& data );
 
   protected slots:
-    void processPendingData();
+    void deliver( const QByteArray& data, const qint64 receivedNs );
 
   public:
     QString port;
     double baudrate = 0;
 
   private:
-    QSerialPort* serialPort = nullptr;
+    void createWorker();
+
+  private:
+    SerialPortWorker* worker = nullptr;
+    bool onIoThread = false;
 };
 
 class SerialPortFactory : public BlockFactory {
@@ -0,0 +1,150 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "StreamWorker.h"
+
+#include "block/MeasurementTimestamp.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QTimerEvent>
+
+#include <array>
+
+BufferPool::BufferPool( const int numBuffers, const int initialCapacity )
+  : buffers( std::size_t( numBuffers ) ) {
+  for( auto& buffer : buffers ) {
+    // a reserved capacity survives resize( 0 )
+    buffer.reserve( initialCapacity );
+  }
+}
+
+int BufferPool::acquire( QByteArray** acquired, const int count ) {
+  int numAcquired = 0;
+
+  for( std::size_t i = 0; i < buffers.size() && numAcquired < count; ++i ) {
+    auto& buffer = buffers[next];
+    next = ( next + 1 ) % buffers.size();
+
+    if( buffer.isDetached() ) {
+      acquired[numAcquired++] = &buffer;
+    }
+  }
+
+  return numAcquired;
+}
+
+StreamWorker::StreamWorker( const int initialCapacity, QObject* parent )
+  : QObject( parent ), pool( NumBuffers, initialCapacity ) {}
+
+QThread* StreamWorker::ioThread() {
+  static QThread* thread = [] {
+    auto* thread = new QThread();
+    thread->setObjectName( QStringLiteral( "I/O" ) );
+    thread->start( QThread::TimeCriticalPriority );
+
+    QObject::connect( qApp, &QCoreApplication::aboutToQuit, thread, [thread] {
+      thread->quit();
+      thread->wait();
+    }, Qt::DirectConnection );
+
+    return thread;
+  }();
+
+  return thread;
+}
+
+void StreamWorker::destroy( StreamWorker* worker ) {
+  if( worker->thread() == QThread::currentThread() ) {
+    delete worker;
+  } else {
+    QMetaObject::invokeMethod( worker, [worker] {
+      delete worker;
+    }, Qt::BlockingQueuedConnection );
+  }
+}
+
+void StreamWorker::readPending() {
+  for( ;; ) {
+    std::array<QByteArray*, MaxBatchSize> batch;
+    const int acquired = pool.acquire( batch.data(), MaxBatchSize );
+
+    if( acquired == 0 ) {
+      if( hasPending() ) {
+        stall();
+        return;
+      }
+
+      break;
+    }
+
+    const int numRead = readChunks( batch.data(), acquired );
+    const auto receivedNs = MeasurementTimestamp::nowNs();
+
+    for( int i = 0; i < numRead; ++i ) {
+      // the copy in the signal only references the buffer
+      Q_EMIT chunkReceived( *batch[std::size_t( i )], receivedNs );
+    }
+
+    // the device is drained
+    if( numRead < acquired ) {
+      break;
+    }
+  }
+
+  stalledSinceNs = 0;
+  retryTimer.stop();
+}
+
+int StreamWorker::readChunks( QByteArray** buffers, const int count ) {
+  int numRead = 0;
+
+  while( numRead < count && hasPending() && readChunk( *buffers[numRead] ) ) {
+    ++numRead;
+  }
+
+  return numRead;
+}
+
+void StreamWorker::addDropped( const qint64 count ) {
+  if( count != 0 ) {
+    dropped += count;
+    Q_EMIT droppedChanged( double( dropped ) );
+  }
+}
+
+void StreamWorker::stall() {
+  const auto nowNs = MeasurementTimestamp::nowNs();
+
+  if( stalledSinceNs == 0 ) {
+    stalledSinceNs = nowNs;
+    Q_EMIT stallsChanged( double( ++stalls ) );
+  } else if( nowNs - stalledSinceNs > qint64( MaxStallMs ) * 1000000 ) {
+    stalledSinceNs = nowNs;
+    addDropped( dropBacklog() );
+  }
+
+  if( !retryTimer.isActive() ) {
+    retryTimer.start( RetryIntervalMs, Qt::PreciseTimer, this );
+  }
+}
+
+void StreamWorker::timerEvent( QTimerEvent* event ) {
+  if( event->timerId() == retryTimer.timerId() ) {
+    readPending();
+  }
+}
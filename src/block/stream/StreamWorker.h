@@ -0,0 +1,115 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QBasicTimer>
+
+#include <vector>
+
+class QThread;
+
+// a fixed set of buffers, reused once nobody downstream references them anymore. QByteArray is reference counted, so
+// a buffer is handed to the receivers without copying and comes back to the pool when the last copy is released.
+class BufferPool {
+  public:
+    BufferPool( const int numBuffers, const int initialCapacity );
+
+    // up to count distinct buffers referenced by the pool only; fewer, if the others are still in use downstream.
+    // Their capacity is kept, so they only allocate if a chunk is larger than ever before.
+    int acquire( QByteArray** acquired, const int count );
+
+    int numBuffers() const {
+      return int( buffers.size() );
+    }
+
+  private:
+    std::vector<QByteArray> buffers;
+    std::size_t next = 0;
+};
+
+// owns the device of a stream block and reads it into pooled buffers. It runs either on the thread of the block or on
+// the shared I/O thread, so the reads and their timestamps don't depend on the load of the block's thread.
+//
+// If all buffers are still in use downstream, the data is left in the device (back-pressure) and reading is retried
+// shortly; if that lasts for longer than MaxStallMs, the backlog of the device is dropped, so the receivers get fresh
+// data instead of a growing latency. Both are counted.
+class StreamWorker : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit StreamWorker( const int initialCapacity, QObject* parent = nullptr );
+
+    // the thread of the devices of all streams with the dedicated I/O thread enabled; started on first use with a
+    // high priority and stopped when the application quits
+    static QThread* ioThread();
+
+    // deletes the worker on its thread and waits for it, so its device is closed on return
+    static void destroy( StreamWorker* worker );
+
+  Q_SIGNALS:
+    // receivedNs: MeasurementTimestamp::nowNs() right after the read
+    void chunkReceived( const QByteArray& data, const qint64 receivedNs );
+
+    void droppedChanged( const double );
+    void stallsChanged( const double );
+
+  public Q_SLOTS:
+    virtual void send( const QByteArray& data ) = 0;
+
+  protected Q_SLOTS:
+    void readPending();
+
+  protected:
+    void timerEvent( QTimerEvent* event ) override;
+
+    // the implementations of the devices
+    virtual bool hasPending() = 0;
+
+    // reads the next chunk (or datagram) into buffer; false if nothing could be read
+    virtual bool readChunk( QByteArray& buffer ) = 0;
+
+    // reads up to count chunks at once; returns the number read. Calls readChunk() by default, devices with a batched
+    // read override it.
+    virtual int readChunks( QByteArray** buffers, const int count );
+
+    // discards everything pending in the device; returns the dropped units (bytes or datagrams)
+    virtual qint64 dropBacklog() = 0;
+
+    // drops counted by the device itself, like the overflows of the receive buffer of a socket
+    void addDropped( const qint64 count );
+
+  private:
+    void stall();
+
+  protected:
+    static constexpr int NumBuffers = 32;
+    static constexpr int MaxBatchSize = 16;
+    static constexpr int RetryIntervalMs = 1;
+    static constexpr int MaxStallMs = 100;
+
+    BufferPool pool;
+
+  private:
+    QBasicTimer retryTimer;
+    qint64 stalledSinceNs = 0;
+
+    qint64 dropped = 0;
+    qint64 stalls = 0;
+};
@@ -21,48 +21,541 @@
 #include "qneblock.h"
 #include "qneport.h"
 
+#include "block/MeasurementTimestamp.h"
+
 #include <QBrush>
+#include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QtNetwork>
 
-UdpSocket::UdpSocket() {
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+  #include <arpa/inet.h>
+  #include <netinet/in.h>
+  #include <sys/socket.h>
+#endif
+
+namespace {
+#ifdef Q_OS_LINUX
+  // the address of QHostAddress for a socket of family; an IPv4 address is mapped for a dual stack socket, like
+  // QUdpSocket does. Returns the length of the address, or 0 if it can't be used with the socket.
+  socklen_t toSockaddr( const QHostAddress& address, const quint16 port, const int family, sockaddr_storage& storage ) {
+    std::memset( &storage, 0, sizeof( storage ) );
+
+    if( family == AF_INET && address.protocol() == QAbstractSocket::IPv4Protocol ) {
+      auto* in = reinterpret_cast<sockaddr_in*>( &storage );
+      in->sin_family = AF_INET;
+      in->sin_port = htons( port );
+      in->sin_addr.s_addr = htonl( address.toIPv4Address() );
+      return sizeof( sockaddr_in );
+    }
+
+    if( family == AF_INET6 ) {
+      auto* in6 = reinterpret_cast<sockaddr_in6*>( &storage );
+      in6->sin6_family = AF_INET6;
+      in6->sin6_port = htons( port );
+
+      if( address.protocol() == QAbstractSocket::IPv4Protocol ) {
+        const auto ipv4 = htonl( address.toIPv4Address() );
+        in6->sin6_addr.s6_addr[10] = 0xff;
+        in6->sin6_addr.s6_addr[11] = 0xff;
+        std::memcpy( &in6->sin6_addr.s6_addr[12], &ipv4, sizeof( ipv4 ) );
+      } else {
+        const auto ipv6 = address.toIPv6Address();
+        std::memcpy( &in6->sin6_addr, &ipv6, sizeof( ipv6 ) );
+      }
+
+      return sizeof( sockaddr_in6 );
+    }
+
+    return 0;
+  }
+#endif
+}
+
+UdpSocketWorker::UdpSocketWorker( QObject* parent )
+  : StreamWorker( MaxDatagramSize, parent ) {
   udpSocket = new QUdpSocket( this );
+
   connect( udpSocket, &QIODevice::readyRead,
-           this, &UdpSocket::processPendingDatagrams );
+           this, &UdpSocketWorker::readDatagrams );
+
+  outgoing.reserve( MaxBatchSize );
+  statisticsTimer.start( StatisticsIntervalMs, this );
+}
+
+void UdpSocketWorker::bind( const quint16 port ) {
+  this->port = port;
+  rebind();
+}
+
+void UdpSocketWorker::setDestination( const QString& destination ) {
+  this->destination.clear();
+  destinationPort = 0;
+
+  if( destination.isEmpty() ) {
+    return;
+  }
+
+  // "address", "address:port", "[ipv6]:port" or a bare IPv6 address
+  QString host = destination;
+  const int colon = destination.lastIndexOf( QLatin1Char( ':' ) );
+
+  if( destination.startsWith( QLatin1Char( '[' ) ) ) {
+    const int bracket = destination.indexOf( QLatin1Char( ']' ) );
+    host = destination.mid( 1, bracket - 1 );
+
+    if( colon > bracket ) {
+      destinationPort = quint16( destination.midRef( colon + 1 ).toUInt() );
+    }
+  } else if( colon >= 0 && destination.count( QLatin1Char( ':' ) ) == 1 ) {
+    host = destination.left( colon );
+    destinationPort = quint16( destination.midRef( colon + 1 ).toUInt() );
+  }
+
+  // no lookups of names: they would block the thread of the socket
+  if( !this->destination.setAddress( host ) ) {
+    qWarning() << "UdpSocket: not an address:" << destination;
+  }
+}
+
+void UdpSocketWorker::setMulticastGroup( const QString& group ) {
+  multicastGroup.clear();
+
+  if( !group.isEmpty() && !multicastGroup.setAddress( group ) ) {
+    qWarning() << "UdpSocket: not an address:" << group;
+  }
+
+  rebind();
+}
+
+void UdpSocketWorker::rebind() {
+  udpSocket->close();
+
+  if( port == 0 ) {
+    return;
+  }
+
+  const bool multicast = multicastGroup.isMulticast();
+
+  // IPv4 groups can only be joined by an IPv4 socket
+  const QHostAddress bindAddress( multicast && multicastGroup.protocol() == QAbstractSocket::IPv4Protocol ?
+                                  QHostAddress::AnyIPv4 : QHostAddress::Any );
+
+  if( !udpSocket->bind( bindAddress, port,
+                        multicast ? QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint : QUdpSocket::DontShareAddress ) ) {
+    qWarning() << "UdpSocket: couldn't bind to" << port << udpSocket->errorString();
+    return;
+  }
+
+  udpSocket->setSocketOption( QAbstractSocket::ReceiveBufferSizeSocketOption, ReceiveBufferSize );
+
+  if( multicast ) {
+    // the datagrams sent to the group reach the programs on this host too, like another ECU in a simulation
+    udpSocket->setSocketOption( QAbstractSocket::MulticastLoopbackOption, 1 );
+
+    if( !udpSocket->joinMulticastGroup( multicastGroup ) ) {
+      qWarning() << "UdpSocket: couldn't join" << multicastGroup << udpSocket->errorString();
+    }
+  }
+
+#ifdef Q_OS_LINUX
+  const int on = 1;
+  ::setsockopt( int( udpSocket->socketDescriptor() ), SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof( on ) );
+  kernelDrops = 0;
+#endif
+}
+
+void UdpSocketWorker::readDatagrams() {
+  qtReadPending = true;
+  readPending();
+}
+
+void UdpSocketWorker::send( const QByteArray& data ) {
+  outgoing.push_back( data );
+
+  if( int( outgoing.size() ) >= MaxBatchSize ) {
+    flush();
+  } else if( !flushTimer.isActive() ) {
+    flushTimer.start( 0, this );
+  }
+}
+
+void UdpSocketWorker::flush() {
+  flushTimer.stop();
+
+  if( outgoing.empty() ) {
+    return;
+  }
+
+  const QHostAddress address = destination.isNull() ? QHostAddress( QHostAddress::Broadcast ) : destination;
+  const quint16 toPort = destinationPort != 0 ? destinationPort : port;
+
+#ifdef Q_OS_LINUX
+  const int fd = int( udpSocket->socketDescriptor() );
+  sockaddr_storage local;
+  socklen_t localLength = sizeof( local );
+  sockaddr_storage remote;
+  socklen_t remoteLength = 0;
+
+  if( udpSocket->state() == QAbstractSocket::BoundState &&
+      ::getsockname( fd, reinterpret_cast<sockaddr*>( &local ), &localLength ) == 0 ) {
+    remoteLength = toSockaddr( address, toPort, local.ss_family, remote );
+  }
+
+  if( remoteLength != 0 ) {
+    std::array<mmsghdr, MaxBatchSize> messages = {};
+    std::array<iovec, MaxBatchSize> iovecs;
+    const int count = int( outgoing.size() );
+
+    for( int i = 0; i < count; ++i ) {
+      iovecs[std::size_t( i )].iov_base = const_cast<char*>( outgoing[std::size_t( i )].constData() );
+      iovecs[std::size_t( i )].iov_len = std::size_t( outgoing[std::size_t( i )].size() );
+
+      auto& header = messages[std::size_t( i )].msg_hdr;
+      header.msg_name = &remote;
+      header.msg_namelen = remoteLength;
+      header.msg_iov = &iovecs[std::size_t( i )];
+      header.msg_iovlen = 1;
+    }
+
+    int sent = 0;
+
+    while( sent < count ) {
+      const int result = ::sendmmsg( fd, messages.data() + sent, unsigned( count - sent ), MSG_DONTWAIT );
+
+      if( result <= 0 ) {
+        break;
+      }
+
+      sent += result;
+    }
+
+    packetsSent += sent;
+    addSendErrors( count - sent );
+    outgoing.clear();
+    return;
+  }
+#endif
+
+  for( const auto& data : outgoing ) {
+    if( udpSocket->writeDatagram( data, address, toPort ) >= 0 ) {
+      ++packetsSent;
+    } else {
+      addSendErrors( 1 );
+    }
+  }
+
+  outgoing.clear();
+}
+
+void UdpSocketWorker::addSendErrors( const qint64 count ) {
+  if( count > 0 ) {
+    // once per socket, the count is reported with the statistics
+    if( sendErrors == 0 ) {
+      qWarning() << "UdpSocket: couldn't send to port" << ( destinationPort != 0 ? destinationPort : port ) << udpSocket->errorString();
+    }
+
+    sendErrors += count;
+  }
+}
+
+void UdpSocketWorker::timerEvent( QTimerEvent* event ) {
+  if( event->timerId() == flushTimer.timerId() ) {
+    flush();
+  } else if( event->timerId() == statisticsTimer.timerId() ) {
+    reportStatistics();
+  } else {
+    StreamWorker::timerEvent( event );
+  }
+}
+
+void UdpSocketWorker::reportStatistics() {
+  if( packetsReceived != reportedPacketsReceived ) {
+    reportedPacketsReceived = packetsReceived;
+    Q_EMIT packetsReceivedChanged( double( packetsReceived ) );
+  }
+
+  if( packetsSent != reportedPacketsSent ) {
+    reportedPacketsSent = packetsSent;
+    Q_EMIT packetsSentChanged( double( packetsSent ) );
+  }
+
+  if( sendErrors != reportedSendErrors ) {
+    reportedSendErrors = sendErrors;
+    Q_EMIT sendErrorsChanged( double( sendErrors ) );
+  }
+}
+
+bool UdpSocketWorker::hasPending() {
+  return udpSocket->hasPendingDatagrams();
+}
+
+bool UdpSocketWorker::readChunk( QByteArray& buffer ) {
+  // within the reserved capacity, so no allocation; the datagram is never larger
+  buffer.resize( MaxDatagramSize );
+  const auto bytesRead = udpSocket->readDatagram( buffer.data(), buffer.size() );
+  buffer.resize( int( std::max( bytesRead, qint64( 0 ) ) ) );
+  qtReadPending = false;
+
+  if( bytesRead >= 0 ) {
+    ++packetsReceived;
+    return true;
+  }
+
+  return false;
+}
+
+int UdpSocketWorker::readChunks( QByteArray** buffers, const int count ) {
+#ifdef Q_OS_LINUX
+  if( udpSocket->state() != QAbstractSocket::BoundState ) {
+    return 0;
+  }
+
+  // QUdpSocket only arms its read notification again, once a datagram is read through it: after a readyRead(), the
+  // first datagram is read by QUdpSocket and the rest of the batch with recvmmsg()
+  int numRead = 0;
+
+  if( qtReadPending && readChunk( *buffers[0] ) ) {
+    ++numRead;
+  }
+
+  if( numRead == count ) {
+    return numRead;
+  }
+
+  // room for the counter of SO_RXQ_OVFL
+  struct Control {
+    alignas( cmsghdr ) char data[CMSG_SPACE( sizeof( uint32_t ) )];
+  };
+
+  std::array<mmsghdr, MaxBatchSize> messages = {};
+  std::array<iovec, MaxBatchSize> iovecs;
+  std::array<Control, MaxBatchSize> controls;
+
+  buffers += numRead;
+  const int batchSize = count - numRead;
+
+  for( int i = 0; i < batchSize; ++i ) {
+    // within the reserved capacity, so no allocation
+    buffers[i]->resize( MaxDatagramSize );
+    iovecs[std::size_t( i )].iov_base = buffers[i]->data();
+    iovecs[std::size_t( i )].iov_len = MaxDatagramSize;
+
+    auto& header = messages[std::size_t( i )].msg_hdr;
+    header.msg_iov = &iovecs[std::size_t( i )];
+    header.msg_iovlen = 1;
+    header.msg_control = controls[std::size_t( i )].data;
+    header.msg_controllen = sizeof( Control::data );
+  }
+
+  const int received = ::recvmmsg( int( udpSocket->socketDescriptor() ), messages.data(), unsigned( batchSize ), MSG_DONTWAIT, nullptr );
+
+  if( received <= 0 ) {
+    return numRead;
+  }
+
+  const auto previousKernelDrops = kernelDrops;
+
+  for( int i = 0; i < received; ++i ) {
+    auto& header = messages[std::size_t( i )].msg_hdr;
+    buffers[i]->resize( int( messages[std::size_t( i )].msg_len ) );
+
+    for( auto* control = CMSG_FIRSTHDR( &header ); control != nullptr; control = CMSG_NXTHDR( &header, control ) ) {
+      if( control->cmsg_level == SOL_SOCKET && control->cmsg_type == SO_RXQ_OVFL ) {
+        std::memcpy( &kernelDrops, CMSG_DATA( control ), sizeof( kernelDrops ) );
+      }
+    }
+  }
+
+  packetsReceived += received;
+  addDropped( qint64( uint32_t( kernelDrops - previousKernelDrops ) ) );
+
+  return numRead + received;
+#else
+  return StreamWorker::readChunks( buffers, count );
+#endif
+}
+
+qint64 UdpSocketWorker::dropBacklog() {
+  qint64 datagrams = 0;
+  char discard;
+
+  while( udpSocket->hasPendingDatagrams() ) {
+    udpSocket->readDatagram( &discard, 0 );
+    ++datagrams;
+  }
+
+  qtReadPending = false;
+
+  return datagrams;
+}
+
+UdpSocketWorker::LoopbackResult UdpSocketWorker::loopbackTest( const quint16 port, const int datagrams, const int datagramSize ) {
+  LoopbackResult result;
+
+  UdpSocketWorker receiver;
+  receiver.bind( port );
+
+  UdpSocketWorker sender;
+  sender.bind( quint16( port + 1 ) );
+  sender.setDestination( QStringLiteral( "127.0.0.1:%1" ).arg( port ) );
+
+  QObject::connect( &receiver, &StreamWorker::chunkReceived, [&result]( const QByteArray&, const qint64 ) {
+    ++result.received;
+  } );
+  QObject::connect( &receiver, &StreamWorker::droppedChanged, [&result]( const double dropped ) {
+    result.dropped = qint64( dropped );
+  } );
+
+  const QByteArray payload( datagramSize, 'x' );
+
+  QElapsedTimer timer;
+  timer.start();
+
+  for( int i = 0; i < datagrams; ++i ) {
+    sender.send( payload );
+
+    // lets the receiver drain the socket now and then, like the event loop of a busy host
+    if( ( i % 256 ) == 255 ) {
+      QCoreApplication::processEvents();
+    }
+  }
+
+  sender.flush();
+
+  // until everything is accounted for, or nothing arrived for 100 ms
+  QElapsedTimer idle;
+  idle.start();
+  qint64 lastReceived = result.received;
+
+  while( result.received + result.dropped < sender.packetsSent && idle.elapsed() < 100 ) {
+    QCoreApplication::processEvents( QEventLoop::AllEvents, 10 );
+
+    if( result.received != lastReceived ) {
+      lastReceived = result.received;
+      idle.restart();
+    }
+  }
+
+  result.seconds = double( timer.nsecsElapsed() ) / 1e9;
+  result.sent = sender.packetsSent;
+
+  return result;
+}
+
+UdpSocket::UdpSocket() {
+  createWorker();
 }
 
 UdpSocket::~UdpSocket() {
-  if( udpSocket ) {
-    udpSocket->deleteLater();
+  // on the I/O thread, the worker has no parent
+  if( onIoThread && worker ) {
+    worker->deleteLater();
+  }
+}
+
+void UdpSocket::createWorker() {
+  if( worker ) {
+    StreamWorker::destroy( worker );
+  }
+
+  worker = new UdpSocketWorker( onIoThread ? nullptr : this );
+
+  if( onIoThread ) {
+    worker->moveToThread( StreamWorker::ioThread() );
+  }
+
+  connect( worker, &StreamWorker::chunkReceived, this, &UdpSocket::deliver );
+  connect( worker, &StreamWorker::droppedChanged, this, &UdpSocket::droppedChanged );
+  connect( worker, &StreamWorker::stallsChanged, this, &UdpSocket::stallsChanged );
+  connect( worker, &UdpSocketWorker::packetsReceivedChanged, this, &UdpSocket::packetsReceivedChanged );
+  connect( worker, &UdpSocketWorker::packetsSentChanged, this, &UdpSocket::packetsSentChanged );
+  connect( worker, &UdpSocketWorker::sendErrorsChanged, this, &UdpSocket::sendErrorsChanged );
+
+  if( !destination.isEmpty() ) {
+    setDestination( destination );
+  }
+
+  if( !multicastGroup.isEmpty() ) {
+    setMulticastGroup( multicastGroup );
+  }
+
+  if( port != 0 ) {
+    setPort( double( port ) );
   }
 }
 
 void UdpSocket::setPort( double port ) {
-  this->port = port;
-  udpSocket->bind( quint16( port ),  QUdpSocket::DontShareAddress );
+  this->port = float( port );
+
+  auto* worker = this->worker;
+  QMetaObject::invokeMethod( worker, [worker, port] {
+    worker->bind( quint16( port ) );
+  } );
 }
 
-void UdpSocket::sendData( const QByteArray& data ) {
-  udpSocket->writeDatagram( data, QHostAddress::Broadcast, port );
+void UdpSocket::setDestination( const QString& destination ) {
+  this->destination = destination;
+
+  auto* worker = this->worker;
+  QMetaObject::invokeMethod( worker, [worker, destination] {
+    worker->setDestination( destination );
+  } );
 }
 
-void UdpSocket::processPendingDatagrams() {
-  QByteArray datagram;
+void UdpSocket::setMulticastGroup( const QString& group ) {
+  this->multicastGroup = group;
 
-  while( udpSocket->hasPendingDatagrams() ) {
-    datagram.resize( int( udpSocket->pendingDatagramSize() ) );
-    udpSocket->readDatagram( datagram.data(), datagram.size() );
-    Q_EMIT dataReceived( datagram );
+  auto* worker = this->worker;
+  QMetaObject::invokeMethod( worker, [worker, group] {
+    worker->setMulticastGroup( group );
+  } );
+}
+
+void UdpSocket::setIoThread( double ioThread ) {
+  if( ( ioThread != 0 ) != onIoThread ) {
+    // the old worker closes the socket, the new one binds it again on its thread
+    onIoThread = ioThread != 0;
+    createWorker();
   }
 }
 
+void UdpSocket::sendData( const QByteArray& data ) {
+  auto* worker = this->worker;
+  QMetaObject::invokeMethod( worker, [worker, data] {
+    worker->send( data );
+  } );
+}
+
+void UdpSocket::deliver( const QByteArray& data, const qint64 receivedNs ) {
+  // the time of receipt is the one of the read, not of this delivery
+  MeasurementTimestamp timestamp;
+  timestamp.receivedNs = receivedNs;
+
+  MeasurementTimestamp::Scope timestampScope( timestamp );
+  Q_EMIT dataReceived( data );
+}
+
 QNEBlock* UdpSocketFactory::createBlock( QGraphicsScene* scene, int id ) {
   auto* obj = new UdpSocket();
   auto* b = createBaseBlock( scene, obj, id );
 
   b->addInputPort( QStringLiteral( "Port" ), QLatin1String( SLOT( setPort( double ) ) ) );
+  b->addInputPort( QStringLiteral( "Destination" ), QLatin1String( SLOT( setDestination( const QString& ) ) ) );
+  b->addInputPort( QStringLiteral( "Multicast Group" ), QLatin1String( SLOT( setMulticastGroup( const QString& ) ) ) );
+  b->addInputPort( QStringLiteral( "I/O Thread" ), QLatin1String( SLOT( setIoThread( double ) ) ) );
   b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( sendData( const QByteArray& ) ) ) );
 
   b->addOutputPort( QStringLiteral( "Data" ), QLatin1String( SIGNAL( dataReceived( const QByteArray& ) ) ) );
+  b->addOutputPort( QStringLiteral( "Dropped" ), QLatin1String( SIGNAL( droppedChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Stalls" ), QLatin1String( SIGNAL( stallsChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Packets Received" ), QLatin1String( SIGNAL( packetsReceivedChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Packets Sent" ), QLatin1String( SIGNAL( packetsSentChanged( const double ) ) ) );
+  b->addOutputPort( QStringLiteral( "Send Errors" ), QLatin1String( SIGNAL( sendErrorsChanged( const double ) ) ) );
 
   b->setBrush( inputOutputColor );
 
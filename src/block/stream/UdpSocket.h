@@ -15,39 +15,154 @@
 //
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see < https : //www.gnu.org/licenses/>.
-
 #pragma once
 
 #include <QObject>
+#include <QBasicTimer>
+#include <QHostAddress>
 
 #include "block/BlockBase.h"
 
+#include "StreamWorker.h"
+
+#include <vector>
+
 class QUdpSocket;
 
+// on Linux, the datagrams are received with recvmmsg() straight into the pooled buffers and sent with sendmmsg(), up to
+// MaxBatchSize per syscall; elsewhere, QUdpSocket reads and writes them one by one
+class UdpSocketWorker : public StreamWorker {
+    Q_OBJECT
+
+  public:
+    explicit UdpSocketWorker( QObject* parent = nullptr );
+
+    struct LoopbackResult {
+      qint64 sent = 0;
+      qint64 received = 0;
+      qint64 dropped = 0;
+      double seconds = 0;
+    };
+
+    // sends datagrams from one worker to another over 127.0.0.1:port on the current thread, which needs an event loop
+    static LoopbackResult loopbackTest( const quint16 port, const int datagrams, const int datagramSize );
+
+  Q_SIGNALS:
+    // at most once a second
+    void packetsReceivedChanged( const double );
+    void packetsSentChanged( const double );
+    void sendErrorsChanged( const double );
+
+  public Q_SLOTS:
+    void bind( const quint16 port );
+
+    // "" sends broadcasts to the bound port as before; else an unicast or multicast address with an optional port,
+    // like "192.168.1.10", "239.1.2.3:5000" or "[ff02::1]:5000"
+    void setDestination( const QString& destination );
+
+    // "" leaves the group; the socket is bound with a shared address, so other programs can join it too
+    void setMulticastGroup( const QString& group );
+
+    // queued and sent in batches at the end of the current iteration of the event loop
+    void send( const QByteArray& data ) override;
+
+  protected:
+    void timerEvent( QTimerEvent* event ) override;
+
+    bool hasPending() override;
+    bool readChunk( QByteArray& buffer ) override;
+    int readChunks( QByteArray** buffers, const int count ) override;
+    qint64 dropBacklog() override;
+
+  private Q_SLOTS:
+    void readDatagrams();
+
+  private:
+    void rebind();
+    void flush();
+    void addSendErrors( const qint64 count );
+    void reportStatistics();
+
+  private:
+    // the largest payload of UDP; the buffers of the pool only commit the memory actually used by the datagrams
+    static constexpr int MaxDatagramSize = 65536;
+
+    // the datagrams queued by the OS during a stall
+    static constexpr int ReceiveBufferSize = 1024 * 1024;
+
+    static constexpr int StatisticsIntervalMs = 1000;
+
+    QUdpSocket* udpSocket = nullptr;
+    quint16 port = 0;
+
+    // set by readyRead() until a datagram is read through QUdpSocket
+    bool qtReadPending = false;
+
+    QHostAddress destination;
+    quint16 destinationPort = 0;
+    QHostAddress multicastGroup;
+
+    std::vector<QByteArray> outgoing;
+    QBasicTimer flushTimer;
+    QBasicTimer statisticsTimer;
+
+    qint64 packetsReceived = 0;
+    qint64 packetsSent = 0;
+    qint64 sendErrors = 0;
+    qint64 reportedPacketsReceived = 0;
+    qint64 reportedPacketsSent = 0;
+    qint64 reportedSendErrors = 0;
+
+    // the counter of SO_RXQ_OVFL: the datagrams dropped by the kernel because the receive buffer was full
+    uint32_t kernelDrops = 0;
+};
+
+// the socket is read by a UdpSocketWorker, on the thread of the block or on the I/O thread
 class UdpSocket : public BlockBase {
     Q_OBJECT
 
   public:
     explicit UdpSocket();
 
+    ExecutionDomain executionDomain() const override {
+      return ExecutionDomain::Realtime;
+    }
+
     ~UdpSocket();
 
   Q_SIGNALS:
     void dataReceived( const QByteArray& );
 
+    void droppedChanged( const double );
+    void stallsChanged( const double );
+    void packetsReceivedChanged( const double );
+    void packetsSentChanged( const double );
+    void sendErrorsChanged( const double );
+
   public Q_SLOTS:
     void setPort( double port );
+    void setDestination( const QString& destination );
+    void setMulticastGroup( const QString& group );
+
+    // 0: read the socket on the thread of the block, else on the I/O thread
+    void setIoThread( double ioThread );
 
     void sendData( const QByteArray& data );
 
   protected Q_SLOTS:
-    void processPendingDatagrams();
+    void deliver( const QByteArray& data, const qint64 receivedNs );
 
   public:
     float port = 0;
+    QString destination;
+    QString multicastGroup;
 
   private:
-    QUdpSocket* udpSocket = nullptr;
+    void createWorker();
+
+  private:
+    UdpSocketWorker* worker = nullptr;
+    bool onIoThread = false;
 };
 
 class UdpSocketFactory : public BlockFactory {
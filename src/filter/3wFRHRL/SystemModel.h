@@ -112,50 +112,7 @@ namespace ThreeWheeledFRHRL {
           // model isn't compatible with negative velocities (driving backwards), so use the straight kinematic model
           {
 
-            // matrix for the first term (formula 2.58 + 5.9)
-            const _T Ftrac = Cx * slipX;
-            Eigen::Matrix<double, 5, 5> firstTerm;
-            firstTerm <<
-                      -Car / ( m * V ), ( b * Car ) / ( m * V ) - V, -( Ftrac + Caf ) / m, -Car / m, -Cah / m,
-                      ( b * Car ) / ( Iz * V ), -( b * b * Car ) / ( Iz * V ), ( -( Ftrac * a + Caf * a ) ) / Iz, ( b * Car ) / Iz, ( ( b + c )*Cah ) / Iz,
-                      1 / sigmaF, a / sigmaF, -V / sigmaF, 0, 0,
-                      1 / sigmaR, -b / sigmaR, 0, -V / sigmaR, 0,
-                      1 / sigmaH, -( b + c ) / sigmaH, 0, 0, -V / sigmaH;
-
-            if( enableDebug ) {
-              std::cout << "firstTerm" << std::endl << firstTerm << std::endl;
-            }
-
-            Eigen::Matrix<double, 5, 1> secondTerm;
-            secondTerm <<
-                       -xBuffer( StateNames::Vy ),
-                       -xBuffer( StateNames::Vyaw ),
-                       -xBuffer( StateNames::AlphaFront ),
-                       -xBuffer( StateNames::AlphaRear ),
-                       -xBuffer( StateNames::AlphaHitch );
-
-            if( enableDebug ) {
-              std::cout << "secondTerm" << std::endl << secondTerm << std::endl;
-            }
-
-
-            Eigen::Matrix<double, 5, 1> thirdTerm;
-            thirdTerm <<
-                      0,
-                      0,
-                      -V / sigmaF,
-                      0,
-                      0;
-
-            if( enableDebug ) {
-              std::cout << "thirdTerm" << std::endl << thirdTerm << std::endl;
-            }
-
-            if( enableDebug ) {
-              std::cout << "deltaF" << std::endl << deltaF << std::endl;
-            }
-
-            auto result = ( firstTerm * secondTerm ) + ( thirdTerm * -deltaF );
+            auto result = dynamicTerm( xBuffer, V, deltaF, a, b, c, Caf, Car, Cah, m, Iz, sigmaF, sigmaR, sigmaH, Cx, slipX );
 
             // Trapezoidal rule:
             // https://en.wikipedia.org/wiki/Trapezoidal_rule
@@ -215,6 +172,48 @@ namespace ThreeWheeledFRHRL {
         prediction( StateNames::AlphaHitch ) = normalizeAngleRadians( prediction( StateNames::AlphaHitch ) );
       }
 
+      // the velocities, that predict() sets directly instead of integrating them;
+      // used with derivative() by fixed-step integrators before every evaluation
+      template<typename T, typename _T>
+      void applyInputs( StateType<T>& x, const _T V, const _T deltaF, const _T a, const _T b ) {
+        if( !( V > 0.1 ) ) {
+          x( StateNames::Vyaw ) = ( V < 0.1 ) ? ( std::tan( deltaF ) * V / ( a + b ) ) : 0;
+          x( StateNames::Vy ) = 0;
+          x( StateNames::AlphaFront ) = 0;
+          x( StateNames::AlphaRear ) = 0;
+          x( StateNames::AlphaHitch ) = 0;
+        }
+
+        x( StateNames::Vx ) = V;
+      }
+
+      // the continuous form of predict(): dx/dt
+      template<typename T, typename _T>
+      void derivative( const StateType<T>& x,
+                       const _T V, const _T deltaF,
+                       const _T a, const _T b, const _T c,
+                       const _T Caf, const _T Car, const _T Cah,
+                       const _T m, const _T Iz,
+                       const _T sigmaF, const _T sigmaR, const _T sigmaH,
+                       const _T Cx, const _T slipX,
+                       StateType<T>& dxdt ) {
+        // the transfer matrix for one second without the identity and the terms of second order is the jacobian of the kinematics
+        Eigen::Matrix<T, StateNames::End, StateNames::End> kinematics = prepareTransferMatrix( x, _T( 1 ) );
+        kinematics -= Eigen::Matrix<T, StateNames::End, StateNames::End>::Identity();
+        kinematics.template block<3, 3>( StateNames::X, StateNames::Ax ).setZero();
+
+        dxdt = kinematics * x;
+
+        if( V > 0.1 ) {
+          auto result = dynamicTerm( x, V, deltaF, a, b, c, Caf, Car, Cah, m, Iz, sigmaF, sigmaR, sigmaH, Cx, slipX );
+          dxdt( StateNames::Vy ) = -result( 0 );
+          dxdt( StateNames::Vyaw ) = -result( 1 );
+          dxdt( StateNames::AlphaFront ) = -result( 2 );
+          dxdt( StateNames::AlphaRear ) = -result( 3 );
+          dxdt( StateNames::AlphaHitch ) = -result( 4 );
+        }
+      }
+
       template<typename T, typename _T>
       void predict( const StateType<T>& x,
                     const _T deltaT,
@@ -240,6 +239,63 @@ namespace ThreeWheeledFRHRL {
       Eigen::Matrix<double, 5, 1> oldResult;
 
     private:
+      // the right side of formula 2.58 + 5.9: the derivatives of Vy, Vyaw, AlphaFront, AlphaRear and AlphaHitch (negated)
+      template<typename T, typename _T>
+      Eigen::Matrix<double, 5, 1> dynamicTerm( const StateType<T>& xBuffer,
+          const _T V, const _T deltaF,
+          const _T a, const _T b, const _T c,
+          const _T Caf, const _T Car, const _T Cah,
+          const _T m, const _T Iz,
+          const _T sigmaF, const _T sigmaR, const _T sigmaH,
+          const _T Cx, const _T slipX ) {
+        constexpr bool enableDebug = false;
+
+        // matrix for the first term (formula 2.58 + 5.9)
+        const _T Ftrac = Cx * slipX;
+        Eigen::Matrix<double, 5, 5> firstTerm;
+        firstTerm <<
+                  -Car / ( m * V ), ( b * Car ) / ( m * V ) - V, -( Ftrac + Caf ) / m, -Car / m, -Cah / m,
+                  ( b * Car ) / ( Iz * V ), -( b * b * Car ) / ( Iz * V ), ( -( Ftrac * a + Caf * a ) ) / Iz, ( b * Car ) / Iz, ( ( b + c )*Cah ) / Iz,
+                  1 / sigmaF, a / sigmaF, -V / sigmaF, 0, 0,
+                  1 / sigmaR, -b / sigmaR, 0, -V / sigmaR, 0,
+                  1 / sigmaH, -( b + c ) / sigmaH, 0, 0, -V / sigmaH;
+
+        if( enableDebug ) {
+          std::cout << "firstTerm" << std::endl << firstTerm << std::endl;
+        }
+
+        Eigen::Matrix<double, 5, 1> secondTerm;
+        secondTerm <<
+                   -xBuffer( StateNames::Vy ),
+                   -xBuffer( StateNames::Vyaw ),
+                   -xBuffer( StateNames::AlphaFront ),
+                   -xBuffer( StateNames::AlphaRear ),
+                   -xBuffer( StateNames::AlphaHitch );
+
+        if( enableDebug ) {
+          std::cout << "secondTerm" << std::endl << secondTerm << std::endl;
+        }
+
+
+        Eigen::Matrix<double, 5, 1> thirdTerm;
+        thirdTerm <<
+                  0,
+                  0,
+                  -V / sigmaF,
+                  0,
+                  0;
+
+        if( enableDebug ) {
+          std::cout << "thirdTerm" << std::endl << thirdTerm << std::endl;
+        }
+
+        if( enableDebug ) {
+          std::cout << "deltaF" << std::endl << deltaF << std::endl;
+        }
+
+        return ( firstTerm * secondTerm ) + ( thirdTerm * -deltaF );
+      }
+
       template<typename T, typename _T>
       Eigen::Matrix<T, StateNames::End, StateNames::End> prepareTransferMatrix( const StateType<T>& x, const _T deltaT ) {
         Eigen::Matrix<T, StateNames::End, StateNames::End> transferFunction_;
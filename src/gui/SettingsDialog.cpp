@@ -26,6 +26,7 @@
 
 
 #include <QDebug>
+#include <QElapsedTimer>
 
 #include "qneblock.h"
 #include "qneconnection.h"
@@ -81,9 +82,7 @@
 #include "block/guidance/PoseSynchroniser.h"
 
 #include "block/calculation/TransverseMercatorConverter.h"
-#include "block/parser/NmeaParserGGA.h"
-#include "block/parser/NmeaParserHDT.h"
-#include "block/parser/NmeaParserRMC.h"
+#include "block/parser/NmeaParser.h"
 #include "block/parser/UbxParser.h"
 
 #include "block/dock/input/ActionDockBlock.h"
@@ -102,6 +101,8 @@
 #include "block/converter/CommunicationJrk.h"
 #include "block/converter/CommunicationPgn7FFE.h"
 #include "block/stream/FileStream.h"
+#include "block/stream/CaptureReplay.h"
+#include "block/stream/CaptureRecorder.h"
 #include "block/stream/UdpSocket.h"
 
 #ifdef SERIALPORT_ENABLED
@@ -120,6 +121,11 @@
 #include "block/kinematic/TrailerKinematic.h"
 #include "block/kinematic/TrailerKinematicPrimitive.h"
 
+#include "block/DataflowScheduler.h"
+#include "block/ExecutionDomains.h"
+#include "block/BlockProfiler.h"
+#include "block/DeliveryPolicies.h"
+
 #include "model/VectorBlockModel.h"
 #include "model/OrientationBlockModel.h"
 #include "model/NumberBlockModel.h"
@@ -159,6 +165,9 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity,
 
   ui->setupUi( this );
 
+  dataflowScheduler = new DataflowScheduler( this );
+  executionDomains = new ExecutionDomains( this );
+
   // load states of checkboxes from global config
   {
     blockSettingsSaving = true;
@@ -174,8 +183,13 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity,
       ui->cbRunSimulatorOnStart->setCheckState( settings.value( QStringLiteral( "RunSimulatorOnStart" ), false ).toBool() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked );
       ui->cbRestoreDockPositions->setCheckState( settings.value( QStringLiteral( "RestoreDockPositionsOnStart" ), false ).toBool() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked );
       ui->cbSaveDockPositionsOnExit->setCheckState( settings.value( QStringLiteral( "SaveDockPositionsOnExit" ), false ).toBool() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked );
+      ui->cbCompiledDataflow->setCheckState( settings.value( QStringLiteral( "CompiledDataflow" ), false ).toBool() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked );
+      ui->cbRealtimeThread->setCheckState( settings.value( QStringLiteral( "RealtimeThread" ), false ).toBool() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked );
     }
 
+    // the domains of the blocks can only be set up before they run, so changing it takes effect on the next start
+    executionDomains->setRealtimeEnabled( ui->cbRealtimeThread->isChecked() );
+
     // grid
     {
       ui->gbGrid->setChecked( settings.value( QStringLiteral( "Grid/Enabled" ), true ).toBool() );
@@ -238,11 +252,15 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity,
   auto* scene = new QGraphicsScene();
   ui->gvNodeEditor->setScene( scene );
 
+  blockProfiler = new BlockProfiler( scene, this );
+  deliveryPolicies = new DeliveryPolicies( this );
+
   ui->gvNodeEditor->setRenderHint( QPainter::Antialiasing, true );
 
   auto* nodesEditor = new QNodesEditor( this );
   nodesEditor->install( scene );
   QObject::connect( nodesEditor, &QNodesEditor::resetModels, this, &SettingsDialog::resetAllModels );
+  QObject::connect( nodesEditor, &QNodesEditor::deliveryPolicyChanged, this, &SettingsDialog::connectionDeliveryPolicyChanged );
 
   // new/open/save toolbar
   newOpenSaveToolbar = new NewOpenSaveToolbar( this );
@@ -401,7 +419,7 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity,
       rootEntity,
       static_cast<Qt3DRender::QFrameGraphNode*>( qt3dWindow->activeFrameGraph()->children().front() ) );
 
-  pathPlannerModelFactory = new PathPlannerModelFactory( rootEntity );
+  pathPlannerModelFactory = new PathPlannerModelFactory( rootEntity, qt3dWindow->camera() );
 
   // Factories for the blocks
   transverseMercatorConverterFactory = new TransverseMercatorConverterFactory( geographicConvertionWrapperGuidance );
@@ -410,7 +428,7 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity,
   trailerModelFactory = new TrailerModelFactory( rootEntity, usePBR );
   tractorModelFactory = new TractorModelFactory( rootEntity, usePBR );
   sprayerModelFactory = new SprayerModelFactory( rootEntity, usePBR );
-  cultivatedAreaModelFactory = new CultivatedAreaModelFactory( rootEntity, usePBR );
+  cultivatedAreaModelFactory = new CultivatedAreaModelFactory( mainWindow, newOpenSaveToolbar->saveMenu, rootEntity, qt3dWindow->camera(), usePBR, geographicConvertionWrapperGuidance );
   fixedKinematicFactory = new FixedKinematicFactory;
   trailerKinematicFactory = new TrailerKinematicFactory();
   fixedKinematicPrimitiveFactory = new FixedKinematicPrimitiveFactory;
@@ -439,9 +457,12 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity,
 #endif
 
   fileStreamFactory = new FileStreamFactory();
+  captureReplayFactory = new CaptureReplayFactory();
+  captureRecorderFactory = new CaptureRecorderFactory();
   communicationPgn7ffeFactory = new CommunicationPgn7ffeFactory();
   communicationJrkFactory = new CommunicationJrkFactory();
   ubxParserFactory = new UbxParserFactory();
+  nmeaParserFactory = new NmeaParserFactory();
   nmeaParserGGAFactory = new NmeaParserGGAFactory();
   nmeaParserHDTFactory = new NmeaParserHDTFactory();
   nmeaParserRMCFactory = new NmeaParserRMCFactory();
@@ -476,6 +497,7 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity,
   sectionControlFactory->addToTreeWidget( ui->twBlocks );
   pathPlannerModelFactory->addToTreeWidget( ui->twBlocks );
   ubxParserFactory->addToTreeWidget( ui->twBlocks );
+  nmeaParserFactory->addToTreeWidget( ui->twBlocks );
   nmeaParserGGAFactory->addToTreeWidget( ui->twBlocks );
   nmeaParserHDTFactory->addToTreeWidget( ui->twBlocks );
   nmeaParserRMCFactory->addToTreeWidget( ui->twBlocks );
@@ -505,6 +527,8 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity,
 #endif
 
   fileStreamFactory->addToTreeWidget( ui->twBlocks );
+  captureReplayFactory->addToTreeWidget( ui->twBlocks );
+  captureRecorderFactory->addToTreeWidget( ui->twBlocks );
   communicationPgn7ffeFactory->addToTreeWidget( ui->twBlocks );
   communicationJrkFactory->addToTreeWidget( ui->twBlocks );
 
@@ -641,8 +665,11 @@ SettingsDialog::~SettingsDialog() {
 #endif
 
   fileStreamFactory->deleteLater();
+  captureReplayFactory->deleteLater();
+  captureRecorderFactory->deleteLater();
   communicationPgn7ffeFactory->deleteLater();
   communicationJrkFactory->deleteLater();
+  nmeaParserFactory->deleteLater();
   nmeaParserGGAFactory->deleteLater();
   nmeaParserHDTFactory->deleteLater();
   nmeaParserRMCFactory->deleteLater();
@@ -839,19 +866,7 @@ void SettingsDialog::saveConfigToFile( QFile& file ) {
 }
 
 QNEBlock* SettingsDialog::getBlockWithId( int id ) {
-  const auto& constRefOfList = ui->gvNodeEditor->scene()->items();
-
-  for( const auto& item : constRefOfList ) {
-    auto* block = qgraphicsitem_cast<QNEBlock*>( item );
-
-    if( block != nullptr ) {
-      if( block->id == id ) {
-        return block;
-      }
-    }
-  }
-
-  return nullptr;
+  return QNEBlock::blockWithId( ui->gvNodeEditor->scene(), id );
 }
 
 QNEBlock* SettingsDialog::getBlockWithName( const QString& name ) {
@@ -937,15 +952,29 @@ void SettingsDialog::on_pbLoad_clicked() {
 }
 
 void SettingsDialog::loadConfigFromFile( QFile& file ) {
+  QElapsedTimer loadTimer;
+  loadTimer.start();
+
   QByteArray saveData = file.readAll();
 
   QJsonDocument loadDoc( QJsonDocument::fromJson( saveData ) );
   QJsonObject json = loadDoc.object();
 
+  const qint64 parseNs = loadTimer.nsecsElapsed();
+  int numBlocks = 0;
+  int numConnections = 0;
+
+  // the graph changes, so the blocks run with direct connections until the new one is compiled
+  dataflowScheduler->clear();
+  blockProfiler->unrouteConnections();
+
   // as the new object get new id, here is a QMap to hold the conversions
   // first int: id in file, second int: id in the graphicsview
   QMap<int, int> idMap;
 
+  // all models are reset once at the end, instead of once per created block
+  BlockFactory::deferModelResets = true;
+
   if( json.contains( QStringLiteral( "blocks" ) ) && json[QStringLiteral( "blocks" )].isArray() ) {
     QJsonArray blocksArray = json[QStringLiteral( "blocks" )].toArray();
 
@@ -969,23 +998,7 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
 
           // id is not a system-id -> create new blocks
         } else {
-          BlockFactory* factory = nullptr;
-
-          {
-            auto* rootItem = ui->twBlocks->invisibleRootItem();
-
-            for( int i = 0, end = rootItem->childCount(); i < end; i++ ) {
-              auto* item = rootItem->child( i );
-
-              for( int j = 0, end = item->childCount(); j < end; j++ ) {
-                auto* childItem = item->child( j );
-
-                if( childItem->text( 1 ) == blockObject[QStringLiteral( "type" )].toString() ) {
-                  factory = qobject_cast<BlockFactory*>( qvariant_cast<QObject*>( childItem->data( 0, Qt::UserRole ) ) );
-                }
-              }
-            }
-          }
+          BlockFactory* factory = BlockFactory::factoryForType( blockObject[QStringLiteral( "type" )].toString() );
 
           if( factory != nullptr ) {
             QNEBlock* block = factory->createBlock( ui->gvNodeEditor->scene(), id );
@@ -997,12 +1010,18 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
             block->setName( blockObject[QStringLiteral( "name" )].toString( factory->getNameOfFactory() ) );
             block->fromJSON( blockObject );
             block->setSelected( true );
+
+            ++numBlocks;
           }
         }
       }
     }
   }
 
+  BlockFactory::deferModelResets = false;
+
+  const qint64 blocksNs = loadTimer.nsecsElapsed();
+
 
   if( json.contains( QStringLiteral( "connections" ) ) && json[QStringLiteral( "connections" )].isArray() ) {
     QJsonArray connectionsArray = json[QStringLiteral( "connections" )].toArray();
@@ -1037,7 +1056,10 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
                 blockFrom->scene()->addItem( conn );
                 conn->updatePosFromPorts();
                 conn->updatePath();
+                conn->deliveryPolicyFromJSON( connectionsObject );
                 conn->setSelected( true );
+
+                ++numConnections;
               } else {
                 delete conn;
               }
@@ -1048,6 +1070,26 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
     }
   }
 
+  const qint64 connectionsNs = loadTimer.nsecsElapsed();
+
+  // move the sensor/control blocks to their thread, then route the connections with a delivery policy and decouple the
+  // remaining ones to the GUI
+  executionDomains->assignAll( ui->gvNodeEditor->scene() );
+  deliveryPolicies->routeConnections( ui->gvNodeEditor->scene() );
+  executionDomains->routeConnections( ui->gvNodeEditor->scene() );
+
+  // sort the loaded graph and route its connections through the scheduler
+  if( ui->cbCompiledDataflow->isChecked() ) {
+    dataflowScheduler->compile( json, [this, &idMap]( int id ) {
+      return getBlockWithId( idMap.value( id, 0 ) );
+    } );
+  }
+
+  // time the remaining direct connections, if the profiler is running
+  blockProfiler->routeConnections();
+
+  const qint64 routingNs = loadTimer.nsecsElapsed();
+
   // as new values for the blocks are added above, emit all signals now, when the connections are made
   const auto& constRefOfList = ui->gvNodeEditor->scene()->items();
 
@@ -1060,6 +1102,16 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
   }
 
   resetAllModels();
+
+  const qint64 totalNs = loadTimer.nsecsElapsed();
+
+  qDebug().nospace() << "loaded " << file.fileName() << ": "
+                     << numBlocks << " blocks, " << numConnections << " connections in " << totalNs / 1e6 << " ms "
+                     << "(parse " << parseNs / 1e6
+                     << " ms, blocks " << ( blocksNs - parseNs ) / 1e6
+                     << " ms, connections " << ( connectionsNs - blocksNs ) / 1e6
+                     << " ms, routing " << ( routingNs - connectionsNs ) / 1e6
+                     << " ms, signals and models " << ( totalNs - routingNs ) / 1e6 << " ms)";
 }
 
 void SettingsDialog::on_pbAddBlock_clicked() {
@@ -1071,6 +1123,7 @@ void SettingsDialog::on_pbAddBlock_clicked() {
     if( factory != nullptr ) {
       QNEBlock* block = factory->createBlock( ui->gvNodeEditor->scene() );
       block->setPos( ui->gvNodeEditor->mapToScene( ui->gvNodeEditor->viewport()->rect().center() ) );
+      executionDomains->assign( block );
     }
 
     resetAllModels();
@@ -1254,6 +1307,27 @@ void SettingsDialog::on_cbRunSimulatorOnStart_stateChanged( int arg1 ) {
   settings.sync();
 }
 
+void SettingsDialog::on_cbCompiledDataflow_stateChanged( int arg1 ) {
+  QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
+                      QSettings::IniFormat );
+
+  settings.setValue( QStringLiteral( "CompiledDataflow" ), bool( arg1 == Qt::CheckState::Checked ) );
+  settings.sync();
+
+  // takes effect on the next load of a config
+  if( arg1 != Qt::CheckState::Checked ) {
+    dataflowScheduler->clear();
+  }
+}
+
+void SettingsDialog::on_cbRealtimeThread_stateChanged( int arg1 ) {
+  QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
+                      QSettings::IniFormat );
+
+  settings.setValue( QStringLiteral( "RealtimeThread" ), bool( arg1 == Qt::CheckState::Checked ) );
+  settings.sync();
+}
+
 void SettingsDialog::on_pbDeleteSettings_clicked() {
   QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
                       QSettings::IniFormat );
@@ -1350,6 +1424,24 @@ void SettingsDialog::on_cbImplements_currentIndexChanged( int index ) {
   ui->twSections->resizeColumnsToContents();
 }
 
+void SettingsDialog::connectionDeliveryPolicyChanged( QNEConnection* connection ) {
+  // the routing of the graph changes: the schedule is dropped like on any other edit of the graph
+  dataflowScheduler->clear();
+  blockProfiler->unrouteConnections();
+
+  if( connection->scheduler() == deliveryPolicies ) {
+    deliveryPolicies->connectionRemoved( connection );
+  } else if( connection->scheduler() == executionDomains ) {
+    executionDomains->connectionRemoved( connection );
+  }
+
+  connection->setScheduler( nullptr );
+
+  deliveryPolicies->routeConnections( ui->gvNodeEditor->scene() );
+  executionDomains->routeConnections( ui->gvNodeEditor->scene() );
+  blockProfiler->routeConnections();
+}
+
 void SettingsDialog::implementModelReset() {
   if( ui->cbImplements->currentIndex() == -1 || ui->cbImplements->currentIndex() >= ui->cbImplements->model()->rowCount() ) {
     ui->cbImplements->setCurrentIndex( 0 );
@@ -2001,6 +2093,7 @@ void SettingsDialog::on_twBlocks_itemDoubleClicked( QTreeWidgetItem* item, int )
   if( factory != nullptr ) {
     QNEBlock* block = factory->createBlock( ui->gvNodeEditor->scene() );
     block->setPos( ui->gvNodeEditor->mapToScene( ui->gvNodeEditor->viewport()->rect().center() ) );
+    executionDomains->assign( block );
   }
 
   resetAllModels();
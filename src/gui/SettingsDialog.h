@@ -46,6 +46,11 @@ class QMainWindow;
 class MyMainWindow;
 
 class QNEBlock;
+class DataflowScheduler;
+class ExecutionDomains;
+class BlockProfiler;
+class DeliveryPolicies;
+class QNEConnection;
 
 #include "block/BlockBase.h"
 
@@ -112,6 +117,8 @@ class SettingsDialog : public QDialog {
 
     void resetAllModels();
 
+    void connectionDeliveryPolicyChanged( QNEConnection* connection );
+
     void setSimulatorValues( const double a, const double b, const double c,
                              const double Caf, const double Car, const double Cah,
                              const double m, const double Iz,
@@ -145,6 +152,8 @@ class SettingsDialog : public QDialog {
     void on_cbLoadConfigOnStart_stateChanged( int arg1 );
     void on_cbOpenSettingsDialogOnStart_stateChanged( int arg1 );
     void on_cbRunSimulatorOnStart_stateChanged( int arg1 );
+    void on_cbCompiledDataflow_stateChanged( int arg1 );
+    void on_cbRealtimeThread_stateChanged( int arg1 );
 
     void on_pbSaveAsDefault_clicked();
     void on_pbLoadSavedConfig_clicked();
@@ -287,6 +296,9 @@ class SettingsDialog : public QDialog {
     BlockBase* xteGuidance = nullptr;
     BlockBase* globalPlannerModel = nullptr;
 
+    BlockProfiler* blockProfiler = nullptr;
+    DeliveryPolicies* deliveryPolicies = nullptr;
+
   private:
     Ui::SettingsDialog* ui = nullptr;
 
@@ -295,6 +307,9 @@ class SettingsDialog : public QDialog {
 
     BlockFactory* poseSimulationFactory = nullptr;
 
+    DataflowScheduler* dataflowScheduler = nullptr;
+    ExecutionDomains* executionDomains = nullptr;
+
 #ifdef SPNAV_ENABLED
     SpaceNavigatorPollingThread* spaceNavigatorPollingThread = nullptr;
 #endif
@@ -318,9 +333,12 @@ class SettingsDialog : public QDialog {
 #endif
 
     BlockFactory* fileStreamFactory = nullptr;
+    BlockFactory* captureReplayFactory = nullptr;
+    BlockFactory* captureRecorderFactory = nullptr;
     BlockFactory* ackermannSteeringFactory = nullptr;
     BlockFactory* angularVelocityLimiterFactory = nullptr;
     BlockFactory* ubxParserFactory = nullptr;
+    BlockFactory* nmeaParserFactory = nullptr;
     BlockFactory* nmeaParserGGAFactory = nullptr;
     BlockFactory* nmeaParserHDTFactory = nullptr;
     BlockFactory* nmeaParserRMCFactory = nullptr;
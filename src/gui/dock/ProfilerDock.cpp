@@ -0,0 +1,155 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "ProfilerDock.h"
+#include "ui_ProfilerDock.h"
+
+#include "block/BlockProfiler.h"
+
+#include <QTimer>
+#include <QFile>
+#include <QFileDialog>
+#include <QStandardPaths>
+#include <QHeaderView>
+
+#include <algorithm>
+
+ProfilerDock::ProfilerDock( BlockProfiler* profiler, QWidget* parent ) :
+  QGroupBox( parent ),
+  ui( new Ui::ProfilerDock ),
+  profiler( profiler ) {
+  ui->setupUi( this );
+
+  setContentsMargins( 0, 0, 0, 0 );
+
+  ui->twBlocks->setColumnCount( 10 );
+  ui->twBlocks->setHorizontalHeaderLabels( { QStringLiteral( "Block" ),
+                                             QStringLiteral( "Calls/s" ),
+                                             QStringLiteral( "Excl. mean [µs]" ),
+                                             QStringLiteral( "Excl. p99 [µs]" ),
+                                             QStringLiteral( "Incl. mean [µs]" ),
+                                             QStringLiteral( "Incl. max [µs]" ),
+                                             QStringLiteral( "Excl. total [%]" ),
+                                             QStringLiteral( "Emits/s" ),
+                                             QStringLiteral( "Fan-out" ),
+                                             QStringLiteral( "Latency p99 [ms]" ) } );
+  ui->twBlocks->horizontalHeader()->setSectionResizeMode( QHeaderView::ResizeToContents );
+  ui->twBlocks->horizontalHeader()->setStretchLastSection( true );
+
+  ui->cbEnabled->setChecked( profiler->enabled() );
+  connect( profiler, &BlockProfiler::enabledChanged, ui->cbEnabled, &QCheckBox::setChecked );
+
+  refreshTimer = new QTimer( this );
+  refreshTimer->setInterval( 1000 );
+  connect( refreshTimer, &QTimer::timeout, this, &ProfilerDock::refresh );
+}
+
+ProfilerDock::~ProfilerDock() {
+  delete ui;
+}
+
+void ProfilerDock::showEvent( QShowEvent* event ) {
+  refresh();
+  refreshTimer->start();
+  QGroupBox::showEvent( event );
+}
+
+void ProfilerDock::hideEvent( QHideEvent* event ) {
+  refreshTimer->stop();
+  QGroupBox::hideEvent( event );
+}
+
+void ProfilerDock::refresh() {
+  const auto blocks = profiler->snapshot();
+  const auto seconds = double( profiler->elapsedNs() ) * 1e-9;
+
+  uint64_t totalExclusiveNs = 0;
+
+  for( const auto& block : blocks ) {
+    totalExclusiveNs += block.exclusiveNs;
+  }
+
+  ui->twBlocks->setUpdatesEnabled( false );
+  ui->twBlocks->setRowCount( int( blocks.size() ) );
+
+  auto setCell = [this]( const int row, const int column, const QString & text ) {
+    auto* item = ui->twBlocks->item( row, column );
+
+    if( item == nullptr ) {
+      item = new QTableWidgetItem();
+
+      if( column > 0 ) {
+        item->setTextAlignment( Qt::AlignRight | Qt::AlignVCenter );
+      }
+
+      ui->twBlocks->setItem( row, column, item );
+    }
+
+    item->setText( text );
+  };
+
+  for( std::size_t i = 0; i < blocks.size(); ++i ) {
+    const auto& block = blocks[i];
+    const int row = int( i );
+    const double calls = double( std::max( block.calls, uint64_t( 1 ) ) );
+
+    setCell( row, 0, block.name );
+    setCell( row, 1, QString::number( seconds > 0 ? double( block.calls ) / seconds : 0., 'f', 1 ) );
+    setCell( row, 2, QString::number( double( block.exclusiveNs ) / calls * 1e-3, 'f', 2 ) );
+    setCell( row, 3, QString::number( double( BlockProfiler::BlockStatistics::quantileNs( block.exclusiveHistogram, 0.99 ) ) * 1e-3, 'f', 2 ) );
+    setCell( row, 4, QString::number( double( block.inclusiveNs ) / calls * 1e-3, 'f', 2 ) );
+    setCell( row, 5, QString::number( double( block.maxInclusiveNs ) * 1e-3, 'f', 2 ) );
+    setCell( row, 6, QString::number( totalExclusiveNs > 0 ? double( block.exclusiveNs ) * 100. / double( totalExclusiveNs ) : 0., 'f', 1 ) );
+    setCell( row, 7, QString::number( seconds > 0 ? double( block.emits ) / seconds : 0., 'f', 1 ) );
+    setCell( row, 8, QString::number( block.emits > 0 ? double( block.deliveries ) / double( block.emits ) : 0., 'f', 1 ) );
+    setCell( row, 9, block.latencySamples > 0 ?
+             QString::number( double( BlockProfiler::BlockStatistics::quantileNs( block.latencyHistogram, 0.99 ) ) * 1e-6, 'f', 2 ) :
+             QStringLiteral( "-" ) );
+  }
+
+  ui->twBlocks->setUpdatesEnabled( true );
+
+  ui->lbSummary->setText( QStringLiteral( "%1 s, %2 % of the time in blocks" )
+                          .arg( seconds, 0, 'f', 0 )
+                          .arg( seconds > 0 ? double( totalExclusiveNs ) * 1e-7 / seconds : 0., 0, 'f', 1 ) );
+}
+
+void ProfilerDock::on_cbEnabled_stateChanged( int arg1 ) {
+  profiler->setEnabled( arg1 == Qt::CheckState::Checked );
+}
+
+void ProfilerDock::on_pbReset_clicked() {
+  profiler->reset();
+  refresh();
+}
+
+void ProfilerDock::on_pbExport_clicked() {
+  QString selectedFilter = QStringLiteral( "CSV Files (*.csv)" );
+  QString fileName = QFileDialog::getSaveFileName( this,
+                     tr( "Export Profile" ),
+                     QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/profile.csv",
+                     tr( "All Files (*);;CSV Files (*.csv)" ),
+                     &selectedFilter );
+
+  if( !fileName.isEmpty() ) {
+    QFile file( fileName );
+
+    if( file.open( QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate ) ) {
+      profiler->exportCsv( file );
+    }
+  }
+}
@@ -0,0 +1,53 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QGroupBox>
+
+class QTimer;
+class BlockProfiler;
+
+namespace Ui {
+  class ProfilerDock;
+}
+
+// shows the statistics of BlockProfiler, refreshed every second while visible
+class ProfilerDock : public QGroupBox {
+    Q_OBJECT
+
+  public:
+    explicit ProfilerDock( BlockProfiler* profiler, QWidget* parent = nullptr );
+    ~ProfilerDock();
+
+  protected:
+    void showEvent( QShowEvent* event ) override;
+    void hideEvent( QHideEvent* event ) override;
+
+  private Q_SLOTS:
+    void refresh();
+
+    void on_cbEnabled_stateChanged( int arg1 );
+    void on_pbReset_clicked();
+    void on_pbExport_clicked();
+
+  private:
+    Ui::ProfilerDock* ui = nullptr;
+
+    BlockProfiler* profiler = nullptr;
+    QTimer* refreshTimer = nullptr;
+};
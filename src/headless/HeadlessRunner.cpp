@@ -0,0 +1,421 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "HeadlessRunner.h"
+#include "HeadlessStubBlock.h"
+
+#include "qneblock.h"
+#include "qneport.h"
+#include "qneconnection.h"
+
+#include "block/BlockBase.h"
+#include "block/BlockProfiler.h"
+#include "block/DataflowScheduler.h"
+#include "block/DeliveryPolicies.h"
+#include "block/ExecutionDomains.h"
+
+#include "block/literal/NumberObject.h"
+#include "block/literal/OrientationBlock.h"
+#include "block/literal/StringObject.h"
+#include "block/literal/VectorObject.h"
+
+#include "block/arithmetic/ArithmeticAddition.h"
+#include "block/arithmetic/ArithmeticDivision.h"
+#include "block/arithmetic/ArithmeticMultiplication.h"
+#include "block/arithmetic/ArithmeticSubtraction.h"
+
+#include "block/comparison/ComparisonEqualTo.h"
+#include "block/comparison/ComparisonGreaterOrEqualTo.h"
+#include "block/comparison/ComparisonGreaterThan.h"
+#include "block/comparison/ComparisonLessOrEqualTo.h"
+#include "block/comparison/ComparisonLessThan.h"
+#include "block/comparison/ComparisonNotEqualTo.h"
+
+#include "block/calculation/AckermannSteering.h"
+#include "block/calculation/AngularVelocityLimiter.h"
+#include "block/calculation/TransverseMercatorConverter.h"
+
+#include "block/ExtendedKalmanFilter.h"
+
+#include "block/global/GlobalPlanner.h"
+
+#include "block/guidance/LocalPlanner.h"
+#include "block/guidance/PoseSynchroniser.h"
+#include "block/guidance/StanleyGuidance.h"
+#include "block/guidance/XteGuidance.h"
+
+#include "block/kinematic/FixedKinematic.h"
+#include "block/kinematic/FixedKinematicPrimitive.h"
+#include "block/kinematic/TrailerKinematic.h"
+#include "block/kinematic/TrailerKinematicPrimitive.h"
+
+#include "block/parser/NmeaParser.h"
+#include "block/parser/UbxParser.h"
+
+#include "block/sectionControl/Implement.h"
+
+#include "block/base/DebugSink.h"
+
+#include "block/converter/CommunicationJrk.h"
+#include "block/converter/CommunicationPgn7FFE.h"
+#include "block/converter/ValueTransmissionBase64Data.h"
+#include "block/converter/ValueTransmissionNumber.h"
+#include "block/converter/ValueTransmissionQuaternion.h"
+#include "block/converter/ValueTransmissionState.h"
+
+#include "block/stream/FileStream.h"
+#include "block/stream/CaptureReplay.h"
+#include "block/stream/CaptureRecorder.h"
+#include "block/stream/UdpSocket.h"
+
+#ifdef SERIALPORT_ENABLED
+#include "block/stream/SerialPort.h"
+#endif
+
+#include "gui/model/NumberBlockModel.h"
+#include "gui/model/OrientationBlockModel.h"
+#include "gui/model/StringBlockModel.h"
+#include "gui/model/VectorBlockModel.h"
+
+#include "helpers/GeographicConvertionWrapper.h"
+
+#include <QFile>
+#include <QGraphicsScene>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+HeadlessRunner::HeadlessRunner( const Options& options, QObject* parent )
+  : QObject( parent ), options( options ) {
+  scene = new QGraphicsScene( this );
+
+  geographicConvertionWrapper = std::make_unique<GeographicConvertionWrapper>();
+
+  numberBlockModel = new NumberBlockModel( scene );
+  orientationBlockModel = new OrientationBlockModel( scene );
+  stringBlockModel = new StringBlockModel( scene );
+  vectorBlockModel = new VectorBlockModel( scene );
+
+  addFactory( new NumberFactory( numberBlockModel ) );
+  addFactory( new OrientationBlockFactory( orientationBlockModel ) );
+  addFactory( new StringFactory( stringBlockModel ) );
+  addFactory( new VectorFactory( vectorBlockModel ) );
+
+  addFactory( new ArithmeticAdditionFactory() );
+  addFactory( new ArithmeticSubtractionFactory() );
+  addFactory( new ArithmeticMultiplicationFactory() );
+  addFactory( new ArithmeticDivisionFactory() );
+
+  addFactory( new ComparisonEqualToFactory() );
+  addFactory( new ComparisonNotEqualToFactory() );
+  addFactory( new ComparisonGreaterThanFactory() );
+  addFactory( new ComparisonLessThanFactory() );
+  addFactory( new ComparisonGreaterOrEqualToFactory() );
+  addFactory( new ComparisonLessOrEqualToFactory() );
+
+  addFactory( new AckermannSteeringFactory() );
+  addFactory( new AngularVelocityLimiterFactory() );
+  addFactory( new TransverseMercatorConverterFactory( geographicConvertionWrapper.get() ) );
+
+  addFactory( new ExtendedKalmanFilterFactory() );
+  addFactory( new PoseSynchroniserFactory() );
+
+  // without a main window, the planners and the implement have no docks and the global planner no markers
+  addFactory( new GlobalPlannerFactory( nullptr, KDDockWidgets::Location_OnRight, nullptr, geographicConvertionWrapper.get(), nullptr ) );
+  addFactory( new LocalPlannerFactory( nullptr, KDDockWidgets::Location_OnRight, nullptr ) );
+  addFactory( new StanleyGuidanceFactory() );
+  addFactory( new XteGuidanceFactory() );
+
+  addFactory( new FixedKinematicFactory() );
+  addFactory( new FixedKinematicPrimitiveFactory() );
+  addFactory( new TrailerKinematicFactory() );
+  addFactory( new TrailerKinematicPrimitiveFactory() );
+
+  addFactory( new NmeaParserFactory() );
+  addFactory( new NmeaParserGGAFactory() );
+  addFactory( new NmeaParserHDTFactory() );
+  addFactory( new NmeaParserRMCFactory() );
+  addFactory( new UbxParserFactory() );
+
+  addFactory( new DebugSinkFactory() );
+
+  addFactory( new ImplementFactory( nullptr, KDDockWidgets::Location_OnBottom, nullptr, nullptr ) );
+
+  addFactory( new CommunicationJrkFactory() );
+  addFactory( new CommunicationPgn7ffeFactory() );
+  addFactory( new ValueTransmissionNumberFactory() );
+  addFactory( new ValueTransmissionQuaternionFactory() );
+  addFactory( new ValueTransmissionStateFactory() );
+  addFactory( new ValueTransmissionBase64DataFactory() );
+
+  addFactory( new FileStreamFactory() );
+  addFactory( new CaptureReplayFactory() );
+  addFactory( new CaptureRecorderFactory() );
+  addFactory( new UdpSocketFactory() );
+
+#ifdef SERIALPORT_ENABLED
+  addFactory( new SerialPortFactory() );
+#endif
+
+  addStubFactories();
+
+  executionDomains = new ExecutionDomains( this );
+  executionDomains->setRealtimeEnabled( options.realtimeThread );
+
+  deliveryPolicies = new DeliveryPolicies( this );
+
+  // there is no rendered frame to deliver the values of the connections with "once per frame" delivery, so a timer at
+  // the usual frame rate stands in for it
+  frameTimer = new QTimer( this );
+  frameTimer->setTimerType( Qt::PreciseTimer );
+  QObject::connect( frameTimer, &QTimer::timeout, deliveryPolicies, &DeliveryPolicies::frameSwapped );
+  frameTimer->start( 1000 / 60 );
+
+  dataflowScheduler = new DataflowScheduler( this );
+  blockProfiler = new BlockProfiler( scene, this );
+}
+
+HeadlessRunner::~HeadlessRunner() {
+  // the blocks reference the factories and models, so they go first
+  dataflowScheduler->clear();
+  blockProfiler->setEnabled( false );
+  scene->clear();
+
+  delete numberBlockModel;
+  delete orientationBlockModel;
+  delete stringBlockModel;
+  delete vectorBlockModel;
+}
+
+void HeadlessRunner::addFactory( BlockFactory* factory ) {
+  factory->registerFactory();
+  ownedFactories.emplace_back( factory );
+}
+
+void HeadlessRunner::addStubFactories() {
+  const auto pose = QLatin1String( SLOT( setPose( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) );
+  const auto implementData = QLatin1String( SLOT( setImplement( const QPointer<Implement> ) ) );
+  const auto sectionControlData = QLatin1String( SLOT( setSections() ) );
+
+  // the ports are the ones of the factories of the GUI
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Action Dock Block" ), false, {
+    { QStringLiteral( "Action with State" ), QLatin1String( SIGNAL( action( const bool ) ) ), true } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "SliderDockBlock" ), false, {
+    { QStringLiteral( "Number" ), QLatin1String( SIGNAL( valueChanged( const double ) ) ), true } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "ValueDockBlock" ), false, {
+    { QStringLiteral( "Number" ), QLatin1String( SLOT( setValue( const double ) ) ), false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "XteDockBlock" ), false, {
+    { QStringLiteral( "XTE" ), QLatin1String( SLOT( setXte( const double ) ) ), false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "OrientationDockBlock" ), false, {
+    { QStringLiteral( "Orientation" ), QLatin1String( SLOT( setOrientation( const Eigen::Quaterniond& ) ) ), false },
+    { QStringLiteral( "Pose" ), pose, false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "PositionDockBlock" ), false, {
+    { QStringLiteral( "WGS84 Position" ), QLatin1String( SLOT( setWGS84Position( const Eigen::Vector3d& ) ) ), false },
+    { QStringLiteral( "Pose" ), pose, false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "OrientationPlotDockBlock" ), false, {
+    { QStringLiteral( "Orientation" ), QLatin1String( SLOT( setOrientation( const Eigen::Quaterniond& ) ) ), false },
+    { QStringLiteral( "Pose" ), pose, false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "ValuePlotDockBlock" ), false, {
+    { QStringLiteral( "Number 0" ), QLatin1String( SLOT( addValue0( const double ) ) ), false },
+    { QStringLiteral( "Number 1" ), QLatin1String( SLOT( addValue1( const double ) ) ), false },
+    { QStringLiteral( "Number 2" ), QLatin1String( SLOT( addValue2( const double ) ) ), false },
+    { QStringLiteral( "Number 3" ), QLatin1String( SLOT( addValue3( const double ) ) ), false } } ) );
+
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Tractor Model" ), false, {
+    { QStringLiteral( "Length Wheelbase" ), QLatin1String( SLOT( setWheelbase( const double ) ) ), false },
+    { QStringLiteral( "Track Width" ), QLatin1String( SLOT( setTrackwidth( const double ) ) ), false },
+    { QStringLiteral( "Pose Hook Point" ), QLatin1String( SLOT( setPoseHookPoint( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ), false },
+    { QStringLiteral( "Pose Pivot Point" ), QLatin1String( SLOT( setPosePivotPoint( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ), false },
+    { QStringLiteral( "Pose Tow Point" ), QLatin1String( SLOT( setPoseTowPoint( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ), false },
+    { QStringLiteral( "Steering Angle Left" ), QLatin1String( SLOT( setSteeringAngleLeft( const double ) ) ), false },
+    { QStringLiteral( "Steering Angle Right" ), QLatin1String( SLOT( setSteeringAngleRight( const double ) ) ), false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Trailer Model" ), false, {
+    { QStringLiteral( "Track Width" ), QLatin1String( SLOT( setTrackwidth( const double ) ) ), false },
+    { QStringLiteral( "Offset Hook Point" ), QLatin1String( SLOT( setOffsetHookPointPosition( const Eigen::Vector3d& ) ) ), false },
+    { QStringLiteral( "Pose Hook Point" ), QLatin1String( SLOT( setPoseHookPoint( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ), false },
+    { QStringLiteral( "Pose Pivot Point" ), QLatin1String( SLOT( setPosePivotPoint( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ), false },
+    { QStringLiteral( "Pose Tow Point" ), QLatin1String( SLOT( setPoseTowPoint( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ), false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Sprayer Model" ), false, {
+    { QStringLiteral( "Pose" ), pose, false },
+    { QStringLiteral( "Height" ), QLatin1String( SLOT( setHeight( const double ) ) ), false },
+    { QStringLiteral( "Implement Data" ), implementData, false },
+    { QStringLiteral( "Section Control Data" ), sectionControlData, false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Cultivated Area Model" ), false, {
+    { QStringLiteral( "Pose" ), pose, false },
+    { QStringLiteral( "Implement Data" ), implementData, false },
+    { QStringLiteral( "Section Control Data" ), sectionControlData, false },
+    { QStringLiteral( "Cultivated Area" ), QLatin1String( SIGNAL( layerChanged( Qt3DRender::QLayer* ) ) ), true },
+    { QStringLiteral( "Area" ), QLatin1String( SIGNAL( areaChanged( const double ) ) ), true } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Path Planner Model" ), false, {
+    { QStringLiteral( "Pose" ), pose, false },
+    { QStringLiteral( "Plan" ), QLatin1String( SLOT( setPlan( const Plan& ) ) ), false } } ) );
+  // the section control needs the rendered cultivated area
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Section Control" ), false, {
+    { QStringLiteral( "Pose" ), pose, false },
+    { QStringLiteral( "Implement Data" ), implementData, false },
+    { QStringLiteral( "Section Control Data" ), sectionControlData, false },
+    { QStringLiteral( "Cultivated Area" ), QLatin1String( SLOT( setLayer( Qt3DRender::QLayer* ) ) ), false } } ) );
+
+  // the system blocks of the GUI
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Pose Simulation" ), true, {
+    { QStringLiteral( "Antenna Position" ), QLatin1String( SLOT( setAntennaOffset( const Eigen::Vector3d& ) ) ), false },
+    { QStringLiteral( "Initial WGS84 Position" ), QLatin1String( SLOT( setInitialWGS84Position( const Eigen::Vector3d& ) ) ), false },
+    { QStringLiteral( "WGS84 Position" ), QLatin1String( SIGNAL( globalPositionChanged( const Eigen::Vector3d& ) ) ), true },
+    { QStringLiteral( "Velocity 3D" ), QLatin1String( SIGNAL( velocity3DChanged( const Eigen::Vector3d& ) ) ), true },
+    { QStringLiteral( "Position" ), QLatin1String( SIGNAL( positionChanged( const Eigen::Vector3d& ) ) ), true },
+    { QStringLiteral( "Orientation" ), QLatin1String( SIGNAL( orientationChanged( const Eigen::Quaterniond& ) ) ), true },
+    { QStringLiteral( "Steering Angle" ), QLatin1String( SIGNAL( steeringAngleChanged( const double ) ) ), true },
+    { QStringLiteral( "Velocity" ), QLatin1String( SIGNAL( velocityChanged( const double ) ) ), true },
+    { QStringLiteral( "IMU Data" ), QLatin1String( SIGNAL( imuDataChanged( const Eigen::Quaterniond&, const Eigen::Vector3d&, const Eigen::Vector3d& ) ) ), true },
+    { QStringLiteral( "Autosteer Enabled" ), QLatin1String( SLOT( autosteerEnabled( const bool ) ) ), false },
+    { QStringLiteral( "Autosteer Steering Angle" ), QLatin1String( SLOT( setSteerAngleFromAutosteer( const double ) ) ), false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Field Manager" ), true, {
+    { QStringLiteral( "Pose" ), pose, false },
+    { QStringLiteral( "Pose Left Edge" ), QLatin1String( SLOT( setPoseLeftEdge( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ), false },
+    { QStringLiteral( "Pose Right Edge" ), QLatin1String( SLOT( setPoseRightEdge( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) ) ), false },
+    { QStringLiteral( "Field" ), QLatin1String( SIGNAL( fieldChanged( std::shared_ptr<Polygon_with_holes_2> ) ) ), true },
+    { QStringLiteral( "Points Recorded" ), QLatin1String( SIGNAL( pointsRecordedChanged( const double ) ) ), true },
+    { QStringLiteral( "Points Generated" ), QLatin1String( SIGNAL( pointsGeneratedForFieldBoundaryChanged( const double ) ) ), true },
+    { QStringLiteral( "Points Boundary" ), QLatin1String( SIGNAL( pointsInFieldBoundaryChanged( const double ) ) ), true } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Camera Controller" ), true, {
+    { QStringLiteral( "View Center Position" ), pose, false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Grid Model" ), true, {
+    { QStringLiteral( "Pose" ), pose, false } } ) );
+  addFactory( new HeadlessStubBlockFactory( QStringLiteral( "Fps Measurement" ), true, {
+    { QStringLiteral( "FPS" ), QLatin1String( SIGNAL( fpsChanged( double ) ) ), true } } ) );
+}
+
+QStringList HeadlessRunner::factoryNames() const {
+  return BlockFactory::registeredTypes();
+}
+
+BlockProfiler* HeadlessRunner::profiler() const {
+  return blockProfiler;
+}
+
+bool HeadlessRunner::loadAbLine( QFile& file ) {
+  if( globalPlanner == nullptr ) {
+    qWarning() << "HeadlessRunner: the config has no global planner for" << file.fileName();
+    return false;
+  }
+
+  globalPlanner->openAbLineFromFile( file );
+  return true;
+}
+
+bool HeadlessRunner::loadConfig( QFile& file, LoadResult& result ) {
+  QElapsedTimer timer;
+  timer.start();
+
+  QJsonParseError error;
+  const auto json = QJsonDocument::fromJson( file.readAll(), &error ).object();
+
+  if( error.error != QJsonParseError::NoError ) {
+    qWarning() << "HeadlessRunner:" << file.fileName() << error.errorString();
+    return false;
+  }
+
+  // the ids of the config -> the blocks created for them
+  QHash<int, QNEBlock*> blockForId;
+
+  for( const auto& blockValue : json[QStringLiteral( "blocks" )].toArray() ) {
+    auto blockObject = blockValue.toObject();
+    const int id = blockObject[QStringLiteral( "id" )].toInt( 0 );
+    const auto type = blockObject[QStringLiteral( "type" )].toString();
+
+    if( id == 0 ) {
+      continue;
+    }
+
+    // the system blocks are created with the ids of the config, as there is no GUI which created them before
+    auto* factory = BlockFactory::factoryForType( type );
+
+    if( factory == nullptr ) {
+      ++result.skippedBlocks[type];
+      continue;
+    }
+
+    QNEBlock* block = factory->createBlock( scene, id );
+    block->setName( blockObject[QStringLiteral( "name" )].toString( factory->getNameOfFactory() ) );
+    block->fromJSON( blockObject );
+
+    if( auto* planner = qobject_cast<GlobalPlanner*>( block->object ) ) {
+      globalPlanner = planner;
+    }
+
+    blockForId.insert( id, block );
+    ++result.blocks;
+  }
+
+  for( const auto& connectionValue : json[QStringLiteral( "connections" )].toArray() ) {
+    const auto connectionObject = connectionValue.toObject();
+
+    QNEBlock* blockFrom = blockForId.value( connectionObject[QStringLiteral( "idFrom" )].toInt( 0 ), nullptr );
+    QNEBlock* blockTo = blockForId.value( connectionObject[QStringLiteral( "idTo" )].toInt( 0 ), nullptr );
+
+    if( blockFrom == nullptr || blockTo == nullptr ) {
+      ++result.skippedConnections;
+      continue;
+    }
+
+    QNEPort* portFrom = blockFrom->getPortWithName( connectionObject[QStringLiteral( "portFrom" )].toString(), true );
+    QNEPort* portTo = blockTo->getPortWithName( connectionObject[QStringLiteral( "portTo" )].toString(), false );
+
+    if( portFrom == nullptr || portTo == nullptr ) {
+      ++result.skippedConnections;
+      continue;
+    }
+
+    auto* connection = new QNEConnection();
+    connection->setPort1( portFrom );
+
+    if( connection->setPort2( portTo ) ) {
+      scene->addItem( connection );
+      connection->deliveryPolicyFromJSON( connectionObject );
+      ++result.connections;
+    } else {
+      delete connection;
+      ++result.skippedConnections;
+    }
+  }
+
+  // the same routing as in the GUI
+  executionDomains->assignAll( scene );
+  deliveryPolicies->routeConnections( scene );
+  executionDomains->routeConnections( scene );
+
+  if( options.compiledDataflow ) {
+    dataflowScheduler->compile( json, [&blockForId]( int id ) {
+      return blockForId.value( id, nullptr );
+    } );
+  }
+
+  blockProfiler->setEnabled( options.profile );
+
+  // the connections are made, so the blocks can emit their values
+  for( auto* block : qAsConst( blockForId ) ) {
+    Q_EMIT block->emitConfigSignals();
+  }
+
+  result.milliseconds = timer.elapsed();
+
+  return true;
+}
@@ -0,0 +1,107 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QObject>
+#include <QMap>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+class QFile;
+class QGraphicsScene;
+class QTimer;
+class QNEBlock;
+
+class BlockFactory;
+class BlockProfiler;
+class DataflowScheduler;
+class DeliveryPolicies;
+class ExecutionDomains;
+class GeographicConvertionWrapper;
+class GlobalPlanner;
+
+class NumberBlockModel;
+class OrientationBlockModel;
+class StringBlockModel;
+class VectorBlockModel;
+
+// runs the block graph of a saved config without the GUI: the blocks without docks or 3D entities are instantiated
+// (streams, parsers, filters, kinematics, the planners, the implement, guidance, converters, arithmetic); the global
+// planner and the implement run without their docks and markers. The docks, the 3D models and the other system blocks
+// are replaced by stubs with the same ports, so all the connections of the config load; their outputs stay silent.
+// Unknown blocks and their connections are skipped and reported. The graph is routed like in the GUI, so the realtime
+// thread, the compiled dataflow, the delivery policies and the profiler behave the same.
+class HeadlessRunner : public QObject {
+    Q_OBJECT
+
+  public:
+    struct Options {
+      bool realtimeThread = false;
+      bool compiledDataflow = false;
+      bool profile = false;
+    };
+
+    struct LoadResult {
+      int blocks = 0;
+      int connections = 0;
+      // type -> number of the skipped blocks
+      QMap<QString, int> skippedBlocks;
+      int skippedConnections = 0;
+      qint64 milliseconds = 0;
+    };
+
+  public:
+    explicit HeadlessRunner( const Options& options, QObject* parent = nullptr );
+    ~HeadlessRunner();
+
+    bool loadConfig( QFile& file, LoadResult& result );
+
+    QStringList factoryNames() const;
+
+    BlockProfiler* profiler() const;
+
+    // passes a saved AB-line/curve (GeoJSON) to the global planner of the config, as there is no toolbar to set one
+    bool loadAbLine( QFile& file );
+
+  private:
+    void addFactory( BlockFactory* factory );
+    void addStubFactories();
+
+    Options options;
+
+    QGraphicsScene* scene = nullptr;
+
+    std::unique_ptr<GeographicConvertionWrapper> geographicConvertionWrapper;
+
+    NumberBlockModel* numberBlockModel = nullptr;
+    OrientationBlockModel* orientationBlockModel = nullptr;
+    StringBlockModel* stringBlockModel = nullptr;
+    VectorBlockModel* vectorBlockModel = nullptr;
+
+    std::vector<std::unique_ptr<BlockFactory>> ownedFactories;
+
+    GlobalPlanner* globalPlanner = nullptr;
+
+    ExecutionDomains* executionDomains = nullptr;
+    DeliveryPolicies* deliveryPolicies = nullptr;
+    QTimer* frameTimer = nullptr;
+    DataflowScheduler* dataflowScheduler = nullptr;
+    BlockProfiler* blockProfiler = nullptr;
+};
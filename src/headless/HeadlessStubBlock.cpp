@@ -0,0 +1,41 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "HeadlessStubBlock.h"
+
+#include "qneblock.h"
+#include "qneport.h"
+
+QNEBlock* HeadlessStubBlockFactory::createBlock( QGraphicsScene* scene, int id ) {
+  auto* obj = new HeadlessStubBlock();
+  auto* b = createBaseBlock( scene, obj, id, systemBlock );
+
+  for( const auto& port : ports ) {
+    if( port.output ) {
+      b->addOutputPort( port.name, port.signature );
+    } else {
+      b->addInputPort( port.name, port.signature );
+    }
+  }
+
+  // the system blocks keep the color of QNEBlock
+  if( !systemBlock ) {
+    b->setBrush( dockColor );
+  }
+
+  return b;
+}
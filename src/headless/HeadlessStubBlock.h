@@ -0,0 +1,127 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+
+#include <memory>
+#include <vector>
+
+#include <Qt3DRender/QLayer>
+
+#include "block/BlockBase.h"
+
+#include "block/sectionControl/Implement.h"
+
+#include "helpers/cgalHelper.h"
+#include "helpers/eigenHelper.h"
+#include "kinematic/Plan.h"
+#include "kinematic/PoseOptions.h"
+
+// stands in for a block with a dock or a 3D entity, so the headless runner loads the ports and the connections of
+// the config like the GUI. The slots are the ones of the stubbed blocks and do nothing; the signals are never emitted.
+class HeadlessStubBlock : public BlockBase {
+    Q_OBJECT
+
+  public Q_SLOTS:
+    // docks
+    void setValue( const double ) {}
+    void setXte( const double ) {}
+    void setOrientation( const Eigen::Quaterniond& ) {}
+    void setWGS84Position( const Eigen::Vector3d& ) {}
+    void addValue0( const double ) {}
+    void addValue1( const double ) {}
+    void addValue2( const double ) {}
+    void addValue3( const double ) {}
+
+    // models and system blocks
+    void setPose( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) {}
+    void setPoseHookPoint( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) {}
+    void setPosePivotPoint( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) {}
+    void setPoseTowPoint( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) {}
+    void setPoseLeftEdge( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) {}
+    void setPoseRightEdge( const Eigen::Vector3d&, const Eigen::Quaterniond&, const PoseOption::Options& ) {}
+    void setPlan( const Plan& ) {}
+    void setImplement( const QPointer<Implement> ) {}
+    void setSections() {}
+    void setLayer( Qt3DRender::QLayer* ) {}
+    void setWheelbase( const double ) {}
+    void setTrackwidth( const double ) {}
+    void setHeight( const double ) {}
+    void setSteeringAngleLeft( const double ) {}
+    void setSteeringAngleRight( const double ) {}
+    void setOffsetHookPointPosition( const Eigen::Vector3d& ) {}
+    void setAntennaOffset( const Eigen::Vector3d& ) {}
+    void setInitialWGS84Position( const Eigen::Vector3d& ) {}
+    void autosteerEnabled( const bool ) {}
+    void setSteerAngleFromAutosteer( const double ) {}
+
+  Q_SIGNALS:
+    // docks
+    void action( const bool );
+    void valueChanged( const double );
+
+    // models and system blocks
+    void layerChanged( Qt3DRender::QLayer* );
+    void areaChanged( const double );
+    void fpsChanged( double );
+    void fieldChanged( std::shared_ptr<Polygon_with_holes_2> );
+    void pointsRecordedChanged( const double );
+    void pointsGeneratedForFieldBoundaryChanged( const double );
+    void pointsInFieldBoundaryChanged( const double );
+    void globalPositionChanged( const Eigen::Vector3d& );
+    void velocity3DChanged( const Eigen::Vector3d& );
+    void positionChanged( const Eigen::Vector3d& );
+    void orientationChanged( const Eigen::Quaterniond& );
+    void steeringAngleChanged( const double );
+    void velocityChanged( const double );
+    void imuDataChanged( const Eigen::Quaterniond&, const Eigen::Vector3d&, const Eigen::Vector3d& );
+};
+
+// creates stubs with the type and the ports of a block of the GUI
+class HeadlessStubBlockFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    struct Port {
+      QString name;
+      // like SIGNAL() or SLOT()
+      QLatin1String signature;
+      bool output;
+    };
+
+  public:
+    HeadlessStubBlockFactory( const QString& type, const bool systemBlock, std::vector<Port> ports )
+      : BlockFactory(), type( type ), systemBlock( systemBlock ), ports( std::move( ports ) ) {}
+
+    QString getNameOfFactory() override {
+      return type;
+    }
+
+    QString getCategoryOfFactory() override {
+      return QStringLiteral( "Headless Stubs" );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override;
+
+  private:
+    QString type;
+    bool systemBlock = false;
+    std::vector<Port> ports;
+};
@@ -0,0 +1,185 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+// runs the block graph of a saved config without the GUI, see HeadlessRunner
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+#include <QTimer>
+
+#include "HeadlessRunner.h"
+
+#include "block/BlockProfiler.h"
+#include "block/parser/NmeaParser.h"
+#include "block/stream/UdpSocket.h"
+
+#include "helpers/eigenHelper.h"
+#include "kinematic/PoseOptions.h"
+#include "kinematic/Plan.h"
+
+int main( int argc, char** argv ) {
+  // the blocks live in a QGraphicsScene, which needs a QApplication; no display is needed with the offscreen platform
+  if( qEnvironmentVariableIsEmpty( "QT_QPA_PLATFORM" ) ) {
+    qputenv( "QT_QPA_PLATFORM", "offscreen" );
+  }
+
+  QApplication app( argc, argv );
+  QCoreApplication::setOrganizationDomain( QStringLiteral( "QtOpenGuidance.org" ) );
+  QCoreApplication::setApplicationName( QStringLiteral( "QtOpenGuidanceHeadless" ) );
+
+  qRegisterMetaType<Plan>();
+
+  // the types used by most of the blocks; needed to pass them between threads or through the dataflow scheduler
+  qRegisterMetaType<Eigen::Vector3d>( "Eigen::Vector3d" );
+  qRegisterMetaType<Eigen::Quaterniond>( "Eigen::Quaterniond" );
+  qRegisterMetaType<PoseOption::Options>( "PoseOption::Options" );
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription( QStringLiteral( "Runs the non-visual blocks of a saved config: streams, parsers, filters, kinematics, planners, guidance and converters. "
+                                    "Docks and 3D blocks are replaced by stubs without output." ) );
+  parser.addHelpOption();
+  parser.addPositionalArgument( QStringLiteral( "config" ), QStringLiteral( "Config as saved by QtOpenGuidance (JSON)." ) );
+
+  const QCommandLineOption durationOption( QStringLiteral( "duration" ), QStringLiteral( "Quit after this time in s; 0: run until terminated." ), QStringLiteral( "s" ), QStringLiteral( "0" ) );
+  const QCommandLineOption realtimeThreadOption( QStringLiteral( "realtime-thread" ), QStringLiteral( "Run the sensor and control blocks on the realtime thread." ) );
+  const QCommandLineOption compiledDataflowOption( QStringLiteral( "compiled-dataflow" ), QStringLiteral( "Route the graph through the dataflow scheduler." ) );
+  const QCommandLineOption profileOption( QStringLiteral( "profile" ), QStringLiteral( "Profile the blocks and write the statistics as CSV on exit." ), QStringLiteral( "file" ) );
+  const QCommandLineOption abLineOption( QStringLiteral( "ab-line" ), QStringLiteral( "Plan along this AB-line/curve as saved by the global planner (GeoJSON)." ), QStringLiteral( "file" ) );
+  const QCommandLineOption listBlocksOption( QStringLiteral( "list-blocks" ), QStringLiteral( "List the types of the blocks available headless and quit." ) );
+  const QCommandLineOption benchmarkUdpOption( QStringLiteral( "benchmark-udp" ), QStringLiteral( "Send datagrams over the loopback interface to this port and the next one, report the throughput and the drops and quit." ), QStringLiteral( "port" ) );
+  const QCommandLineOption benchmarkNmeaOption( QStringLiteral( "benchmark-nmea" ), QStringLiteral( "Report the throughput of the NMEA parser on a log of NMEA sentences and quit." ), QStringLiteral( "file" ) );
+
+  parser.addOptions( { durationOption, realtimeThreadOption, compiledDataflowOption, profileOption, abLineOption, listBlocksOption, benchmarkNmeaOption, benchmarkUdpOption } );
+  parser.process( app );
+
+  QTextStream errorStream( stderr );
+
+  HeadlessRunner::Options options;
+  options.realtimeThread = parser.isSet( realtimeThreadOption );
+  options.compiledDataflow = parser.isSet( compiledDataflowOption );
+  options.profile = parser.isSet( profileOption );
+
+  HeadlessRunner runner( options );
+
+  if( parser.isSet( listBlocksOption ) ) {
+    QTextStream outputStream( stdout );
+
+    for( const auto& name : runner.factoryNames() ) {
+      outputStream << name << Qt::endl;
+    }
+
+    return 0;
+  }
+
+  if( parser.isSet( benchmarkNmeaOption ) ) {
+    QFile logFile( parser.value( benchmarkNmeaOption ) );
+
+    if( !logFile.open( QIODevice::ReadOnly ) ) {
+      errorStream << "Couldn't open " << logFile.fileName() << Qt::endl;
+      return 1;
+    }
+
+    const auto log = logFile.readAll();
+
+    QTextStream outputStream( stdout );
+    outputStream << "chunkSize,megabytesPerSecond,sentencesPerSecond,checksumErrors" << Qt::endl;
+
+    // from single reads of a serial port to whole UDP datagrams
+    for( const int chunkSize : { 16, 64, 512, 4096 } ) {
+      const auto result = NmeaParser::benchmark( log, chunkSize, 2 );
+      outputStream << chunkSize << ',' << result.megabytesPerSecond << ',' << qRound64( result.sentencesPerSecond ) << ',' << result.checksumErrors << Qt::endl;
+    }
+
+    return 0;
+  }
+
+  if( parser.isSet( benchmarkUdpOption ) ) {
+    const auto port = quint16( parser.value( benchmarkUdpOption ).toUInt() );
+
+    QTextStream outputStream( stdout );
+    outputStream << "datagramSize,sent,received,dropped,datagramsPerSecond" << Qt::endl;
+
+    for( const int datagramSize : { 64, 512, 1400 } ) {
+      const auto result = UdpSocketWorker::loopbackTest( port, 100000, datagramSize );
+      outputStream << datagramSize << ',' << result.sent << ',' << result.received << ',' << result.dropped << ','
+                   << qRound64( double( result.received ) / result.seconds ) << Qt::endl;
+    }
+
+    return 0;
+  }
+
+  if( parser.positionalArguments().size() != 1 ) {
+    parser.showHelp( 1 );
+  }
+
+  QFile configFile( parser.positionalArguments().front() );
+
+  if( !configFile.open( QIODevice::ReadOnly ) ) {
+    errorStream << "Couldn't open " << configFile.fileName() << Qt::endl;
+    return 1;
+  }
+
+  HeadlessRunner::LoadResult result;
+
+  if( !runner.loadConfig( configFile, result ) ) {
+    errorStream << "Couldn't load " << configFile.fileName() << Qt::endl;
+    return 1;
+  }
+
+  errorStream << result.blocks << " blocks and " << result.connections << " connections loaded in " << result.milliseconds << " ms" << Qt::endl;
+
+  if( !result.skippedBlocks.isEmpty() ) {
+    errorStream << "skipped (not available headless): ";
+
+    for( auto it = result.skippedBlocks.cbegin(), end = result.skippedBlocks.cend(); it != end; ++it ) {
+      errorStream << it.key() << " (" << it.value() << ") ";
+    }
+
+    errorStream << "and " << result.skippedConnections << " connections" << Qt::endl;
+  }
+
+  if( parser.isSet( abLineOption ) ) {
+    QFile abLineFile( parser.value( abLineOption ) );
+
+    if( !abLineFile.open( QIODevice::ReadOnly ) || !runner.loadAbLine( abLineFile ) ) {
+      errorStream << "Couldn't load " << abLineFile.fileName() << Qt::endl;
+      return 1;
+    }
+  }
+
+  const double duration = parser.value( durationOption ).toDouble();
+
+  if( duration > 0 ) {
+    QTimer::singleShot( int( duration * 1000 ), &app, &QCoreApplication::quit );
+  }
+
+  const int returnCode = app.exec();
+
+  if( parser.isSet( profileOption ) ) {
+    QFile profileFile( parser.value( profileOption ) );
+
+    if( !profileFile.open( QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text ) ||
+        !runner.profiler()->exportCsv( profileFile ) ) {
+      errorStream << "Couldn't write " << profileFile.fileName() << Qt::endl;
+      return 1;
+    }
+  }
+
+  return returnCode;
+}
@@ -26,8 +26,10 @@
 #include <QtMath>
 
 void GeographicConvertionWrapper::Forward( const double latitude, const double longitude, const double height, double& x, double& y, double& z ) {
+  std::lock_guard<std::mutex> lock( mutex );
+
   if( !isLatLonOffsetSet ) {
-    Reset( latitude, longitude, height );
+    resetUnlocked( latitude, longitude, height );
 
     x = 0;
     y = 0;
@@ -53,8 +55,10 @@ void GeographicConvertionWrapper::Forward( const double latitude, const double l
 }
 
 void GeographicConvertionWrapper::Forward( const double latitude, const double longitude, double& x, double& y, double& z ) {
+  std::lock_guard<std::mutex> lock( mutex );
+
   if( !isLatLonOffsetSet ) {
-    Reset( latitude, longitude, height0TM );
+    resetUnlocked( latitude, longitude, height0TM );
 
     x = 0;
     y = 0;
@@ -85,6 +89,8 @@ Eigen::Vector3d GeographicConvertionWrapper::Forward( const Eigen::Vector3d& poi
 }
 
 void GeographicConvertionWrapper::Reverse( const double x, const double y, const double z, double& latitude, double& longitude, double& height ) {
+  std::lock_guard<std::mutex> lock( mutex );
+
   if( isLatLonOffsetSet ) {
     if( useTM ) {
       TransverseMercator::UTM().Reverse( lon0TM, -y, x + falseNorthingTM, latitude, longitude );
@@ -101,6 +107,8 @@ void GeographicConvertionWrapper::Reverse( const double x, const double y, const
 }
 
 void GeographicConvertionWrapper::Reverse( const double x, const double y, double& latitude, double& longitude, double& height ) {
+  std::lock_guard<std::mutex> lock( mutex );
+
   if( isLatLonOffsetSet ) {
     if( useTM ) {
       TransverseMercator::UTM().Reverse( lon0TM, -y, x + falseNorthingTM, latitude, longitude );
@@ -117,6 +125,11 @@ void GeographicConvertionWrapper::Reverse( const double x, const double y, doubl
 }
 
 void GeographicConvertionWrapper::Reset( const double latitude, const double longitude, const double height ) {
+  std::lock_guard<std::mutex> lock( mutex );
+  resetUnlocked( latitude, longitude, height );
+}
+
+void GeographicConvertionWrapper::resetUnlocked( const double latitude, const double longitude, const double height ) {
   double y;
   lon0TM = longitude;
   TransverseMercator::UTM().Forward( lon0TM, latitude, longitude, y, falseNorthingTM );
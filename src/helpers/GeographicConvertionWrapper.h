@@ -22,6 +22,8 @@
 
 #include <GeographicLib/LocalCartesian.hpp>
 
+#include <mutex>
+
 // NOTE: QtOpenGuidance uses the coordinate system for the vehicle according to ISO 8855:2011(E)
 // (Y left, X forward, Z up), but the coordinate system of the geographic conversions
 // is another one: X east, Y north and Z up. As this is the only code that uses both,
@@ -31,7 +33,8 @@
 using namespace std;
 using namespace GeographicLib;
 
-// an instance of this class gets shared across all the blocks, so the conversions are the same everywhere
+// an instance of this class gets shared across all the blocks, so the conversions are the same everywhere;
+// as the blocks can run on different threads, the conversions are serialised
 class GeographicConvertionWrapper {
   public:
     void Forward( const double latitude, const double longitude, const double height, double& x, double& y, double& z );
@@ -52,6 +55,10 @@ class GeographicConvertionWrapper {
     bool useTM = true;
 
   private:
+    void resetUnlocked( const double latitude, const double longitude, const double height );
+
+    std::mutex mutex;
+
     LocalCartesian _lc;
 
     bool isLatLonOffsetSet = false;
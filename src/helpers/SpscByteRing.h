@@ -0,0 +1,109 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// lock-free ring of bytes for exactly one producer thread and one consumer thread; the memory is allocated and touched
+// once in the constructor. The producer appends a record in parts and publishes it as a whole with commit(), so the
+// consumer only ever sees whole records.
+class SpscByteRing {
+  public:
+    // the capacity is rounded up to a power of two
+    explicit SpscByteRing( const std::size_t capacity )
+      : buffer( roundUp( capacity ) ), mask( buffer.size() - 1 ) {}
+
+    SpscByteRing( const SpscByteRing& ) = delete;
+    SpscByteRing& operator=( const SpscByteRing& ) = delete;
+
+    // producer side; returns false if there isn't space for size more bytes
+    bool reserve( const std::size_t size ) const {
+      return ( pending - m_tail.load( std::memory_order_acquire ) ) + size <= buffer.size();
+    }
+
+    // producer side; only after a successful reserve()
+    void append( const char* data, const std::size_t size ) {
+      const auto index = std::size_t( pending & mask );
+      const auto first = std::min( size, buffer.size() - index );
+
+      std::memcpy( buffer.data() + index, data, first );
+      std::memcpy( buffer.data(), data + first, size - first );
+
+      pending += size;
+    }
+
+    // producer side; publishes the appended bytes
+    void commit() {
+      m_head.store( pending, std::memory_order_release );
+    }
+
+    // consumer side; the published bytes in up to two contiguous segments, the second one is empty if it doesn't wrap
+    std::size_t peek( const char*& first, std::size_t& firstSize, const char*& second, std::size_t& secondSize ) const {
+      const auto tail = m_tail.load( std::memory_order_relaxed );
+      const auto size = std::size_t( m_head.load( std::memory_order_acquire ) - tail );
+      const auto index = std::size_t( tail & mask );
+
+      first = buffer.data() + index;
+      firstSize = std::min( size, buffer.size() - index );
+      second = buffer.data();
+      secondSize = size - firstSize;
+
+      return size;
+    }
+
+    // consumer side; frees the peeked bytes
+    void consume( const std::size_t size ) {
+      m_tail.store( m_tail.load( std::memory_order_relaxed ) + size, std::memory_order_release );
+    }
+
+    // the published bytes, from either side
+    std::size_t size() const {
+      return std::size_t( m_head.load( std::memory_order_acquire ) - m_tail.load( std::memory_order_acquire ) );
+    }
+
+    std::size_t capacity() const {
+      return buffer.size();
+    }
+
+  private:
+    static std::size_t roundUp( const std::size_t capacity ) {
+      std::size_t size = 64;
+
+      while( size < capacity ) {
+        size <<= 1;
+      }
+
+      return size;
+    }
+
+  private:
+    std::vector<char> buffer;
+    const uint64_t mask;
+
+    // the producer only; the end of the appended, not yet published bytes
+    uint64_t pending = 0;
+
+    // head and tail on separate cache lines, so producer and consumer don't invalidate each other; they only grow
+    alignas( 64 ) std::atomic<uint64_t> m_head = { 0 };
+    alignas( 64 ) std::atomic<uint64_t> m_tail = { 0 };
+};
@@ -0,0 +1,93 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// lock-free ring buffer for exactly one producer thread and one consumer thread
+template<typename T>
+class SpscQueue {
+  public:
+    explicit SpscQueue( const std::size_t capacity )
+      : buffer( capacity + 1 ) {}
+
+    SpscQueue( const SpscQueue& ) = delete;
+    SpscQueue& operator=( const SpscQueue& ) = delete;
+
+    // producer side; returns false if the queue is full
+    bool push( const T& value ) {
+      const auto head = m_head.load( std::memory_order_relaxed );
+      const auto next = increment( head );
+
+      if( next == m_tail.load( std::memory_order_acquire ) ) {
+        return false;
+      }
+
+      buffer[head] = value;
+      m_head.store( next, std::memory_order_release );
+      return true;
+    }
+
+    // consumer side; returns false if the queue is empty
+    bool pop( T& value ) {
+      const auto tail = m_tail.load( std::memory_order_relaxed );
+
+      if( tail == m_head.load( std::memory_order_acquire ) ) {
+        return false;
+      }
+
+      value = std::move( buffer[tail] );
+      m_tail.store( increment( tail ), std::memory_order_release );
+      return true;
+    }
+
+    // consumer side; pops everything and keeps the newest value only
+    bool popLatest( T& value ) {
+      bool popped = false;
+
+      while( pop( value ) ) {
+        popped = true;
+      }
+
+      return popped;
+    }
+
+    bool empty() const {
+      return m_tail.load( std::memory_order_acquire ) == m_head.load( std::memory_order_acquire );
+    }
+
+    std::size_t capacity() const {
+      return buffer.size() - 1;
+    }
+
+  private:
+    std::size_t increment( const std::size_t index ) const {
+      return ( index + 1 ) == buffer.size() ? 0 : index + 1;
+    }
+
+  private:
+    std::vector<T> buffer;
+
+    // head and tail on separate cache lines, so producer and consumer don't invalidate each other
+    alignas( 64 ) std::atomic<std::size_t> m_head = { 0 };
+    alignas( 64 ) std::atomic<std::size_t> m_tail = { 0 };
+};
@@ -0,0 +1,63 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#include "StartupTimeline.h"
+
+#include <QDebug>
+#include <QString>
+
+QElapsedTimer StartupTimeline::timer;
+std::vector<std::pair<const char*, qint64>> StartupTimeline::phases;
+bool StartupTimeline::reported = false;
+
+void StartupTimeline::start() {
+  timer.start();
+  phases.reserve( 32 );
+}
+
+void StartupTimeline::mark( const char* phase ) {
+  if( reported ) {
+    return;
+  }
+
+  if( !timer.isValid() ) {
+    timer.start();
+  }
+
+  phases.emplace_back( phase, timer.nsecsElapsed() );
+}
+
+void StartupTimeline::report() {
+  if( reported || phases.empty() ) {
+    return;
+  }
+
+  reported = true;
+
+  qDebug().nospace() << "startup: " << phases.back().second / 1e6 << " ms until " << phases.back().first;
+
+  qint64 lastNs = 0;
+
+  for( const auto& phase : phases ) {
+    qDebug().noquote() << QString::number( ( phase.second - lastNs ) / 1e6, 'f', 2 ).rightJustified( 10 )
+                       << "ms " << phase.first;
+    lastNs = phase.second;
+  }
+
+  phases.clear();
+  phases.shrink_to_fit();
+}
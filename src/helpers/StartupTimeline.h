@@ -0,0 +1,43 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+#pragma once
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+#include <utility>
+#include <vector>
+
+// the timeline of the start of the application: each phase is marked when it is done, the report shows the time
+// spent in each of them
+class StartupTimeline {
+  public:
+    // starts the clock; the phases before are reported relative to the first mark
+    static void start();
+
+    // the phase has to be a string literal, as only the pointer is stored
+    static void mark( const char* phase );
+
+    // prints the phases with their durations to qDebug(); only the first call prints something
+    static void report();
+
+  private:
+    static QElapsedTimer timer;
+    static std::vector<std::pair<const char*, qint64>> phases;
+    static bool reported;
+};
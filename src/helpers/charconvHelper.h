@@ -0,0 +1,51 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+
+#ifndef __cpp_lib_to_chars
+  #include <QByteArray>
+#endif
+
+// the whole text as a double, like std::from_chars. The floating point overloads of std::from_chars need libstdc++ 11
+// or a recent libc++, which the toolchains of Android and macOS don't have yet: there, a copy of the text is parsed by
+// Qt, which always uses the C locale, unlike strtod()
+inline bool doubleFromChars( const std::string_view text, double& value ) {
+  if( text.empty() ) {
+    return false;
+  }
+
+#ifdef __cpp_lib_to_chars
+  const auto* end = text.data() + text.size();
+  const auto result = std::from_chars( text.data(), end, value );
+  return result.ec == std::errc() && result.ptr == end;
+#else
+  bool ok = false;
+  const double parsed = QByteArray::fromRawData( text.data(), int( text.size() ) ).toDouble( &ok );
+
+  if( ok ) {
+    value = parsed;
+  }
+
+  return ok;
+#endif
+}
@@ -177,6 +177,245 @@ void CgalWorker::simplifyPolyline( std::vector<Point_2>* pointsPointer, double m
   Q_EMIT simplifyPolylineResult( polylineOut );
 }
 
+static Polygon_2_Epeck toEpeck( const Polygon_2& polygon ) {
+  EpickEpeckConverter converter;
+  Polygon_2_Epeck polygonEpeck;
+
+  for( const auto& point : polygon ) {
+    polygonEpeck.push_back( converter( point ) );
+  }
+
+  return polygonEpeck;
+}
+
+static Polygon_2 toEpick( const Polygon_2_Epeck& polygon ) {
+  EpeckEpickConverter converter;
+  Polygon_2 polygonEpick;
+
+  for( const auto& point : polygon ) {
+    polygonEpick.push_back( converter( point ) );
+  }
+
+  return polygonEpick;
+}
+
+static void addStripToPolygons( const CultivatedAreaStrip& strip, std::vector<Polygon_with_holes_2_Epeck>& polygons ) {
+  if( strip.left.size() < 2 || strip.right.size() < 2 ) {
+    return;
+  }
+
+  EpickEpeckConverter converter;
+
+  // the outline of the strip: along the left edge and back along the right edge
+  Polygon_2_Epeck polygon;
+
+  for( const auto& point : strip.left ) {
+    polygon.push_back( converter( point ) );
+  }
+
+  for( auto it = strip.right.crbegin(), end = strip.right.crend(); it != end; ++it ) {
+    polygon.push_back( converter( *it ) );
+  }
+
+  if( polygon.is_simple() ) {
+    if( polygon.is_clockwise_oriented() ) {
+      polygon.reverse_orientation();
+    }
+
+    polygons.emplace_back( polygon );
+  } else {
+    // the strip crosses itself (tight turns, reversing), so add the triangles of the strip one by one,
+    // in the same order as CultivatedAreaMeshGeometry::updateBuffers() creates them
+    auto addTriangle = [&polygons, &converter]( const Point_2 & a, const Point_2 & b, const Point_2 & c ) {
+      if( !CGAL::collinear( a, b, c ) ) {
+        Polygon_2_Epeck triangle;
+        triangle.push_back( converter( a ) );
+        triangle.push_back( converter( b ) );
+        triangle.push_back( converter( c ) );
+
+        if( triangle.is_clockwise_oriented() ) {
+          triangle.reverse_orientation();
+        }
+
+        polygons.emplace_back( triangle );
+      }
+    };
+
+    auto lastLeft = strip.left.cbegin();
+    auto lastRight = strip.right.cbegin();
+    auto itLeft = lastLeft + 1;
+    auto itRight = lastRight + 1;
+
+    while( ( itLeft != strip.left.cend() ) || ( itRight != strip.right.cend() ) ) {
+      if( itLeft != strip.left.cend() ) {
+        addTriangle( *itLeft, *lastLeft, *lastRight );
+        lastLeft = itLeft++;
+      }
+
+      if( itRight != strip.right.cend() ) {
+        addTriangle( *itRight, *lastLeft, *lastRight );
+        lastRight = itRight++;
+      }
+    }
+  }
+}
+
+static void markDomains( CDT& cdt, CDT::Face_handle start, const int index, std::list<CDT::Edge>& border ) {
+  if( start->info().nestingLevel != -1 ) {
+    return;
+  }
+
+  std::list<CDT::Face_handle> queue;
+  queue.push_back( start );
+
+  while( !queue.empty() ) {
+    auto face = queue.front();
+    queue.pop_front();
+
+    if( face->info().nestingLevel == -1 ) {
+      face->info().nestingLevel = index;
+
+      for( int i = 0; i < 3; ++i ) {
+        CDT::Edge edge( face, i );
+        auto neighbor = face->neighbor( i );
+
+        if( neighbor->info().nestingLevel == -1 ) {
+          if( cdt.is_constrained( edge ) ) {
+            border.push_back( edge );
+          } else {
+            queue.push_back( neighbor );
+          }
+        }
+      }
+    }
+  }
+}
+
+// mark the faces with their nesting level: the faces in the infinite face have 0, the faces inside
+// an outer boundary have 1, the faces in a hole 2 and so on; odd levels are inside of the polygons
+static void markDomains( CDT& cdt ) {
+  for( auto it = cdt.all_faces_begin(), end = cdt.all_faces_end(); it != end; ++it ) {
+    it->info().nestingLevel = -1;
+  }
+
+  std::list<CDT::Edge> border;
+  markDomains( cdt, cdt.infinite_face(), 0, border );
+
+  while( !border.empty() ) {
+    auto edge = border.front();
+    border.pop_front();
+
+    auto neighbor = edge.first->neighbor( edge.second );
+
+    if( neighbor->info().nestingLevel == -1 ) {
+      markDomains( cdt, neighbor, edge.first->info().nestingLevel + 1, border );
+    }
+  }
+}
+
+static void triangulatePolygons( const std::vector<Polygon_with_holes_2>& polygons, std::vector<Point_2>& vertices, std::vector<uint32_t>& indices ) {
+  CDT cdt;
+
+  for( const auto& polygon : polygons ) {
+    cdt.insert_constraint( polygon.outer_boundary().vertices_begin(), polygon.outer_boundary().vertices_end(), true );
+
+    for( auto hole = polygon.holes_begin(), end = polygon.holes_end(); hole != end; ++hole ) {
+      cdt.insert_constraint( hole->vertices_begin(), hole->vertices_end(), true );
+    }
+  }
+
+  markDomains( cdt );
+
+  vertices.clear();
+  vertices.reserve( cdt.number_of_vertices() );
+  indices.clear();
+  indices.reserve( cdt.number_of_faces() * 3 );
+
+  uint32_t index = 0;
+
+  for( auto it = cdt.finite_vertices_begin(), end = cdt.finite_vertices_end(); it != end; ++it ) {
+    it->info() = index++;
+    vertices.push_back( it->point() );
+  }
+
+  for( auto it = cdt.finite_faces_begin(), end = cdt.finite_faces_end(); it != end; ++it ) {
+    if( it->info().inDomain() ) {
+      indices.push_back( it->vertex( 0 )->info() );
+      indices.push_back( it->vertex( 1 )->info() );
+      indices.push_back( it->vertex( 2 )->info() );
+    }
+  }
+}
+
+struct CultivatedAreaExactSet {
+  Polygon_set_2_Epeck polygonSet;
+};
+
+void CgalWorker::unionCultivatedArea( const std::shared_ptr<CultivatedAreaUnion>& previousUnion, std::vector<CultivatedAreaStrip>* stripsPointer ) {
+  QScopedPointer<std::vector<CultivatedAreaStrip>> strips( stripsPointer );
+
+  auto cultivatedAreaUnion = std::make_shared<CultivatedAreaUnion>();
+
+  // only the new strips are joined into the kept exact union
+  if( previousUnion != nullptr && previousUnion->exactSet != nullptr ) {
+    cultivatedAreaUnion->exactSet = previousUnion->exactSet;
+  } else {
+    cultivatedAreaUnion->exactSet = std::make_shared<CultivatedAreaExactSet>();
+  }
+
+  std::vector<Polygon_with_holes_2_Epeck> polygons;
+
+  for( const auto& strip : *strips ) {
+    addStripToPolygons( strip, polygons );
+  }
+
+  auto& polygonSet = cultivatedAreaUnion->exactSet->polygonSet;
+  polygonSet.join( polygons.cbegin(), polygons.cend() );
+
+  std::vector<Polygon_with_holes_2_Epeck> unionPolygons;
+  polygonSet.polygons_with_holes( std::back_inserter( unionPolygons ) );
+
+  cultivatedAreaUnion->polygons.reserve( unionPolygons.size() );
+
+  // the area is calculated with the exact kernel; the holes are oriented clockwise and have a negative area
+  Epeck::FT area = 0;
+
+  for( const auto& polygon : unionPolygons ) {
+    area += polygon.outer_boundary().area();
+
+    std::vector<Polygon_2> holes;
+
+    for( auto hole = polygon.holes_begin(), end = polygon.holes_end(); hole != end; ++hole ) {
+      area += hole->area();
+      holes.push_back( toEpick( *hole ) );
+    }
+
+    cultivatedAreaUnion->polygons.emplace_back( toEpick( polygon.outer_boundary() ), holes.cbegin(), holes.cend() );
+  }
+
+  cultivatedAreaUnion->area = CGAL::to_double( area );
+
+  triangulatePolygons( cultivatedAreaUnion->polygons, cultivatedAreaUnion->vertices, cultivatedAreaUnion->indices );
+
+  // the coarse version drops all the vertices, that deviate less than the threshold from the boundaries;
+  // the constrained triangulation handles the intersections the simplification can introduce
+  {
+    constexpr double maxDeviationCoarse = 0.5;
+    PS::Squared_distance_cost cost;
+
+    std::vector<Polygon_with_holes_2> polygonsCoarse;
+    polygonsCoarse.reserve( cultivatedAreaUnion->polygons.size() );
+
+    for( const auto& polygon : cultivatedAreaUnion->polygons ) {
+      polygonsCoarse.push_back( PS::simplify( polygon, cost, PS::Stop_above_cost_threshold( maxDeviationCoarse * maxDeviationCoarse ) ) );
+    }
+
+    triangulatePolygons( polygonsCoarse, cultivatedAreaUnion->verticesCoarse, cultivatedAreaUnion->indicesCoarse );
+  }
+
+  Q_EMIT unionCultivatedAreaResult( cultivatedAreaUnion );
+}
+
 void CgalWorker::simplifyPolygon( Polygon_with_holes_2* out_poly, double maxDeviation, bool emitSignal ) {
   PS::Squared_distance_cost cost;
 
@@ -38,6 +38,33 @@ typedef CGAL::Delaunay_triangulation_2<Epick, ATds>
 typedef CGAL::Alpha_shape_2<ATriangulation_2, Alpha_cmp_tag>                      Alpha_shape_2;
 typedef Alpha_shape_2::Alpha_shape_edges_iterator                                 Alpha_shape_edges_iterator;
 
+// a finished strip of cultivated area, as recorded by the left and right edge of a section
+struct CultivatedAreaStrip {
+  std::vector<Point_2> left;
+  std::vector<Point_2> right;
+};
+
+// the exact polygon set of the union; only used by CgalWorker
+struct CultivatedAreaExactSet;
+
+// the union of all the strips, triangulated for rendering
+struct CultivatedAreaUnion {
+  std::vector<Polygon_with_holes_2> polygons;
+
+  // the next batch of strips is joined into it, so it is handed on to the next union; the unions are calculated one
+  // after the other
+  std::shared_ptr<CultivatedAreaExactSet> exactSet;
+
+  std::vector<Point_2> vertices;
+  std::vector<uint32_t> indices;
+
+  // simplified version for rendering when the camera is far away
+  std::vector<Point_2> verticesCoarse;
+  std::vector<uint32_t> indicesCoarse;
+
+  double area = 0;
+};
+
 class CgalWorker : public QObject {
     Q_OBJECT
   public:
@@ -57,6 +84,8 @@ class CgalWorker : public QObject {
     void simplifyPolygon( Polygon_with_holes_2* out_poly, const double maxDeviation, const bool emitSignal = false );
     void simplifyPolyline( std::vector<Point_2>* pointsPointer, const double maxDeviation );
 
+    void unionCultivatedArea( const std::shared_ptr<CultivatedAreaUnion>& previousUnion, std::vector<CultivatedAreaStrip>* stripsPointer );
+
   Q_SIGNALS:
     void alphaShapeFinished( std::shared_ptr<Polygon_with_holes_2>, const double );
     void alphaChanged( const double optimal, const double solid );
@@ -66,6 +95,7 @@ class CgalWorker : public QObject {
     void connectPointsResult( std::vector<Point_2>* );
     void simplifyPolygonResult( Polygon_with_holes_2* );
     void simplifyPolylineResult( std::vector<Point_2>* );
+    void unionCultivatedAreaResult( std::shared_ptr<CultivatedAreaUnion> );
 
   private:
     // form polygons from alpha shape
@@ -101,3 +131,5 @@ class CgalThread : public QThread {
 Q_DECLARE_METATYPE( FieldsOptimitionToolbar::AlphaType )
 Q_DECLARE_METATYPE( uint32_t )
 Q_DECLARE_METATYPE( std::shared_ptr<Polygon_with_holes_2> )
+Q_DECLARE_METATYPE( std::shared_ptr<CultivatedAreaUnion> )
+Q_DECLARE_METATYPE( std::vector<CultivatedAreaStrip>* )
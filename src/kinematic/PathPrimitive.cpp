@@ -67,6 +67,10 @@ void PathPrimitive::setSource( const Point_2 ) {}
 
 void PathPrimitive::setTarget( const Point_2 ) {}
 
+std::shared_ptr<PathPrimitive> PathPrimitive::createCopy() {
+  return nullptr;
+}
+
 std::shared_ptr<PathPrimitive> PathPrimitive::createReverse() {
   return nullptr;
 }
@@ -66,6 +66,7 @@ class PathPrimitive {
     virtual void setTarget( const Point_2 point );
     virtual void transform( const Aff_transformation_2& transformation ) = 0;
 
+    virtual std::shared_ptr<PathPrimitive> createCopy();
     virtual std::shared_ptr<PathPrimitive> createReverse();
     virtual std::shared_ptr<PathPrimitive> createNextPrimitive( const bool /*left*/ );
 
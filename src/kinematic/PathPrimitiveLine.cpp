@@ -31,6 +31,10 @@ bool PathPrimitiveLine::operator==( const PathPrimitiveLine& b ) const {
   return passNumber == b.passNumber;
 }
 
+std::shared_ptr<PathPrimitive> PathPrimitiveLine::createCopy() {
+  return std::make_shared<PathPrimitiveLine>( *this );
+}
+
 std::shared_ptr<PathPrimitive> PathPrimitiveLine::createReverse() {
   return std::make_shared<PathPrimitiveLine> (
                  line.opposite(),
@@ -46,6 +46,7 @@ class PathPrimitiveLine : public PathPrimitive {
 
     virtual void transform( const Aff_transformation_2& transformation ) override;
 
+    virtual std::shared_ptr<PathPrimitive> createCopy() override;
     virtual std::shared_ptr<PathPrimitive> createReverse() override;
     virtual std::shared_ptr<PathPrimitive> createNextPrimitive( const bool left ) override;
 
@@ -35,6 +35,10 @@ bool PathPrimitiveRay::operator==( const PathPrimitiveRay& b ) const {
   return ray == b.ray;
 }
 
+std::shared_ptr<PathPrimitive> PathPrimitiveRay::createCopy() {
+  return std::make_shared<PathPrimitiveRay>( *this );
+}
+
 std::shared_ptr<PathPrimitive> PathPrimitiveRay::createReverse() {
   return std::make_shared<PathPrimitiveRay> (
                  ray,
@@ -31,6 +31,10 @@ bool PathPrimitiveSegment::operator==( const PathPrimitiveSegment& b ) const {
   return segment == b.segment;
 }
 
+std::shared_ptr<PathPrimitive> PathPrimitiveSegment::createCopy() {
+  return std::make_shared<PathPrimitiveSegment>( *this );
+}
+
 std::shared_ptr<PathPrimitive> PathPrimitiveSegment::createReverse() {
   return std::make_shared<PathPrimitiveSegment> (
                  segment.opposite(),
@@ -48,6 +48,7 @@ class PathPrimitiveSegment : public PathPrimitive {
     virtual void setTarget( const Point_2 point ) override;
     virtual void transform( const Aff_transformation_2& transformation ) override;
 
+    virtual std::shared_ptr<PathPrimitive> createCopy() override;
     virtual std::shared_ptr<PathPrimitive> createReverse() override;
     virtual std::shared_ptr<PathPrimitive> createNextPrimitive( const bool left ) override;
 
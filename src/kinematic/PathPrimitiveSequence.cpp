@@ -94,6 +94,16 @@ void PathPrimitiveSequence::updateWithPolyline( const std::vector<Point_2>& poly
   orderBisectors( bisectors, sequence );
 }
 
+std::shared_ptr<PathPrimitive> PathPrimitiveSequence::createCopy() {
+  auto copy = std::make_shared<PathPrimitiveSequence>( *this );
+
+  for( auto& primitive : copy->sequence ) {
+    primitive = primitive->createCopy();
+  }
+
+  return copy;
+}
+
 std::shared_ptr<PathPrimitive> PathPrimitiveSequence::createReverse() {
   std::vector<std::shared_ptr<PathPrimitive>> sequenceNew;
   std::vector<Line_2> bisectorsNew;
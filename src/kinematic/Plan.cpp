@@ -20,22 +20,40 @@
 
 #include <QElapsedTimer>
 
+#include <atomic>
+
+namespace {
+  std::atomic<uint32_t> planVersionCounter = { 0 };
+}
+
 Plan::Plan() {
-  plan = std::make_shared<std::deque<std::shared_ptr<PathPrimitive>>>();
+  plan = std::make_shared<Primitives>();
 }
 
 Plan::Plan( const Plan::Type type )
   : type( type ) {
-  plan = std::make_shared<std::deque<std::shared_ptr<PathPrimitive>>>();
+  plan = std::make_shared<Primitives>();
+}
+
+void Plan::setPrimitives( std::shared_ptr<const Primitives> primitives ) {
+  plan = std::move( primitives );
+  version = ++planVersionCounter;
 }
 
 void Plan::transform( const Aff_transformation_2& transformation ) {
+  // the primitives of the current deque may be in use by other threads, so transform copies of them
+  auto primitives = std::make_shared<Primitives>();
+
   for( const auto& it : *plan ) {
-    it->transform( transformation );
+    auto primitive = it->createCopy();
+    primitive->transform( transformation );
+    primitives->push_back( std::move( primitive ) );
   }
+
+  setPrimitives( std::move( primitives ) );
 }
 
-Plan::ConstPrimitiveIterator Plan::getNearestPrimitive( Point_2 position2D, double& distanceSquared ) {
+Plan::ConstPrimitiveIterator Plan::getNearestPrimitive( Point_2 position2D, double& distanceSquared ) const {
 //        QElapsedTimer timer;
 //        timer.start();
   auto nearestPrimitive = plan->cend();
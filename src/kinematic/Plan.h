@@ -34,17 +34,34 @@ class Plan {
     Plan( const Type type );
 
   public:
+    typedef std::shared_ptr<PathPrimitive> PrimitiveSharedPointer;
+    typedef std::deque<PrimitiveSharedPointer> Primitives;
+
     Type type = Type::Mixed;
-    std::shared_ptr<std::deque<std::shared_ptr<PathPrimitive>>> plan;
 
-    typedef std::shared_ptr<PathPrimitive> PrimitiveSharedPointer;
-    typedef decltype( plan->begin() ) PrimitiveIterator;
+    // the primitives are shared between all the copies of a plan, which are handed to other blocks and threads;
+    // they are never changed in place, a change builds a new deque and publishes it with setPrimitives()
+    std::shared_ptr<const Primitives> plan;
+
     typedef decltype( plan->cbegin() ) ConstPrimitiveIterator;
 
   public:
     void transform( const Aff_transformation_2& transformation );
 
-    ConstPrimitiveIterator getNearestPrimitive( Point_2 position2D, double& distanceSquared );
+    std::shared_ptr<Primitives> copyOfPrimitives() const {
+      return std::make_shared<Primitives>( *plan );
+    }
+    void setPrimitives( std::shared_ptr<const Primitives> primitives );
+
+    // unique over all plans and copied along with the plan, so a receiver can tell whether the primitives changed
+    uint32_t getVersion() const {
+      return version;
+    }
+
+    ConstPrimitiveIterator getNearestPrimitive( Point_2 position2D, double& distanceSquared ) const;
+
+  private:
+    uint32_t version = 0;
 };
 
 Q_DECLARE_METATYPE( Plan )
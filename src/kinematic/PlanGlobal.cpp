@@ -22,41 +22,70 @@ PlanGlobal::PlanGlobal( const Plan::Type type )
   : Plan( type ) {}
 
 void PlanGlobal::resetPlanWith( const Plan::PrimitiveSharedPointer& referencePrimitive ) {
-  plan->clear();
-  plan->push_back( referencePrimitive );
+  auto primitives = std::make_shared<Primitives>();
+  primitives->push_back( referencePrimitive );
 
   for( std::size_t i = 0; i < pathsInReserve; ++i ) {
-    createNewPrimitiveOnTheLeft();
-    createNewPrimitiveOnTheRight();
+    addPrimitiveOnTheLeft( *primitives );
+    addPrimitiveOnTheRight( *primitives );
   }
+
+  setPrimitives( std::move( primitives ) );
 }
 
 void PlanGlobal::createNewPrimitiveOnTheLeft() {
   if( !plan->empty() ) {
-    plan->push_front( plan->front()->createNextPrimitive( true ) );
+    auto primitives = copyOfPrimitives();
+    addPrimitiveOnTheLeft( *primitives );
+    setPrimitives( std::move( primitives ) );
   }
 }
 
 void PlanGlobal::createNewPrimitiveOnTheRight() {
   if( !plan->empty() ) {
-    plan->push_back( plan->back()->createNextPrimitive( false ) );
+    auto primitives = copyOfPrimitives();
+    addPrimitiveOnTheRight( *primitives );
+    setPrimitives( std::move( primitives ) );
   }
 }
 
 void PlanGlobal::expand( Point_2 position2D ) {
   if( !plan->empty() ) {
+    auto needsExpansion = [this]( const Primitives & primitives, const Point_2 position2D ) {
+      return ( primitives.size() / 2 ) < pathsInReserve ||
+             ( *( primitives.cbegin() + pathsInReserve ) )->leftOf( position2D ) ||
+             !( *( primitives.cend() - 1 - pathsInReserve ) )->leftOf( position2D );
+    };
+
+    // this runs on every pose, so only copy the primitives if they really change
+    if( !needsExpansion( *plan, position2D ) ) {
+      return;
+    }
+
+    auto primitives = copyOfPrimitives();
+
     // make sure, at least pathsInReserve primitives exist on both sides of the reference
-    while( ( plan->size() / 2 ) < pathsInReserve ) {
-      createNewPrimitiveOnTheLeft();
-      createNewPrimitiveOnTheRight();
+    while( ( primitives->size() / 2 ) < pathsInReserve ) {
+      addPrimitiveOnTheLeft( *primitives );
+      addPrimitiveOnTheRight( *primitives );
     }
 
-    while( ( *( plan->cbegin() + pathsInReserve ) )->leftOf( position2D ) ) {
-      createNewPrimitiveOnTheLeft();
+    while( ( *( primitives->cbegin() + pathsInReserve ) )->leftOf( position2D ) ) {
+      addPrimitiveOnTheLeft( *primitives );
     }
 
-    while( !( *( plan->cend() - 1 - pathsInReserve ) )->leftOf( position2D ) ) {
-      createNewPrimitiveOnTheRight();
+    while( !( *( primitives->cend() - 1 - pathsInReserve ) )->leftOf( position2D ) ) {
+      addPrimitiveOnTheRight( *primitives );
     }
+
+    setPrimitives( std::move( primitives ) );
   }
 }
+
+void PlanGlobal::addPrimitiveOnTheLeft( Primitives& primitives ) {
+  primitives.push_front( primitives.front()->createNextPrimitive( true ) );
+}
+
+void PlanGlobal::addPrimitiveOnTheRight( Primitives& primitives ) {
+  primitives.push_back( primitives.back()->createNextPrimitive( false ) );
+}
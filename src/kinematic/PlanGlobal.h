@@ -34,6 +34,10 @@ class PlanGlobal : public Plan {
 
   public:
     std::size_t pathsInReserve = 3;
+
+  private:
+    static void addPrimitiveOnTheLeft( Primitives& primitives );
+    static void addPrimitiveOnTheRight( Primitives& primitives );
 };
 
 Q_DECLARE_METATYPE( PlanGlobal )
@@ -0,0 +1,312 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "SimulationCore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "helpers/anglesHelper.h"
+
+#include "kinematic/VehicleDynamics/TireLinear.h"
+#include "kinematic/VehicleDynamics/VehicleNonLinear3DOF.h"
+#include "kinematic/VehicleDynamics/VehicleNonLinear4DOF.h"
+
+SimulationCore::SimulationCore()
+  : inputQueue( 64 ), sampleQueue( 1024 ) {}
+
+SimulationCore::~SimulationCore() {
+  stop();
+}
+
+void SimulationCore::start( const State& initialState, const Inputs& inputs ) {
+  stop();
+
+  // the thread is joined, so the queues can be emptied from here
+  {
+    Inputs dummyInputs;
+    inputQueue.popLatest( dummyInputs );
+    Sample dummySample;
+    sampleQueue.popLatest( dummySample );
+  }
+
+  ++pacingVersion;
+  running = true;
+  thread = std::thread( &SimulationCore::run, this, initialState, inputs, m_stepSize.load() );
+}
+
+void SimulationCore::stop() {
+  running = false;
+
+  if( thread.joinable() ) {
+    thread.join();
+  }
+}
+
+bool SimulationCore::isRunning() const {
+  return running.load();
+}
+
+void SimulationCore::setInputs( const Inputs& inputs ) {
+  // the simulation thread takes the newest value every step, so the queue is only full while it is
+  // stopped; start() gets the inputs directly in that case
+  inputQueue.push( inputs );
+}
+
+void SimulationCore::setIntegrator( const Integrator integrator ) {
+  m_integrator = integrator;
+}
+
+SimulationCore::Integrator SimulationCore::integrator() const {
+  return m_integrator.load();
+}
+
+void SimulationCore::setMode( const Mode mode, const double timeFactor ) {
+  m_mode = mode;
+  m_timeFactor = std::max( timeFactor, 0.001 );
+  ++pacingVersion;
+}
+
+SimulationCore::Mode SimulationCore::mode() const {
+  return m_mode.load();
+}
+
+double SimulationCore::timeFactor() const {
+  return m_timeFactor.load();
+}
+
+void SimulationCore::setVehicleModel( const VehicleModel vehicleModel ) {
+  if( running.load() ) {
+    return;
+  }
+
+  m_vehicleModel = vehicleModel;
+  vehicle.reset();
+  frontTires = {};
+  rearTires = {};
+
+  switch( vehicleModel ) {
+    case VehicleModel::NonLinear3DOF: {
+      frontTires[0] = new VehicleDynamics::TireLinear();
+      rearTires[0] = new VehicleDynamics::TireLinear();
+      vehicle = std::make_unique<VehicleDynamics::VehicleNonLinear3DOF>( frontTires[0], rearTires[0] );
+    }
+    break;
+
+    case VehicleModel::NonLinear4DOF: {
+      frontTires = { new VehicleDynamics::TireLinear(), new VehicleDynamics::TireLinear() };
+      rearTires = { new VehicleDynamics::TireLinear(), new VehicleDynamics::TireLinear() };
+      vehicle = std::make_unique<VehicleDynamics::VehicleNonLinear4DOF>( frontTires[0], frontTires[1], rearTires[0], rearTires[1] );
+    }
+    break;
+
+    default:
+      break;
+  }
+}
+
+SimulationCore::VehicleModel SimulationCore::vehicleModel() const {
+  return m_vehicleModel;
+}
+
+void SimulationCore::setStepSize( const double stepSize ) {
+  if( stepSize > 0 ) {
+    m_stepSize = stepSize;
+  }
+}
+
+double SimulationCore::stepSize() const {
+  return m_stepSize.load();
+}
+
+void SimulationCore::setPublishInterval( const double interval ) {
+  m_publishInterval = interval;
+}
+
+double SimulationCore::publishInterval() const {
+  return m_publishInterval.load();
+}
+
+bool SimulationCore::popSample( Sample& sample ) {
+  return sampleQueue.pop( sample );
+}
+
+void SimulationCore::run( State state, Inputs inputs, const double stepSize ) {
+  using Clock = std::chrono::steady_clock;
+
+  uint64_t step = 0;
+  uint64_t nextPublishStep = 0;
+
+  auto referenceTime = Clock::now();
+  uint64_t referenceStep = 0;
+  uint32_t currentPacingVersion = pacingVersion.load();
+
+  systemModel.applyInputs( state, inputs.velocity, inputs.steerAngle, inputs.a, inputs.b );
+
+  while( running.load( std::memory_order_relaxed ) ) {
+    inputQueue.popLatest( inputs );
+
+    if( step >= nextPublishStep ) {
+      Sample sample;
+      sample.step = step;
+      sample.time = double( step ) * stepSize;
+      sample.inputs = inputs;
+      sample.state = state;
+
+      // wait for the consumer instead of dropping samples: the published results stay the same for every run
+      while( !sampleQueue.push( sample ) ) {
+        if( !running.load( std::memory_order_relaxed ) ) {
+          return;
+        }
+
+        std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+      }
+
+      nextPublishStep = step + std::max<uint64_t>( 1, uint64_t( std::llround( m_publishInterval.load( std::memory_order_relaxed ) / stepSize ) ) );
+    }
+
+    integrate( state, inputs, stepSize, m_integrator.load( std::memory_order_relaxed ) );
+    ++step;
+
+    // pace the logical clock against the wall clock; a change of the mode starts a new reference
+    // so switching from a fast mode doesn't stall and switching to one doesn't catch up
+    if( pacingVersion.load( std::memory_order_relaxed ) != currentPacingVersion ) {
+      currentPacingVersion = pacingVersion.load();
+      referenceTime = Clock::now();
+      referenceStep = step;
+    }
+
+    const auto mode = m_mode.load( std::memory_order_relaxed );
+
+    if( mode != Mode::AsFastAsPossible ) {
+      const double factor = ( mode == Mode::Accelerated ) ? m_timeFactor.load( std::memory_order_relaxed ) : 1.;
+      const auto target = referenceTime +
+                          std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( double( step - referenceStep ) * stepSize / factor ) );
+
+      if( target > Clock::now() ) {
+        std::this_thread::sleep_until( target );
+      }
+    }
+  }
+}
+
+void SimulationCore::integrate( State& state, const Inputs& inputs, const double stepSize, const Integrator integrator ) {
+  // the slip angles of the nonlinear models are not defined for standstill and driving backwards,
+  // so the kinematic part of the model of Pearson is used there like in predict()
+  if( vehicle && inputs.velocity > 0.1 ) {
+    stepVehicle( state, inputs, stepSize );
+    return;
+  }
+
+  switch( integrator ) {
+    case Integrator::Euler: {
+      State k1;
+      derivative( state, inputs, k1 );
+      state += stepSize * k1;
+    }
+    break;
+
+    case Integrator::RungeKutta4: {
+      State k1, k2, k3, k4, buffer;
+
+      derivative( state, inputs, k1 );
+
+      buffer = state + ( stepSize / 2 ) * k1;
+      systemModel.applyInputs( buffer, inputs.velocity, inputs.steerAngle, inputs.a, inputs.b );
+      derivative( buffer, inputs, k2 );
+
+      buffer = state + ( stepSize / 2 ) * k2;
+      systemModel.applyInputs( buffer, inputs.velocity, inputs.steerAngle, inputs.a, inputs.b );
+      derivative( buffer, inputs, k3 );
+
+      buffer = state + stepSize * k3;
+      systemModel.applyInputs( buffer, inputs.velocity, inputs.steerAngle, inputs.a, inputs.b );
+      derivative( buffer, inputs, k4 );
+
+      state += ( stepSize / 6 ) * ( k1 + 2 * k2 + 2 * k3 + k4 );
+    }
+    break;
+  }
+
+  systemModel.applyInputs( state, inputs.velocity, inputs.steerAngle, inputs.a, inputs.b );
+
+  state( ThreeWheeledFRHRL::StateNames::Yaw ) = normalizeAngleRadians( state( ThreeWheeledFRHRL::StateNames::Yaw ) );
+  state( ThreeWheeledFRHRL::StateNames::Roll ) = normalizeAngleRadians( state( ThreeWheeledFRHRL::StateNames::Roll ) );
+  state( ThreeWheeledFRHRL::StateNames::Pitch ) = normalizeAngleRadians( state( ThreeWheeledFRHRL::StateNames::Pitch ) );
+  state( ThreeWheeledFRHRL::StateNames::AlphaFront ) = normalizeAngleRadians( state( ThreeWheeledFRHRL::StateNames::AlphaFront ) );
+  state( ThreeWheeledFRHRL::StateNames::AlphaRear ) = normalizeAngleRadians( state( ThreeWheeledFRHRL::StateNames::AlphaRear ) );
+  state( ThreeWheeledFRHRL::StateNames::AlphaHitch ) = normalizeAngleRadians( state( ThreeWheeledFRHRL::StateNames::AlphaHitch ) );
+}
+
+void SimulationCore::derivative( const State& state, const Inputs& inputs, State& dxdt ) {
+  systemModel.derivative( state,
+                    inputs.velocity, inputs.steerAngle,
+                    inputs.a, inputs.b, inputs.c,
+                    inputs.Caf, inputs.Car, inputs.Cah,
+                    inputs.m, inputs.Iz,
+                    inputs.sigmaF, inputs.sigmaR, inputs.sigmaH,
+                    inputs.Cx, inputs.slipX,
+                    dxdt );
+}
+
+void SimulationCore::stepVehicle( State& state, const Inputs& inputs, const double stepSize ) {
+  const double wheelbase = inputs.a + inputs.b;
+  vehicle->wheelBase = wheelbase;
+  vehicle->massFrontAxle = inputs.m * inputs.b / wheelbase;
+  vehicle->massRearAxle = inputs.m * inputs.a / wheelbase;
+  vehicle->momentOfInertia = inputs.Iz;
+
+  // the cornering stiffness of an axle is split on the tires of both sides
+  for( auto* tire : frontTires ) {
+    if( tire ) {
+      tire->Cy = inputs.Caf / 2;
+    }
+  }
+
+  for( auto* tire : rearTires ) {
+    if( tire ) {
+      tire->Cy = inputs.Car / 2;
+    }
+  }
+
+  // the state of the simulator is the only state, so every step starts from it and the models stay
+  // exchangeable; the velocity is an input like for the model of Pearson
+  VehicleDynamics::Vehicle::CommonState commonState;
+  commonState.x = state( ThreeWheeledFRHRL::StateNames::X );
+  commonState.y = state( ThreeWheeledFRHRL::StateNames::Y );
+  commonState.psi = state( ThreeWheeledFRHRL::StateNames::Yaw );
+  commonState.theta = state( ThreeWheeledFRHRL::StateNames::Roll );
+  commonState.v = inputs.velocity;
+  commonState.alphaT = std::atan2( state( ThreeWheeledFRHRL::StateNames::Vy ), std::max( state( ThreeWheeledFRHRL::StateNames::Vx ), 0.1 ) );
+  commonState.dPsi = state( ThreeWheeledFRHRL::StateNames::Vyaw );
+  commonState.dTheta = state( ThreeWheeledFRHRL::StateNames::Vroll );
+
+  vehicle->setCommonState( commonState );
+  vehicle->step( stepSize, inputs.steerAngle, 0, 0, 0, 0 );
+  commonState = vehicle->getCommonState();
+
+  state( ThreeWheeledFRHRL::StateNames::X ) = commonState.x;
+  state( ThreeWheeledFRHRL::StateNames::Y ) = commonState.y;
+  state( ThreeWheeledFRHRL::StateNames::Yaw ) = normalizeAngleRadians( commonState.psi );
+  state( ThreeWheeledFRHRL::StateNames::Roll ) = normalizeAngleRadians( commonState.theta );
+  state( ThreeWheeledFRHRL::StateNames::Vx ) = inputs.velocity * std::cos( commonState.alphaT );
+  state( ThreeWheeledFRHRL::StateNames::Vy ) = inputs.velocity * std::sin( commonState.alphaT );
+  state( ThreeWheeledFRHRL::StateNames::Vyaw ) = commonState.dPsi;
+  state( ThreeWheeledFRHRL::StateNames::Vroll ) = commonState.dTheta;
+}
@@ -0,0 +1,166 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "helpers/SpscQueue.h"
+
+#include "filter/3wFRHRL/SystemModel.h"
+
+namespace VehicleDynamics {
+  class Vehicle;
+  class TireLinear;
+}
+
+// fixed-step integration of the vehicle model on its own thread
+//
+// the simulated time is a logical clock (steps * step size), so a run with the same inputs gives
+// the same results regardless of the load of the machine or the chosen mode; the mode only decides
+// how the logical clock is paced against the wall clock
+class SimulationCore {
+  public:
+    template <typename T_> using StateType = ThreeWheeledFRHRL::State<T_>;
+    using State = StateType<double>;
+
+    enum class Integrator : uint8_t {
+      Euler = 0,
+      RungeKutta4
+    };
+
+    // ThreeWheeled: model of Pearson with hitch (ThreeWheeledFRHRL); the others are the models of
+    // VehicleDynamics with linear tires and forward Euler, independent of the chosen integrator
+    enum class VehicleModel : uint8_t {
+      ThreeWheeled = 0,
+      NonLinear3DOF,
+      NonLinear4DOF
+    };
+
+    enum class Mode : uint8_t {
+      RealTime = 0,
+      Accelerated,
+      AsFastAsPossible
+    };
+
+    // angles in rad, Caf, Car, Cah and Cx in N/rad
+    struct Inputs {
+      double velocity = 0;
+      double steerAngle = 0;
+
+      double a = 1;
+      double b = 2;
+      double c = 2.5;
+      double Caf = 2400 * 180 / M_PI;
+      double Car = 5000 * 180 / M_PI;
+      double Cah = 750 * 180 / M_PI;
+      double m = 5500;
+      double Iz = 9500;
+      double sigmaF = 0.34;
+      double sigmaR = 0.34;
+      double sigmaH = 0.40;
+      double Cx = 5000 * 180 / M_PI;
+      double slipX = 0.025;
+    };
+
+    struct Sample {
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+      uint64_t step = 0;
+      double time = 0;
+      Inputs inputs;
+      State state;
+    };
+
+  public:
+    SimulationCore();
+    ~SimulationCore();
+
+    SimulationCore( const SimulationCore& ) = delete;
+    SimulationCore& operator=( const SimulationCore& ) = delete;
+
+    // starts a new run at simulated time 0
+    void start( const State& initialState, const Inputs& inputs );
+    void stop();
+    bool isRunning() const;
+
+    // thread safe, used from the next step on
+    void setInputs( const Inputs& inputs );
+
+    void setIntegrator( const Integrator integrator );
+    Integrator integrator() const;
+
+    // timeFactor is only used in Mode::Accelerated
+    void setMode( const Mode mode, const double timeFactor = 1 );
+    Mode mode() const;
+    double timeFactor() const;
+
+    // only while stopped
+    void setVehicleModel( const VehicleModel vehicleModel );
+    VehicleModel vehicleModel() const;
+
+    // whether the model is stepped by the chosen integrator at all
+    static bool usesIntegrator( const VehicleModel vehicleModel ) {
+      return vehicleModel == VehicleModel::ThreeWheeled;
+    }
+
+    // used from the next call of start() on
+    void setStepSize( const double stepSize );
+    double stepSize() const;
+
+    // a sample is published every interval of simulated time
+    void setPublishInterval( const double interval );
+    double publishInterval() const;
+
+    // consumer side of the sample queue
+    bool popSample( Sample& sample );
+
+    // one step of the integrator; can be used synchronously without starting the thread
+    void integrate( State& state, const Inputs& inputs, const double stepSize, const Integrator integrator );
+
+  private:
+    void run( State state, Inputs inputs, const double stepSize );
+    void derivative( const State& state, const Inputs& inputs, State& dxdt );
+    void stepVehicle( State& state, const Inputs& inputs, const double stepSize );
+
+  private:
+    std::thread thread;
+    std::atomic<bool> running = { false };
+
+    std::atomic<Integrator> m_integrator = { Integrator::RungeKutta4 };
+    std::atomic<Mode> m_mode = { Mode::RealTime };
+    std::atomic<double> m_timeFactor = { 1 };
+    std::atomic<uint32_t> pacingVersion = { 0 };
+    std::atomic<double> m_stepSize = { 0.001 };
+    std::atomic<double> m_publishInterval = { 0.05 };
+
+    SpscQueue<Inputs> inputQueue;
+    SpscQueue<Sample> sampleQueue;
+
+    ThreeWheeledFRHRL::TractorImuGpsFusionModel<StateType> systemModel;
+
+    VehicleModel m_vehicleModel = VehicleModel::ThreeWheeled;
+    std::unique_ptr<VehicleDynamics::Vehicle> vehicle;
+    // owned by vehicle; the second tire of an axle is nullptr for the models with one tire per axle
+    std::array<VehicleDynamics::TireLinear*, 2> frontTires = {};
+    std::array<VehicleDynamics::TireLinear*, 2> rearTires = {};
+};
@@ -0,0 +1,266 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "Terrain.h"
+#include "TerrainMesh.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+// tolerance for points on the edges, so they are found in both faces
+static constexpr double EdgeTolerance = 1e-9;
+
+bool Terrain::Face::contains( const double x, const double y ) const {
+  return ( ( edges[0][0] * x + edges[0][1] * y + edges[0][2] ) >= -EdgeTolerance ) &&
+         ( ( edges[1][0] * x + edges[1][1] * y + edges[1][2] ) >= -EdgeTolerance ) &&
+         ( ( edges[2][0] * x + edges[2][1] * y + edges[2][2] ) >= -EdgeTolerance );
+}
+
+void Terrain::setTriangles( const TerrainMesh& mesh ) {
+  setTriangles( mesh.vertices, mesh.indices );
+}
+
+void Terrain::setTriangles( const std::vector<Eigen::Vector3d>& vertices, const std::vector<uint32_t>& indices ) {
+  clear();
+
+  faces.reserve( indices.size() / 3 );
+
+  // the bounding boxes of the faces for the index: xMin, yMin, xMax, yMax
+  std::vector<std::array<double, 4>> faceBoxes;
+  faceBoxes.reserve( indices.size() / 3 );
+
+  double xMin = std::numeric_limits<double>::max();
+  double yMin = std::numeric_limits<double>::max();
+  double xMax = std::numeric_limits<double>::lowest();
+  double yMax = std::numeric_limits<double>::lowest();
+
+  for( std::size_t i = 0; ( i + 2 ) < indices.size(); i += 3 ) {
+    Eigen::Vector3d points[] = { vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]] };
+
+    // counterclockwise in the XY-plane, so the normal points up
+    const double doubleArea = ( points[1].x() - points[0].x() ) * ( points[2].y() - points[0].y() ) -
+                              ( points[2].x() - points[0].x() ) * ( points[1].y() - points[0].y() );
+
+    if( std::abs( doubleArea ) < 1e-12 ) {
+      continue;
+    }
+
+    if( doubleArea < 0 ) {
+      std::swap( points[1], points[2] );
+    }
+
+    Face face;
+
+    const Eigen::Vector3d normal = ( points[1] - points[0] ).cross( points[2] - points[0] );
+    face.planeA = -normal.x() / normal.z();
+    face.planeB = -normal.y() / normal.z();
+    face.planeC = points[0].z() + ( normal.x() * points[0].x() + normal.y() * points[0].y() ) / normal.z();
+
+    for( int edge = 0; edge < 3; ++edge ) {
+      const auto& from = points[edge];
+      const auto& to = points[( edge + 1 ) % 3];
+      const double dx = to.x() - from.x();
+      const double dy = to.y() - from.y();
+      const double length = std::sqrt( dx * dx + dy * dy );
+
+      face.edges[edge][0] = -dy / length;
+      face.edges[edge][1] = dx / length;
+      face.edges[edge][2] = ( dy * from.x() - dx * from.y() ) / length;
+    }
+
+    face.orientation = Eigen::Quaterniond::FromTwoVectors( Eigen::Vector3d::UnitZ(), normal );
+
+    faces.push_back( face );
+
+    std::array<double, 4> faceBox = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                                      std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()
+                                    };
+
+    for( const auto& point : points ) {
+      faceBox[0] = std::min( faceBox[0], point.x() );
+      faceBox[1] = std::min( faceBox[1], point.y() );
+      faceBox[2] = std::max( faceBox[2], point.x() );
+      faceBox[3] = std::max( faceBox[3], point.y() );
+    }
+
+    faceBoxes.push_back( faceBox );
+
+    xMin = std::min( xMin, faceBox[0] );
+    yMin = std::min( yMin, faceBox[1] );
+    xMax = std::max( xMax, faceBox[2] );
+    yMax = std::max( yMax, faceBox[3] );
+  }
+
+  if( faces.empty() ) {
+    return;
+  }
+
+  // about one face per cell
+  originX = xMin;
+  originY = yMin;
+  cellSize = std::max( std::sqrt( ( ( xMax - xMin ) * ( yMax - yMin ) ) / double( faces.size() ) ), 0.01 );
+  columns = uint32_t( std::floor( ( xMax - xMin ) / cellSize ) ) + 1;
+  rows = uint32_t( std::floor( ( yMax - yMin ) / cellSize ) ) + 1;
+
+  // add every face to all the cells its bounding box touches, counting first and filling second
+  auto forEachCellOfFace = [this]( const std::array<double, 4>& faceBox, const auto & function ) {
+    const auto columnMin = uint32_t( std::clamp( std::floor( ( faceBox[0] - originX ) / cellSize ), 0., double( columns - 1 ) ) );
+    const auto columnMax = uint32_t( std::clamp( std::floor( ( faceBox[2] - originX ) / cellSize ), 0., double( columns - 1 ) ) );
+    const auto rowMin = uint32_t( std::clamp( std::floor( ( faceBox[1] - originY ) / cellSize ), 0., double( rows - 1 ) ) );
+    const auto rowMax = uint32_t( std::clamp( std::floor( ( faceBox[3] - originY ) / cellSize ), 0., double( rows - 1 ) ) );
+
+    for( uint32_t row = rowMin; row <= rowMax; ++row ) {
+      for( uint32_t column = columnMin; column <= columnMax; ++column ) {
+        function( row * columns + column );
+      }
+    }
+  };
+
+  cellStart.assign( std::size_t( columns ) * rows + 1, 0 );
+
+  for( const auto& faceBox : faceBoxes ) {
+    forEachCellOfFace( faceBox, [this]( const uint32_t cell ) {
+      ++cellStart[cell + 1];
+    } );
+  }
+
+  for( std::size_t i = 1; i < cellStart.size(); ++i ) {
+    cellStart[i] += cellStart[i - 1];
+  }
+
+  cellFaces.resize( cellStart.back() );
+  std::vector<uint32_t> cellFill( cellStart.cbegin(), cellStart.cend() - 1 );
+
+  for( uint32_t i = 0, end = uint32_t( faces.size() ); i < end; ++i ) {
+    forEachCellOfFace( faceBoxes[i], [this, &cellFill, i]( const uint32_t cell ) {
+      cellFaces[cellFill[cell]++] = i;
+    } );
+  }
+
+  type = Type::Triangles;
+}
+
+void Terrain::setRaster( const double originX, const double originY, const double cellSize,
+                         const uint32_t columns, const uint32_t rows, std::vector<double>&& heights ) {
+  clear();
+
+  if( columns < 2 || rows < 2 || heights.size() < std::size_t( columns ) * rows || cellSize <= 0 ) {
+    return;
+  }
+
+  this->originX = originX;
+  this->originY = originY;
+  this->cellSize = cellSize;
+  this->columns = columns;
+  this->rows = rows;
+  this->heights = std::move( heights );
+
+  type = Type::Raster;
+}
+
+void Terrain::clear() {
+  type = Type::None;
+  faces.clear();
+  cellStart.clear();
+  cellFaces.clear();
+  heights.clear();
+  lastFace = 0;
+  columns = 0;
+  rows = 0;
+}
+
+bool Terrain::isEmpty() const {
+  return type == Type::None;
+}
+
+bool Terrain::lookup( const double x, const double y, double& height, Eigen::Quaterniond& orientation ) const {
+  switch( type ) {
+    case Type::Triangles:
+      return lookupTriangles( x, y, height, orientation );
+
+    case Type::Raster:
+      return lookupRaster( x, y, height, orientation );
+
+    default:
+      return false;
+  }
+}
+
+bool Terrain::lookupTriangles( const double x, const double y, double& height, Eigen::Quaterniond& orientation ) const {
+  auto found = [&]( const Face & face ) {
+    height = face.planeA * x + face.planeB * y + face.planeC;
+    orientation = face.orientation;
+  };
+
+  if( faces[lastFace].contains( x, y ) ) {
+    found( faces[lastFace] );
+    return true;
+  }
+
+  const double column = std::floor( ( x - originX ) / cellSize );
+  const double row = std::floor( ( y - originY ) / cellSize );
+
+  if( column < 0 || row < 0 || column >= columns || row >= rows ) {
+    return false;
+  }
+
+  const auto cell = uint32_t( row ) * columns + uint32_t( column );
+
+  for( uint32_t i = cellStart[cell], end = cellStart[cell + 1]; i < end; ++i ) {
+    const auto& face = faces[cellFaces[i]];
+
+    if( face.contains( x, y ) ) {
+      lastFace = cellFaces[i];
+      found( face );
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool Terrain::lookupRaster( const double x, const double y, double& height, Eigen::Quaterniond& orientation ) const {
+  const double columnFloat = ( x - originX ) / cellSize;
+  const double rowFloat = ( y - originY ) / cellSize;
+
+  if( columnFloat < 0 || rowFloat < 0 || columnFloat > ( columns - 1 ) || rowFloat > ( rows - 1 ) ) {
+    return false;
+  }
+
+  const auto column = std::min( uint32_t( columnFloat ), columns - 2 );
+  const auto row = std::min( uint32_t( rowFloat ), rows - 2 );
+  const double tx = columnFloat - column;
+  const double ty = rowFloat - row;
+
+  const auto index = std::size_t( row ) * columns + column;
+  const double h00 = heights[index];
+  const double h10 = heights[index + 1];
+  const double h01 = heights[index + columns];
+  const double h11 = heights[index + columns + 1];
+
+  height = ( h00 * ( 1 - tx ) + h10 * tx ) * ( 1 - ty ) + ( h01 * ( 1 - tx ) + h11 * tx ) * ty;
+
+  // the normal from the gradient of the bilinear patch
+  const double dzdx = ( ( h10 - h00 ) * ( 1 - ty ) + ( h11 - h01 ) * ty ) / cellSize;
+  const double dzdy = ( ( h01 - h00 ) * ( 1 - tx ) + ( h11 - h10 ) * tx ) / cellSize;
+  orientation = Eigen::Quaterniond::FromTwoVectors( Eigen::Vector3d::UnitZ(), Eigen::Vector3d( -dzdx, -dzdy, 1 ) );
+
+  return true;
+}
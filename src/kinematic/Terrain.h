@@ -0,0 +1,88 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "helpers/eigenHelper.h"
+
+struct TerrainMesh;
+
+// flat representation of the terrain for fast lookups of the height and the orientation of the ground:
+// either a triangulated irregular network with precomputed planes and a uniform grid index,
+// or a raster (DEM) with bilinear interpolation
+class Terrain {
+  public:
+    Terrain() = default;
+
+    // the indices are three per triangle; degenerated triangles are skipped
+    void setTriangles( const std::vector<Eigen::Vector3d>& vertices, const std::vector<uint32_t>& indices );
+    void setTriangles( const TerrainMesh& mesh );
+
+    // the heights are row by row, starting with the row at originY
+    void setRaster( const double originX, const double originY, const double cellSize,
+                    const uint32_t columns, const uint32_t rows, std::vector<double>&& heights );
+
+    void clear();
+    bool isEmpty() const;
+
+    // returns false, if the point is outside the terrain
+    bool lookup( const double x, const double y, double& height, Eigen::Quaterniond& orientation ) const;
+
+  private:
+    bool lookupTriangles( const double x, const double y, double& height, Eigen::Quaterniond& orientation ) const;
+    bool lookupRaster( const double x, const double y, double& height, Eigen::Quaterniond& orientation ) const;
+
+    struct Face {
+      bool contains( const double x, const double y ) const;
+
+      // the plane: z = planeA * x + planeB * y + planeC
+      double planeA = 0;
+      double planeB = 0;
+      double planeC = 0;
+
+      // the signed distance to the edges: a * x + b * y + c; positive inside
+      double edges[3][3] = {};
+
+      Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();
+    };
+
+    enum class Type : uint8_t {
+      None,
+      Triangles,
+      Raster
+    } type = Type::None;
+
+    // the grid of the index or the raster
+    double originX = 0;
+    double originY = 0;
+    double cellSize = 1;
+    uint32_t columns = 0;
+    uint32_t rows = 0;
+
+    std::vector<Face> faces;
+    // the faces of cell i are cellFaces[cellStart[i]] to cellFaces[cellStart[i + 1] - 1]
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellFaces;
+    // the vehicle moves slowly, so the last found face is the first one to test
+    mutable uint32_t lastFace = 0;
+
+    std::vector<double> heights;
+};
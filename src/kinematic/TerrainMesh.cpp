@@ -0,0 +1,119 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "TerrainMesh.h"
+
+#include <algorithm>
+#include <thread>
+
+// splits [0, count) into one contiguous range per thread; the ranges write into disjoint parts of the outputs
+template<typename Function>
+static void parallelForRanges( const std::size_t count, unsigned int threads, const Function& function ) {
+  if( threads == 0 ) {
+    threads = std::max( std::thread::hardware_concurrency(), 1u );
+  }
+
+  // small meshes aren't worth the threads
+  constexpr std::size_t minimalRange = 4096;
+  threads = unsigned( std::max<std::size_t>( std::min<std::size_t>( threads, count / minimalRange ), 1 ) );
+
+  if( threads == 1 ) {
+    function( 0, count );
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve( threads );
+
+  const std::size_t rangeSize = ( count + threads - 1 ) / threads;
+
+  for( std::size_t begin = 0; begin < count; begin += rangeSize ) {
+    workers.emplace_back( function, begin, std::min( begin + rangeSize, count ) );
+  }
+
+  for( auto& worker : workers ) {
+    worker.join();
+  }
+}
+
+void TerrainMesh::computeNormals( const unsigned int threads ) {
+  const std::size_t numFaces = indices.size() / 3;
+  const std::size_t numVertices = vertices.size();
+
+  // the cross product has the length of the double area, so summing them up weights the faces by their area
+  std::vector<Eigen::Vector3d> faceNormals( numFaces );
+  parallelForRanges( numFaces, threads, [&]( const std::size_t begin, const std::size_t end ) {
+    for( std::size_t face = begin; face < end; ++face ) {
+      const auto& p0 = vertices[indices[face * 3]];
+      const auto& p1 = vertices[indices[face * 3 + 1]];
+      const auto& p2 = vertices[indices[face * 3 + 2]];
+
+      faceNormals[face] = ( p1 - p0 ).cross( p2 - p0 );
+
+      // the terrain is seen from above
+      if( faceNormals[face].z() < 0 ) {
+        faceNormals[face] = -faceNormals[face];
+      }
+    }
+  } );
+
+  // the faces around each vertex as a compressed adjacency list, so the vertices can be summed up in parallel
+  // without writing to shared data
+  std::vector<uint32_t> adjacencyOffsets( numVertices + 1, 0 );
+
+  for( const auto index : indices ) {
+    ++adjacencyOffsets[index + 1];
+  }
+
+  for( std::size_t i = 1; i < adjacencyOffsets.size(); ++i ) {
+    adjacencyOffsets[i] += adjacencyOffsets[i - 1];
+  }
+
+  std::vector<uint32_t> adjacentFaces( adjacencyOffsets.back() );
+  {
+    std::vector<uint32_t> fill( adjacencyOffsets.cbegin(), adjacencyOffsets.cend() - 1 );
+
+    for( std::size_t i = 0; i < numFaces * 3; ++i ) {
+      adjacentFaces[fill[indices[i]]++] = uint32_t( i / 3 );
+    }
+  }
+
+  normals.resize( numVertices );
+  parallelForRanges( numVertices, threads, [&]( const std::size_t begin, const std::size_t end ) {
+    for( std::size_t vertex = begin; vertex < end; ++vertex ) {
+      Eigen::Vector3d normal( 0, 0, 0 );
+
+      for( auto i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; ++i ) {
+        normal += faceNormals[adjacentFaces[i]];
+      }
+
+      if( normal.squaredNorm() > 0 ) {
+        normals[vertex] = normal.normalized().cast<float>();
+      } else {
+        normals[vertex] = Eigen::Vector3f( 0, 0, 1 );
+      }
+    }
+  } );
+}
+
+void TerrainMesh::clear() {
+  vertices.clear();
+  indices.clear();
+  edges.clear();
+  normals.clear();
+}
@@ -0,0 +1,43 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "helpers/eigenHelper.h"
+
+// indexed triangle mesh of the terrain with shared vertices; the same data feeds the rendering and the lookups
+// in Terrain, so a TIN is only compiled once
+struct TerrainMesh {
+  // counterclockwise in the XY-plane, three indices per face
+  std::vector<Eigen::Vector3d> vertices;
+  std::vector<uint32_t> indices;
+
+  // two indices per edge, each edge once
+  std::vector<uint32_t> edges;
+
+  // the area weighted normals of the faces around a vertex, normalised; filled by computeNormals()
+  std::vector<Eigen::Vector3f> normals;
+
+  // with threads = 0, all hardware threads are used
+  void computeNormals( unsigned int threads = 0 );
+
+  void clear();
+};
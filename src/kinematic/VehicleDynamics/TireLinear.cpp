@@ -20,8 +20,6 @@
 
 #include "TireLinear.h"
 
-#include <iostream>
-
 double VehicleDynamics::TireLinear::characteristic( double alpha, double, double ) {
   double ret = - Cy * alpha;
 
@@ -33,6 +31,5 @@ double VehicleDynamics::TireLinear::characteristic( double alpha, double, double
   //          ret = -5000;
   //        }
 
-  std::cout << "Tire " << this << " Alpha: " << alpha << ", Fy: " << ret << std::endl;
   return ret;
 }
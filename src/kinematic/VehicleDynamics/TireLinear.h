@@ -29,7 +29,7 @@ namespace VehicleDynamics {
       TireLinear( double Cy ): Cy( Cy ) {}
       virtual ~TireLinear() {}
 
-      virtual double characteristic( double alpha, double, double );
+      virtual double characteristic( double alpha, double, double ) override;
 
       double Cy = 2400 * 180 / M_PI;
   };
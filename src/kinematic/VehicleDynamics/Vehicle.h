@@ -35,21 +35,36 @@ namespace VehicleDynamics {
       Vehicle() {}
       virtual ~Vehicle() {}
 
+      // the state all models share, so they can be exchanged behind this interface
+      struct CommonState {
+        double x = 0; /// Position [m]
+        double y = 0; /// Position [m]
+        double psi = 0; /// Yaw [rad]
+        double theta = 0; /// Roll [rad]
+        double v = 0; /// Velocity of the center of mass [m/s]
+        double alphaT = 0; /// Side slip angle of the center of mass [rad]
+        double dPsi = 0; /// Yaw rate [rad/s]
+        double dTheta = 0; /// Roll rate [rad/s]
+      };
+
       virtual void step( double deltaT, double deltaF,
                          double fxFrontLeft, double fxFrontRight, double fxRearLeft, double fxRearRight ) = 0;
 
+      virtual void setCommonState( const CommonState& commonState ) = 0;
+      virtual CommonState getCommonState() const = 0;
+
       /// Mass of the car (tractor) [kg]
-      double mass() {
+      double mass() const {
         return massFrontAxle + massRearAxle;
       }
 
       /// Distance from front axle of the car (tractor) to the center of mass of the car (tractor) [m]
-      double lengthA() {
+      double lengthA() const {
         return massRearAxle / mass() * wheelBase;
       }
 
       /// Distance from center of mass of the car (tractor) to the front axle of the car (tractor) [m]
-      double lengthB() {
+      double lengthB() const {
         return wheelBase - lengthA();
       }
 
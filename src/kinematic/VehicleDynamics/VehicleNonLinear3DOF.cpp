@@ -19,8 +19,6 @@
 // https://github.com/andresmendes/openvd
 
 #include <cmath>
-#include <iomanip>
-#include <iostream>
 #include <memory>
 
 #include <QtMath>
@@ -56,31 +54,23 @@ void VehicleDynamics::VehicleNonLinear3DOF::step( double deltaT, double deltaF,
   double m = mass();
   double a = lengthA();
   double b = lengthB();
-  std::cout << "m: " << m << ", a " << a << ", b " << b << ", trackWidth " << trackWidth << std::endl;
 
   double fzFront = massFrontAxle * G;
   double fzRear  = massRearAxle  * G;
-  std::cout << "fz: " << fzFront << ", " << fzRear << std::endl;
 
   // slip angles
   double alphaFront = std::atan2( v * std::sin( alphaT ) + a * dPsi, v * std::cos( alphaT ) ) - deltaF;
   double alphaRear  = std::atan2( v * std::sin( alphaT ) - b * dPsi, v * std::cos( alphaT ) );
 
-  std::cout << "alpha: " << alphaFront << " (" << radiansToDegrees( alphaFront ) << "), " << alphaRear << " (" << radiansToDegrees( alphaRear ) << ")" << std::endl;
-  std::cout << "operands: " << v* std::sin( alphaT ) + a* dPsi << ", " << v* std::cos( alphaT ) << std::endl;
-
-
   double fxFront = fxFrontLeft + fxFrontRight;
   double fxRear  = fxRearLeft  + fxRearRight;
-  std::cout << "fx: " << fxFront << " " << fxRear << std::endl;
 
   // tyre characteristics
   double fyFront = 2 * nFrontTiresPerSide * frontTire->characteristic( alphaFront, fzFront / ( 2 * nFrontTiresPerSide ), muy );
   double fyRear  = 2 * nRearTiresPerSide  * rearTire-> characteristic( alphaRear,  fzRear  / ( 2 * nRearTiresPerSide ),  muy );
-  std::cout << "fy: " << fyFront << " " << fyRear << std::endl;
 
   // derived state
-  decltype( state ) dState;
+  Eigen::Matrix<double, 6, 1> dState;
   dState( 0 ) = v * std::cos( alphaT + psi );
   dState( 1 ) = v * std::sin( alphaT + psi );
   dState( 2 ) = qIsNull( v ) ? 0 : dPsi;
@@ -88,10 +78,6 @@ void VehicleDynamics::VehicleNonLinear3DOF::step( double deltaT, double deltaF,
   dState( 4 ) = qIsNull( v ) ? 0 : ( - fxFront * std::sin( alphaT - deltaF ) - fxRear * std::sin( alphaT ) + fyFront * std::cos( alphaT - deltaF ) + fyRear * std::cos( alphaT ) - m * v * dPsi ) / ( m * v );
   dState( 5 ) = qIsNull( v ) ? 0 : ( fxFront * a * std::sin( deltaF ) + fyFront * a * std::cos( deltaF ) - fyRear * b ) / momentOfInertia;
 
-  std::cout << "deltaF "/*<<std::endl*/ << deltaF << std::endl;
-  std::cout << "deltaT "/*<<std::endl*/ << deltaT << std::endl;
-  std::cout << "dState" << std::endl << dState << std::endl;
-
   // new state, basicaly integrating y'=f(x, t)
   state = state + ( dState * deltaT );
 
@@ -100,8 +86,24 @@ void VehicleDynamics::VehicleNonLinear3DOF::step( double deltaT, double deltaF,
 
   state( 2 ) = normalizeAngleRadians( state( 2 ) );
   state( 4 ) = normalizeAngleRadians( state( 4 ) );
+}
+
+void VehicleDynamics::VehicleNonLinear3DOF::setCommonState( const VehicleDynamics::Vehicle::CommonState& commonState ) {
+  state( 0 ) = commonState.x;
+  state( 1 ) = commonState.y;
+  state( 2 ) = commonState.psi;
+  state( 3 ) = commonState.v;
+  state( 4 ) = commonState.alphaT;
+  state( 5 ) = commonState.dPsi;
+}
 
-  for( int i = 0, end = stateNames.count(); i < end; ++i ) {
-    std::cout << std::fixed << std::setw( 12 ) << std::setprecision( 10 ) <</*std::scientific<<*/std::showpos << state( i ) << " " << stateNames[i].toStdString() << std::endl;
-  }
+VehicleDynamics::Vehicle::CommonState VehicleDynamics::VehicleNonLinear3DOF::getCommonState() const {
+  CommonState commonState;
+  commonState.x = state( 0 );
+  commonState.y = state( 1 );
+  commonState.psi = state( 2 );
+  commonState.v = state( 3 );
+  commonState.alphaT = state( 4 );
+  commonState.dPsi = state( 5 );
+  return commonState;
 }
@@ -33,7 +33,10 @@ namespace VehicleDynamics {
       virtual ~VehicleNonLinear3DOF() {}
 
       virtual void step( double deltaT, double deltaF,
-                         double fxFront, double fxFrontRight, double fxRearLeft, double fxRearRight );
+                         double fxFront, double fxFrontRight, double fxRearLeft, double fxRearRight ) override;
+
+      virtual void setCommonState( const CommonState& commonState ) override;
+      virtual CommonState getCommonState() const override;
 
 
     public:
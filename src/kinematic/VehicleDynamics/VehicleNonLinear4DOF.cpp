@@ -19,8 +19,6 @@
 // https://github.com/andresmendes/openvd
 
 #include <cmath>
-#include <iomanip>
-#include <iostream>
 #include <memory>
 
 #include "helpers/eigenHelper.h"
@@ -47,9 +45,6 @@ VehicleDynamics::VehicleNonLinear4DOF::VehicleNonLinear4DOF( VehicleDynamics::Ti
 
 void VehicleDynamics::VehicleNonLinear4DOF::step( double deltaT, double deltaF,
     double fxFrontLeft, double fxFrontRight, double fxRearLeft, double fxRearRight ) {
-
-  std::cout << "forces " << fxFrontLeft << " " << fxFrontRight << " " << fxRearLeft << " " << fxRearRight << std::endl;
-
   double psi = state( 2 );
   double theta = state( 3 );
   double v = state( 4 );
@@ -60,7 +55,6 @@ void VehicleDynamics::VehicleNonLinear4DOF::step( double deltaT, double deltaF,
   double m = mass();
   double a = lengthA();
   double b = lengthB();
-  std::cout << "m: " << m << ", a " << a << ", b " << b << ", trackWidth " << trackWidth << std::endl;
 
   // weight forces
   double fzRight = ( m * G * trackWidth / 2 + K * theta + C * dTheta ) / trackWidth;
@@ -70,7 +64,6 @@ void VehicleDynamics::VehicleNonLinear4DOF::step( double deltaT, double deltaF,
   double fzFrontLeft = fzLeft * b / ( a + b );
   double fzRearRight = fzRight * a / ( a + b );
   double fzRearLeft = fzLeft * a / ( a + b );
-  std::cout << "fz: " << fzFrontLeft << ", " << fzFrontRight << ", " << fzRearLeft << ", " << fzRearRight << std::endl;
 
   // slip angles
   double alphaFrontLeft = std::atan2( ( v * std::sin( alphaT ) + dPsi * a ), ( v * std::cos( alphaT ) - dPsi * trackWidth / 2 ) ) - deltaF;
@@ -79,9 +72,6 @@ void VehicleDynamics::VehicleNonLinear4DOF::step( double deltaT, double deltaF,
   double alphaRearLeft = std::atan2( ( v * std::sin( alphaT ) - dPsi * b ), ( v * std::cos( alphaT ) - dPsi * trackWidth / 2 ) );
   double alphaRearRight = std::atan2( ( v * std::sin( alphaT ) - dPsi * b ), ( v * std::cos( alphaT ) + dPsi * trackWidth / 2 ) );
 
-  std::cout << "alpha: " << alphaFrontLeft << ", " << alphaFrontRight << ", " << alphaRearLeft << ", " << alphaRearRight << std::endl;
-
-
   // tyre characteristics
   double fyFrontLeft = nFrontTiresPerSide * frontLeftTire->characteristic( alphaFrontLeft, fzFrontLeft / nFrontTiresPerSide, muy );
   double fyFrontRight = nFrontTiresPerSide * frontRightTire->characteristic( alphaFrontRight, fzFrontRight / nFrontTiresPerSide, muy );
@@ -128,37 +118,40 @@ void VehicleDynamics::VehicleNonLinear4DOF::step( double deltaT, double deltaF,
                 + ( fyFrontLeft * trackWidth * cos( theta ) * sin( deltaF ) ) / 2
                 - ( fyFrontRight * trackWidth * cos( theta ) * sin( deltaF ) ) / 2;
 
-  auto M = massMatrix();
-
-//  std::cout << "MassMatrix"<<std::endl<<M<<std::endl;
-
-  Eigen::FullPivLU<decltype( massMatrix() )> lu( M );
-  auto Minv = lu.inverse();
-//  std::cout << "MassMatrix inverse "<<bool(lu.isInvertible()) <<std::endl<<Minv<<std::endl;
-  std::cout << "deltaF "/*<<std::endl*/ << deltaF << std::endl;
-  std::cout << "deltaT "/*<<std::endl*/ << deltaT << std::endl;
-  std::cout << "dState" << std::endl << dState << std::endl;
-
-  dState = Minv * dState;
-  std::cout << "Minv * dState" << std::endl << dState << std::endl;
-
-  // new state, basicaly y'=Minv * f(x, t)
-  dState = dState * deltaT;
-  state( 0 ) = dState( 0 );
-  state( 1 ) = dState( 1 );
-  state( 2 ) = normalizeAngleRadians( dState( 2 ) );
-  state( 3 ) = dState( 3 );
-  state( 4 ) = dState( 4 );
-  state( 5 ) = normalizeAngleRadians( dState( 5 ) );
-  state( 6 ) = dState( 6 );
-  state( 7 ) = dState( 7 );
-
-  for( int i = 0, end = stateNames.count(); i < end; ++i ) {
-    std::cout << std::fixed << std::setw( 12 ) << std::setprecision( 10 ) <</*std::scientific<<*/std::showpos << state( i ) << " " << stateNames[i].toStdString() << std::endl;
-  }
+  // M * y' = f(x, t); solved in place of inverting M, all on the stack
+  dState = massMatrix().partialPivLu().solve( dState );
+
+  // new state, basicaly integrating y'
+  state += dState * deltaT;
+  state( 2 ) = normalizeAngleRadians( state( 2 ) );
+  state( 5 ) = normalizeAngleRadians( state( 5 ) );
+}
+
+void VehicleDynamics::VehicleNonLinear4DOF::setCommonState( const VehicleDynamics::Vehicle::CommonState& commonState ) {
+  state( 0 ) = commonState.x;
+  state( 1 ) = commonState.y;
+  state( 2 ) = commonState.psi;
+  state( 3 ) = commonState.theta;
+  state( 4 ) = commonState.v;
+  state( 5 ) = commonState.alphaT;
+  state( 6 ) = commonState.dPsi;
+  state( 7 ) = commonState.dTheta;
+}
+
+VehicleDynamics::Vehicle::CommonState VehicleDynamics::VehicleNonLinear4DOF::getCommonState() const {
+  CommonState commonState;
+  commonState.x = state( 0 );
+  commonState.y = state( 1 );
+  commonState.psi = state( 2 );
+  commonState.theta = state( 3 );
+  commonState.v = state( 4 );
+  commonState.alphaT = state( 5 );
+  commonState.dPsi = state( 6 );
+  commonState.dTheta = state( 7 );
+  return commonState;
 }
 
-Eigen::Matrix<double, 8, 8> VehicleDynamics::VehicleNonLinear4DOF::massMatrix() {
+Eigen::Matrix<double, 8, 8> VehicleDynamics::VehicleNonLinear4DOF::massMatrix() const {
   double m = mass();
   double theta = state( 3 );
   double v = state( 4 );
@@ -33,9 +33,12 @@ namespace VehicleDynamics {
       virtual ~VehicleNonLinear4DOF() {}
 
       virtual void step( double deltaT, double deltaF,
-                         double fxFrontLeft, double fxFrontRight, double fxRearLeft, double fxRearRight );
+                         double fxFrontLeft, double fxFrontRight, double fxRearLeft, double fxRearRight ) override;
 
-      Eigen::Matrix<double, 8, 8> massMatrix();
+      virtual void setCommonState( const CommonState& commonState ) override;
+      virtual CommonState getCommonState() const override;
+
+      Eigen::Matrix<double, 8, 8> massMatrix() const;
 
     public:
       QStringList stateNames;
@@ -24,4 +24,31 @@
 
 #ifndef __clang_analyzer__
 
+// boolean operations on polygons need exact constructions
+#include <CGAL/Polygon_set_2.h>
+typedef CGAL::Polygon_2<Epeck>                                  Polygon_2_Epeck;
+typedef CGAL::Polygon_with_holes_2<Epeck>                       Polygon_with_holes_2_Epeck;
+typedef CGAL::Polygon_set_2<Epeck>                              Polygon_set_2_Epeck;
+
+typedef CGAL::Cartesian_converter<Epeck, Epick>                 EpeckEpickConverter;
+
+// constrained triangulation to triangulate polygons with holes
+#include <CGAL/Constrained_Delaunay_triangulation_2.h>
+#include <CGAL/Triangulation_vertex_base_with_info_2.h>
+#include <CGAL/Triangulation_face_base_with_info_2.h>
+
+struct FaceInfoNestingLevel {
+  int nestingLevel = -1;
+
+  bool inDomain() const {
+    return ( nestingLevel % 2 ) == 1;
+  }
+};
+
+typedef CGAL::Triangulation_vertex_base_with_info_2<uint32_t, Epick>              CdtVb;
+typedef CGAL::Triangulation_face_base_with_info_2<FaceInfoNestingLevel, Epick>    CdtFbWithInfo;
+typedef CGAL::Constrained_triangulation_face_base_2<Epick, CdtFbWithInfo>         CdtFb;
+typedef CGAL::Triangulation_data_structure_2<CdtVb, CdtFb>                        CdtTds;
+typedef CGAL::Constrained_Delaunay_triangulation_2<Epick, CdtTds, CGAL::Exact_predicates_tag> CDT;
+
 #endif // not __clang_analyzer__
@@ -47,6 +47,8 @@
 
 #include <Qt3DInput/QInputAspect>
 
+#include <Qt3DLogic/QFrameAction>
+
 #include <Qt3DRender/QEffect>
 #include <Qt3DRender/QMaterial>
 #include <Qt3DRender/QMesh>
@@ -80,10 +82,12 @@
 #include "gui/PassToolbar.h"
 #include "gui/SettingsDialog.h"
 #include "gui/dock/SliderDock.h"
+#include "gui/dock/ProfilerDock.h"
 
 #include "block/global/CameraController.h"
 #include "block/global/FieldManager.h"
 #include "block/global/FpsMeasurement.h"
+#include "block/DeliveryPolicies.h"
 #include "block/global/GridModel.h"
 #include "block/graphical/TractorModel.h"
 #include "block/graphical/TrailerModel.h"
@@ -119,6 +123,8 @@
 
 #include "gui/MyFrameworkWidgetFactory.h"
 
+#include "helpers/StartupTimeline.h"
+
 #if defined (Q_OS_ANDROID)
 #include <QtAndroid>
 const std::vector<QString> permissions( {"android.permission.INTERNET",
@@ -128,6 +134,8 @@ const std::vector<QString> permissions( {"android.permission.INTERNET",
 #endif
 
 int main( int argc, char** argv ) {
+  StartupTimeline::start();
+
 //  // hack to make the app apear without cropped qt3d-widget
 //  QCoreApplication::setAttribute( Qt::AA_DisableHighDpiScaling );
 
@@ -142,6 +150,7 @@ int main( int argc, char** argv ) {
   QApplication app( argc, argv );
   QApplication::setOrganizationDomain( QStringLiteral( "QtOpenGuidance.org" ) );
   QApplication::setApplicationName( QStringLiteral( "QtOpenGuidance" ) );
+  StartupTimeline::mark( "application" );
 
 #if !defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
   QIcon::setThemeSearchPaths( QIcon::themeSearchPaths() << QStringLiteral( ":themes/" ) );
@@ -165,6 +174,7 @@ int main( int argc, char** argv ) {
 #endif
 
   auto* view = new Qt3DExtras::Qt3DWindow();
+  StartupTimeline::mark( "3D window" );
 
   qDebug() << "OpenGL: " << view->format().majorVersion() << view->format().minorVersion();
 
@@ -173,6 +183,11 @@ int main( int argc, char** argv ) {
   qRegisterMetaType<Plan>();
   qRegisterMetaType<PlanGlobal>();
 
+  // the types used by most of the blocks; needed to pass them between threads or through the dataflow scheduler
+  qRegisterMetaType<Eigen::Vector3d>( "Eigen::Vector3d" );
+  qRegisterMetaType<Eigen::Quaterniond>( "Eigen::Quaterniond" );
+  qRegisterMetaType<PoseOption::Options>( "PoseOption::Options" );
+
   QWidget* container = QWidget::createWindowContainer( view );
 //  QSize screenSize = view->screen()->size();
 //  container->setMinimumSize( QSize( 500, 400 ) );
@@ -211,9 +226,11 @@ int main( int argc, char** argv ) {
   guidaceToolbarDock->setWidget( guidanceToolbar );
   guidaceToolbarDock->setTitle( guidanceToolbar->windowTitle() );
   mainWindow->addDockWidget( guidaceToolbarDock, KDDockWidgets::Location_OnRight );
+  StartupTimeline::mark( "main window" );
 
   // Create setting Window
   auto* settingDialog = new SettingsDialog( rootEntity, mainWindow, view, guidanceToolbar->menu, widget );
+  StartupTimeline::mark( "settings dialog and system blocks" );
 
   // Camera
   Qt3DRender::QCamera* cameraEntity = view->camera();
@@ -277,6 +294,7 @@ int main( int argc, char** argv ) {
   fieldsOptimitionToolbarDock->setTitle( fieldsOptimitionToolbar->windowTitle() );
   mainWindow->addDockWidget( fieldsOptimitionToolbarDock, KDDockWidgets::Location_OnLeft );
   guidanceToolbar->menu->addAction( fieldsOptimitionToolbarDock->toggleAction() );
+  StartupTimeline::mark( "toolbars" );
 
   // simulator docks
   auto* simulatorVelocity = new SliderDock( widget );
@@ -363,6 +381,7 @@ int main( int argc, char** argv ) {
   simulatorSteerAngleOffset->setUnit( QStringLiteral( " °" ) );
   mainWindow->addDockWidget( simulatorSteerAngleOffsetDock, KDDockWidgets::Location_OnBottom, simulatorFrequencyDock );
   guidanceToolbar->menu->addAction( simulatorSteerAngleOffsetDock->toggleAction() );
+  StartupTimeline::mark( "simulator docks" );
 
   // XTE dock
   BlockFactory* xteDockBlockFactory = new XteDockBlockFactory(
@@ -428,6 +447,7 @@ int main( int argc, char** argv ) {
           guidanceToolbar->menu,
           settingDialog->implementBlockModel );
   implementFactory->addToTreeWidget( settingDialog->getBlockTreeWidget() );
+  StartupTimeline::mark( "dock factories" );
 
   // camera block
   BlockFactory* cameraControllerFactory = new CameraControllerFactory( rootEntity, cameraEntity );
@@ -445,6 +465,21 @@ int main( int argc, char** argv ) {
   BlockFactory* fpsMeasurementFactory = new FpsMeasurementFactory( rootEntity );
   fpsMeasurementFactory->createBlock( settingDialog->getSceneOfConfigGraphicsView() );
 
+  // the connections with the delivery policy "latest value per frame" deliver on every rendered frame
+  auto* deliveryFrameAction = new Qt3DLogic::QFrameAction( rootEntity );
+  QObject::connect( deliveryFrameAction, &Qt3DLogic::QFrameAction::triggered,
+                    settingDialog->deliveryPolicies, &DeliveryPolicies::frameSwapped );
+
+  // profiler dock: the time spent in the blocks; closed on start, as the profiler only runs when enabled there
+  auto* profilerDock = new KDDockWidgets::DockWidget( QStringLiteral( "ProfilerDock" ) );
+  auto* profilerWidget = new ProfilerDock( settingDialog->blockProfiler, widget );
+  profilerDock->setWidget( profilerWidget );
+  profilerDock->setTitle( QStringLiteral( "Block Profiler" ) );
+  mainWindow->addDockWidget( profilerDock, KDDockWidgets::Location_OnBottom );
+  profilerDock->close();
+  guidanceToolbar->menu->addAction( profilerDock->toggleAction() );
+  StartupTimeline::mark( "camera, grid and profiler" );
+
 
   // Setting Dialog
   QObject::connect( guidanceToolbar, &GuidanceToolbar::toggleSettings,
@@ -535,6 +570,7 @@ int main( int argc, char** argv ) {
 
   // emit all initial signals from the settings dialog
   settingDialog->emitAllConfigSignals();
+  StartupTimeline::mark( "connections and config signals" );
 
   // load states of checkboxes from global config
   {
@@ -556,6 +592,7 @@ int main( int argc, char** argv ) {
   settingDialog->onStart();
   QObject::connect( mainWindow, &MyMainWindow::closed,
                     settingDialog, &SettingsDialog::onExit );
+  StartupTimeline::mark( "config and dock layout" );
 
   // camera controller
   QObject::connect( mainWindow, SIGNAL( closed() ),
@@ -573,6 +610,17 @@ int main( int argc, char** argv ) {
   mainWindow->show();
   mainWindow->resize( 1200, 800 );
 #endif
+  StartupTimeline::mark( "window shown" );
+
+  // the application is usable with the first rendered frame
+  {
+    auto* firstFrameAction = new Qt3DLogic::QFrameAction( rootEntity );
+    QObject::connect( firstFrameAction, &Qt3DLogic::QFrameAction::triggered, firstFrameAction, [firstFrameAction]() {
+      StartupTimeline::mark( "first frame" );
+      StartupTimeline::report();
+      firstFrameAction->deleteLater();
+    } );
+  }
 
   return QApplication::exec();
 }
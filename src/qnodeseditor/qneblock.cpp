@@ -53,6 +53,9 @@
 int QNEBlock::m_nextSystemId = int( IdRange::SystemIdStart );
 int QNEBlock::m_nextUserId = int( IdRange::UserIdStart );
 
+// scene -> id -> block
+static QHash<const QGraphicsScene*, QHash<int, QNEBlock*>> blocksOfScenes;
+
 QNEBlock::QNEBlock( QObject* object, int id, bool systemBlock, QGraphicsItem* parent )
   : QGraphicsPathItem( parent ),
     systemBlock( systemBlock ), width( 20 ), height( cornerRadius * 2 ), object( object ) {
@@ -92,6 +95,9 @@ QNEBlock::QNEBlock( QObject* object, int id, bool systemBlock, QGraphicsItem* pa
 }
 
 QNEBlock::~QNEBlock() {
+  // the destructor of QGraphicsItem removes the block from the scene without calling itemChange()
+  unregisterId();
+
   object->deleteLater();
 }
 
@@ -115,6 +121,15 @@ QNEPort* QNEBlock::addPort( const QString& name, QLatin1String signalSlotSignatu
 
   port->setPortFlags( flags );
 
+  if( ( flags & ( QNEPort::NamePort | QNEPort::TypePort ) ) == 0 ) {
+    // the first port with a name is found, like with a search through the children
+    auto& portsByName = isOutput ? outputPortsByName : inputPortsByName;
+
+    if( !portsByName.contains( name ) ) {
+      portsByName.insert( name, port );
+    }
+  }
+
   height += port->getHeightOfLabelBoundingRect();
 
   resizeBlockWidth();
@@ -179,27 +194,55 @@ void QNEBlock::setName( const QString& name, bool setFromLabel ) {
 }
 
 QVariant QNEBlock::itemChange( GraphicsItemChange change, const QVariant& value ) {
+  if( change == QGraphicsItem::ItemSceneChange ) {
+    unregisterId();
+  }
 
-  Q_UNUSED( change )
+  if( change == QGraphicsItem::ItemSceneHasChanged ) {
+    registerId( scene() );
+  }
 
   return value;
 }
 
 QNEPort* QNEBlock::getPortWithName( const QString& name, bool output ) {
-  const auto& constRefOfList = childItems();
+  return ( output ? outputPortsByName : inputPortsByName ).value( name, nullptr );
+}
 
-  for( const auto& item : constRefOfList ) {
-    auto* port = qgraphicsitem_cast<QNEPort*>( item );
+QNEBlock* QNEBlock::blockWithId( const QGraphicsScene* scene, const int id ) {
+  const auto it = blocksOfScenes.constFind( scene );
 
-    if( ( port != nullptr ) &&
-        ( ( port->portFlags() & ( QNEPort::NamePort | QNEPort::TypePort ) ) == 0 ) &&
-        port->isOutput() == output &&
-        port->getName() == name ) {
-      return port;
-    }
+  if( it == blocksOfScenes.cend() ) {
+    return nullptr;
+  }
+
+  return it->value( id, nullptr );
+}
+
+void QNEBlock::registerId( const QGraphicsScene* scene ) {
+  if( scene != nullptr ) {
+    blocksOfScenes[scene].insert( id, this );
+    registeredScene = scene;
   }
+}
+
+void QNEBlock::unregisterId() {
+  if( registeredScene != nullptr ) {
+    auto it = blocksOfScenes.find( registeredScene );
 
-  return nullptr;
+    if( it != blocksOfScenes.end() ) {
+      // only if the id wasn't taken over by another block
+      if( it->value( id, nullptr ) == this ) {
+        it->remove( id );
+      }
+
+      if( it->isEmpty() ) {
+        blocksOfScenes.erase( it );
+      }
+    }
+
+    registeredScene = nullptr;
+  }
 }
 
 void QNEBlock::toJSON( QJsonObject& json ) {
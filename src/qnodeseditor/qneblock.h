@@ -28,6 +28,7 @@
 #pragma once
 
 #include <QGraphicsPathItem>
+#include <QHash>
 
 class QNEPort;
 
@@ -65,6 +66,9 @@ class QNEBlock : public QObject, public QGraphicsPathItem {
 
     QNEPort* getPortWithName( const QString& name, bool output );
 
+    // the blocks of a scene by their id; maintained as the blocks are added to and removed from the scenes
+    static QNEBlock* blockWithId( const QGraphicsScene* scene, const int id );
+
     bool systemBlock = false;
 
   Q_SIGNALS:
@@ -93,6 +97,11 @@ class QNEBlock : public QObject, public QGraphicsPathItem {
     static int m_nextSystemId;
     static int m_nextUserId;
 
+    void registerId( const QGraphicsScene* scene );
+    void unregisterId();
+
+    const QGraphicsScene* registeredScene = nullptr;
+
   protected:
     QVariant itemChange( GraphicsItemChange change, const QVariant& value ) override;
     void mouseReleaseEvent( QGraphicsSceneMouseEvent* event ) override;
@@ -102,6 +111,10 @@ class QNEBlock : public QObject, public QGraphicsPathItem {
     qreal height = 0;
     QString name;
 
+    // the names of the ports can't be changed, so they are hashed on creation
+    QHash<QString, QNEPort*> inputPortsByName;
+    QHash<QString, QNEPort*> outputPortsByName;
+
   public:
     const QString getName() {
       return name;
@@ -50,6 +50,10 @@ QNEConnection::QNEConnection( QGraphicsItem* parent ) : QGraphicsPathItem( paren
 }
 
 QNEConnection::~QNEConnection() {
+  if( m_scheduler != nullptr ) {
+    QMetaObject::invokeMethod( m_scheduler, "connectionRemoved", Qt::DirectConnection, Q_ARG( void*, this ) );
+  }
+
   if( m_port1 != nullptr ) {
     for( auto it = m_port1->connections().cbegin(), end = m_port1->connections().cend();
          it != end;
@@ -77,12 +81,15 @@ QNEConnection::~QNEConnection() {
 
 
 void QNEConnection::paint( QPainter* painter, const QStyleOptionGraphicsItem*, QWidget* ) {
+  // connections, that drop values, are dashed
+  const auto penStyle = m_deliveryPolicy == DeliveryPolicy::EveryValue ? Qt::SolidLine : Qt::DashLine;
+
   if( isSelected() ) {
-    painter->setPen( QPen( Qt::red, 3 ) );
+    painter->setPen( QPen( Qt::red, 3, penStyle ) );
     painter->setBrush( Qt::NoBrush );
     setZValue( 1.5 );
   } else {
-    painter->setPen( QPen( Qt::darkGreen, 3 ) );
+    painter->setPen( QPen( Qt::darkGreen, 3, penStyle ) );
     painter->setBrush( Qt::NoBrush );
     setZValue( 0 );
   }
@@ -105,13 +112,16 @@ void QNEConnection::setPort1( QNEPort* p ) {
   m_port1->connections().push_back( this );
 }
 
-bool QNEConnection::setPort2( QNEPort* p ) {
-
+bool QNEConnection::connectPorts( QNEPort* port2 ) {
   connection = QObject::connect( m_port1->block()->object, ( m_port1->slotSignalSignature.latin1() ),
-                                 p->block()->object, ( p->slotSignalSignature.latin1() ),
+                                 port2->block()->object, ( port2->slotSignalSignature.latin1() ),
                                  Qt::ConnectionType( Qt::AutoConnection | Qt::UniqueConnection ) );
 
-  if( connection ) {
+  return bool( connection );
+}
+
+bool QNEConnection::setPort2( QNEPort* p ) {
+  if( connectPorts( p ) ) {
     m_port2 = p;
     m_port2->connections().push_back( this );
 
@@ -142,6 +152,22 @@ void QNEConnection::updatePath() {
   setPath( p );
 }
 
+void QNEConnection::setScheduler( QObject* scheduler ) {
+  if( scheduler != nullptr && m_scheduler == nullptr ) {
+    QObject::disconnect( connection );
+  }
+
+  if( scheduler == nullptr && m_scheduler != nullptr && m_port2 != nullptr ) {
+    connectPorts( m_port2 );
+  }
+
+  m_scheduler = scheduler;
+}
+
+QObject* QNEConnection::scheduler() const {
+  return m_scheduler;
+}
+
 QNEPort* QNEConnection::port1() const {
   return m_port1;
 }
@@ -158,7 +184,70 @@ void QNEConnection::toJSON( QJsonObject& json ) const {
   connectionObject[QStringLiteral( "portFrom" )] = port1()->getName();
   connectionObject[QStringLiteral( "idTo" )] =  port2()->block()->id;
   connectionObject[QStringLiteral( "portTo" )] = port2()->getName();
+
+  // every value is the default, so the configs without a policy stay the same
+  switch( m_deliveryPolicy ) {
+    case DeliveryPolicy::RateLimited:
+      connectionObject[QStringLiteral( "delivery" )] = QStringLiteral( "rate" );
+      connectionObject[QStringLiteral( "maxRate" )] = m_maxRateHz;
+      break;
+
+    case DeliveryPolicy::LatestPerFrame:
+      connectionObject[QStringLiteral( "delivery" )] = QStringLiteral( "frame" );
+      break;
+
+    default:
+      break;
+  }
+
   connectionsArray.append( connectionObject );
 
   json[QStringLiteral( "connections" )] = connectionsArray;
 }
+
+void QNEConnection::deliveryPolicyFromJSON( const QJsonObject& connectionObject ) {
+  const auto delivery = connectionObject[QStringLiteral( "delivery" )].toString();
+
+  if( delivery == QStringLiteral( "rate" ) ) {
+    setDeliveryPolicy( DeliveryPolicy::RateLimited, connectionObject[QStringLiteral( "maxRate" )].toDouble( 0 ) );
+  } else if( delivery == QStringLiteral( "frame" ) ) {
+    setDeliveryPolicy( DeliveryPolicy::LatestPerFrame );
+  } else {
+    setDeliveryPolicy( DeliveryPolicy::EveryValue );
+  }
+}
+
+void QNEConnection::setDeliveryPolicy( const DeliveryPolicy policy, const double maxRateHz ) {
+  m_deliveryPolicy = policy;
+  m_maxRateHz = maxRateHz;
+
+  // a rate limit without a rate is no limit
+  if( m_deliveryPolicy == DeliveryPolicy::RateLimited && !( m_maxRateHz > 0 ) ) {
+    m_deliveryPolicy = DeliveryPolicy::EveryValue;
+    m_maxRateHz = 0;
+  }
+
+  switch( m_deliveryPolicy ) {
+    case DeliveryPolicy::RateLimited:
+      setToolTip( QStringLiteral( "At most %1 Hz" ).arg( m_maxRateHz ) );
+      break;
+
+    case DeliveryPolicy::LatestPerFrame:
+      setToolTip( QStringLiteral( "Latest value per frame" ) );
+      break;
+
+    default:
+      setToolTip( QString() );
+      break;
+  }
+
+  update();
+}
+
+QNEConnection::DeliveryPolicy QNEConnection::deliveryPolicy() const {
+  return m_deliveryPolicy;
+}
+
+double QNEConnection::maxRateHz() const {
+  return m_maxRateHz;
+}
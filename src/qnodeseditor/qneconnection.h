@@ -29,6 +29,7 @@
 
 #include <QObject>
 #include <QGraphicsPathItem>
+#include <QPointer>
 
 class QNEPort;
 
@@ -36,6 +37,14 @@ class QNEConnection : public QGraphicsPathItem {
   public:
     enum { Type = QGraphicsItem::UserType + 2 };
 
+    // how the values of the signal reach the slot; anything but EveryValue drops intermediate values and is carried
+    // out by a relay (see setScheduler())
+    enum class DeliveryPolicy {
+      EveryValue,
+      RateLimited,
+      LatestPerFrame
+    };
+
     QNEConnection( QGraphicsItem* parent = nullptr );
     ~QNEConnection();
 
@@ -56,13 +65,30 @@ class QNEConnection : public QGraphicsPathItem {
     }
 
     void toJSON( QJsonObject& json ) const;
+    // reads the delivery policy from an entry of "connections"
+    void deliveryPolicyFromJSON( const QJsonObject& connectionObject );
+
+    void setDeliveryPolicy( const DeliveryPolicy policy, const double maxRateHz = 0 );
+    DeliveryPolicy deliveryPolicy() const;
+    double maxRateHz() const;
+
+    // routes the connection through a scheduler instead of connecting the signal directly to the slot;
+    // nullptr restores the direct connection. The scheduler gets connectionRemoved( void* ) invoked on deletion
+    void setScheduler( QObject* scheduler );
+    QObject* scheduler() const;
 
   private:
+    bool connectPorts( QNEPort* port2 );
+
     QPointF pos1;
     QPointF pos2;
     QNEPort* m_port1 = nullptr;
     QNEPort* m_port2 = nullptr;
 
     QMetaObject::Connection connection;
+    QPointer<QObject> m_scheduler;
+
+    DeliveryPolicy m_deliveryPolicy = DeliveryPolicy::EveryValue;
+    double m_maxRateHz = 0;
 };
 
@@ -35,6 +35,8 @@
 #include <QGraphicsView>
 #include <QKeyEvent>
 #include <QScrollBar>
+#include <QMenu>
+#include <QInputDialog>
 
 #include "qneblock.h"
 #include "qneconnection.h"
@@ -126,6 +128,19 @@ bool QNodesEditor::eventFilter( QObject* o, QEvent* e ) {
     break;
 
 
+    case QEvent::GraphicsSceneMouseDoubleClick: {
+      if( mouseEvent->button() == Qt::LeftButton ) {
+        auto* connection = qgraphicsitem_cast<QNEConnection*>( itemAt( mouseEvent->scenePos() ) );
+
+        if( connection != nullptr ) {
+          editDeliveryPolicy( connection, mouseEvent->screenPos() );
+          return true;
+        }
+      }
+
+      break;
+    }
+
     case QEvent::GraphicsSceneMouseMove: {
       auto* const m = dynamic_cast<QGraphicsSceneMouseEvent*>( e );
 
@@ -228,3 +243,52 @@ bool QNodesEditor::eventFilter( QObject* o, QEvent* e ) {
 
   return QObject::eventFilter( o, e );
 }
+
+void QNodesEditor::editDeliveryPolicy( QNEConnection* connection, const QPoint& screenPos ) {
+  QMenu menu;
+
+  auto* everyValueAction = menu.addAction( tr( "Every value" ) );
+  auto* rateLimitedAction = menu.addAction( tr( "At most N Hz..." ) );
+  auto* latestPerFrameAction = menu.addAction( tr( "Latest value per frame" ) );
+
+  everyValueAction->setCheckable( true );
+  rateLimitedAction->setCheckable( true );
+  latestPerFrameAction->setCheckable( true );
+
+  switch( connection->deliveryPolicy() ) {
+    case QNEConnection::DeliveryPolicy::RateLimited:
+      rateLimitedAction->setChecked( true );
+      rateLimitedAction->setText( tr( "At most %1 Hz..." ).arg( connection->maxRateHz() ) );
+      break;
+
+    case QNEConnection::DeliveryPolicy::LatestPerFrame:
+      latestPerFrameAction->setChecked( true );
+      break;
+
+    default:
+      everyValueAction->setChecked( true );
+      break;
+  }
+
+  auto* selectedAction = menu.exec( screenPos );
+
+  if( selectedAction == everyValueAction ) {
+    connection->setDeliveryPolicy( QNEConnection::DeliveryPolicy::EveryValue );
+  } else if( selectedAction == latestPerFrameAction ) {
+    connection->setDeliveryPolicy( QNEConnection::DeliveryPolicy::LatestPerFrame );
+  } else if( selectedAction == rateLimitedAction ) {
+    bool ok = false;
+    const double maxRateHz = QInputDialog::getDouble( nullptr, tr( "Delivery Policy" ), tr( "Maximal rate [Hz]" ),
+                             connection->maxRateHz() > 0 ? connection->maxRateHz() : 10, 0.1, 1000, 1, &ok );
+
+    if( !ok ) {
+      return;
+    }
+
+    connection->setDeliveryPolicy( QNEConnection::DeliveryPolicy::RateLimited, maxRateHz );
+  } else {
+    return;
+  }
+
+  Q_EMIT deliveryPolicyChanged( connection );
+}
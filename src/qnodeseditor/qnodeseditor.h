@@ -33,6 +33,7 @@ class QGraphicsScene;
 class QNEConnection;
 class QGraphicsItem;
 class QPointF;
+class QPoint;
 class QNEBlock;
 
 class QNodesEditor : public QObject {
@@ -52,9 +53,15 @@ class QNodesEditor : public QObject {
   Q_SIGNALS:
     void resetModels();
 
+    // the delivery policy of the connection was changed by the user, so it has to be routed again
+    void deliveryPolicyChanged( QNEConnection* connection );
+
   private:
     QGraphicsItem* itemAt( QPointF );
 
+    // double click on a connection
+    void editDeliveryPolicy( QNEConnection* connection, const QPoint& screenPos );
+
   private:
     QGraphicsScene* scene = nullptr;
     QNEConnection* currentConnection = nullptr;
@@ -0,0 +1,325 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "GuidanceTuning.h"
+
+#include <QFile>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <thread>
+
+#include "helpers/eigenHelper.h"
+#include "helpers/GeoJsonHelper.h"
+#include "helpers/GeographicConvertionWrapper.h"
+
+#include "kinematic/PlanGlobal.h"
+#include "kinematic/PathPrimitiveLine.h"
+#include "kinematic/PathPrimitiveSequence.h"
+
+#include "block/guidance/XteGuidance.h"
+#include "block/guidance/StanleyGuidance.h"
+
+GuidanceTuning::GuidanceTuning() {
+  setSyntheticPlan();
+}
+
+void GuidanceTuning::setScenario( const GuidanceScenario& scenario ) {
+  this->scenario = scenario;
+}
+
+void GuidanceTuning::setSyntheticPlan() {
+  polyline.clear();
+  polyline.emplace_back( 0, 0 );
+  polyline.emplace_back( 100, 0 );
+}
+
+bool GuidanceTuning::setPlanFromFile( QFile& file ) {
+  auto geoJsonHelper = GeoJsonHelper( file );
+  GeographicConvertionWrapper tmw;
+
+  for( const auto& member : geoJsonHelper.members ) {
+    if( member.first == GeoJsonHelper::GeometryType::LineString ) {
+      const auto& lineString = std::get<GeoJsonHelper::LineStringType>( member.second );
+
+      if( lineString.size() >= 2 ) {
+        tmw.Reset( lineString.front().x(), lineString.front().y(), lineString.front().z() );
+
+        polyline.clear();
+
+        for( const auto& point : lineString ) {
+          polyline.push_back( to2D( tmw.Forward( point ) ) );
+        }
+
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+Plan GuidanceTuning::createPlan() const {
+  if( polyline.size() == 2 ) {
+    PlanGlobal plan( Plan::Type::OnlyLines );
+    plan.resetPlanWith( std::make_shared<PathPrimitiveLine>( Line_2( polyline.front(), polyline.back() ),
+                        scenario.implementWidth, true, 0 ) );
+    plan.expand( polyline.front() );
+    return std::move( plan );
+  }
+
+  PlanGlobal plan( Plan::Type::Mixed );
+  plan.resetPlanWith( std::make_shared<PathPrimitiveSequence>( polyline, scenario.implementWidth, true, 0 ) );
+  return std::move( plan );
+}
+
+std::vector<GuidanceSweepResult> GuidanceTuning::sweep( const std::vector<StanleyGains>& gains,
+    const std::size_t runsPerSet,
+    const uint32_t baseSeed,
+    std::size_t threads ) {
+  const std::size_t numJobs = gains.size() * runsPerSet;
+  std::vector<GuidanceRunResult> runResults( numJobs );
+
+  if( threads == 0 ) {
+    threads = std::max( std::thread::hardware_concurrency(), 1u );
+  }
+
+  threads = std::min( threads, std::max<std::size_t>( numJobs, 1 ) );
+
+  // the jobs are handed out one by one, so runs of different length don't leave workers idle
+  std::atomic<std::size_t> nextJob = { 0 };
+
+  auto worker = [&]() {
+    SimulationCore simulationCore;
+    simulationCore.setVehicleModel( scenario.vehicleModel );
+    Plan plan = createPlan();
+
+    for( std::size_t job = nextJob++; job < numJobs; job = nextJob++ ) {
+      const auto setIndex = job / runsPerSet;
+      const auto runIndex = job % runsPerSet;
+      runResults[job] = run( simulationCore, plan, gains[setIndex], baseSeed + uint32_t( runIndex ) );
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve( threads );
+
+  for( std::size_t i = 0; i < threads; ++i ) {
+    workers.emplace_back( worker );
+  }
+
+  for( auto& thread : workers ) {
+    thread.join();
+  }
+
+  std::vector<GuidanceSweepResult> results;
+  results.reserve( gains.size() );
+
+  for( std::size_t setIndex = 0; setIndex < gains.size(); ++setIndex ) {
+    GuidanceSweepResult result;
+    result.gains = gains[setIndex];
+    result.runs = runsPerSet;
+
+    for( std::size_t runIndex = 0; runIndex < runsPerSet; ++runIndex ) {
+      const auto& runResult = runResults[setIndex * runsPerSet + runIndex];
+      result.xteRmsMean += runResult.xteRms;
+      result.xteRmsWorst = std::max( result.xteRmsWorst, runResult.xteRms );
+      result.xteMax = std::max( result.xteMax, runResult.xteMax );
+      result.steeringRateRmsMean += runResult.steeringRateRms;
+    }
+
+    if( runsPerSet > 0 ) {
+      result.xteRmsMean /= double( runsPerSet );
+      result.steeringRateRmsMean /= double( runsPerSet );
+    }
+
+    results.push_back( result );
+  }
+
+  return results;
+}
+
+GuidanceRunResult GuidanceTuning::run( SimulationCore& simulationCore, Plan& plan, const StanleyGains& gains, const uint32_t seed ) const {
+  GuidanceRunResult result;
+
+  if( plan.plan->empty() || scenario.controlRate <= 0 || scenario.stepSize <= 0 ) {
+    return result;
+  }
+
+  const bool reverse = scenario.velocity < 0;
+
+  // the blocks are used like in the GUI, only the connections are direct calls in this thread
+  XteGuidance xteGuidance;
+  StanleyGuidance stanleyGuidance;
+  xteGuidance.setPlan( plan );
+
+  double steerAngleRequested = 0;
+
+  if( reverse ) {
+    stanleyGuidance.setStanleyGainKReverse( gains.k );
+    stanleyGuidance.setStanleyGainKSoftReverse( gains.kSoft );
+    stanleyGuidance.setStanleyGainDampeningYawReverse( gains.dampeningYaw );
+    stanleyGuidance.setStanleyGainDampeningSteeringReverse( gains.dampeningSteering );
+    QObject::connect( &xteGuidance, &XteGuidance::headingOfPathChanged, &stanleyGuidance, &StanleyGuidance::setHeadingOfPathRearWheels, Qt::DirectConnection );
+    QObject::connect( &xteGuidance, &XteGuidance::xteChanged, &stanleyGuidance, &StanleyGuidance::setXteRearWheels, Qt::DirectConnection );
+  } else {
+    stanleyGuidance.setStanleyGainKForwards( gains.k );
+    stanleyGuidance.setStanleyGainKSoftForwards( gains.kSoft );
+    stanleyGuidance.setStanleyGainDampeningYawForwards( gains.dampeningYaw );
+    stanleyGuidance.setStanleyGainDampeningSteeringForwards( gains.dampeningSteering );
+    QObject::connect( &xteGuidance, &XteGuidance::headingOfPathChanged, &stanleyGuidance, &StanleyGuidance::setHeadingOfPathFrontWheels, Qt::DirectConnection );
+    QObject::connect( &xteGuidance, &XteGuidance::xteChanged, &stanleyGuidance, &StanleyGuidance::setXteFrontWheels, Qt::DirectConnection );
+  }
+
+  stanleyGuidance.setMaxSteeringAngle( scenario.maxSteeringAngle );
+  QObject::connect( &stanleyGuidance, &StanleyGuidance::steerAngleChanged, [&steerAngleRequested]( const double steerAngle ) {
+    steerAngleRequested = steerAngle;
+  } );
+
+  // a normal distribution needs a positive standard deviation, so a disabled noise is drawn as 0
+  std::mt19937 noiseGenerator( seed );
+  std::normal_distribution<double> noisePosition( 0, scenario.noisePosition > 0 ? scenario.noisePosition : 1 );
+  std::normal_distribution<double> noiseHeading( 0, scenario.noiseHeading > 0 ? degreesToRadians( scenario.noiseHeading ) : 1 );
+  const double noisePositionFactor = scenario.noisePosition > 0 ? 1 : 0;
+  const double noiseHeadingFactor = scenario.noiseHeading > 0 ? 1 : 0;
+
+  // start on the reference line, pointing along it
+  const Point_2& start = polyline.front();
+  const Point_2& towards = polyline[1];
+  const double headingOfLine = std::atan2( towards.y() - start.y(), towards.x() - start.x() );
+
+  SimulationCore::State state;
+  state.setZero();
+  state( ThreeWheeledFRHRL::StateNames::X ) = start.x() - std::sin( headingOfLine ) * scenario.initialOffset;
+  state( ThreeWheeledFRHRL::StateNames::Y ) = start.y() + std::cos( headingOfLine ) * scenario.initialOffset;
+  state( ThreeWheeledFRHRL::StateNames::Yaw ) = normalizeAngleRadians( headingOfLine + degreesToRadians( scenario.initialHeadingOffset ) );
+
+  SimulationCore::Inputs inputs = scenario.vehicle;
+  inputs.velocity = scenario.velocity;
+  inputs.steerAngle = 0;
+
+  const double controlPeriod = 1. / scenario.controlRate;
+  const auto stepsPerControl = std::max<uint64_t>( 1, uint64_t( std::llround( controlPeriod / scenario.stepSize ) ) );
+  const auto numControlCycles = uint64_t( std::llround( scenario.duration / controlPeriod ) );
+  const double maxSteeringStep = scenario.maxSteeringRate > 0 ? scenario.maxSteeringRate * controlPeriod : std::numeric_limits<double>::infinity();
+
+  // the wheels, that are guided: front forwards, rear backwards
+  const double guidedWheelsOffset = reverse ? -inputs.b : inputs.a;
+
+  double steerAngle = 0;
+  double sumXteSquared = 0;
+  double sumSteeringRateSquared = 0;
+  std::size_t numSamples = 0;
+
+  for( uint64_t cycle = 0; cycle < numControlCycles; ++cycle ) {
+    const double time = double( cycle ) * controlPeriod;
+    const double yaw = state( ThreeWheeledFRHRL::StateNames::Yaw );
+
+    const Eigen::Vector3d guidedWheels( state( ThreeWheeledFRHRL::StateNames::X ) + std::cos( yaw ) * guidedWheelsOffset,
+                                        state( ThreeWheeledFRHRL::StateNames::Y ) + std::sin( yaw ) * guidedWheelsOffset,
+                                        0 );
+
+    // measured pose with noise
+    {
+      const Eigen::Vector3d position( guidedWheels.x() + noisePositionFactor * noisePosition( noiseGenerator ),
+                                      guidedWheels.y() + noisePositionFactor * noisePosition( noiseGenerator ),
+                                      0 );
+      const Eigen::Quaterniond orientation = taitBryanToQuaternion( yaw + noiseHeadingFactor * noiseHeading( noiseGenerator ), 0, 0 );
+
+      stanleyGuidance.setVelocity( scenario.velocity );
+      stanleyGuidance.setSteeringAngle( steerAngle );
+
+      if( reverse ) {
+        stanleyGuidance.setPoseRearWheels( position, orientation, PoseOption::Options() );
+      } else {
+        stanleyGuidance.setPoseFrontWheels( position, orientation, PoseOption::Options() );
+      }
+
+      xteGuidance.setPose( position, orientation, PoseOption::Options() );
+    }
+
+    // actuator with limited rate
+    const double newSteerAngle = std::clamp( steerAngleRequested, steerAngle - maxSteeringStep, steerAngle + maxSteeringStep );
+
+    // statistics with the true pose
+    if( time >= scenario.settleTime ) {
+      double distanceSquared = 0;
+      auto nearestPrimitive = plan.getNearestPrimitive( to2D( guidedWheels ), distanceSquared );
+
+      if( nearestPrimitive != plan.plan->cend() && !std::isinf( distanceSquared ) ) {
+        const double xte = std::sqrt( distanceSquared );
+        sumXteSquared += distanceSquared;
+        result.xteMax = std::max( result.xteMax, xte );
+
+        const double steeringRate = ( newSteerAngle - steerAngle ) / controlPeriod;
+        sumSteeringRateSquared += steeringRate * steeringRate;
+
+        ++numSamples;
+      }
+    }
+
+    steerAngle = newSteerAngle;
+    inputs.steerAngle = degreesToRadians( steerAngle );
+
+    for( uint64_t step = 0; step < stepsPerControl; ++step ) {
+      simulationCore.integrate( state, inputs, scenario.stepSize, scenario.integrator );
+    }
+  }
+
+  if( numSamples > 0 ) {
+    result.xteRms = std::sqrt( sumXteSquared / double( numSamples ) );
+    result.steeringRateRms = std::sqrt( sumSteeringRateSquared / double( numSamples ) );
+  }
+
+  return result;
+}
+
+double GuidanceTuning::benchmark( const SimulationCore::VehicleModel vehicleModel,
+                                  const SimulationCore::Integrator integrator,
+                                  const double stepSize,
+                                  const uint64_t steps ) {
+  SimulationCore simulationCore;
+  simulationCore.setVehicleModel( vehicleModel );
+
+  SimulationCore::State state;
+  state.setZero();
+
+  SimulationCore::Inputs inputs;
+  inputs.velocity = 3;
+
+  const auto start = std::chrono::steady_clock::now();
+
+  for( uint64_t step = 0; step < steps; ++step ) {
+    // a slow sine on the steering keeps the dynamic part busy
+    inputs.steerAngle = 0.3 * std::sin( double( step ) * stepSize * 0.5 );
+    simulationCore.integrate( state, inputs, stepSize, integrator );
+  }
+
+  const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+  // keep the result alive, so the loop isn't optimised away
+  if( std::isnan( state( ThreeWheeledFRHRL::StateNames::X ) ) ) {
+    return 0;
+  }
+
+  return double( steps ) / std::max( duration.count(), 1e-9 );
+}
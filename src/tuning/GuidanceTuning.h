@@ -0,0 +1,124 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "helpers/cgalHelper.h"
+
+#include "kinematic/Plan.h"
+#include "kinematic/SimulationCore.h"
+
+class QFile;
+
+// gains of StanleyGuidance; used for forwards or reverse, depending on the sign of the velocity
+struct StanleyGains {
+  double k = 1;
+  double kSoft = 1;
+  double dampeningYaw = 0;
+  double dampeningSteering = 0;
+};
+
+struct GuidanceScenario {
+  // m/s; negative values drive backwards and use the rear wheels
+  double velocity = 2;
+  // s of simulated time
+  double duration = 60;
+  // the first seconds are not part of the statistics, so the initial offsets don't dominate them
+  double settleTime = 5;
+
+  double initialOffset = 0.5;
+  double initialHeadingOffset = 0;
+
+  // Hz, the rate of the pose (GNSS) and the guidance
+  double controlRate = 10;
+  double stepSize = 0.001;
+  SimulationCore::Integrator integrator = SimulationCore::Integrator::RungeKutta4;
+  SimulationCore::VehicleModel vehicleModel = SimulationCore::VehicleModel::ThreeWheeled;
+
+  // standard deviations in m and °
+  double noisePosition = 0.02;
+  double noiseHeading = 0.1;
+
+  // ° and °/s; 0: unlimited rate
+  double maxSteeringAngle = 40;
+  double maxSteeringRate = 0;
+
+  double implementWidth = 3;
+
+  // vehicle parameters as in PoseSimulation
+  SimulationCore::Inputs vehicle;
+};
+
+struct GuidanceRunResult {
+  double xteRms = 0;
+  double xteMax = 0;
+  // RMS of the rate of the steering angle in °/s
+  double steeringRateRms = 0;
+};
+
+struct GuidanceSweepResult {
+  StanleyGains gains;
+  std::size_t runs = 0;
+
+  double xteRmsMean = 0;
+  double xteRmsWorst = 0;
+  double xteMax = 0;
+  double steeringRateRmsMean = 0;
+};
+
+// headless closed-loop simulations of the vehicle model with XteGuidance and StanleyGuidance,
+// run in parallel over a grid of gains and randomised noise seeds
+class GuidanceTuning {
+  public:
+    GuidanceTuning();
+
+    void setScenario( const GuidanceScenario& scenario );
+
+    // a straight AB-line along the x-axis
+    void setSyntheticPlan();
+
+    // the first LineString of a GeoJSON file, like saved by GlobalPlanner; two points make an AB-line,
+    // more points an AB-curve
+    bool setPlanFromFile( QFile& file );
+
+    // the runs use the same seeds for every set of gains, so the sets are compared on the same noise
+    std::vector<GuidanceSweepResult> sweep( const std::vector<StanleyGains>& gains,
+                                            const std::size_t runsPerSet,
+                                            const uint32_t baseSeed,
+                                            std::size_t threads = 0 );
+
+    GuidanceRunResult run( SimulationCore& simulationCore, Plan& plan, const StanleyGains& gains, const uint32_t seed ) const;
+
+    // steps per second of a vehicle model in open loop
+    static double benchmark( const SimulationCore::VehicleModel vehicleModel,
+                             const SimulationCore::Integrator integrator,
+                             const double stepSize,
+                             const uint64_t steps );
+
+  private:
+    // every worker gets its own copy, so no primitive is shared across threads
+    Plan createPlan() const;
+
+  private:
+    GuidanceScenario scenario;
+
+    std::vector<Point_2> polyline;
+};
@@ -0,0 +1,221 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+// headless sweep of the gains of StanleyGuidance over closed-loop simulations, see GuidanceTuning
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+#include "GuidanceTuning.h"
+
+// "1,2,5" or "start:step:end"
+static std::vector<double> parseValues( const QString& string, bool& ok ) {
+  std::vector<double> values;
+  ok = true;
+
+  if( string.contains( QLatin1Char( ':' ) ) ) {
+    const auto parts = string.split( QLatin1Char( ':' ) );
+
+    if( parts.size() == 3 ) {
+      bool ok1, ok2, ok3;
+      const double start = parts.at( 0 ).toDouble( &ok1 );
+      const double step = parts.at( 1 ).toDouble( &ok2 );
+      const double end = parts.at( 2 ).toDouble( &ok3 );
+
+      if( ok1 && ok2 && ok3 && step > 0 ) {
+        for( int i = 0; start + i * step <= end + step * 1e-6; ++i ) {
+          values.push_back( start + i * step );
+        }
+
+        return values;
+      }
+    }
+
+    ok = false;
+    return values;
+  }
+
+  for( const auto& part : string.split( QLatin1Char( ',' ), Qt::SkipEmptyParts ) ) {
+    bool okValue;
+    values.push_back( part.toDouble( &okValue ) );
+    ok &= okValue;
+  }
+
+  return values;
+}
+
+int main( int argc, char** argv ) {
+  QCoreApplication app( argc, argv );
+  QCoreApplication::setOrganizationDomain( QStringLiteral( "QtOpenGuidance.org" ) );
+  QCoreApplication::setApplicationName( QStringLiteral( "GuidanceTuning" ) );
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription( QStringLiteral( "Sweeps the gains of the stanley controller over closed-loop simulations and reports XTE and steering effort as CSV." ) );
+  parser.addHelpOption();
+
+  const QCommandLineOption kOption( QStringLiteral( "k" ), QStringLiteral( "Gain K, as list \"a,b,c\" or range \"start:step:end\"." ), QStringLiteral( "values" ), QStringLiteral( "1" ) );
+  const QCommandLineOption kSoftOption( QStringLiteral( "k-soft" ), QStringLiteral( "Gain K softening." ), QStringLiteral( "values" ), QStringLiteral( "1" ) );
+  const QCommandLineOption dampeningYawOption( QStringLiteral( "dampening-yaw" ), QStringLiteral( "Gain yaw dampening." ), QStringLiteral( "values" ), QStringLiteral( "0" ) );
+  const QCommandLineOption dampeningSteeringOption( QStringLiteral( "dampening-steering" ), QStringLiteral( "Gain steering dampening." ), QStringLiteral( "values" ), QStringLiteral( "0" ) );
+  const QCommandLineOption runsOption( QStringLiteral( "runs" ), QStringLiteral( "Runs with different noise seeds per set of gains." ), QStringLiteral( "number" ), QStringLiteral( "10" ) );
+  const QCommandLineOption seedOption( QStringLiteral( "seed" ), QStringLiteral( "Seed of the first run." ), QStringLiteral( "number" ), QStringLiteral( "1" ) );
+  const QCommandLineOption threadsOption( QStringLiteral( "threads" ), QStringLiteral( "Worker threads, 0: all cores." ), QStringLiteral( "number" ), QStringLiteral( "0" ) );
+  const QCommandLineOption planOption( QStringLiteral( "plan" ), QStringLiteral( "GeoJSON file with an AB-line/curve; default: synthetic AB-line." ), QStringLiteral( "file" ) );
+  const QCommandLineOption velocityOption( QStringLiteral( "velocity" ), QStringLiteral( "Velocity in m/s, negative: reverse." ), QStringLiteral( "m/s" ), QStringLiteral( "2" ) );
+  const QCommandLineOption durationOption( QStringLiteral( "duration" ), QStringLiteral( "Simulated time per run in s." ), QStringLiteral( "s" ), QStringLiteral( "60" ) );
+  const QCommandLineOption settleTimeOption( QStringLiteral( "settle-time" ), QStringLiteral( "Time in s before the statistics start." ), QStringLiteral( "s" ), QStringLiteral( "5" ) );
+  const QCommandLineOption offsetOption( QStringLiteral( "offset" ), QStringLiteral( "Initial lateral offset in m." ), QStringLiteral( "m" ), QStringLiteral( "0.5" ) );
+  const QCommandLineOption headingOffsetOption( QStringLiteral( "heading-offset" ), QStringLiteral( "Initial heading offset in °." ), QStringLiteral( "°" ), QStringLiteral( "0" ) );
+  const QCommandLineOption rateOption( QStringLiteral( "rate" ), QStringLiteral( "Rate of pose and guidance in Hz." ), QStringLiteral( "Hz" ), QStringLiteral( "10" ) );
+  const QCommandLineOption noisePositionOption( QStringLiteral( "noise-position" ), QStringLiteral( "Standard deviation of the position in m." ), QStringLiteral( "m" ), QStringLiteral( "0.02" ) );
+  const QCommandLineOption noiseHeadingOption( QStringLiteral( "noise-heading" ), QStringLiteral( "Standard deviation of the heading in °." ), QStringLiteral( "°" ), QStringLiteral( "0.1" ) );
+  const QCommandLineOption maxSteeringRateOption( QStringLiteral( "max-steering-rate" ), QStringLiteral( "Rate limit of the steering in °/s, 0: unlimited." ), QStringLiteral( "°/s" ), QStringLiteral( "0" ) );
+  const QCommandLineOption modelOption( QStringLiteral( "model" ), QStringLiteral( "Vehicle model: 0: ThreeWheeledFRHRL, 1: VehicleNonLinear3DOF, 2: VehicleNonLinear4DOF." ), QStringLiteral( "number" ), QStringLiteral( "0" ) );
+  const QCommandLineOption benchmarkOption( QStringLiteral( "benchmark" ), QStringLiteral( "Report the steps per second of every vehicle model, and of every integrator for the model using them, instead of a sweep." ) );
+  const QCommandLineOption outputOption( QStringLiteral( "output" ), QStringLiteral( "CSV file; default: stdout." ), QStringLiteral( "file" ) );
+
+  parser.addOptions( { kOption, kSoftOption, dampeningYawOption, dampeningSteeringOption,
+                       runsOption, seedOption, threadsOption, planOption,
+                       velocityOption, durationOption, settleTimeOption, offsetOption, headingOffsetOption, rateOption,
+                       noisePositionOption, noiseHeadingOption, maxSteeringRateOption, modelOption, benchmarkOption, outputOption } );
+  parser.process( app );
+
+  QTextStream errorStream( stderr );
+
+  if( parser.isSet( benchmarkOption ) ) {
+    QTextStream outputStream( stdout );
+    outputStream << "model,integrator,stepsPerSecond" << Qt::endl;
+
+    const std::array<const char*, 3> modelNames = { "ThreeWheeledFRHRL", "VehicleNonLinear3DOF", "VehicleNonLinear4DOF" };
+    const std::array<const char*, 2> integratorNames = { "Euler", "RungeKutta4" };
+
+    for( std::size_t model = 0; model < modelNames.size(); ++model ) {
+      const auto vehicleModel = SimulationCore::VehicleModel( model );
+
+      // the nonlinear models step themselves with forward Euler, so they get one row without an integrator
+      if( !SimulationCore::usesIntegrator( vehicleModel ) ) {
+        const double stepsPerSecond = GuidanceTuning::benchmark( vehicleModel, SimulationCore::Integrator::Euler, 0.001, 2000000 );
+        outputStream << modelNames[model] << ",none," << qRound64( stepsPerSecond ) << Qt::endl;
+        continue;
+      }
+
+      for( std::size_t integrator = 0; integrator < integratorNames.size(); ++integrator ) {
+        const double stepsPerSecond = GuidanceTuning::benchmark( vehicleModel,
+                                      SimulationCore::Integrator( integrator ),
+                                      0.001, 2000000 );
+        outputStream << modelNames[model] << ',' << integratorNames[integrator] << ',' << qRound64( stepsPerSecond ) << Qt::endl;
+      }
+    }
+
+    return 0;
+  }
+
+  GuidanceScenario scenario;
+  scenario.velocity = parser.value( velocityOption ).toDouble();
+  scenario.duration = parser.value( durationOption ).toDouble();
+  scenario.settleTime = parser.value( settleTimeOption ).toDouble();
+  scenario.initialOffset = parser.value( offsetOption ).toDouble();
+  scenario.initialHeadingOffset = parser.value( headingOffsetOption ).toDouble();
+  scenario.controlRate = parser.value( rateOption ).toDouble();
+  scenario.noisePosition = parser.value( noisePositionOption ).toDouble();
+  scenario.noiseHeading = parser.value( noiseHeadingOption ).toDouble();
+  scenario.maxSteeringRate = parser.value( maxSteeringRateOption ).toDouble();
+  scenario.vehicleModel = SimulationCore::VehicleModel( std::clamp( parser.value( modelOption ).toInt(), 0, 2 ) );
+
+  GuidanceTuning tuning;
+  tuning.setScenario( scenario );
+
+  if( parser.isSet( planOption ) ) {
+    QFile planFile( parser.value( planOption ) );
+
+    if( !planFile.open( QIODevice::ReadOnly ) || !tuning.setPlanFromFile( planFile ) ) {
+      errorStream << "Couldn't load a LineString from " << planFile.fileName() << Qt::endl;
+      return 1;
+    }
+  }
+
+  bool ok1, ok2, ok3, ok4;
+  const auto kValues = parseValues( parser.value( kOption ), ok1 );
+  const auto kSoftValues = parseValues( parser.value( kSoftOption ), ok2 );
+  const auto dampeningYawValues = parseValues( parser.value( dampeningYawOption ), ok3 );
+  const auto dampeningSteeringValues = parseValues( parser.value( dampeningSteeringOption ), ok4 );
+
+  if( !( ok1 && ok2 && ok3 && ok4 ) ) {
+    errorStream << "Invalid list of gains" << Qt::endl;
+    return 1;
+  }
+
+  // the grid of all combinations
+  std::vector<StanleyGains> gains;
+
+  for( const auto k : kValues ) {
+    for( const auto kSoft : kSoftValues ) {
+      for( const auto dampeningYaw : dampeningYawValues ) {
+        for( const auto dampeningSteering : dampeningSteeringValues ) {
+          gains.push_back( StanleyGains{ k, kSoft, dampeningYaw, dampeningSteering } );
+        }
+      }
+    }
+  }
+
+  const auto runs = std::size_t( std::max( parser.value( runsOption ).toInt(), 1 ) );
+
+  QElapsedTimer timer;
+  timer.start();
+
+  const auto results = tuning.sweep( gains, runs, parser.value( seedOption ).toUInt(), std::size_t( std::max( parser.value( threadsOption ).toInt(), 0 ) ) );
+
+  errorStream << gains.size() * runs << " runs in " << double( timer.elapsed() ) / 1000 << " s" << Qt::endl;
+
+  QFile outputFile;
+
+  if( parser.isSet( outputOption ) ) {
+    outputFile.setFileName( parser.value( outputOption ) );
+
+    if( !outputFile.open( QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text ) ) {
+      errorStream << "Couldn't open " << outputFile.fileName() << Qt::endl;
+      return 1;
+    }
+  } else {
+    outputFile.open( stdout, QIODevice::WriteOnly | QIODevice::Text );
+  }
+
+  QTextStream outputStream( &outputFile );
+  outputStream << "k,kSoft,dampeningYaw,dampeningSteering,runs,xteRmsMean,xteRmsWorst,xteMax,steeringRateRmsMean" << Qt::endl;
+
+  for( const auto& result : results ) {
+    outputStream << result.gains.k << ','
+                 << result.gains.kSoft << ','
+                 << result.gains.dampeningYaw << ','
+                 << result.gains.dampeningSteering << ','
+                 << result.runs << ','
+                 << result.xteRmsMean << ','
+                 << result.xteRmsWorst << ','
+                 << result.xteMax << ','
+                 << result.steeringRateRmsMean << Qt::endl;
+  }
+
+  return 0;
+}